@@ -0,0 +1,95 @@
+#include "audio/capture_session.h"
+#include <algorithm>
+#include <android/log.h>
+
+#define LOG_TAG "RVC_CAPTURE_SESSION"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+
+namespace rvc {
+
+bool CaptureSession::isValidFormat(int sampleRate, int channelCount) {
+    return sampleRate >= kMinSampleRate && sampleRate <= kMaxSampleRate &&
+           channelCount >= 1 && channelCount <= kMaxChannels;
+}
+
+size_t CaptureSession::maxModelSamples(size_t maxFrames, int modelSampleRate) {
+    // Marge : arrondi des positions fractionnaires du convertisseur.
+    return (maxFrames * modelSampleRate + kMinSampleRate - 1) / kMinSampleRate + 2;
+}
+
+CaptureSession::CaptureSession(int sampleRate, int channelCount, int modelSampleRate, size_t maxFrames)
+    : sampleRate_(sampleRate),
+      channelCount_(channelCount),
+      voiceActivity_(sampleRate),
+      modelBridge_(sampleRate, modelSampleRate, maxFrames),
+      pitchTracker_(sampleRate),
+      f0DelayHops_((pitchTracker_.latencySamples() + pitchTracker_.hopSamples() / 2) / pitchTracker_.hopSamples() +
+                   F0Conditioner::kMedianDelayHops) {
+    if (channelCount_ > 1) {
+        mono_.resize(maxFrames);
+    }
+    // Pas terminés par bloc : au plus un de plus que la durée du bloc.
+    estimates_.resize(maxFrames / pitchTracker_.hopSamples() + 2);
+    f0Frames_.resize(estimates_.size());
+    LOGI("Session de capture : %d Hz, %d canal(aux), modèle à %d Hz (%zu échantillons de conversion, "
+         "F0 en retard de %zu pas recalée).",
+         sampleRate_, channelCount_, modelSampleRate, modelBridge_.latencySamples(), f0DelayHops_);
+}
+
+size_t CaptureSession::modelBlockSamples() const {
+    size_t frames = maxBlockFrames_.load(std::memory_order_relaxed);
+    if (frames == 0) frames = static_cast<size_t>(sampleRate_) * kNominalBlockMs / 1000;
+    const size_t sessionRate = static_cast<size_t>(sampleRate_);
+    return (frames * static_cast<size_t>(modelSampleRate()) + sessionRate - 1) / sessionRate;
+}
+
+float* CaptureSession::downmix(float* interleaved, size_t numFrames) {
+    if (numFrames > maxBlockFrames_.load(std::memory_order_relaxed)) {
+        maxBlockFrames_.store(numFrames, std::memory_order_relaxed);
+    }
+    if (channelCount_ == 1) return interleaved;
+
+    const float scale = 1.0f / static_cast<float>(channelCount_);
+    for (size_t i = 0; i < numFrames; ++i) {
+        const float* frame = interleaved + i * channelCount_;
+        float sum = 0.0f;
+        for (int c = 0; c < channelCount_; ++c) sum += frame[c];
+        mono_[i] = sum * scale;
+    }
+    return mono_.data();
+}
+
+void CaptureSession::upmix(const float* mono, float* interleaved, size_t numFrames) const {
+    if (channelCount_ == 1) return;
+
+    for (size_t i = 0; i < numFrames; ++i) {
+        float* frame = interleaved + i * channelCount_;
+        for (int c = 0; c < channelCount_; ++c) frame[c] = mono[i];
+    }
+}
+
+const VoiceParameters& CaptureSession::acquireVoice() {
+    if (voiceBlock_.acquire()) {
+        voice_ = voiceBlock_.read();
+        f0Conditioner_.setVoice(voice_);
+    }
+    return voice_;
+}
+
+void CaptureSession::trackPitch(const float* mono, size_t numFrames) {
+    const size_t count = std::min(pitchTracker_.process(mono, numFrames, estimates_.data(), estimates_.size()),
+                                  estimates_.size());
+    for (size_t i = 0; i < count; ++i) {
+        f0Frames_[i] = f0Conditioner_.condition(estimates_[i]);
+    }
+    numF0Frames_ = count;
+    if (count == 0) return;
+
+    // Trame i : pas i - f0DelayHops_ du bloc. Celles des pas du bloc précédent (déjà rendu
+    // avec la F0 maintenue) sont écartées, les derniers pas gardent la F0 la plus récente.
+    const size_t shift = std::min(f0DelayHops_, count - 1);
+    std::copy(f0Frames_.begin() + shift, f0Frames_.begin() + count, f0Frames_.begin());
+    std::fill(f0Frames_.begin() + (count - shift), f0Frames_.begin() + count, f0Frames_[count - shift - 1]);
+}
+
+} // namespace rvc
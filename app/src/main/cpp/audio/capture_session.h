@@ -0,0 +1,117 @@
+#pragma once
+
+#include "dsp/pitch_tracker.h"
+#include "dsp/resampler.h"
+#include "dsp/triple_buffer.h"
+#include "dsp/voice_activity.h"
+#include "inference/f0_conditioner.h"
+#include "inference/model_conditioning.h"
+#include "inference/voice_parameters.h"
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Session de capture d'une application hookée (AudioRecord) : son format et les
+ * conversions qui en découlent (V16.0).
+ *
+ * Le graphe d'effets et le VAD tournent à la fréquence de l'application : aucune
+ * conversion en mode Low Power, et seulement deux, autour du modèle, sinon (aucune quand
+ * l'application capture déjà à la fréquence du modèle). Les canaux entrelacés sont réduits
+ * en mono pour le traitement, puis la voix convertie est recopiée sur chaque canal.
+ *
+ * La session porte aussi la voix de l'application (réglages du profil, publiés sans verrou)
+ * et le contour de F0 conditionné qui accompagne chaque bloc vers le modèle : changer de
+ * voix d'une application à l'autre ne recharge pas le modèle.
+ *
+ * Alignement F0 / audio : une trame de F0 décrit le pas situé f0DelayHops() plus tôt
+ * (centre de la trame d'analyse du PitchTracker, décimation comprise, puis centre du
+ * médian du F0Conditioner). Plutôt que de retarder l'audio du modèle d'autant, chaque
+ * trame est rapportée au pas qu'elle décrit : les f0DelayHops() derniers pas du bloc, pas
+ * encore analysés, reprennent la dernière F0 connue.
+ */
+class CaptureSession {
+public:
+    // Bornes d'AudioRecord.
+    static constexpr int kMinSampleRate = 4000;
+    static constexpr int kMaxSampleRate = 192000;
+    static constexpr int kMaxChannels = 8;
+    // Lecture d'AudioRecord supposée tant qu'aucun bloc n'est arrivé (applications de voix).
+    static constexpr int kNominalBlockMs = 20;
+
+    static bool isValidFormat(int sampleRate, int channelCount);
+    // Plus grand bloc vu par le modèle, toutes sessions confondues (capture à kMinSampleRate).
+    static size_t maxModelSamples(size_t maxFrames, int modelSampleRate);
+
+    // maxFrames : plus grand bloc (trames) ; modelSampleRate : fréquence native du modèle.
+    CaptureSession(int sampleRate, int channelCount, int modelSampleRate, size_t maxFrames);
+
+    int sampleRate() const { return sampleRate_; }
+    int channelCount() const { return channelCount_; }
+    int modelSampleRate() const { return modelBridge_.innerRate(); }
+    // Bloc vu par le modèle (échantillons à sa fréquence) : le plus grand bloc reçu par la
+    // session, ou kNominalBlockMs avant le premier. Lisible depuis n'importe quel thread.
+    size_t modelBlockSamples() const;
+
+    // Écrivain unique : les appelants se sérialisent (sessionMutex du moteur).
+    void publishVoice(const VoiceParameters& voice) { voiceBlock_.publish(voice); }
+
+    // --- Thread audio ---
+    // Voix mono à la fréquence de la session : le buffer lui-même en mono, sinon la moyenne
+    // des canaux dans un buffer interne. Relève aussi la taille du bloc (modelBlockSamples).
+    float* downmix(float* interleaved, size_t numFrames);
+    // Recopie la voix traitée sur chaque canal (rien à faire en mono).
+    void upmix(const float* mono, float* interleaved, size_t numFrames) const;
+
+    // Réglages de voix publiés depuis le bloc précédent (sans verrou).
+    const VoiceParameters& acquireVoice();
+    // Suivi de F0 de la voix prétraitée : contour conditionné du bloc pour runModel, une
+    // trame par pas, alignée sur l'audio du bloc (voir f0DelayHops).
+    void trackPitch(const float* mono, size_t numFrames);
+    // Retard des trames de F0 sur l'audio qu'elles décrivent, en pas du PitchTracker.
+    size_t f0DelayHops() const { return f0DelayHops_; }
+
+    // Inférence à la fréquence du modèle, en place :
+    // run(float* samples, size_t count, const ModelConditioning& conditioning).
+    template <typename Run>
+    void runModel(float* mono, size_t numFrames, Run&& run) {
+        const bool discontinuity = modelSkipped_;
+        if (modelSkipped_) {
+            // Les historiques des filtres datent d'avant la pause : nouveau flux.
+            modelBridge_.reset();
+            modelSkipped_ = false;
+        }
+        const ModelConditioning conditioning{f0Frames_.data(), numF0Frames_, voice_.indexRate, discontinuity};
+        modelBridge_.process(mono, numFrames, [&](float* samples, size_t count) { run(samples, count, conditioning); });
+    }
+    // Bloc où le modèle n'a pas tourné (VAD, Noise Gate).
+    void skipModel() { modelSkipped_ = true; }
+
+    VoiceActivityGate& voiceActivity() { return voiceActivity_; }
+    const VoiceActivityGate& voiceActivity() const { return voiceActivity_; }
+
+    // Retard des conversions vers le modèle et retour (échantillons de la session).
+    size_t modelLatencySamples() const { return modelBridge_.latencySamples(); }
+
+private:
+    int sampleRate_;
+    int channelCount_;
+    std::vector<float> mono_; // Vide en mono
+    std::atomic<size_t> maxBlockFrames_{0}; // Écrit par le thread audio
+    VoiceActivityGate voiceActivity_;
+    RateBridge modelBridge_;
+    bool modelSkipped_ = true; // Le premier bloc ouvre un nouveau flux pour le modèle
+
+    TripleBuffer<VoiceParameters> voiceBlock_;
+    VoiceParameters voice_; // Copie propre au thread audio
+    PitchTracker pitchTracker_;
+    F0Conditioner f0Conditioner_;
+    std::vector<PitchTracker::Estimate> estimates_;
+    std::vector<F0Frame> f0Frames_; // Contour du bloc courant (une trame par pas de 10 ms)
+    size_t numF0Frames_ = 0;
+    size_t f0DelayHops_;
+};
+
+} // namespace rvc
@@ -0,0 +1,705 @@
+#include "dsp/audio_graph.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <android/log.h>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+#define LOG_TAG "RVC_AUDIO_GRAPH"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace rvc {
+
+namespace {
+
+// Poids d'une nouvelle mesure dans le coût moyen d'une étape.
+constexpr float kCostSmoothing = 0.1f;
+
+// Durée du fondu enchaîné d'un contournement (assez long pour ne pas cliquer, assez court
+// pour rester imperceptible comme transition).
+constexpr float kCrossfadeMs = 10.0f;
+
+constexpr uint32_t kNoNode = UINT32_MAX;
+
+// Crête sous laquelle un bloc est considéré silencieux (-120 dBFS).
+constexpr float kSilenceThreshold = 1e-6f;
+
+std::unique_ptr<CompiledGraph> fail(std::string* error, const std::string& message) {
+    LOGE("Graphe invalide : %s", message.c_str());
+    if (error != nullptr) *error = message;
+    return nullptr;
+}
+
+} // namespace
+
+GraphDescription GraphDescription::chain(const std::vector<Node>& nodes) {
+    GraphDescription description;
+    description.nodes = nodes;
+    std::string previous = kInput;
+    for (const Node& node : nodes) {
+        description.edges.push_back({previous, node.id});
+        previous = node.id;
+    }
+    description.edges.push_back({previous, kOutput});
+    return description;
+}
+
+/**
+ * Compilation : validation, tri topologique (Kahn, ordre de déclaration conservé entre
+ * nœuds indépendants, sortie toujours en dernier) puis attribution des buffers.
+ */
+std::unique_ptr<CompiledGraph> CompiledGraph::compile(const GraphDescription& description,
+                                                      const NodeContext& context,
+                                                      std::string* error) {
+    if (context.maxBlockSize == 0) {
+        return fail(error, "taille de bloc maximale nulle");
+    }
+
+    // Sommets : 0 = entrée, 1..N = nœuds, N+1 = sortie.
+    const size_t numNodes = description.nodes.size();
+    const size_t inputVertex = 0;
+    const size_t outputVertex = numNodes + 1;
+    const size_t numVertices = numNodes + 2;
+
+    std::unordered_map<std::string, size_t> vertexOf;
+    vertexOf[GraphDescription::kInput] = inputVertex;
+    vertexOf[GraphDescription::kOutput] = outputVertex;
+    NodeRegistry* registry = NodeRegistry::getInstance();
+    for (size_t i = 0; i < numNodes; ++i) {
+        const GraphDescription::Node& node = description.nodes[i];
+        if (!vertexOf.emplace(node.id, i + 1).second) {
+            return fail(error, "identifiant dupliqué ou réservé '" + node.id + "'");
+        }
+        if (!registry->contains(node.type)) {
+            return fail(error, "type de nœud inconnu '" + node.type + "'");
+        }
+    }
+
+    std::vector<std::vector<size_t>> preds(numVertices);
+    std::vector<std::vector<size_t>> succs(numVertices);
+    for (const GraphDescription::Edge& edge : description.edges) {
+        auto from = vertexOf.find(edge.from);
+        auto to = vertexOf.find(edge.to);
+        if (from == vertexOf.end() || to == vertexOf.end()) {
+            return fail(error, "arête vers un nœud inconnu '" + edge.from + "' -> '" + edge.to + "'");
+        }
+        const size_t u = from->second;
+        const size_t v = to->second;
+        if (u == outputVertex || v == inputVertex || u == v) {
+            return fail(error, "arête invalide '" + edge.from + "' -> '" + edge.to + "'");
+        }
+        if (std::find(preds[v].begin(), preds[v].end(), u) != preds[v].end()) {
+            return fail(error, "arête dupliquée '" + edge.from + "' -> '" + edge.to + "'");
+        }
+        preds[v].push_back(u);
+        succs[u].push_back(v);
+    }
+    for (size_t v = 1; v < numVertices; ++v) {
+        if (preds[v].empty()) {
+            return fail(error, v == outputVertex ? std::string("sortie non reliée")
+                                                 : "nœud sans entrée '" + description.nodes[v - 1].id + "'");
+        }
+    }
+
+    // Tri topologique.
+    std::vector<size_t> pending(numVertices);
+    for (size_t v = 0; v < numVertices; ++v) pending[v] = preds[v].size();
+    std::vector<bool> done(numVertices, false);
+    std::vector<size_t> order;
+    order.reserve(numVertices);
+    order.push_back(inputVertex);
+    done[inputVertex] = true;
+    for (size_t v : succs[inputVertex]) --pending[v];
+    while (order.size() < numVertices - 1) {
+        size_t next = numVertices;
+        for (size_t v = 1; v <= numNodes; ++v) {
+            if (!done[v] && pending[v] == 0) {
+                next = v;
+                break;
+            }
+        }
+        if (next == numVertices) {
+            return fail(error, "cycle détecté");
+        }
+        done[next] = true;
+        order.push_back(next);
+        for (size_t v : succs[next]) --pending[v];
+    }
+    order.push_back(outputVertex);
+
+    std::unique_ptr<CompiledGraph> graph(new CompiledGraph());
+    graph->maxBlockSize_ = context.maxBlockSize;
+    graph->nodes_.resize(numNodes);
+    for (size_t i = 0; i < numNodes; ++i) {
+        const GraphDescription::Node& node = description.nodes[i];
+        graph->nodes_[i] = registry->create(node.type, context);
+        if (!graph->nodes_[i]) {
+            return fail(error, "création du nœud '" + node.id + "' impossible");
+        }
+        graph->params_.push_back(graph->nodes_[i]->numParameters() > 0
+                                     ? std::make_unique<NodeParameters>(*graph->nodes_[i], context.sampleRate)
+                                     : nullptr);
+        graph->nodeIds_.push_back(node.id);
+        graph->nodeTypes_.push_back(node.type);
+    }
+
+    // Contournement : chemin sec retardé de la latence du nœud, historique pour l'amorçage.
+    graph->bypassRequested_ = std::make_unique<std::atomic<bool>[]>(numNodes);
+    graph->bypass_.resize(numNodes);
+    for (size_t i = 0; i < numNodes; ++i) {
+        const AudioProcessor& node = *graph->nodes_[i];
+        if (node.latencySamples() > 0) {
+            graph->bypass_[i].dryDelay = std::make_unique<DelayLine>(node.latencySamples());
+        }
+        graph->bypass_[i].history.assign(node.primingSamples(), 0.0f);
+    }
+    graph->crossfadeSamples_ = std::max<size_t>(1, static_cast<size_t>(kCrossfadeMs * 0.001f * context.sampleRate));
+
+    // Latence cumulée en sortie de chaque sommet ; inputLatency = alignement de ses entrées.
+    std::vector<size_t> latency(numVertices, 0);
+    std::vector<size_t> inputLatency(numVertices, 0);
+    for (size_t position = 1; position < order.size(); ++position) {
+        const size_t v = order[position];
+        for (size_t u : preds[v]) inputLatency[v] = std::max(inputLatency[v], latency[u]);
+        latency[v] = inputLatency[v] + (v == outputVertex ? 0 : graph->nodes_[v - 1]->latencySamples());
+    }
+    graph->latencySamples_ = latency[outputVertex];
+
+    // Niveaux du DAG : un nœud suit tous ses prédécesseurs, et tout nœud partageant le même
+    // état externe (sharedState) placé avant lui dans l'ordre topologique.
+    std::vector<size_t> level(numVertices, 0);
+    std::unordered_map<const void*, size_t> stateLevel;
+    size_t maxLevel = 0;
+    for (size_t position = 1; position + 1 < order.size(); ++position) {
+        const size_t v = order[position];
+        for (size_t u : preds[v]) level[v] = std::max(level[v], level[u] + 1);
+        const void* state = graph->nodes_[v - 1]->sharedState();
+        if (state != nullptr) {
+            auto it = stateLevel.find(state);
+            if (it != stateLevel.end()) level[v] = std::max(level[v], it->second + 1);
+            stateLevel[state] = level[v];
+        }
+        maxLevel = std::max(maxLevel, level[v]);
+    }
+    level[outputVertex] = maxLevel + 1;
+
+    std::vector<size_t> nodesPerLevel(maxLevel + 1, 0);
+    for (size_t v = 1; v <= numNodes; ++v) ++nodesPerLevel[level[v]];
+    // Vagues calculées dès que le DAG a des branches indépendantes, pool présent ou non : le
+    // propriétaire peut attacher ses workers ensuite (attachWorkers), et l'exécution
+    // séquentielle d'un ordonnancement par vagues reste valide.
+    const bool parallel = std::any_of(nodesPerLevel.begin(), nodesPerLevel.end(), [](size_t n) { return n > 1; });
+
+    // En parallèle, l'ordre d'exécution regroupe les nœuds par niveau (ordre topologique
+    // conservé à l'intérieur d'un niveau).
+    std::vector<size_t> schedule = order;
+    if (parallel) {
+        std::stable_sort(schedule.begin() + 1, schedule.end(),
+                         [&level](size_t a, size_t b) { return level[a] < level[b]; });
+    }
+
+    // Attribution des buffers par durée de vie : remaining[v] = consommateurs restants
+    // de la sortie de v. Les buffers de travail libérés sont réutilisés (plus petit index).
+    // En parallèle, un buffer libéré ne redevient disponible qu'à la vague suivante, et un
+    // nœud ne traite en place que l'entrée qu'aucun autre nœud de sa vague ne lit.
+    std::vector<size_t> remaining(numVertices);
+    for (size_t v = 0; v < numVertices; ++v) remaining[v] = succs[v].size();
+    std::vector<uint32_t> bufferOf(numVertices, 0);
+    std::vector<uint32_t> freeBuffers;
+    std::vector<uint32_t> releasedInWave;
+    std::vector<size_t> stepLevel;
+    uint32_t numBuffers = 1;
+    size_t currentLevel = 0;
+
+    for (size_t position = 1; position < schedule.size(); ++position) {
+        const size_t v = schedule[position];
+        if (level[v] != currentLevel) {
+            freeBuffers.insert(freeBuffers.end(), releasedInWave.begin(), releasedInWave.end());
+            releasedInWave.clear();
+            currentLevel = level[v];
+        }
+        std::vector<uint32_t>& released = parallel ? releasedInWave : freeBuffers;
+
+        uint32_t out = 0;
+        if (v != outputVertex) {
+            bool inPlace = false;
+            for (size_t u : preds[v]) {
+                const bool sharedInWave = parallel && std::any_of(succs[u].begin(), succs[u].end(),
+                    [&](size_t w) { return w != v && level[w] == level[v]; });
+                if (remaining[u] == 1 && !sharedInWave) {
+                    out = bufferOf[u];
+                    inPlace = true;
+                    break;
+                }
+            }
+            if (!inPlace) {
+                if (!freeBuffers.empty()) {
+                    auto smallest = std::min_element(freeBuffers.begin(), freeBuffers.end());
+                    out = *smallest;
+                    freeBuffers.erase(smallest);
+                } else {
+                    out = numBuffers++;
+                }
+            }
+        }
+
+        std::vector<uint32_t> inputs;
+        std::vector<DelayLine*> inputDelays;
+        for (size_t u : preds[v]) {
+            inputs.push_back(bufferOf[u]);
+            const size_t lag = inputLatency[v] - latency[u];
+            if (lag > 0) graph->delays_.push_back(std::make_unique<DelayLine>(lag));
+            inputDelays.push_back(lag > 0 ? graph->delays_.back().get() : nullptr);
+        }
+        auto self = std::find(inputs.begin(), inputs.end(), out);
+        if (self != inputs.end()) {
+            const size_t k = static_cast<size_t>(self - inputs.begin());
+            std::rotate(inputs.begin(), self, self + 1);
+            std::rotate(inputDelays.begin(), inputDelays.begin() + k, inputDelays.begin() + k + 1);
+        }
+
+        // La sortie déjà dans le buffer de l'appelant n'a pas besoin d'étape.
+        if (!(v == outputVertex && inputs.size() == 1 && inputs[0] == 0)) {
+            Step step;
+            step.node = (v == outputVertex) ? nullptr : graph->nodes_[v - 1].get();
+            step.params = (v == outputVertex) ? nullptr : graph->params_[v - 1].get();
+            step.nodeIndex = (v == outputVertex) ? kNoNode : static_cast<uint32_t>(v - 1);
+            step.firstInput = static_cast<uint32_t>(graph->stepInputs_.size());
+            step.numInputs = static_cast<uint32_t>(inputs.size());
+            step.output = out;
+            graph->stepInputs_.insert(graph->stepInputs_.end(), inputs.begin(), inputs.end());
+            graph->stepInputDelays_.insert(graph->stepInputDelays_.end(), inputDelays.begin(), inputDelays.end());
+            graph->steps_.push_back(step);
+            stepLevel.push_back(level[v]);
+        }
+
+        for (size_t u : preds[v]) {
+            if (--remaining[u] == 0 && bufferOf[u] != out && bufferOf[u] != 0) {
+                released.push_back(bufferOf[u]);
+            }
+        }
+        bufferOf[v] = out;
+        // Sortie sans consommateur (branche d'analyse) : le buffer est libre aussitôt.
+        if (v != outputVertex && remaining[v] == 0 && out != 0) {
+            released.push_back(out);
+        }
+    }
+
+    if (parallel) {
+        graph->stepCostNs_.assign(graph->steps_.size(), 0.0f);
+        for (size_t i = 0; i < graph->steps_.size(); ++i) {
+            if (i == 0 || stepLevel[i] != stepLevel[i - 1]) {
+                graph->waves_.push_back({static_cast<uint32_t>(i), 0});
+            }
+            ++graph->waves_.back().numSteps;
+        }
+        for (const Wave& wave : graph->waves_) {
+            if (wave.numSteps > 1) ++graph->numParallelWaves_;
+        }
+        graph->scheduledWaves_.resize(graph->waves_.size());
+    }
+
+    graph->stepSilentRun_.assign(graph->steps_.size(), 0);
+    graph->stepInputDelay_.assign(graph->steps_.size(), 0);
+    for (size_t i = 0; i < graph->steps_.size(); ++i) {
+        const Step& step = graph->steps_[i];
+        for (uint32_t k = 0; k < step.numInputs; ++k) {
+            const DelayLine* delay = graph->stepInputDelays_[step.firstInput + k];
+            if (delay != nullptr) graph->stepInputDelay_[i] = std::max(graph->stepInputDelay_[i], delay->delay());
+        }
+    }
+
+    graph->attachWorkers(context.workers);
+
+    graph->schedule_.resize(graph->steps_.size());
+    graph->rebuildSchedule();
+
+    graph->numScratch_ = numBuffers - 1;
+    graph->bufferSilent_.assign(numBuffers, 0);
+    graph->scratch_.assign(graph->numScratch_ * graph->maxBlockSize_, 0.0f);
+    LOGI("Graphe compilé : %zu nœuds, %zu étapes, %zu buffers de travail, %zu vagues parallèles, "
+         "latence %zu échantillons (%zu retards de compensation).",
+         numNodes, graph->steps_.size(), graph->numScratch_, graph->numParallelWaves_,
+         graph->latencySamples_, graph->delays_.size());
+    return graph;
+}
+
+void CompiledGraph::attachWorkers(WorkerPool* workers) {
+    if (workers != nullptr && workers->numWorkers() > 0 && numParallelWaves_ > 0) {
+        workers_ = workers;
+    }
+}
+
+void CompiledGraph::process(float* buffer, size_t numSamples) {
+    if (bypassRequests_.load(std::memory_order_acquire) != bypassRequestsSeen_) {
+        applyBypassRequests();
+    }
+    while (numSamples > 0) {
+        const size_t len = std::min(numSamples, maxBlockSize_);
+        if (scheduleDirty_.load(std::memory_order_relaxed)) rebuildSchedule();
+        bufferSilent_[0] = simd::peakAbs(buffer, len) < kSilenceThreshold;
+        if (workers_ != nullptr) {
+            runWaves(buffer, len);
+        } else {
+            runSteps(buffer, len);
+        }
+        buffer += len;
+        numSamples -= len;
+    }
+}
+
+void CompiledGraph::runSteps(float* io, size_t numSamples) {
+    for (size_t i = 0; i < scheduleSize_; ++i) {
+        runStep(schedule_[i], io, numSamples);
+    }
+}
+
+void CompiledGraph::runStep(size_t index, float* io, size_t numSamples) {
+    const Step& step = steps_[index];
+    float* out = bufferAt(io, step.output);
+    if (skipSilentStep(index, step, out, numSamples)) return;
+
+    const uint32_t* inputs = stepInputs_.data() + step.firstInput;
+    DelayLine* const* delays = stepInputDelays_.data() + step.firstInput;
+    const float* first = bufferAt(io, inputs[0]);
+    if (delays[0] != nullptr) {
+        delays[0]->process(first, out, numSamples);
+    } else if (inputs[0] != step.output) {
+        std::copy(first, first + numSamples, out);
+    }
+    for (uint32_t k = 1; k < step.numInputs; ++k) {
+        if (delays[k] != nullptr) {
+            delays[k]->accumulate(bufferAt(io, inputs[k]), out, numSamples);
+        } else {
+            simd::accumulate(out, bufferAt(io, inputs[k]), numSamples);
+        }
+    }
+    if (step.node != nullptr) {
+        Bypass& bypass = bypass_[step.nodeIndex];
+        for (size_t offset = 0; offset < numSamples;) {
+            offset += runBypassMode(step, bypass, out + offset, numSamples - offset);
+        }
+    }
+    bufferSilent_[step.output] = simd::peakAbs(out, numSamples) < kSilenceThreshold;
+}
+
+/**
+ * Étape dont les entrées sont silencieuses depuis plus que ses retards et la traîne de son
+ * nœud : sortie nulle sans exécuter le nœud. Les nœuds en cours de fondu ou contournés
+ * suivent le chemin normal (leur sortie est mesurée comme les autres).
+ */
+bool CompiledGraph::skipSilentStep(size_t index, const Step& step, float* out, size_t numSamples) {
+    const uint32_t* inputs = stepInputs_.data() + step.firstInput;
+    bool inputsSilent = true;
+    for (uint32_t k = 0; k < step.numInputs; ++k) {
+        inputsSilent = inputsSilent && bufferSilent_[inputs[k]] != 0;
+    }
+    size_t& silentRun = stepSilentRun_[index];
+    if (!inputsSilent) {
+        silentRun = 0;
+        return false;
+    }
+
+    size_t settle = stepInputDelay_[index];
+    if (step.node != nullptr) {
+        const size_t tail = std::max(step.node->tailSamples(), step.node->latencySamples());
+        const bool active = bypass_[step.nodeIndex].mode == Bypass::Mode::Active;
+        settle = (tail == AudioProcessor::kUnboundedTail || !active) ? AudioProcessor::kUnboundedTail
+                                                                     : settle + tail;
+    }
+    const bool settled = silentRun >= settle;
+    silentRun = std::min(silentRun + numSamples, AudioProcessor::kUnboundedTail - 1);
+    if (!settled) return false;
+
+    std::fill(out, out + numSamples, 0.0f);
+    bufferSilent_[step.output] = 1;
+    return true;
+}
+
+void CompiledGraph::runNode(const Step& step, float* buffer, size_t numSamples) {
+    // Paramètres publiés depuis le bloc précédent, puis lissage par tranches si besoin.
+    NodeParameters* params = step.params;
+    if (params != nullptr) params->acquire();
+    if (params == nullptr || !params->isSmoothing()) {
+        step.node->process(buffer, numSamples);
+        return;
+    }
+    for (size_t offset = 0; offset < numSamples; offset += NodeParameters::kSmoothingSlice) {
+        const size_t len = std::min(NodeParameters::kSmoothingSlice, numSamples - offset);
+        params->advance(len);
+        step.node->process(buffer + offset, len);
+    }
+}
+
+/**
+ * Traite le début du bloc selon le mode de contournement ; retourne le nombre
+ * d'échantillons consommés (un fondu s'arrête à sa fin, le reste suit le nouveau mode).
+ */
+size_t CompiledGraph::runBypassMode(const Step& step, Bypass& bypass, float* buffer, size_t numSamples) {
+    switch (bypass.mode) {
+        case Bypass::Mode::Active:
+            if (bypass.dryDelay) bypass.dryDelay->push(buffer, numSamples);
+            runNode(step, buffer, numSamples);
+            return numSamples;
+        case Bypass::Mode::Bypassed:
+            if (!bypass.history.empty()) recordHistory(bypass, buffer, numSamples);
+            if (bypass.dryDelay) bypass.dryDelay->process(buffer, buffer, numSamples);
+            return numSamples;
+        case Bypass::Mode::FadingOut:
+        case Bypass::Mode::FadingIn:
+            return runCrossfade(step, bypass, buffer, numSamples);
+    }
+    return numSamples;
+}
+
+/**
+ * Fondu à puissance constante entre la sortie du nœud (wet) et son entrée retardée de sa
+ * latence (dry) : wet = cos θ, dry = sin θ en sortie (θ de 0 à π/2), l'inverse en entrée.
+ */
+size_t CompiledGraph::runCrossfade(const Step& step, Bypass& bypass, float* buffer, size_t numSamples) {
+    constexpr size_t kSlice = NodeParameters::kSmoothingSlice;
+    const bool fadingOut = bypass.mode == Bypass::Mode::FadingOut;
+    const size_t total = std::min(numSamples, crossfadeSamples_ - bypass.fadePosition);
+    const float thetaStep = static_cast<float>(M_PI_2) / static_cast<float>(crossfadeSamples_);
+
+    float dry[kSlice];
+    for (size_t offset = 0; offset < total; offset += kSlice) {
+        const size_t len = std::min(kSlice, total - offset);
+        float* x = buffer + offset;
+        if (bypass.dryDelay) {
+            bypass.dryDelay->process(x, dry, len);
+        } else {
+            std::copy(x, x + len, dry);
+        }
+        runNode(step, x, len);
+
+        for (size_t i = 0; i < len; ++i) {
+            const float theta = thetaStep * static_cast<float>(bypass.fadePosition + offset + i + 1);
+            const float wetGain = fadingOut ? std::cos(theta) : std::sin(theta);
+            const float dryGain = fadingOut ? std::sin(theta) : std::cos(theta);
+            x[i] = x[i] * wetGain + dry[i] * dryGain;
+        }
+    }
+
+    bypass.fadePosition += total;
+    if (bypass.fadePosition >= crossfadeSamples_) {
+        bypass.mode = fadingOut ? Bypass::Mode::Bypassed : Bypass::Mode::Active;
+        bypass.fadePosition = 0;
+        scheduleDirty_.store(true, std::memory_order_relaxed);
+    }
+    return total;
+}
+
+/**
+ * Historique circulaire des dernières entrées contournées : seules les primingSamples plus
+ * récentes comptent, un bloc plus long n'en garde que la fin.
+ */
+void CompiledGraph::recordHistory(Bypass& bypass, const float* in, size_t numSamples) {
+    const size_t size = bypass.history.size();
+    if (numSamples > size) {
+        in += numSamples - size;
+        numSamples = size;
+    }
+    const size_t first = std::min(numSamples, size - bypass.historyWrite);
+    std::copy(in, in + first, bypass.history.data() + bypass.historyWrite);
+    std::copy(in + first, in + numSamples, bypass.history.data());
+    bypass.historyWrite = (bypass.historyWrite + numSamples) % size;
+    bypass.historyFill = std::min(size, bypass.historyFill + numSamples);
+}
+
+/**
+ * Amorçage : l'historique traverse le nœud du plus ancien au plus récent échantillon, sortie
+ * ignorée. Ses filtres et enveloppes reprennent depuis l'audio qui précède la réactivation,
+ * quelle que soit la durée du contournement.
+ */
+void CompiledGraph::primeNode(size_t index) {
+    Bypass& bypass = bypass_[index];
+    if (bypass.historyFill == 0) return;
+    if (params_[index]) params_[index]->acquire();
+    // Plein : le plus ancien est à historyWrite ; sinon l'historique commence en 0.
+    const size_t oldest = bypass.historyFill == bypass.history.size() ? bypass.historyWrite : 0;
+    float* history = bypass.history.data();
+    const size_t segments[2][2] = {{oldest, bypass.historyFill - oldest}, {0, oldest}};
+    for (const auto& segment : segments) {
+        for (size_t offset = 0; offset < segment[1]; offset += maxBlockSize_) {
+            nodes_[index]->process(history + segment[0] + offset, std::min(maxBlockSize_, segment[1] - offset));
+        }
+    }
+    bypass.historyWrite = 0;
+    bypass.historyFill = 0;
+}
+
+/**
+ * Demandes du thread UI. Un fondu interrompu repart dans l'autre sens depuis le même
+ * point de la courbe (cos/sin symétriques) : pas de saut de niveau.
+ */
+void CompiledGraph::applyBypassRequests() {
+    bypassRequestsSeen_ = bypassRequests_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < bypass_.size(); ++i) {
+        Bypass& bypass = bypass_[i];
+        const bool requested = bypassRequested_[i].load(std::memory_order_relaxed);
+        if (requested && bypass.mode == Bypass::Mode::Active) {
+            bypass.mode = Bypass::Mode::FadingOut;
+            bypass.fadePosition = 0;
+        } else if (requested && bypass.mode == Bypass::Mode::FadingIn) {
+            bypass.mode = Bypass::Mode::FadingOut;
+            bypass.fadePosition = crossfadeSamples_ - bypass.fadePosition;
+        } else if (!requested && bypass.mode == Bypass::Mode::Bypassed) {
+            primeNode(i);
+            bypass.mode = Bypass::Mode::FadingIn;
+            bypass.fadePosition = 0;
+            scheduleDirty_.store(true, std::memory_order_relaxed);
+        } else if (!requested && bypass.mode == Bypass::Mode::FadingOut) {
+            bypass.mode = Bypass::Mode::FadingIn;
+            bypass.fadePosition = crossfadeSamples_ - bypass.fadePosition;
+        }
+    }
+}
+
+/**
+ * Ordonnancement : une étape contournée qui n'a ni entrée à mixer, ni retard, ni historique
+ * d'amorçage à tenir ne fait plus rien et disparaît de la boucle séquentielle comme des vagues.
+ */
+void CompiledGraph::rebuildSchedule() {
+    scheduleDirty_.store(false, std::memory_order_relaxed);
+    scheduleSize_ = 0;
+    numScheduledWaves_ = 0;
+    size_t wave = 0;
+    bool waveOpened = false; // Vague courante de waves_ déjà ouverte dans scheduledWaves_
+    for (size_t i = 0; i < steps_.size(); ++i) {
+        if (!waves_.empty() && i == waves_[wave].firstStep + waves_[wave].numSteps) {
+            ++wave;
+            waveOpened = false;
+        }
+        const Step& step = steps_[i];
+        if (step.node != nullptr) {
+            const Bypass& bypass = bypass_[step.nodeIndex];
+            const bool passThrough = step.numInputs == 1 && stepInputs_[step.firstInput] == step.output &&
+                                     stepInputDelays_[step.firstInput] == nullptr;
+            if (bypass.mode == Bypass::Mode::Bypassed && passThrough && !bypass.dryDelay &&
+                bypass.history.empty()) {
+                continue;
+            }
+        }
+        if (!waves_.empty()) {
+            if (!waveOpened) scheduledWaves_[numScheduledWaves_++] = {static_cast<uint32_t>(scheduleSize_), 0};
+            waveOpened = true;
+            ++scheduledWaves_[numScheduledWaves_ - 1].numSteps;
+        }
+        schedule_[scheduleSize_++] = static_cast<uint32_t>(i);
+    }
+}
+
+bool CompiledGraph::setBypass(const std::string& id, bool bypass) {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodeIds_[i] != id) continue;
+        bypassRequested_[i].store(bypass, std::memory_order_relaxed);
+        bypassRequests_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+void CompiledGraph::restoreBypass(size_t index, bool bypass) {
+    bypassRequested_[index].store(bypass);
+    bypass_[index].mode = bypass ? Bypass::Mode::Bypassed : Bypass::Mode::Active;
+    rebuildSchedule();
+}
+
+int CompiledGraph::nodeIndexOf(const AudioProcessor* node) const {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodes_[i].get() == node) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+/**
+ * Étape chronométrée : alimente le modèle de coût (moyenne glissante du coût par
+ * échantillon). Chaque étape n'est exécutée que par un seul thread par vague, et la
+ * barrière de fin publie la mesure vers le thread audio.
+ */
+void CompiledGraph::runTimedStep(size_t index, float* io, size_t numSamples) {
+    const auto start = std::chrono::steady_clock::now();
+    runStep(index, io, numSamples);
+    const auto end = std::chrono::steady_clock::now();
+    const float perSample = std::chrono::duration<float, std::nano>(end - start).count() /
+                            static_cast<float>(numSamples);
+    float& cost = stepCostNs_[index];
+    cost = (cost == 0.0f) ? perSample : cost + kCostSmoothing * (perSample - cost);
+}
+
+namespace {
+
+struct WaveJob {
+    CompiledGraph* graph;
+    float* io;
+    size_t numSamples;
+    const uint32_t* steps; // Étapes de la vague dans schedule_
+};
+
+} // namespace
+
+void CompiledGraph::runWaveTask(void* context, size_t index) {
+    const WaveJob* job = static_cast<const WaveJob*>(context);
+    job->graph->runTimedStep(job->steps[index], job->io, job->numSamples);
+}
+
+/**
+ * Modèle de coût : une vague n'est distribuée que si le temps gagné (travail total moins
+ * la plus longue étape, ou moins la part idéale par thread) dépasse le coût mesuré d'une
+ * distribution. Sinon (et tant que les coûts ne sont pas encore mesurés) elle reste
+ * séquentielle sur le thread audio.
+ */
+void CompiledGraph::runWaves(float* io, size_t numSamples) {
+    const float threads = static_cast<float>(workers_->numWorkers() + 1);
+    for (size_t w = 0; w < numScheduledWaves_; ++w) {
+        const Wave& wave = scheduledWaves_[w];
+        const uint32_t* steps = schedule_.data() + wave.firstStep;
+        if (wave.numSteps == 1) {
+            runStep(steps[0], io, numSamples);
+            continue;
+        }
+
+        float total = 0.0f;
+        float longest = 0.0f;
+        for (uint32_t k = 0; k < wave.numSteps; ++k) {
+            const float cost = stepCostNs_[steps[k]] * static_cast<float>(numSamples);
+            total += cost;
+            longest = std::max(longest, cost);
+        }
+        const float saving = total - std::max(longest, total / threads);
+        if (saving > workers_->dispatchOverheadNs()) {
+            WaveJob job = {this, io, numSamples, steps};
+            workers_->run(&CompiledGraph::runWaveTask, &job, wave.numSteps);
+        } else {
+            for (uint32_t k = 0; k < wave.numSteps; ++k) {
+                runTimedStep(steps[k], io, numSamples);
+            }
+        }
+    }
+}
+
+AudioProcessor* CompiledGraph::findNode(std::string_view id) const {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodeIds_[i] == id) return nodes_[i].get();
+    }
+    return nullptr;
+}
+
+NodeParameters* CompiledGraph::findParameters(std::string_view id) const {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodeIds_[i] == id) return params_[i].get();
+    }
+    return nullptr;
+}
+
+AudioProcessor* CompiledGraph::findNodeByType(const std::string& type) const {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (nodeTypes_[i] == type) return nodes_[i].get();
+    }
+    return nullptr;
+}
+
+} // namespace rvc
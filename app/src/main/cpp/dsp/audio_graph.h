@@ -0,0 +1,202 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/delay_line.h"
+#include "dsp/node_parameters.h"
+#include "dsp/node_registry.h"
+#include "dsp/worker_pool.h"
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Description d'un graphe d'effets : nœuds (identifiant + type du registre) et arêtes.
+ * Les identifiants réservés "input" et "output" désignent le bloc audio de l'appelant.
+ * Un nœud à plusieurs entrées reçoit leur somme.
+ */
+struct GraphDescription {
+    static constexpr const char* kInput = "input";
+    static constexpr const char* kOutput = "output";
+
+    struct Node {
+        std::string id;
+        std::string type;
+    };
+
+    struct Edge {
+        std::string from;
+        std::string to;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+
+    // Raccourci : input -> nodes[0] -> ... -> nodes[n-1] -> output.
+    static GraphDescription chain(const std::vector<Node>& nodes);
+};
+
+/**
+ * Graphe compilé en un ordonnancement plat (ordre topologique) exécuté sans allocation.
+ *
+ * Les buffers sont attribués par analyse de durée de vie : un nœud traite en place le
+ * buffer de son entrée lorsqu'il en est le dernier consommateur, sinon il reçoit un buffer
+ * de travail libéré par un nœud précédent. Le buffer 0 est celui de l'appelant ; une
+ * chaîne linéaire n'utilise donc aucun buffer de travail.
+ *
+ * Avec des branches indépendantes, les nœuds sont regroupés en vagues (niveaux du DAG) ;
+ * si un WorkerPool est attaché (contexte ou attachWorkers), les nœuds d'une vague sont
+ * distribués aux workers lorsque le modèle de coût l'estime rentable. Les buffers sont alors attribués de sorte
+ * qu'aucun nœud d'une vague n'écrive un buffer lu ou écrit par un autre nœud de la même vague.
+ *
+ * Les latences déclarées par les nœuds (latencySamples) sont cumulées le long des chemins :
+ * à chaque point de mixage, les entrées en avance sont retardées pour s'aligner sur la plus
+ * en retard. La latence totale est celle du chemin le plus long jusqu'à la sortie.
+ *
+ * Chaque nœud peut être contourné (bypass) : fondu enchaîné à puissance constante vers le
+ * signal sec (retardé de la latence du nœud). Tant qu'il est contourné, les primingSamples
+ * dernières entrées sèches sont gardées dans un historique circulaire ; un nœud sans
+ * amorçage sort de l'ordonnancement (séquentiel et par vagues) s'il n'a plus rien à faire.
+ * À la réactivation, le nœud est amorcé avec cet historique, du plus ancien au plus récent :
+ * ses filtres et enveloppes repartent de l'audio qui précède immédiatement le fondu d'entrée.
+ *
+ * Chaque buffer porte un drapeau "bloc silencieux" (crête sous -120 dBFS). Une étape dont
+ * toutes les entrées sont silencieuses depuis plus que ses retards de compensation et la
+ * traîne de son nœud (tailSamples) n'est pas exécutée : sa sortie est mise à zéro et reste
+ * silencieuse. Reprendre après une telle coupure revient à retirer le silence du flux : les
+ * retards et l'état du nœud contiennent déjà du silence, l'alignement est conservé.
+ */
+class CompiledGraph {
+public:
+    // nullptr (et message dans error) si la description est invalide : identifiant inconnu
+    // ou dupliqué, type absent du registre, cycle, nœud sans entrée, sortie non reliée.
+    static std::unique_ptr<CompiledGraph> compile(const GraphDescription& description,
+                                                  const NodeContext& context,
+                                                  std::string* error = nullptr);
+
+    // Les blocs plus grands que context.maxBlockSize sont traités par tranches.
+    void process(float* buffer, size_t numSamples);
+
+    // Nœud par identifiant (ou premier nœud d'un type donné) ; nullptr si absent. Sans
+    // allocation, y compris depuis une chaîne C (preset projeté).
+    AudioProcessor* findNode(std::string_view id) const;
+    AudioProcessor* findNodeByType(const std::string& type) const;
+
+    // Bloc de paramètres d'un nœud ; nullptr si absent ou sans paramètre.
+    NodeParameters* findParameters(std::string_view id) const;
+
+    size_t numNodes() const { return nodes_.size(); }
+    const std::string& nodeId(size_t index) const { return nodeIds_[index]; }
+    const std::string& nodeType(size_t index) const { return nodeTypes_[index]; }
+    NodeParameters* parameters(size_t index) const { return params_[index].get(); }
+    size_t numScratchBuffers() const { return numScratch_; }
+    // Nombre de vagues de plus d'un nœud (0 : exécution toujours séquentielle).
+    size_t numParallelWaves() const { return numParallelWaves_; }
+    // Workers pour les vagues (ignoré sans vague parallèle ou sans worker), avant que le
+    // graphe soit visible du thread audio.
+    void attachWorkers(WorkerPool* workers);
+    // Latence entrée -> sortie (échantillons) et nombre de retards de compensation insérés.
+    size_t latencySamples() const { return latencySamples_; }
+    size_t numCompensationDelays() const { return delays_.size(); }
+    // Thread audio : vrai si le dernier bloc produit était silencieux.
+    bool isOutputSilent() const { return bufferSilent_[0] != 0; }
+
+    // Contournement d'un nœud (thread UI), pris en compte au bloc suivant ; faux si inconnu.
+    bool setBypass(const std::string& id, bool bypass);
+    bool isBypassRequested(size_t index) const { return bypassRequested_[index].load(); }
+    // Reprise de l'état d'un graphe précédent (sans fondu), avant que le graphe soit visible.
+    void restoreBypass(size_t index, bool bypass);
+    // Thread audio : vrai une fois le fondu de sortie terminé (le nœud n'est plus exécuté).
+    bool isBypassed(size_t index) const { return bypass_[index].mode == Bypass::Mode::Bypassed; }
+    int nodeIndexOf(const AudioProcessor* node) const; // -1 si absent
+
+private:
+    CompiledGraph() = default;
+
+    struct Step {
+        AudioProcessor* node; // nullptr pour l'étape finale de recopie vers la sortie
+        NodeParameters* params;
+        uint32_t nodeIndex;
+        uint32_t firstInput;  // Index dans stepInputs_
+        uint32_t numInputs;
+        uint32_t output;      // Buffer de sortie (0 = buffer de l'appelant)
+    };
+
+    // État de contournement d'un nœud (thread audio).
+    struct Bypass {
+        enum class Mode : uint8_t { Active, FadingOut, Bypassed, FadingIn };
+        Mode mode = Mode::Active;
+        size_t fadePosition = 0;
+        std::unique_ptr<DelayLine> dryDelay; // Chemin sec aligné sur la latence du nœud
+        std::vector<float> history;          // Dernières entrées contournées (circulaire), pour l'amorçage
+        size_t historyWrite = 0;             // Prochaine écriture (plus ancien échantillon une fois plein)
+        size_t historyFill = 0;
+    };
+
+    // Vague : étapes consécutives de steps_ (ou de schedule_) sans dépendance entre elles.
+    struct Wave {
+        uint32_t firstStep;
+        uint32_t numSteps;
+    };
+
+    void runSteps(float* io, size_t numSamples);
+    void runWaves(float* io, size_t numSamples);
+    void runStep(size_t index, float* io, size_t numSamples);
+    bool skipSilentStep(size_t index, const Step& step, float* out, size_t numSamples);
+    void runNode(const Step& step, float* buffer, size_t numSamples);
+    size_t runBypassMode(const Step& step, Bypass& bypass, float* buffer, size_t numSamples);
+    size_t runCrossfade(const Step& step, Bypass& bypass, float* buffer, size_t numSamples);
+    void applyBypassRequests();
+    void primeNode(size_t index);
+    void rebuildSchedule();
+    void recordHistory(Bypass& bypass, const float* in, size_t numSamples);
+    void runTimedStep(size_t index, float* io, size_t numSamples);
+    static void runWaveTask(void* context, size_t index);
+    float* bufferAt(float* io, uint32_t index) {
+        return index == 0 ? io : scratch_.data() + (index - 1) * maxBlockSize_;
+    }
+
+    std::vector<std::unique_ptr<AudioProcessor>> nodes_;
+    std::vector<std::unique_ptr<NodeParameters>> params_;
+    std::vector<std::string> nodeIds_;
+    std::vector<std::string> nodeTypes_;
+    std::vector<Step> steps_;
+    std::vector<uint32_t> stepInputs_; // Buffers d'entrée ; le premier est la sortie si elle y figure
+    std::vector<DelayLine*> stepInputDelays_; // Retard de compensation de chaque entrée (nullptr : aucun)
+    std::vector<std::unique_ptr<DelayLine>> delays_;
+    size_t latencySamples_ = 0;
+
+    // Contournement : demandes publiées par le thread UI (compteur de génération + drapeaux),
+    // état et ordonnancement (étapes contournées sans effet retirées) côté audio.
+    std::unique_ptr<std::atomic<bool>[]> bypassRequested_;
+    std::atomic<uint32_t> bypassRequests_{0};
+    uint32_t bypassRequestsSeen_ = 0;
+    std::vector<Bypass> bypass_;
+    std::vector<uint32_t> schedule_;
+    size_t scheduleSize_ = 0;
+    std::atomic<bool> scheduleDirty_{false}; // Fin de fondu (éventuellement sur un worker)
+    size_t crossfadeSamples_ = 1;
+    // Silence : drapeau du bloc en cours par buffer (uint8_t : écrit par des workers
+    // différents dans une vague), durée de silence continu en entrée de chaque étape.
+    std::vector<uint8_t> bufferSilent_;
+    std::vector<size_t> stepSilentRun_;
+    std::vector<size_t> stepInputDelay_; // Plus grand retard de compensation des entrées
+    std::vector<float> scratch_;       // numScratch_ buffers de maxBlockSize_ échantillons
+    size_t numScratch_ = 0;
+    size_t maxBlockSize_ = 0;
+
+    // Exécution parallèle (workers_ == nullptr : séquentielle)
+    WorkerPool* workers_ = nullptr;
+    std::vector<Wave> waves_;
+    std::vector<Wave> scheduledWaves_; // Vagues de schedule_ (vagues vides retirées)
+    size_t numScheduledWaves_ = 0;
+    std::vector<float> stepCostNs_; // Coût moyen mesuré par échantillon de chaque étape
+    size_t numParallelWaves_ = 0;
+};
+
+} // namespace rvc
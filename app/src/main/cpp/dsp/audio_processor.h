@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace rvc {
+
+/**
+ * Description d'un paramètre réglable d'un nœud (publié depuis l'UI, voir NodeParameters).
+ */
+struct ParameterInfo {
+    const char* name;
+    float minValue;
+    float maxValue;
+    float defaultValue;
+    float smoothingMs; // 0 = appliqué immédiatement (seuils, paramètres déjà lissés par le nœud)
+};
+
+// Interface de base pour tous les processeurs d'effets
+class AudioProcessor {
+public:
+    virtual ~AudioProcessor() = default;
+    virtual void process(float* buffer, size_t numSamples) = 0;
+
+    // Paramètres exposés au graphe ; les valeurs par défaut correspondent à l'état initial du nœud.
+    virtual size_t numParameters() const { return 0; }
+    virtual const ParameterInfo* parameterInfo() const { return nullptr; }
+
+    // Appelé dans le thread audio, entre deux appels à process(), avec numParameters() valeurs bornées.
+    virtual void setParameters(const float* /*values*/) {}
+
+    // État partagé avec d'autres nœuds hors des arêtes du graphe (ex. analyse STFT) : les
+    // nœuds qui renvoient le même pointeur ne sont jamais exécutés en parallèle.
+    virtual const void* sharedState() const { return nullptr; }
+
+    // Retard introduit par le nœud (anticipation, trame STFT...), en échantillons. Lu à la
+    // compilation du graphe, qui aligne les branches parallèles : constant pour un nœud donné.
+    virtual size_t latencySamples() const { return 0; }
+
+    // Historique d'entrée (échantillons) rejoué au nœud quand on réactive un nœud contourné,
+    // pour que ses filtres et enveloppes repartent d'un état cohérent. 0 : nœud sans état.
+    virtual size_t primingSamples() const { return 0; }
+
+    // Traîne (échantillons) : entrée silencieuse depuis au moins cette durée, la sortie est
+    // silencieuse et l'état du nœud au repos (latence comprise). Le graphe saute alors le nœud
+    // tant que le silence dure. kUnboundedTail : jamais sauté (générateurs, PLC, nœuds qui ne
+    // la déclarent pas). Peut dépendre des paramètres : relue à chaque bloc, thread audio.
+    static constexpr size_t kUnboundedTail = static_cast<size_t>(-1);
+    virtual size_t tailSamples() const { return kUnboundedTail; }
+};
+
+} // namespace rvc
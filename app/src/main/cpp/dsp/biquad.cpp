@@ -0,0 +1,79 @@
+#include "dsp/biquad.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+BiquadCoefficients designBiquad(BiquadType type, int sampleRate, float frequencyHz, float gainDb, float q) {
+    const float nyquist = 0.5f * static_cast<float>(sampleRate);
+    const float freq = std::clamp(frequencyHz, 10.0f, nyquist * 0.95f);
+    q = std::max(q, 0.05f);
+    const float w0 = 2.0f * static_cast<float>(M_PI) * freq / static_cast<float>(sampleRate);
+    const float cosW = std::cos(w0);
+    const float alpha = std::sin(w0) / (2.0f * q);
+    const float A = std::pow(10.0f, gainDb / 40.0f);
+    const float sqrtA2Alpha = 2.0f * std::sqrt(A) * alpha;
+
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
+    switch (type) {
+        case BiquadType::Peaking:
+            b0 = 1.0f + alpha * A;
+            b1 = -2.0f * cosW;
+            b2 = 1.0f - alpha * A;
+            a0 = 1.0f + alpha / A;
+            a1 = -2.0f * cosW;
+            a2 = 1.0f - alpha / A;
+            break;
+        case BiquadType::LowShelf:
+            b0 = A * ((A + 1.0f) - (A - 1.0f) * cosW + sqrtA2Alpha);
+            b1 = 2.0f * A * ((A - 1.0f) - (A + 1.0f) * cosW);
+            b2 = A * ((A + 1.0f) - (A - 1.0f) * cosW - sqrtA2Alpha);
+            a0 = (A + 1.0f) + (A - 1.0f) * cosW + sqrtA2Alpha;
+            a1 = -2.0f * ((A - 1.0f) + (A + 1.0f) * cosW);
+            a2 = (A + 1.0f) + (A - 1.0f) * cosW - sqrtA2Alpha;
+            break;
+        case BiquadType::HighShelf:
+            b0 = A * ((A + 1.0f) + (A - 1.0f) * cosW + sqrtA2Alpha);
+            b1 = -2.0f * A * ((A - 1.0f) + (A + 1.0f) * cosW);
+            b2 = A * ((A + 1.0f) + (A - 1.0f) * cosW - sqrtA2Alpha);
+            a0 = (A + 1.0f) - (A - 1.0f) * cosW + sqrtA2Alpha;
+            a1 = 2.0f * ((A - 1.0f) - (A + 1.0f) * cosW);
+            a2 = (A + 1.0f) - (A - 1.0f) * cosW - sqrtA2Alpha;
+            break;
+        case BiquadType::LowPass:
+            b0 = 0.5f * (1.0f - cosW);
+            b1 = 1.0f - cosW;
+            b2 = 0.5f * (1.0f - cosW);
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosW;
+            a2 = 1.0f - alpha;
+            break;
+        case BiquadType::HighPass:
+            b0 = 0.5f * (1.0f + cosW);
+            b1 = -(1.0f + cosW);
+            b2 = 0.5f * (1.0f + cosW);
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosW;
+            a2 = 1.0f - alpha;
+            break;
+        case BiquadType::Notch:
+            b0 = 1.0f;
+            b1 = -2.0f * cosW;
+            b2 = 1.0f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosW;
+            a2 = 1.0f - alpha;
+            break;
+    }
+
+    const float inv = 1.0f / a0;
+    BiquadCoefficients c;
+    c.b0 = b0 * inv;
+    c.b1 = b1 * inv;
+    c.b2 = b2 * inv;
+    c.a1 = a1 * inv;
+    c.a2 = a2 * inv;
+    return c;
+}
+
+} // namespace rvc
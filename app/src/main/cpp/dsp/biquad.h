@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace rvc {
+
+enum class BiquadType {
+    Peaking,
+    LowShelf,
+    HighShelf,
+    LowPass,
+    HighPass,
+    Notch
+};
+
+// Coefficients normalisés (a0 = 1).
+struct BiquadCoefficients {
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+};
+
+/**
+ * Formules du "Audio EQ Cookbook" (R. Bristow-Johnson). La fréquence est bornée à
+ * [10 Hz, 0.95 * Nyquist] et le Q à 0.05 minimum.
+ */
+BiquadCoefficients designBiquad(BiquadType type, int sampleRate, float frequencyHz, float gainDb, float q);
+
+/**
+ * Biquad scalaire en forme directe transposée II, pour les filtres isolés des nœuds
+ * (la cascade vectorisée de l'égaliseur utilise sa propre disposition SIMD).
+ */
+struct Biquad {
+    BiquadCoefficients c;
+    float z1 = 0.0f;
+    float z2 = 0.0f;
+
+    inline float process(float x) {
+        const float y = c.b0 * x + z1;
+        z1 = c.b1 * x - c.a1 * y + z2;
+        z2 = c.b2 * x - c.a2 * y;
+        return y;
+    }
+
+    void reset() { z1 = z2 = 0.0f; }
+};
+
+} // namespace rvc
@@ -0,0 +1,47 @@
+#include "dsp/builtin_nodes.h"
+#include "dsp/elementwise.h"
+#include "dsp/spectral_analyzer.h"
+
+// --- Définitions des Stubs d'Effets Simples ---
+
+namespace rvc {
+
+/**
+ * Simule l'Annulation d'Écho Acoustique (AEC).
+ */
+void AcousticEchoCanceller::process(float* buffer, size_t numSamples) {
+    // V15.0: Logique d'AEC ici. Soustrait le signal de sortie du casque du signal d'entrée.
+    // L'implémentation réelle nécessiterait un buffer de référence du signal de sortie.
+    // Le Noise Gate est désormais un nœud dédié (NoiseGate), appliqué juste après l'AEC.
+}
+
+/**
+ * Simule la Suppression de Bruit Neuronale (DNS) ou un filtre spectral avancé.
+ */
+void NoiseSuppressor::process(float* buffer, size_t numSamples) {
+    // V9.0: Modèle TFLite ultra-léger pour la DNS s'exécutant ici.
+    // Ceci serait implémenté comme un petit moteur d'inférence distinct.
+    // Pour l'instant, simule un filtre passe-bas très simple pour le lissage.
+    for (size_t i = 1; i < numSamples; ++i) {
+        buffer[i] = buffer[i] * 0.95f + buffer[i-1] * 0.05f;
+    }
+}
+
+/**
+ * Simule le Compresseur Multibandes et le Limiteur de Crête.
+ */
+void MultibandCompressor::process(float* buffer, size_t numSamples) {
+    // V1.0: Applique un Limiteur de Crête pour éviter le clipping dans le casque.
+    fused::Clamp limiter(0.99f);
+    fused::run(buffer, numSamples, limiter);
+}
+
+void SpectralAnalysisNode::process(float* buffer, size_t numSamples) {
+    analyzer_.analyze(buffer, numSamples);
+}
+
+size_t SpectralAnalysisNode::tailSamples() const {
+    return analyzer_.fftSize();
+}
+
+} // namespace rvc
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include <stddef.h>
+
+namespace rvc {
+
+class SpectralAnalyzer;
+
+// Déclarations des effets (Stubs)
+class AcousticEchoCanceller : public AudioProcessor {
+public:
+    void process(float* buffer, size_t numSamples) override;
+    size_t tailSamples() const override { return 0; }
+};
+
+class NoiseSuppressor : public AudioProcessor {
+public:
+    void process(float* buffer, size_t numSamples) override;
+    size_t tailSamples() const override { return 0; }
+};
+
+class MultibandCompressor : public AudioProcessor {
+public:
+    void process(float* buffer, size_t numSamples) override;
+    size_t tailSamples() const override { return 0; }
+};
+
+/**
+ * Nœud transparent qui alimente l'analyse STFT partagée avec son entrée.
+ * Les nœuds spectraux (dé-esseur, correction harmonique) doivent être placés en aval.
+ */
+class SpectralAnalysisNode : public AudioProcessor {
+public:
+    explicit SpectralAnalysisNode(SpectralAnalyzer& analyzer) : analyzer_(analyzer) {}
+    void process(float* buffer, size_t numSamples) override;
+    const void* sharedState() const override { return &analyzer_; }
+    // La fenêtre d'analyse entière doit être silencieuse avant de cesser de l'alimenter.
+    size_t tailSamples() const override;
+
+private:
+    SpectralAnalyzer& analyzer_;
+};
+
+} // namespace rvc
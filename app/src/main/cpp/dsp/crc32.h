@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rvc {
+
+namespace detail {
+
+// CRC-32 IEEE (polynôme réfléchi 0xEDB88320), table calculée à la compilation.
+constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table = {};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1u) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+inline constexpr std::array<uint32_t, 256> kCrcTable = makeCrcTable();
+
+} // namespace detail
+
+/**
+ * CRC-32 IEEE, identique à java.util.zip.CRC32 (sommes de contrôle des fichiers binaires
+ * écrits côté application ou par les outils hôtes).
+ */
+inline uint32_t crc32(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = detail::kCrcTable[(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+} // namespace rvc
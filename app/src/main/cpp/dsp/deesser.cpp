@@ -0,0 +1,114 @@
+#include "dsp/deesser.h"
+#include "dsp/spectral_analyzer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+constexpr float kBodyLowHz = 200.0f;
+constexpr float kBodyHighHz = 4000.0f;
+// Puissance par échantillon minimale (≈ -70 dBFS) pour déclencher : ignore le souffle.
+constexpr float kMinPowerPerSample = 1e-7f;
+
+float timeCoef(float ms, int sampleRate) {
+    return std::exp(-1.0f / std::max(1.0f, ms * 0.001f * static_cast<float>(sampleRate)));
+}
+
+constexpr ParameterInfo kParameters[] = {
+    {"threshold_db", -30.0f, 0.0f, -6.0f, 0.0f},
+    {"ratio", 1.0f, 20.0f, 4.0f, 0.0f},
+    {"max_reduction_db", 0.0f, 24.0f, 12.0f, 0.0f},
+    {"split_hz", 2000.0f, 8000.0f, 4500.0f, 0.0f},
+};
+
+} // namespace
+
+DeEsser::DeEsser(int sampleRate, const SpectralAnalyzer& analyzer)
+    : sampleRate_(sampleRate), analyzer_(analyzer), lastFrame_(analyzer.frameCount()) {
+    updateCoefficients();
+}
+
+void DeEsser::setSettings(const Settings& settings) {
+    settings_ = settings;
+    updateCoefficients();
+}
+
+size_t DeEsser::numParameters() const {
+    return sizeof(kParameters) / sizeof(kParameters[0]);
+}
+
+const ParameterInfo* DeEsser::parameterInfo() const {
+    return kParameters;
+}
+
+void DeEsser::setParameters(const float* values) {
+    Settings settings = settings_;
+    settings.thresholdDb = values[0];
+    settings.ratio = values[1];
+    settings.maxReductionDb = values[2];
+    settings.splitHz = values[3];
+    setSettings(settings);
+}
+
+// Trame d'analyse, puis relâchement de la réduction et séparation de bandes au repos.
+size_t DeEsser::tailSamples() const {
+    return analyzer_.fftSize() +
+           static_cast<size_t>((settings_.releaseMs + 50.0f) * 0.001f * static_cast<float>(sampleRate_));
+}
+
+void DeEsser::updateCoefficients() {
+    const float nyquist = 0.5f * static_cast<float>(sampleRate_);
+    isEnabled_ = settings_.sibilantLowHz < nyquist * 0.9f;
+    split_.c = designBiquad(BiquadType::LowPass, sampleRate_, settings_.splitHz, 0.0f, 0.707f);
+    attackCoef_ = timeCoef(settings_.attackMs, sampleRate_);
+    releaseCoef_ = timeCoef(settings_.releaseMs, sampleRate_);
+}
+
+void DeEsser::updateDetector(const SpectralAnalyzer& analyzer) {
+    if (!isEnabled_) {
+        targetGain_ = 1.0f;
+        reductionDb_ = 0.0f;
+        return;
+    }
+
+    const float nyquist = 0.5f * static_cast<float>(sampleRate_);
+    const float sibilant = analyzer.bandEnergy(settings_.sibilantLowHz, std::min(settings_.sibilantHighHz, nyquist));
+    const float body = analyzer.bandEnergy(kBodyLowHz, kBodyHighHz);
+    // Parseval : énergie spectrale de la trame ≈ N² × puissance par échantillon (au facteur de fenêtre près).
+    const float floor = kMinPowerPerSample * static_cast<float>(analyzer.fftSize() * analyzer.fftSize());
+
+    float reduction = 0.0f;
+    if (sibilant > floor) {
+        const float ratioDb = 10.0f * std::log10((sibilant + 1e-12f) / (body + 1e-12f));
+        const float excess = ratioDb - settings_.thresholdDb;
+        if (excess > 0.0f) {
+            reduction = std::min(settings_.maxReductionDb, excess * (1.0f - 1.0f / std::max(settings_.ratio, 1.0f)));
+        }
+    }
+    reductionDb_ = reduction;
+    targetGain_ = std::pow(10.0f, -reduction / 20.0f);
+}
+
+void DeEsser::process(float* buffer, size_t numSamples) {
+    if (analyzer_.frameCount() != lastFrame_) {
+        lastFrame_ = analyzer_.frameCount();
+        updateDetector(analyzer_);
+    }
+    if (!isEnabled_) return;
+
+    float gain = gain_;
+    const float target = targetGain_;
+    for (size_t i = 0; i < numSamples; ++i) {
+        // Bande haute complémentaire : y = bas + g * haut = x - (1 - g) * haut.
+        const float x = buffer[i];
+        const float high = x - split_.process(x);
+        const float coef = (target < gain) ? attackCoef_ : releaseCoef_;
+        gain = target + (gain - target) * coef;
+        buffer[i] = x - (1.0f - gain) * high;
+    }
+    gain_ = gain;
+}
+
+} // namespace rvc
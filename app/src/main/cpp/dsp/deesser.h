@@ -0,0 +1,65 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/biquad.h"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rvc {
+
+class SpectralAnalyzer;
+
+/**
+ * Dé-esseur dynamique à deux bandes pour la voix convertie.
+ * La détection (rapport d'énergie sibilantes / corps de la voix) est lue sur l'analyse
+ * STFT partagée ; seule la bande haute (séparation complémentaire, reconstruction exacte
+ * sans réduction) est atténuée.
+ */
+class DeEsser : public AudioProcessor {
+public:
+    struct Settings {
+        float splitHz = 4500.0f;         // Coupure de séparation des bandes
+        float sibilantLowHz = 5000.0f;   // Bande de détection des sibilantes
+        float sibilantHighHz = 10000.0f;
+        float thresholdDb = -6.0f;       // Rapport sibilantes/corps au-delà duquel on réduit
+        float ratio = 4.0f;
+        float maxReductionDb = 12.0f;
+        float attackMs = 1.0f;
+        float releaseMs = 60.0f;
+    };
+
+    // Le détecteur lit l'analyse partagée à chaque nouvelle trame (nœud "stft_analysis" en amont).
+    DeEsser(int sampleRate, const SpectralAnalyzer& analyzer);
+
+    void setSettings(const Settings& settings);
+
+    void process(float* buffer, size_t numSamples) override;
+
+    // Paramètres publiés par NodeParameters (voir ParameterInfo).
+    size_t numParameters() const override;
+    const ParameterInfo* parameterInfo() const override;
+    void setParameters(const float* values) override;
+    size_t primingSamples() const override { return 512; }
+    size_t tailSamples() const override;
+    const void* sharedState() const override { return &analyzer_; }
+
+    float currentReductionDb() const { return reductionDb_; }
+
+private:
+    void updateCoefficients();
+    void updateDetector(const SpectralAnalyzer& analyzer);
+
+    int sampleRate_;
+    const SpectralAnalyzer& analyzer_;
+    uint64_t lastFrame_;
+    Settings settings_;
+    Biquad split_;
+    float targetGain_ = 1.0f;
+    float gain_ = 1.0f;
+    float attackCoef_ = 0.0f;
+    float releaseCoef_ = 0.0f;
+    float reductionDb_ = 0.0f;
+    bool isEnabled_ = true; // Faux si la bande sibilante dépasse Nyquist (8/16 kHz)
+};
+
+} // namespace rvc
@@ -0,0 +1,69 @@
+#include "dsp/delay_line.h"
+#include "dsp/simd.h"
+#include <algorithm>
+
+namespace rvc {
+
+namespace {
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+DelayLine::DelayLine(size_t delaySamples)
+    : delay_(delaySamples),
+      mask_(nextPowerOfTwo(delaySamples + kChunk) - 1),
+      ring_(mask_ + 1, 0.0f) {}
+
+void DelayLine::push(const float* in, size_t numSamples) {
+    const size_t size = mask_ + 1;
+    for (size_t done = 0; done < numSamples;) {
+        const size_t len = std::min(numSamples - done, size - writePos_);
+        std::copy(in + done, in + done + len, ring_.data() + writePos_);
+        done += len;
+        writePos_ = (writePos_ + len) & mask_;
+    }
+}
+
+void DelayLine::process(const float* in, float* out, size_t numSamples) {
+    run<false>(in, out, numSamples);
+}
+
+void DelayLine::accumulate(const float* in, float* out, size_t numSamples) {
+    run<true>(in, out, numSamples);
+}
+
+/**
+ * Chaque tranche est d'abord écrite dans l'anneau puis relue `delay_` échantillons plus
+ * tôt : avec une taille >= delay_ + kChunk, l'écriture n'écrase jamais ce qui reste à lire.
+ */
+template <bool kAccumulate>
+void DelayLine::run(const float* in, float* out, size_t numSamples) {
+    const size_t size = mask_ + 1;
+    for (size_t offset = 0; offset < numSamples; offset += kChunk) {
+        const size_t n = std::min(kChunk, numSamples - offset);
+
+        const size_t first = std::min(n, size - writePos_);
+        std::copy(in + offset, in + offset + first, ring_.data() + writePos_);
+        std::copy(in + offset + first, in + offset + n, ring_.data());
+
+        size_t readPos = (writePos_ - delay_) & mask_;
+        for (size_t done = 0; done < n;) {
+            const size_t len = std::min(n - done, size - readPos);
+            if (kAccumulate) {
+                simd::accumulate(out + offset + done, ring_.data() + readPos, len);
+            } else {
+                std::copy(ring_.data() + readPos, ring_.data() + readPos + len, out + offset + done);
+            }
+            done += len;
+            readPos = (readPos + len) & mask_;
+        }
+        writePos_ = (writePos_ + n) & mask_;
+    }
+}
+
+} // namespace rvc
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Retard entier fixe (compensation de latence entre branches du graphe).
+ * Traitement par tranches de kChunk : le buffer circulaire (d + kChunk arrondi à une
+ * puissance de deux) ne dépend pas de la taille des blocs, et l'entrée peut être la sortie.
+ */
+class DelayLine {
+public:
+    static constexpr size_t kChunk = 256;
+
+    explicit DelayLine(size_t delaySamples);
+
+    size_t delay() const { return delay_; }
+
+    // Alimente la ligne sans lecture.
+    void push(const float* in, size_t numSamples);
+    // out[i] = in[i - delay] ; in == out autorisé.
+    void process(const float* in, float* out, size_t numSamples);
+    // out[i] += in[i - delay] (mixage d'une entrée retardée, in != out).
+    void accumulate(const float* in, float* out, size_t numSamples);
+
+private:
+    template <bool kAccumulate>
+    void run(const float* in, float* out, size_t numSamples);
+
+    size_t delay_;
+    size_t mask_;
+    size_t writePos_ = 0;
+    std::vector<float> ring_;
+};
+
+} // namespace rvc
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+namespace rvc {
+
+/**
+ * Mise à zéro des nombres dénormalisés (FTZ/DAZ) pour le thread courant (V16.0).
+ *
+ * Pendant un silence, l'état des filtres récursifs (biquads, FDN, enveloppes) décroît vers
+ * des valeurs dénormalisées, traitées en micro-code (jusqu'à 100x plus lentes) sur certains
+ * cœurs : pics de charge CPU précisément quand il n'y a rien à traiter. -ffast-math ne règle
+ * pas le registre de contrôle sur Android (pas de crtfastmath), il faut le faire par thread.
+ *   - ARMv8 : FPCR.FZ (bit 24), qui couvre aussi les entrées dénormalisées.
+ *   - ARMv7 : FPSCR.FZ (bit 24).
+ *   - x86 : MXCSR.FTZ (bit 15) et MXCSR.DAZ (bit 6).
+ */
+class ScopedFlushDenormals {
+public:
+    ScopedFlushDenormals() : saved_(readControl()) { writeControl(saved_ | kFlushBits); }
+    ~ScopedFlushDenormals() { writeControl(saved_); }
+
+    ScopedFlushDenormals(ScopedFlushDenormals const&) = delete;
+    void operator=(ScopedFlushDenormals const&) = delete;
+
+    // Threads propres au moteur (workers) : activé une fois pour toute leur durée de vie.
+    static void enableForCurrentThread() { writeControl(readControl() | kFlushBits); }
+
+private:
+#if defined(__aarch64__)
+    static constexpr uint64_t kFlushBits = 1ull << 24;
+    static uint64_t readControl() {
+        uint64_t value;
+        asm volatile("mrs %0, fpcr" : "=r"(value));
+        return value;
+    }
+    static void writeControl(uint64_t value) { asm volatile("msr fpcr, %0" : : "r"(value)); }
+#elif defined(__arm__) && defined(__ARM_FP)
+    static constexpr uint64_t kFlushBits = 1ull << 24;
+    static uint64_t readControl() {
+        uint32_t value;
+        asm volatile("vmrs %0, fpscr" : "=r"(value));
+        return value;
+    }
+    static void writeControl(uint64_t value) { asm volatile("vmsr fpscr, %0" : : "r"(static_cast<uint32_t>(value))); }
+#elif defined(__x86_64__) || defined(__i386__)
+    static constexpr uint64_t kFlushBits = 0x8040; // FTZ | DAZ
+    static uint64_t readControl() { return _mm_getcsr(); }
+    static void writeControl(uint64_t value) { _mm_setcsr(static_cast<unsigned int>(value)); }
+#else
+    static constexpr uint64_t kFlushBits = 0;
+    static uint64_t readControl() { return 0; }
+    static void writeControl(uint64_t) {}
+#endif
+
+    uint64_t saved_;
+};
+
+} // namespace rvc
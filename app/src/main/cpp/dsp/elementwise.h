@@ -0,0 +1,176 @@
+#pragma once
+
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <stddef.h>
+
+namespace rvc {
+namespace fused {
+
+/**
+ * Étages élémentaires fusionnables à la compilation.
+ *
+ * Une chaîne d'étages (gain, gate, écrêtage, saturation douce, suppression du continu...)
+ * est exécutée par run() en une seule boucle vectorielle : chaque vecteur est chargé une
+ * fois, traverse tous les étages dans les registres, puis est écrit une fois, au lieu d'un
+ * aller-retour mémoire complet par étage.
+ *
+ * Interface d'un étage (voir Stage pour les versions par défaut) :
+ *   void begin();                                   // une fois par appel de run()
+ *   void prepare(const float* in, size_t n);        // avant chaque tranche (lecture de l'entrée)
+ *   simd::float4 apply(simd::float4 x, size_t i);   // échantillons i..i+3 de la tranche
+ *   float apply(float x, size_t i);                 // reste scalaire de la tranche
+ *
+ * Seul le premier étage peut lire l'entrée dans prepare() (kReadsInput) : les suivants ne
+ * voient que la sortie de leur prédécesseur, dans apply(). Le découpage en tranches et en
+ * vecteurs est le même pour runUnfused(), qui exécute les étages un par un : les deux
+ * chemins calculent exactement les mêmes opérations et donnent une sortie identique au bit
+ * près (à condition que l'unité de compilation ne contracte ni ne réassocie les opérations
+ * entre étages, voir CMakeLists.txt).
+ */
+
+// Taille d'une tranche : le bloc d'entrée du premier étage reste dans le cache L1.
+constexpr size_t kChunkSize = 1024;
+
+struct Stage {
+    static constexpr bool kReadsInput = false;
+    void begin() {}
+    void prepare(const float*, size_t) {}
+};
+
+struct Gain : Stage {
+    float gain = 1.0f;
+
+    explicit Gain(float g) : gain(g) {}
+    simd::float4 apply(simd::float4 x, size_t) const { return x * simd::set1(gain); }
+    float apply(float x, size_t) const { return x * gain; }
+};
+
+// Écrêtage dur à ±limit (limiteur de crête).
+struct Clamp : Stage {
+    float limit = 1.0f;
+
+    explicit Clamp(float l) : limit(l) {}
+    simd::float4 apply(simd::float4 x, size_t) const {
+        return simd::min(simd::max(x, simd::set1(-limit)), simd::set1(limit));
+    }
+    float apply(float x, size_t) const { return std::min(std::max(x, -limit), limit); }
+};
+
+/**
+ * Saturation douce cubique : gain unitaire à bas niveau, plafonnée à ±ceiling à partir
+ * de 1.5 × ceiling (pas de division ni de tanh dans la boucle).
+ */
+struct SoftClip : Stage {
+    float ceiling = 1.0f;
+    float inputScale = 2.0f / 3.0f;
+
+    explicit SoftClip(float c) : ceiling(c), inputScale(2.0f / (3.0f * c)) {}
+    simd::float4 apply(simd::float4 x, size_t) const {
+        const simd::float4 u = simd::min(simd::max(x * simd::set1(inputScale), simd::set1(-1.0f)), simd::set1(1.0f));
+        const simd::float4 shape = simd::set1(1.5f) - simd::set1(0.5f) * (u * u);
+        return simd::set1(ceiling) * (u * shape);
+    }
+    float apply(float x, size_t) const {
+        const float u = std::min(std::max(x * inputScale, -1.0f), 1.0f);
+        const float shape = 1.5f - 0.5f * (u * u);
+        return ceiling * (u * shape);
+    }
+};
+
+/**
+ * Suppression de la composante continue : y[n] = x[n] - x[n-1] + R·y[n-1].
+ * La récurrence est déroulée sur les 4 voies (y = Σ d[k]·R^(j-k) + y[-1]·R^(j+1)).
+ */
+struct DCBlock : Stage {
+    DCBlock(int sampleRate, float cutoffHz = 20.0f) {
+        r = std::exp(-2.0f * static_cast<float>(M_PI) * cutoffHz / static_cast<float>(sampleRate));
+        const float r2 = r * r;
+        const float r3 = r2 * r;
+        c0 = simd::set(1.0f, r, r2, r3);
+        c1 = simd::set(0.0f, 1.0f, r, r2);
+        c2 = simd::set(0.0f, 0.0f, 1.0f, r);
+        c3 = simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+        cy = simd::set(r, r2, r3, r2 * r2);
+    }
+
+    simd::float4 apply(simd::float4 x, size_t) {
+        const simd::float4 d = x - simd::shiftIn(simd::set1(prevIn), x);
+        simd::float4 y = simd::set1(prevOut) * cy;
+        y = simd::madd(simd::broadcast<3>(d), c3, y);
+        y = simd::madd(simd::broadcast<2>(d), c2, y);
+        y = simd::madd(simd::broadcast<1>(d), c1, y);
+        y = simd::madd(simd::broadcast<0>(d), c0, y);
+        prevIn = simd::lastLane(x);
+        prevOut = simd::lastLane(y);
+        return y;
+    }
+    float apply(float x, size_t) {
+        const float y = (x - prevIn) + r * prevOut;
+        prevIn = x;
+        prevOut = y;
+        return y;
+    }
+
+    float r = 0.0f;
+    simd::float4 c0, c1, c2, c3, cy;
+    float prevIn = 0.0f;
+    float prevOut = 0.0f;
+};
+
+namespace detail {
+
+template <typename First, typename... Rest>
+constexpr bool onlyFirstReadsInput() {
+    return (!Rest::kReadsInput && ...);
+}
+
+} // namespace detail
+
+/**
+ * Boucle d'une tranche déjà préparée : chaque vecteur traverse tous les étages.
+ */
+template <typename... Stages>
+inline void applyChunk(float* x, size_t n, Stages&... stages) {
+    size_t i = 0;
+    for (; i + simd::kWidth <= n; i += simd::kWidth) {
+        simd::float4 v = simd::load(x + i);
+        ((v = stages.apply(v, i)), ...);
+        simd::store(x + i, v);
+    }
+    for (; i < n; ++i) {
+        float v = x[i];
+        ((v = stages.apply(v, i)), ...);
+        x[i] = v;
+    }
+}
+
+/**
+ * Chaîne fusionnée : une lecture et une écriture du buffer, quel que soit le nombre d'étages.
+ */
+template <typename... Stages>
+inline void run(float* buffer, size_t numSamples, Stages&... stages) {
+    static_assert(sizeof...(Stages) > 0, "chaîne vide");
+    static_assert(detail::onlyFirstReadsInput<Stages...>(), "seul le premier étage peut lire l'entrée");
+    if (numSamples == 0) return;
+
+    (stages.begin(), ...);
+    for (size_t offset = 0; offset < numSamples; offset += kChunkSize) {
+        const size_t n = std::min(kChunkSize, numSamples - offset);
+        (stages.prepare(buffer + offset, n), ...);
+        applyChunk(buffer + offset, n, stages...);
+    }
+}
+
+/**
+ * Référence non fusionnée : un passage complet sur le buffer par étage. Même résultat que
+ * run(), utilisé pour vérifier la fusion et mesurer le gain en bande passante.
+ */
+template <typename... Stages>
+inline void runUnfused(float* buffer, size_t numSamples, Stages&... stages) {
+    (run(buffer, numSamples, stages), ...);
+}
+
+} // namespace fused
+} // namespace rvc
@@ -0,0 +1,230 @@
+#include "dsp/fdn_reverb.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+// Longueurs de base à 48 kHz (premiers entre eux, 21 à 59 ms) pour une densité d'écho régulière.
+constexpr float kBaseDelays48k[FDNReverb::kLines] = {1031.0f, 1327.0f, 1523.0f, 1871.0f,
+                                                     2053.0f, 2311.0f, 2579.0f, 2819.0f};
+constexpr float kMaxRoomSize = 1.5f;
+constexpr float kMinRoomSize = 0.5f;
+constexpr float kModDepthMs = 0.25f;           // Excursion des retards (évite la coloration métallique)
+constexpr float kDelayGlide = 1.0f / 4096.0f;  // Glissement des retards après un changement de taille
+
+// Signes d'injection et de lecture : décorrèlent les lignes sans coût supplémentaire.
+constexpr float kInputSigns[FDNReverb::kLines] = {1, -1, 1, -1, 1, 1, -1, -1};
+constexpr float kOutputSigns[FDNReverb::kLines] = {1, 1, -1, -1, 1, -1, 1, -1};
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+/**
+ * Hadamard 4x4 dans un vecteur : papillons sur les paires puis sur les moitiés.
+ */
+inline simd::float4 hadamard4(simd::float4 x) {
+    const simd::float4 pairSigns = simd::set(1.0f, -1.0f, 1.0f, -1.0f);
+    const simd::float4 halfSigns = simd::set(1.0f, 1.0f, -1.0f, -1.0f);
+    const simd::float4 u = simd::madd(x, pairSigns, simd::swapPairs(x));
+    return simd::madd(u, halfSigns, simd::swapHalves(u));
+}
+
+// Lissés par le graphe : les coefficients sont recalculés à chaque tranche.
+constexpr ParameterInfo kParameters[] = {
+    {"room_size", kMinRoomSize, kMaxRoomSize, 1.0f, 50.0f},
+    {"decay_s", 0.1f, 10.0f, 1.2f, 50.0f},
+    {"damping_hz", 200.0f, 20000.0f, 6000.0f, 50.0f},
+    {"wet", 0.0f, 1.0f, 0.0f, 30.0f},
+    {"dry", 0.0f, 1.0f, 1.0f, 30.0f},
+};
+
+} // namespace
+
+FDNReverb::FDNReverb(int sampleRate) : sampleRate_(sampleRate) {
+    const float rateScale = static_cast<float>(sampleRate) / 48000.0f;
+    modDepth_ = kModDepthMs * 0.001f * static_cast<float>(sampleRate);
+
+    // Arène dimensionnée pour la plus grande pièce + excursion de modulation.
+    size_t total = 0;
+    for (size_t i = 0; i < kLines; ++i) {
+        const size_t maxDelay = static_cast<size_t>(kBaseDelays48k[i] * rateScale * kMaxRoomSize + modDepth_) + 2;
+        lineMask_[i] = nextPowerOfTwo(maxDelay) - 1;
+        lineOffset_[i] = total;
+        total += lineMask_[i] + 1;
+        writeMask_ = std::max(writeMask_, lineMask_[i]);
+    }
+    arena_.assign(total, 0.0f);
+
+    // LFO en quadrature (rotation de phaseur), fréquences légèrement différentes par ligne.
+    for (size_t i = 0; i < kLines; ++i) {
+        const float hz = 0.3f + 0.11f * static_cast<float>(i);
+        const float w = 2.0f * static_cast<float>(M_PI) * hz / static_cast<float>(sampleRate);
+        const float phase = static_cast<float>(i) * 0.7f;
+        lfoCos_[i] = std::cos(phase);
+        lfoSin_[i] = std::sin(phase);
+        lfoRotCos_[i] = std::cos(w);
+        lfoRotSin_[i] = std::sin(w);
+    }
+
+    updateCoefficients();
+    std::copy(targetDelay_, targetDelay_ + kLines, currentDelay_);
+}
+
+void FDNReverb::setSettings(const Settings& settings) {
+    settings_ = settings;
+    updateCoefficients();
+}
+
+size_t FDNReverb::numParameters() const {
+    return sizeof(kParameters) / sizeof(kParameters[0]);
+}
+
+const ParameterInfo* FDNReverb::parameterInfo() const {
+    return kParameters;
+}
+
+void FDNReverb::setParameters(const float* values) {
+    Settings settings;
+    settings.roomSize = values[0];
+    settings.decaySeconds = values[1];
+    settings.dampingHz = values[2];
+    settings.wet = values[3];
+    settings.dry = values[4];
+    setSettings(settings);
+}
+
+// -120 dB : deux RT60, plus 100 ms pour les plus longues lignes à retard.
+size_t FDNReverb::tailSamples() const {
+    return static_cast<size_t>((2.0f * settings_.decaySeconds + 0.1f) * static_cast<float>(sampleRate_));
+}
+
+void FDNReverb::reset() {
+    std::fill(arena_.begin(), arena_.end(), 0.0f);
+    std::fill(dampState_, dampState_ + kLines, 0.0f);
+}
+
+void FDNReverb::updateCoefficients() {
+    const float rateScale = static_cast<float>(sampleRate_) / 48000.0f;
+    const float room = std::clamp(settings_.roomSize, kMinRoomSize, kMaxRoomSize);
+    const float rt60 = std::max(settings_.decaySeconds, 0.05f);
+
+    for (size_t i = 0; i < kLines; ++i) {
+        targetDelay_[i] = kBaseDelays48k[i] * rateScale * room;
+        // Gain par passage pour -60 dB en rt60 secondes, normalisé par la matrice de Hadamard (1/sqrt(8)).
+        const float seconds = targetDelay_[i] / static_cast<float>(sampleRate_);
+        feedbackGain_[i] = std::pow(10.0f, -3.0f * seconds / rt60) / std::sqrt(static_cast<float>(kLines));
+    }
+
+    const float nyquist = 0.5f * static_cast<float>(sampleRate_);
+    const float cutoff = std::clamp(settings_.dampingHz, 200.0f, nyquist * 0.9f);
+    dampCoef_ = 1.0f - std::exp(-2.0f * static_cast<float>(M_PI) * cutoff / static_cast<float>(sampleRate_));
+}
+
+void FDNReverb::process(float* buffer, size_t numSamples) {
+    if (isBypassed()) return;
+
+    using simd::float4;
+    float* arena = arena_.data();
+
+    const float4 inSignsA = simd::load(kInputSigns);
+    const float4 inSignsB = simd::load(kInputSigns + 4);
+    const float4 outSignsA = simd::load(kOutputSigns);
+    const float4 outSignsB = simd::load(kOutputSigns + 4);
+    const float4 gainA = simd::load(feedbackGain_);
+    const float4 gainB = simd::load(feedbackGain_ + 4);
+    const float4 damp = simd::set1(dampCoef_);
+    const float4 depth = simd::set1(modDepth_);
+    const float4 glide = simd::set1(kDelayGlide);
+    const float4 rotCosA = simd::load(lfoRotCos_), rotCosB = simd::load(lfoRotCos_ + 4);
+    const float4 rotSinA = simd::load(lfoRotSin_), rotSinB = simd::load(lfoRotSin_ + 4);
+    const float4 targetA = simd::load(targetDelay_), targetB = simd::load(targetDelay_ + 4);
+
+    float4 lpA = simd::load(dampState_), lpB = simd::load(dampState_ + 4);
+    float4 cosA = simd::load(lfoCos_), cosB = simd::load(lfoCos_ + 4);
+    float4 sinA = simd::load(lfoSin_), sinB = simd::load(lfoSin_ + 4);
+    float4 delayA = simd::load(currentDelay_), delayB = simd::load(currentDelay_ + 4);
+    const float outScale = 1.0f / std::sqrt(static_cast<float>(kLines));
+    const float wet = settings_.wet * outScale;
+    const float dry = settings_.dry;
+
+    alignas(16) float readDelay[kLines];
+    alignas(16) float taps[kLines];
+    alignas(16) float feedback[kLines];
+    size_t w = writePos_;
+
+    for (size_t n = 0; n < numSamples; ++n) {
+        // 1. Retards modulés (glissement vers la cible + LFO) puis lecture interpolée.
+        delayA = simd::madd(targetA - delayA, glide, delayA);
+        delayB = simd::madd(targetB - delayB, glide, delayB);
+        simd::store(readDelay, simd::madd(sinA, depth, delayA));
+        simd::store(readDelay + 4, simd::madd(sinB, depth, delayB));
+        for (size_t i = 0; i < kLines; ++i) {
+            const float pos = static_cast<float>(w) - readDelay[i];
+            const float floorPos = std::floor(pos);
+            const float frac = pos - floorPos;
+            const size_t i0 = static_cast<size_t>(static_cast<long>(floorPos)) & lineMask_[i];
+            const size_t i1 = (i0 + 1) & lineMask_[i];
+            const float* line = arena + lineOffset_[i];
+            taps[i] = line[i0] + frac * (line[i1] - line[i0]);
+        }
+
+        // 2. Amortissement (passe-bas du premier ordre) et gain de décroissance par ligne.
+        lpA = simd::madd(simd::load(taps) - lpA, damp, lpA);
+        lpB = simd::madd(simd::load(taps + 4) - lpB, damp, lpB);
+        const float4 decayedA = lpA * gainA;
+        const float4 decayedB = lpB * gainB;
+
+        // 3. Sortie : somme signée des lignes.
+        const float x = buffer[n];
+        const float out = simd::hsum(simd::madd(lpA, outSignsA, lpB * outSignsB));
+        buffer[n] = dry * x + wet * out;
+
+        // 4. Mélange de Hadamard 8x8 (H2 entre les deux vecteurs, puis H4 dans chacun) et réinjection.
+        const float4 in = simd::set1(x);
+        simd::store(feedback, simd::madd(in, inSignsA, hadamard4(decayedA + decayedB)));
+        simd::store(feedback + 4, simd::madd(in, inSignsB, hadamard4(decayedA - decayedB)));
+        for (size_t i = 0; i < kLines; ++i) {
+            arena[lineOffset_[i] + (w & lineMask_[i])] = feedback[i];
+        }
+        // Repliement sur la plus grande ligne : la position reste exacte en float.
+        w = (w + 1) & writeMask_;
+
+        // 5. Rotation des phaseurs des LFO.
+        const float4 nextCosA = cosA * rotCosA - sinA * rotSinA;
+        sinA = simd::madd(cosA, rotSinA, sinA * rotCosA);
+        cosA = nextCosA;
+        const float4 nextCosB = cosB * rotCosB - sinB * rotSinB;
+        sinB = simd::madd(cosB, rotSinB, sinB * rotCosB);
+        cosB = nextCosB;
+    }
+
+    writePos_ = w;
+    simd::store(dampState_, lpA);
+    simd::store(dampState_ + 4, lpB);
+    simd::store(currentDelay_, delayA);
+    simd::store(currentDelay_ + 4, delayB);
+
+    // Renormalise les phaseurs une fois par bloc (la rotation accumule une dérive d'amplitude).
+    const float4 normA = simd::madd(cosA, cosA, sinA * sinA);
+    const float4 normB = simd::madd(cosB, cosB, sinB * sinB);
+    simd::store(lfoCos_, cosA);
+    simd::store(lfoCos_ + 4, cosB);
+    simd::store(lfoSin_, sinA);
+    simd::store(lfoSin_ + 4, sinB);
+    alignas(16) float norms[kLines];
+    simd::store(norms, normA);
+    simd::store(norms + 4, normB);
+    for (size_t i = 0; i < kLines; ++i) {
+        const float inv = 1.0f / std::sqrt(norms[i]);
+        lfoCos_[i] *= inv;
+        lfoSin_[i] *= inv;
+    }
+}
+
+} // namespace rvc
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include <stddef.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Réverbération utilisateur à réseau de lignes à retard rebouclées (FDN, 8 lignes).
+ *
+ * Matrice de mélange de Hadamard (transformée rapide, deux vecteurs SIMD), retards
+ * modulés par des LFO lents (interpolation linéaire) et filtres d'amortissement du
+ * premier ordre dans la boucle. Les 8 lignes vivent dans une seule arène contiguë
+ * allouée à la construction : aucune allocation dans le thread audio.
+ */
+class FDNReverb : public AudioProcessor {
+public:
+    static constexpr size_t kLines = 8;
+
+    struct Settings {
+        float roomSize = 1.0f;     // Échelle des retards (0.5 à 1.5)
+        float decaySeconds = 1.2f; // RT60 en basses fréquences
+        float dampingHz = 6000.0f; // Coupure de l'amortissement dans la boucle
+        float wet = 0.0f;          // 0 = nœud désactivé
+        float dry = 1.0f;
+    };
+
+    explicit FDNReverb(int sampleRate);
+
+    void setSettings(const Settings& settings);
+    const Settings& settings() const { return settings_; }
+
+    void process(float* buffer, size_t numSamples) override;
+
+    // Paramètres publiés par NodeParameters (voir ParameterInfo).
+    size_t numParameters() const override;
+    const ParameterInfo* parameterInfo() const override;
+    void setParameters(const float* values) override;
+    size_t primingSamples() const override { return 2048; }
+    size_t tailSamples() const override;
+
+    // Vrai si le mélange est nul : le nœud peut être retiré de la chaîne.
+    bool isBypassed() const { return settings_.wet <= 0.0f; }
+
+    // Vide les lignes (ex: après un changement de profil).
+    void reset();
+
+private:
+    void updateCoefficients();
+
+    int sampleRate_;
+    Settings settings_;
+
+    // Arène unique : les lignes sont des fenêtres de taille puissance de 2 (masque d'index).
+    std::vector<float> arena_;
+    size_t lineOffset_[kLines];
+    size_t lineMask_[kLines];
+    size_t writePos_ = 0;
+    size_t writeMask_ = 0; // Taille de la plus grande ligne - 1 (multiple de toutes les autres)
+
+    // Paramètres par ligne, alignés sur les voies SIMD (lignes 0-3 puis 4-7)
+    alignas(16) float currentDelay_[kLines]; // Retard courant (échantillons), hors modulation
+    alignas(16) float targetDelay_[kLines]; // Retard visé après un changement de roomSize
+    alignas(16) float feedbackGain_[kLines];
+    alignas(16) float dampState_[kLines] = {};
+    alignas(16) float lfoCos_[kLines];
+    alignas(16) float lfoSin_[kLines];
+    alignas(16) float lfoRotCos_[kLines];
+    alignas(16) float lfoRotSin_[kLines];
+    float dampCoef_ = 0.0f;
+    float modDepth_ = 0.0f;
+};
+
+} // namespace rvc
@@ -0,0 +1,94 @@
+#include "dsp/fft.h"
+#include <cmath>
+#include <utility>
+
+namespace rvc {
+
+RealFFT::RealFFT(size_t size) : size_(size), half_(size / 2) {
+    bitReverse_.resize(half_);
+    size_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < half_) ++bits;
+    for (size_t i = 0; i < half_; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            if (i & (static_cast<size_t>(1) << b)) r |= static_cast<size_t>(1) << (bits - 1 - b);
+        }
+        bitReverse_[i] = r;
+    }
+
+    twiddles_.resize(half_ / 2 + 1);
+    for (size_t k = 0; k < twiddles_.size(); ++k) {
+        const double phase = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(half_);
+        twiddles_[k] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+    }
+
+    realTwiddles_.resize(half_ + 1);
+    for (size_t k = 0; k <= half_; ++k) {
+        const double phase = -M_PI * static_cast<double>(k) / static_cast<double>(half_);
+        realTwiddles_[k] = {static_cast<float>(std::cos(phase)), static_cast<float>(std::sin(phase))};
+    }
+
+    work_.resize(half_);
+}
+
+/**
+ * FFT complexe itérative (Cooley-Tukey, décimation temporelle) en place sur N/2 points.
+ */
+void RealFFT::complexFFT(std::complex<float>* data, bool inverse) const {
+    for (size_t i = 0; i < half_; ++i) {
+        const size_t r = bitReverse_[i];
+        if (r > i) std::swap(data[i], data[r]);
+    }
+
+    for (size_t len = 2; len <= half_; len <<= 1) {
+        const size_t halfLen = len / 2;
+        const size_t stride = half_ / len;
+        for (size_t start = 0; start < half_; start += len) {
+            for (size_t k = 0; k < halfLen; ++k) {
+                std::complex<float> w = twiddles_[k * stride];
+                if (inverse) w = std::conj(w);
+                const std::complex<float> a = data[start + k];
+                const std::complex<float> b = data[start + k + halfLen] * w;
+                data[start + k] = a + b;
+                data[start + k + halfLen] = a - b;
+            }
+        }
+    }
+}
+
+void RealFFT::forward(const float* in, std::complex<float>* out) {
+    // Les échantillons pairs/impairs forment la partie réelle/imaginaire d'un signal de N/2 points.
+    for (size_t i = 0; i < half_; ++i) {
+        work_[i] = {in[2 * i], in[2 * i + 1]};
+    }
+    complexFFT(work_.data(), false);
+
+    // Recombinaison : X[k] = E[k] + W^k O[k].
+    for (size_t k = 0; k <= half_; ++k) {
+        const std::complex<float> zk = work_[k % half_];
+        const std::complex<float> zn = std::conj(work_[(half_ - k) % half_]);
+        const std::complex<float> even = 0.5f * (zk + zn);
+        const std::complex<float> odd = std::complex<float>(0.0f, -0.5f) * (zk - zn);
+        out[k] = even + realTwiddles_[k] * odd;
+    }
+}
+
+void RealFFT::inverse(const std::complex<float>* in, float* out) {
+    // Décomposition inverse : Z[k] = E[k] + i O[k].
+    for (size_t k = 0; k < half_; ++k) {
+        const std::complex<float> xk = in[k];
+        const std::complex<float> xn = std::conj(in[half_ - k]);
+        const std::complex<float> even = 0.5f * (xk + xn);
+        const std::complex<float> odd = 0.5f * (xk - xn) * std::conj(realTwiddles_[k]);
+        work_[k] = even + std::complex<float>(0.0f, 1.0f) * odd;
+    }
+    complexFFT(work_.data(), true);
+
+    const float scale = 1.0f / static_cast<float>(half_);
+    for (size_t i = 0; i < half_; ++i) {
+        out[2 * i] = work_[i].real() * scale;
+        out[2 * i + 1] = work_[i].imag() * scale;
+    }
+}
+
+} // namespace rvc
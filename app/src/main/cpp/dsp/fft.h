@@ -0,0 +1,37 @@
+#pragma once
+
+#include <complex>
+#include <stddef.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * FFT réelle radix-2 (taille puissance de 2), tables précalculées à la construction.
+ * Utilise l'astuce de la FFT complexe de taille N/2 : aucune allocation à l'exécution.
+ */
+class RealFFT {
+public:
+    explicit RealFFT(size_t size);
+
+    size_t size() const { return size_; }
+    size_t numBins() const { return size_ / 2 + 1; }
+
+    // in : size() échantillons ; out : numBins() valeurs complexes.
+    void forward(const float* in, std::complex<float>* out);
+
+    // in : numBins() valeurs complexes ; out : size() échantillons (normalisé par 1/N).
+    void inverse(const std::complex<float>* in, float* out);
+
+private:
+    void complexFFT(std::complex<float>* data, bool inverse) const;
+
+    size_t size_;
+    size_t half_;
+    std::vector<size_t> bitReverse_;
+    std::vector<std::complex<float>> twiddles_;     // Racines de l'unité pour la FFT de taille N/2
+    std::vector<std::complex<float>> realTwiddles_; // exp(-i*pi*k/(N/2)) pour la recombinaison réelle
+    std::vector<std::complex<float>> work_;
+};
+
+} // namespace rvc
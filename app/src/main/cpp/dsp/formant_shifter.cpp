@@ -0,0 +1,296 @@
+#include "dsp/formant_shifter.h"
+#include "dsp/simd.h"
+#include "dsp/spectral_analyzer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+constexpr float kMaxGain = 16.0f;         // ±24 dB de correction globale au plus
+constexpr float kMaxReflection = 0.999f;  // Marge de stabilité du treillis tout-pôles
+constexpr float kDetectLowHz = 100.0f;
+constexpr float kDetectHighHz = 4000.0f;
+constexpr float kMinPowerPerSample = 1e-7f; // ≈ -70 dBFS : l'enveloppe du souffle n'a pas de sens
+constexpr float kMinPower = 1e-20f;
+constexpr float kLn2 = 0.69314718f;
+// Conditionnement de l'autocorrélation (comme les codecs de parole) : fenêtre de retard
+// gaussienne (résonances d'au moins ~kLagWindowHz de large) et bruit blanc à -40 dB.
+constexpr double kLagWindowHz = 60.0;
+constexpr double kWhiteNoiseCorrection = 1.0001;
+constexpr float kNepersPerDb = 0.11512925f; // ln(10) / 20
+constexpr float kEnvelopeRangeDb = 60.0f;   // Plancher de l'enveloppe sous son maximum
+// Recherche de la période dans le cepstre (F0 de 800 à 60 Hz) ; pic de voisement minimal
+// (népers) et coupure relative à la période.
+constexpr float kMaxPitchHz = 800.0f;
+constexpr float kMinPitchHz = 60.0f;
+constexpr float kVoicedCepstrum = 0.08f;
+constexpr float kLifterPeriodFraction = 0.75f;
+
+constexpr ParameterInfo kParameters[] = {
+    {"shift_semitones", -12.0f, 12.0f, 0.0f, 0.0f}, // Déjà interpolé trame par trame
+    {"lifter_ms", 1.0f, 5.0f, 3.0f, 0.0f},
+    {"max_correction_db", 6.0f, 30.0f, 18.0f, 0.0f},
+};
+
+} // namespace
+
+FormantShifter::FormantShifter(int sampleRate, const SpectralAnalyzer& analyzer)
+    : sampleRate_(sampleRate),
+      order_(std::clamp<size_t>(static_cast<size_t>(sampleRate) / 1200, 8, kMaxOrder)),
+      analyzer_(analyzer),
+      lastFrame_(analyzer.frameCount()),
+      fft_(analyzer.fftSize()),
+      logEnvelope_(analyzer.numBins(), 0.0f),
+      power_(analyzer.numBins(), 0.0f),
+      cepstrum_(analyzer.fftSize(), 0.0f),
+      spectrum_(analyzer.numBins(), {0.0f, 0.0f}) {
+    lagWindow_[0] = kWhiteNoiseCorrection;
+    for (size_t i = 1; i <= order_; ++i) {
+        const double x = 2.0 * M_PI * kLagWindowHz * static_cast<double>(i) / static_cast<double>(sampleRate);
+        lagWindow_[i] = std::exp(-0.5 * x * x);
+    }
+}
+
+void FormantShifter::setSettings(const Settings& settings) {
+    settings_ = settings;
+    ratio_ = std::exp2(settings_.shiftSemitones / 12.0f);
+}
+
+size_t FormantShifter::numParameters() const {
+    return sizeof(kParameters) / sizeof(kParameters[0]);
+}
+
+const ParameterInfo* FormantShifter::parameterInfo() const {
+    return kParameters;
+}
+
+void FormantShifter::setParameters(const float* values) {
+    Settings settings = settings_;
+    settings.shiftSemitones = values[0];
+    settings.lifterMs = values[1];
+    settings.maxCorrectionDb = values[2];
+    setSettings(settings);
+}
+
+// Trame d'analyse, puis décroissance des résonances (enveloppe lissée : largeurs de bande
+// de l'ordre de 100 Hz, quelques ms).
+size_t FormantShifter::tailSamples() const {
+    return analyzer_.fftSize() + static_cast<size_t>(sampleRate_ / 20);
+}
+
+/**
+ * Récursion de Levinson-Durbin sur l'autocorrélation de l'enveloppe (transformée inverse de
+ * la puissance) fenêtrée, en double : A(z) = 1 + sum a_i z^-i, reflection[m] = k_{m+1}.
+ */
+float FormantShifter::fitLpc(const float* envelopePower, Coefficients& reflection) {
+    for (size_t k = 0; k < spectrum_.size(); ++k) {
+        spectrum_[k] = {envelopePower[k], 0.0f};
+    }
+    fft_.inverse(spectrum_.data(), cepstrum_.data());
+    const float* r = cepstrum_.data();
+    if (!(r[0] > 0.0f)) return 0.0f;
+
+    double a[kMaxOrder + 1] = {1.0};
+    double previous[kMaxOrder + 1];
+    double lagged[kMaxOrder + 1];
+    for (size_t i = 0; i <= order_; ++i) {
+        lagged[i] = r[i] * lagWindow_[i];
+    }
+    double error = lagged[0];
+    for (size_t m = 1; m <= order_; ++m) {
+        double acc = lagged[m];
+        for (size_t i = 1; i < m; ++i) {
+            acc += a[i] * lagged[m - i];
+        }
+        const double k = std::clamp(-acc / error, -static_cast<double>(kMaxReflection),
+                                    static_cast<double>(kMaxReflection));
+        std::copy(a, a + m, previous);
+        for (size_t i = 1; i < m; ++i) {
+            a[i] = previous[i] + k * previous[m - i];
+        }
+        a[m] = k;
+        error *= 1.0 - k * k;
+        reflection[m - 1] = static_cast<float>(k);
+    }
+    return static_cast<float>(error);
+}
+
+/**
+ * Enveloppe de la dernière trame : ln|X|, cepstre réel, liftrage (sous la période du pitch
+ * si le cepstre en montre une), retour au spectre ; puis enveloppe déplacée
+ * E'(f) = E(f / rapport), à maxCorrectionDb au plus de E(f). Le filtre visé est E'/E :
+ * blanchiment par l'ajustement LPC de E, synthèse par celui de E', gain sqrt(erreur'/erreur).
+ */
+void FormantShifter::updateEnvelope(const SpectralAnalyzer& analyzer) {
+    if (ratio_ == 1.0f) {
+        if (isActive_ && !isReleasing_) {
+            // Fondu vers l'identité, le nœud est ignoré à sa fin.
+            switchFilters(Coefficients{}, Coefficients{}, 1.0f);
+            isReleasing_ = true;
+        }
+        return;
+    }
+    const float floor = kMinPowerPerSample * static_cast<float>(analyzer.fftSize() * analyzer.fftSize());
+    if (analyzer.bandEnergy(kDetectLowHz, kDetectHighHz) < floor) {
+        return; // Silence ou souffle : le filtre courant est gardé
+    }
+
+    const size_t bins = logEnvelope_.size();
+    const size_t n = cepstrum_.size();
+    // ln|X| = 0.5 ln|X|^2
+    std::copy(analyzer.powerSpectrum(), analyzer.powerSpectrum() + bins, logEnvelope_.data());
+    simd::logCompress(logEnvelope_.data(), bins, kMinPower, 0.5f * kLn2);
+    for (size_t k = 0; k < bins; ++k) {
+        spectrum_[k] = {logEnvelope_[k], 0.0f};
+    }
+    fft_.inverse(spectrum_.data(), cepstrum_.data());
+    const float rate = static_cast<float>(sampleRate_);
+    size_t cutoff = static_cast<size_t>(settings_.lifterMs * 0.001f * rate);
+    const size_t lowest = static_cast<size_t>(rate / kMaxPitchHz);
+    const size_t highest = std::min(static_cast<size_t>(rate / kMinPitchHz), n / 2 - 1);
+    size_t period = lowest;
+    for (size_t q = lowest; q <= highest; ++q) {
+        if (cepstrum_[q] > cepstrum_[period]) period = q;
+    }
+    if (cepstrum_[period] > kVoicedCepstrum) {
+        cutoff = std::min(cutoff, static_cast<size_t>(kLifterPeriodFraction * static_cast<float>(period)));
+    }
+    cutoff = std::clamp<size_t>(cutoff, 1, n / 2 - 1);
+    std::fill(cepstrum_.begin() + static_cast<ptrdiff_t>(cutoff + 1),
+              cepstrum_.begin() + static_cast<ptrdiff_t>(n - cutoff), 0.0f);
+    fft_.forward(cepstrum_.data(), spectrum_.data());
+
+    float peak = spectrum_[0].real();
+    for (size_t k = 0; k < bins; ++k) {
+        logEnvelope_[k] = spectrum_[k].real();
+        peak = std::max(peak, logEnvelope_[k]);
+    }
+    const float minimum = peak - kEnvelopeRangeDb * kNepersPerDb;
+    for (size_t k = 0; k < bins; ++k) {
+        logEnvelope_[k] = std::max(logEnvelope_[k], minimum);
+        power_[k] = std::exp(2.0f * logEnvelope_[k]);
+    }
+    Coefficients analysis;
+    const float error = fitLpc(power_.data(), analysis);
+
+    // Au-delà de Nyquist / rapport (rapport < 1), le dernier bin est prolongé. L'écart à
+    // l'enveloppe d'origine est borné : pas de gain extrême là où la voix n'a pas d'énergie.
+    const float inverseRatio = 1.0f / ratio_;
+    const float maxCorrection = settings_.maxCorrectionDb * kNepersPerDb;
+    for (size_t k = 0; k < bins; ++k) {
+        const float position = static_cast<float>(k) * inverseRatio;
+        const size_t index = static_cast<size_t>(position);
+        float value = logEnvelope_[bins - 1];
+        if (index + 1 < bins) {
+            const float frac = position - static_cast<float>(index);
+            value = logEnvelope_[index] + frac * (logEnvelope_[index + 1] - logEnvelope_[index]);
+        }
+        value = std::clamp(value, logEnvelope_[k] - maxCorrection, logEnvelope_[k] + maxCorrection);
+        power_[k] = std::exp(2.0f * value);
+    }
+    Coefficients synthesis;
+    const float warpedError = fitLpc(power_.data(), synthesis);
+    if (!(error > 0.0f) || !(warpedError > 0.0f)) return;
+
+    const float gain = std::clamp(std::sqrt(warpedError / error), 1.0f / kMaxGain, kMaxGain);
+    if (!isActive_) {
+        // Fondu depuis l'identité (signal d'entrée), treillis vides.
+        current_ = Lattice{};
+        hasPending_ = false;
+        fadeRemaining_ = 0;
+        isActive_ = true;
+    }
+    isReleasing_ = false;
+    switchFilters(analysis, synthesis, gain);
+}
+
+/**
+ * Les deux treillis changent ensemble : interpoler séparément leurs coefficients de
+ * réflexion fait passer le filtre composé A/A' par des gains non bornés (une résonance de
+ * A' se forme avant le zéro de A qui la compense). Changer d'un coup les coefficients d'un
+ * treillis qui garde son état produit en revanche un clic à chaque trame. L'ancienne paire
+ * continue donc de tourner pendant un saut de l'analyse, et la sortie passe linéairement de
+ * l'une à l'autre (sorties corrélées : même entrée, enveloppes voisines). La nouvelle paire
+ * part de l'état de l'ancienne.
+ */
+void FormantShifter::switchFilters(const Coefficients& analysis, const Coefficients& synthesis, float gain) {
+    pending_.analysis = analysis;
+    pending_.synthesis = synthesis;
+    pending_.gain = gain;
+    hasPending_ = true;
+    if (fadeRemaining_ == 0) startFade();
+}
+
+void FormantShifter::startFade() {
+    previous_ = current_;
+    current_.analysis = pending_.analysis;
+    current_.synthesis = pending_.synthesis;
+    current_.gain = pending_.gain;
+    hasPending_ = false;
+    fadeRemaining_ = std::max<size_t>(1, analyzer_.hopSize());
+    fadeStep_ = 1.0f / static_cast<float>(fadeRemaining_);
+    fade_ = 0.0f;
+}
+
+/**
+ * Treillis RIF (A, erreur de prédiction) suivi du treillis tout-pôles (1/A').
+ */
+float FormantShifter::runLattice(Lattice& lattice, float x) const {
+    // Analyse : f_m = f_{m-1} + k_m b_{m-1}[n-1], b_m = k_m f_{m-1} + b_{m-1}[n-1].
+    float forward = x;
+    float backward = x;
+    for (size_t m = 0; m < order_; ++m) {
+        const float delayed = lattice.analysisState[m];
+        lattice.analysisState[m] = backward;
+        backward = lattice.analysis[m] * forward + delayed;
+        forward += lattice.analysis[m] * delayed;
+    }
+
+    // Synthèse : f_{m-1} = f_m - k_m b_{m-1}[n-1], b_m = k_m f_{m-1} + b_{m-1}[n-1].
+    forward *= lattice.gain;
+    for (size_t m = order_; m-- > 0;) {
+        forward -= lattice.synthesis[m] * lattice.synthesisState[m];
+        if (m + 1 < order_) lattice.synthesisState[m + 1] = lattice.synthesis[m] * forward + lattice.synthesisState[m];
+    }
+    lattice.synthesisState[0] = forward;
+    return forward;
+}
+
+void FormantShifter::filter(float* buffer, size_t numSamples) {
+    size_t i = 0;
+    while (i < numSamples) {
+        if (fadeRemaining_ == 0) {
+            for (; i < numSamples; ++i) buffer[i] = runLattice(current_, buffer[i]);
+            break;
+        }
+        const size_t end = std::min(numSamples, i + fadeRemaining_);
+        fadeRemaining_ -= end - i;
+        for (; i < end; ++i) {
+            const float from = runLattice(previous_, buffer[i]);
+            const float to = runLattice(current_, buffer[i]);
+            fade_ += fadeStep_;
+            buffer[i] = from + fade_ * (to - from);
+        }
+        if (fadeRemaining_ > 0) break;
+        if (hasPending_) {
+            startFade();
+        } else if (isReleasing_) {
+            // Identité atteinte : le reste du bloc passe tel quel.
+            isActive_ = false;
+            isReleasing_ = false;
+            return;
+        }
+    }
+}
+
+void FormantShifter::process(float* buffer, size_t numSamples) {
+    if (analyzer_.frameCount() != lastFrame_) {
+        lastFrame_ = analyzer_.frameCount();
+        if (ratio_ != 1.0f || isActive_) updateEnvelope(analyzer_);
+    }
+    if (isActive_) filter(buffer, numSamples);
+}
+
+} // namespace rvc
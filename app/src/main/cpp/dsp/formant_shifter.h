@@ -0,0 +1,104 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/fft.h"
+#include <array>
+#include <complex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rvc {
+
+class SpectralAnalyzer;
+
+/**
+ * Déplacement des formants indépendant du pitch (V16.0).
+ *
+ * L'enveloppe spectrale est estimée à chaque trame de l'analyse STFT partagée par lissage
+ * cepstral (les harmoniques de la voix, au-delà de la quéfrence de coupure, sont retirées),
+ * puis dilatée en fréquence du rapport demandé. La coupure descend sous la période du pitch
+ * quand le cepstre en montre une (voix aiguës). Les deux enveloppes sont ajustées par LPC
+ * et le signal passe dans un filtre en treillis : blanchiment par l'enveloppe d'origine,
+ * puis synthèse par l'enveloppe déplacée. Les coefficients de réflexion (|k| < 1) gardent le
+ * filtre stable ; à chaque nouvelle trame, la sortie passe de l'ancienne paire de treillis
+ * à la nouvelle par un fondu enchaîné d'un saut. Aucune latence ajoutée, aucune allocation
+ * dans process() ; nœud ignoré tant que le décalage est nul.
+ */
+class FormantShifter : public AudioProcessor {
+public:
+    // Ordre LPC : ~1 pôle par 1200 Hz d'échantillonnage (40 à 48 kHz, 13 à 16 kHz).
+    static constexpr size_t kMaxOrder = 40;
+
+    struct Settings {
+        float shiftSemitones = 0.0f; // > 0 : formants vers l'aigu (voix plus "féminine")
+        float lifterMs = 3.0f;       // Quéfrence de coupure maximale, réduite sous la période du pitch
+        float maxCorrectionDb = 18.0f; // Écart maximal entre enveloppes déplacée et d'origine
+    };
+
+    // Le détecteur lit l'analyse partagée à chaque nouvelle trame (nœud "stft_analysis" en amont).
+    FormantShifter(int sampleRate, const SpectralAnalyzer& analyzer);
+
+    void setSettings(const Settings& settings);
+
+    void process(float* buffer, size_t numSamples) override;
+
+    // Paramètres publiés par NodeParameters (voir ParameterInfo).
+    size_t numParameters() const override;
+    const ParameterInfo* parameterInfo() const override;
+    void setParameters(const float* values) override;
+    size_t primingSamples() const override { return 512; }
+    size_t tailSamples() const override;
+    const void* sharedState() const override { return &analyzer_; }
+
+private:
+    using Coefficients = std::array<float, kMaxOrder>;
+
+    // Paire de treillis A/A' avec son gain et son état. Coefficients nuls et gain 1 :
+    // identité (entrée et sortie du nœud).
+    struct Lattice {
+        Coefficients analysis = {};
+        Coefficients synthesis = {};
+        float gain = 1.0f;
+        Coefficients analysisState = {};  // b_m[n-1] du treillis RIF
+        Coefficients synthesisState = {}; // b_m[n-1] du treillis tout-pôles
+    };
+
+    void updateEnvelope(const SpectralAnalyzer& analyzer);
+    // Enveloppe en puissance (numBins valeurs) -> coefficients de réflexion ; retourne
+    // l'erreur de prédiction (0 si l'enveloppe est dégénérée).
+    float fitLpc(const float* envelopePower, Coefficients& reflection);
+    void switchFilters(const Coefficients& analysis, const Coefficients& synthesis, float gain);
+    void startFade();
+    float runLattice(Lattice& lattice, float x) const;
+    void filter(float* buffer, size_t numSamples);
+
+    int sampleRate_;
+    size_t order_;
+    const SpectralAnalyzer& analyzer_;
+    uint64_t lastFrame_;
+    Settings settings_;
+    float ratio_ = 1.0f;
+
+    // Estimation d'enveloppe (taille de l'analyse partagée)
+    RealFFT fft_;
+    std::vector<float> logEnvelope_; // ln|X| lissé
+    std::vector<float> power_;       // Enveloppe en puissance (d'origine, puis déplacée)
+    std::vector<float> cepstrum_;    // Cepstre, puis autocorrélation
+    std::vector<std::complex<float>> spectrum_;
+    std::array<double, kMaxOrder + 1> lagWindow_ = {};
+
+    // Filtres en treillis : fondu de previous_ vers current_ sur un saut ; une trame arrivée
+    // pendant le fondu attend sa fin (pending_).
+    bool isActive_ = false;
+    bool isReleasing_ = false; // Fondu vers l'identité (décalage nul), puis nœud ignoré
+    Lattice current_;
+    Lattice previous_;
+    Lattice pending_; // Coefficients et gain seulement
+    bool hasPending_ = false;
+    float fade_ = 1.0f; // Part de current_ dans la sortie
+    float fadeStep_ = 0.0f;
+    size_t fadeRemaining_ = 0;
+};
+
+} // namespace rvc
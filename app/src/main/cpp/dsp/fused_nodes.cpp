@@ -0,0 +1,22 @@
+#include "dsp/fused_nodes.h"
+
+// Compilé sans contraction ni réassociation (voir CMakeLists.txt) : la boucle fusionnée
+// effectue exactement les opérations de la chaîne étage par étage.
+
+namespace rvc {
+
+GateLimiterNode::GateLimiterNode(int sampleRate)
+    : gate_(sampleRate), dcBlock_(sampleRate), limiter_(0.99f),
+      dcBlockTail_(static_cast<size_t>(0.15f * static_cast<float>(sampleRate))) {}
+
+void GateLimiterNode::process(float* buffer, size_t numSamples) {
+    NoiseGate::FusedStage gate(gate_);
+    fused::run(buffer, numSamples, gate, dcBlock_, limiter_);
+}
+
+void GateLimiterNode::processUnfused(float* buffer, size_t numSamples) {
+    NoiseGate::FusedStage gate(gate_);
+    fused::runUnfused(buffer, numSamples, gate, dcBlock_, limiter_);
+}
+
+} // namespace rvc
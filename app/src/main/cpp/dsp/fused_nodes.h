@@ -0,0 +1,38 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/elementwise.h"
+#include "dsp/noise_gate.h"
+#include <stddef.h>
+
+namespace rvc {
+
+/**
+ * Gate -> suppression du continu -> limiteur de crête, fusionnés en une seule boucle
+ * (chaîne Low Power). Les paramètres exposés sont ceux du Noise Gate.
+ */
+class GateLimiterNode : public AudioProcessor {
+public:
+    explicit GateLimiterNode(int sampleRate);
+
+    void process(float* buffer, size_t numSamples) override;
+
+    size_t numParameters() const override { return gate_.numParameters(); }
+    const ParameterInfo* parameterInfo() const override { return gate_.parameterInfo(); }
+    void setParameters(const float* values) override { gate_.setParameters(values); }
+    size_t primingSamples() const override { return gate_.primingSamples(); }
+    size_t tailSamples() const override { return gate_.tailSamples() + dcBlockTail_; }
+
+    const NoiseGate& gate() const { return gate_; }
+
+    // Même chaîne exécutée étage par étage (référence pour la vérification de la fusion).
+    void processUnfused(float* buffer, size_t numSamples);
+
+private:
+    NoiseGate gate_;
+    fused::DCBlock dcBlock_;
+    fused::Clamp limiter_;
+    size_t dcBlockTail_; // Pôle à 20 Hz : ~110 ms pour passer sous -120 dB
+};
+
+} // namespace rvc
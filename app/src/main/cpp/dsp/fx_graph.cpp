@@ -1,70 +1,41 @@
 #include "dsp/fx_graph.h"
+#include "dsp/preset_file.h"
 #include "security/lock_manager.h" // Pour les checks de dégradation
-#include <cmath>
-#include <algorithm>
 #include <android/log.h>
+#include <cstring>
+#include <thread>
 
 #define LOG_TAG "RVC_FX_GRAPH"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-// --- Définitions des Stubs d'Effets Simples ---
-
 namespace rvc {
 
-/**
- * Simule un Noise Gate et l'Annulation d'Écho Acoustique (AEC).
- */
-void AcousticEchoCanceller::process(float* buffer, size_t numSamples) {
-    // V15.0: Logique d'AEC ici. Soustrait le signal de sortie du casque du signal d'entrée.
-    // L'implémentation réelle nécessiterait un buffer de référence du signal de sortie.
-    // Pour l'instant, on applique un Noise Gate léger.
-    const float threshold = 0.005f; // Exemple de seuil
-    for (size_t i = 0; i < numSamples; ++i) {
-        if (std::abs(buffer[i]) < threshold) {
-            buffer[i] = 0.0f; // Silence si sous le seuil
-        }
-    }
-}
+namespace {
 
-/**
- * Simule la Suppression de Bruit Neuronale (DNS) ou un filtre spectral avancé.
- */
-void NoiseSuppressor::process(float* buffer, size_t numSamples) {
-    // V9.0: Modèle TFLite ultra-léger pour la DNS s'exécutant ici.
-    // Ceci serait implémenté comme un petit moteur d'inférence distinct.
-    // Pour l'instant, simule un filtre passe-bas très simple pour le lissage.
-    for (size_t i = 1; i < numSamples; ++i) {
-        buffer[i] = buffer[i] * 0.95f + buffer[i-1] * 0.05f;
+// Comparaison directe avec les enregistrements projetés : aucune allocation.
+bool sameTopology(const GraphDescription& description, const PresetFile& preset,
+                  const PresetFile::ChainRecord& chain) {
+    if (description.nodes.size() != chain.numNodes || description.edges.size() != chain.numEdges) {
+        return false;
     }
-}
-
-/**
- * Simule le Compresseur Multibandes et le Limiteur de Crête.
- */
-void MultibandCompressor::process(float* buffer, size_t numSamples) {
-    // V1.0: Applique un Limiteur de Crête pour éviter le clipping dans le casque.
-    const float limit = 0.99f;
-    for (size_t i = 0; i < numSamples; ++i) {
-        buffer[i] = std::max(-limit, std::min(limit, buffer[i]));
+    for (size_t n = 0; n < chain.numNodes; ++n) {
+        const PresetFile::NodeRecord& node = preset.node(chain, n);
+        if (description.nodes[n].id != preset.string(node.id) || description.nodes[n].type != preset.string(node.type)) {
+            return false;
+        }
     }
-}
-
-/**
- * Algorithme de Compensation de Perte de Paquets (PLC - Packet Loss Concealment).
- */
-void PacketLossConcealer::process(float* buffer, size_t numSamples) {
-    // V12.0: Active l'interpolation temporelle si une perte de paquet est détectée.
-    if (isActive) {
-        // Logique : Synthétiser un signal court basé sur la dernière fréquence F0 connue.
-        // Ceci est une implémentation complexe non détaillée ici, mais cruciale.
-        // Pour simuler: on envoie un fade-out rapide du dernier son.
-        for (size_t i = 0; i < numSamples; ++i) {
-            buffer[i] = buffer[i] * (1.0f - (float)i / numSamples); // Fade out
+    for (size_t e = 0; e < chain.numEdges; ++e) {
+        const PresetFile::EdgeRecord& edge = preset.edge(chain, e);
+        if (description.edges[e].from != preset.string(edge.from) || description.edges[e].to != preset.string(edge.to)) {
+            return false;
         }
     }
+    return true;
 }
 
+} // namespace
+
 // --- Implémentation de la Classe FXGraph (Le Graphe Modulaire) ---
 
 FXGraph::FXGraph(int sampleRate) : sampleRate_(sampleRate) {
@@ -72,18 +43,147 @@ FXGraph::FXGraph(int sampleRate) : sampleRate_(sampleRate) {
     LOGI("Initialisation du Graphe de Traitement Audio à %d Hz.", sampleRate);
 
     // V7.0: Architecture de Plugins/Nœuds Modulaires
-    // Initialisation des effets
-    aec_ = std::make_unique<AcousticEchoCanceller>();
-    ns_ = std::make_unique<NoiseSuppressor>();
-    plc_ = std::make_unique<PacketLossConcealer>();
-    compressor_ = std::make_unique<MultibandCompressor>();
-    
+    // Chaque chaîne est compilée depuis sa description (nœuds du NodeRegistry).
+    for (size_t i = 0; i < kNumChains; ++i) {
+        const FXChain chain = static_cast<FXChain>(i);
+        std::unique_ptr<ChainState> state = buildChain(defaultDescription(chain), nullptr);
+        if (!state) {
+            LOGE("Échec de compilation de la chaîne par défaut %zu.", i);
+            return;
+        }
+        chains_[i].store(state.release());
+    }
+
     isInitialized_ = true;
 }
 
 FXGraph::~FXGraph() {
     LOGI("Destruction du Graphe de Traitement Audio.");
-    // unique_ptr s'occupe de la désallocation des effets.
+    for (size_t i = 0; i < kNumChains; ++i) {
+        delete chains_[i].exchange(nullptr);
+    }
+}
+
+/**
+ * Ordre historique : AEC -> Gate -> DNS avant le RVC ; PLC -> Compresseur -> formants ->
+ * correction harmonique -> dé-esseur -> EQ -> réverbération après.
+ */
+GraphDescription FXGraph::defaultDescription(FXChain chain) {
+    switch (chain) {
+        case FXChain::Preprocessing:
+            return GraphDescription::chain({
+                {"aec", "aec"},               // Annulation d'Écho Acoustique (Stabilité Casque)
+                {"gate", "noise_gate"},       // Hystérésis, maintien, rampes de gain lissées
+                {"ns", "noise_suppressor"},   // Suppression de Bruit Neuronale (Qualité d'entrée)
+            });
+        case FXChain::PostProcessing:
+            return GraphDescription::chain({
+                {"plc", "plc"},                       // V12.0: Mode dégradé (Watchdog)
+                {"compressor", "compressor"},         // Qualité de sortie stable
+                {"analysis", "stft_analysis"},        // Analyse partagée par les nœuds spectraux
+                {"formant", "formant_shifter"},       // V16.0: Formants indépendants du pitch (ignoré à 0)
+                {"harmonic", "harmonic_corrector"},   // V9.0: Distorsion harmonique
+                {"deesser", "deesser"},
+                {"eq", "parametric_eq"},              // Effets utilisateur
+                {"reverb", "fdn_reverb"},
+            });
+        case FXChain::LowPower:
+            // Seulement l'AEC, le Noise Gate et le Limiteur de Crête pour la communication simple.
+            // Gate et limiteur sont fusionnés en un seul passage sur le buffer.
+            return GraphDescription::chain({
+                {"aec", "aec"},
+                {"gate_limiter", "gate_limiter"},
+            });
+    }
+    return GraphDescription();
+}
+
+std::unique_ptr<FXGraph::ChainState> FXGraph::buildChain(const GraphDescription& description,
+                                                         std::string* error) {
+    auto state = std::make_unique<ChainState>();
+    state->description = description;
+    state->analyzer = std::make_unique<SpectralAnalyzer>(sampleRate_);
+
+    NodeContext context;
+    context.sampleRate = sampleRate_;
+    context.maxBlockSize = kMaxBlockSize;
+    context.analyzer = state->analyzer.get();
+    context.workers = workers_.get();
+    state->graph = CompiledGraph::compile(description, context, error);
+    if (!state->graph) return nullptr;
+
+    // Pool créé à la première chaîne qui a des branches parallèles : les chaînes linéaires
+    // (par défaut) n'en ont pas besoin, ni de sa calibration ni de ses threads SCHED_FIFO.
+    if (workers_ == nullptr && state->graph->numParallelWaves() > 0) {
+        workers_ = std::make_unique<WorkerPool>(WorkerPool::defaultWorkerCount());
+        state->graph->attachWorkers(workers_.get());
+    }
+
+    state->gate = static_cast<NoiseGate*>(state->graph->findNodeByType("noise_gate"));
+    state->gateIndex = state->graph->nodeIndexOf(state->gate);
+    state->plc = static_cast<PacketLossConcealer*>(state->graph->findNodeByType("plc"));
+    return state;
+}
+
+bool FXGraph::configureChain(FXChain chain, const GraphDescription& description, std::string* error) {
+    std::lock_guard<std::mutex> lock(configureMutex_);
+    std::unique_ptr<ChainState> state = buildChain(description, error);
+    if (!state) return false;
+    installChain(chain, std::move(state));
+    LOGI("Chaîne %d reconfigurée.", static_cast<int>(chain));
+    return true;
+}
+
+/**
+ * Nouvelle session de capture : les trois chaînes sont recompilées à la fréquence de
+ * l'application (coefficients, tailles de FFT, longueurs de retard recalculés), avec les
+ * réglages et contournements courants, exprimés en unités physiques.
+ */
+bool FXGraph::setSampleRate(int sampleRate) {
+    if (!isInitialized_) return false;
+    std::lock_guard<std::mutex> lock(configureMutex_);
+    if (sampleRate == sampleRate_) return true;
+
+    const int previousRate = sampleRate_;
+    sampleRate_ = sampleRate;
+    std::unique_ptr<ChainState> states[kNumChains];
+    for (size_t i = 0; i < kNumChains; ++i) {
+        std::string error;
+        states[i] = buildChain(chains_[i].load()->description, &error);
+        if (!states[i]) {
+            LOGE("Chaîne %zu non recompilée à %d Hz : %s", i, sampleRate, error.c_str());
+            sampleRate_ = previousRate;
+            return false;
+        }
+    }
+    for (size_t i = 0; i < kNumChains; ++i) {
+        installChain(static_cast<FXChain>(i), std::move(states[i]));
+    }
+    LOGI("Graphe de Traitement Audio recompilé à %d Hz.", sampleRate);
+    return true;
+}
+
+void FXGraph::installChain(FXChain chain, std::unique_ptr<ChainState> state) {
+    // Les nœuds conservés (même identifiant et même type) reprennent leurs réglages
+    // et leur contournement.
+    const CompiledGraph& current = *chains_[static_cast<size_t>(chain)].load()->graph;
+    for (size_t i = 0; i < state->graph->numNodes(); ++i) {
+        for (size_t j = 0; j < current.numNodes(); ++j) {
+            if (current.nodeId(j) != state->graph->nodeId(i) || current.nodeType(j) != state->graph->nodeType(i)) {
+                continue;
+            }
+            if (NodeParameters* params = state->graph->parameters(i)) {
+                params->restore(current.parameters(j)->staged());
+            }
+            state->graph->restoreBypass(i, current.isBypassRequested(j));
+            break;
+        }
+    }
+    std::unique_ptr<ChainState> previous(chains_[static_cast<size_t>(chain)].exchange(state.release()));
+    // Un lecteur entré avant l'échange peut encore utiliser l'ancien graphe.
+    while (activeReaders_.load() != 0) {
+        std::this_thread::yield();
+    }
 }
 
 /**
@@ -91,14 +191,8 @@ FXGraph::~FXGraph() {
  */
 void FXGraph::applyAcousticPreprocessing(float* buffer, size_t numSamples) {
     if (!isInitialized_) return;
-
-    // 1. Annulation d'Écho Acoustique (AEC - Stabilité Casque)
-    aec_->process(buffer, numSamples); 
-
-    // 2. Suppression de Bruit Neuronale (DNS - Qualité d'entrée)
-    ns_->process(buffer, numSamples);
-    
-    // Autres : Pré-Égalisation, correction de phase de l'entrée.
+    ReadGuard guard(*this);
+    chains_[static_cast<size_t>(FXChain::Preprocessing)].load()->graph->process(buffer, numSamples);
 }
 
 /**
@@ -106,22 +200,20 @@ void FXGraph::applyAcousticPreprocessing(float* buffer, size_t numSamples) {
  */
 void FXGraph::applyPostProcessing(float* buffer, size_t numSamples) {
     if (!isInitialized_) return;
+    ReadGuard guard(*this);
+    ChainState* state = chains_[static_cast<size_t>(FXChain::PostProcessing)].load();
 
     // V12.0: Vérification du mode dégradé (PLC)
-    if (LockManager::getInstance()->isPLCActive()) {
-        plc_->activate(); // Active le PLC si l'erreur est détectée par le Watchdog
-        plc_->process(buffer, numSamples);
-    } else {
-        plc_->deactivate();
-        
-        // 1. Compresseur Multibandes et Limiteur (Qualité de sortie stable)
-        compressor_->process(buffer, numSamples);
-
-        // 2. Correction de la distorsion harmonique (V9.0)
-        // Correction de la distorsion après le RVC...
-        
-        // 3. Réverbération / EQ final (effets utilisateur)
+    // Le PLC traite chaque bloc : inactif, il mémorise la sortie réelle (historique de pitch)
+    // et assure le fondu de retour ; actif, il remplace le bloc par la synthèse.
+    if (state->plc != nullptr) {
+        if (LockManager::getInstance()->isPLCActive()) {
+            state->plc->activate(); // Active le PLC si l'erreur est détectée par le Watchdog
+        } else {
+            state->plc->deactivate();
+        }
     }
+    state->graph->process(buffer, numSamples);
 }
 
 /**
@@ -129,10 +221,147 @@ void FXGraph::applyPostProcessing(float* buffer, size_t numSamples) {
  */
 void FXGraph::applyLowPowerDSP(float* buffer, size_t numSamples) {
     if (!isInitialized_) return;
+    ReadGuard guard(*this);
+    chains_[static_cast<size_t>(FXChain::LowPower)].load()->graph->process(buffer, numSamples);
+}
+
+bool FXGraph::isInputGated() const {
+    if (!isInitialized_) return false;
+    ReadGuard guard(*this);
+    const ChainState* state = chains_[static_cast<size_t>(FXChain::Preprocessing)].load();
+    // Un gate contourné ne coupe plus rien : son dernier état n'a plus de sens.
+    // Un bloc silencieux en sortie de chaîne (entrée muette, nœuds sautés) vaut un gate fermé.
+    return (state->gate != nullptr && !state->graph->isBypassed(state->gateIndex) && state->gate->isClosed()) ||
+           state->graph->isOutputSilent();
+}
+
+size_t FXGraph::latencySamples(FXChain chain) const {
+    if (!isInitialized_) return 0;
+    ReadGuard guard(*this);
+    return chains_[static_cast<size_t>(chain)].load()->graph->latencySamples();
+}
+
+bool FXGraph::setParameter(FXChain chain, const std::string& nodeId, const std::string& name, float value) {
+    return setParameters(chain, nodeId, {{name, value}});
+}
+
+bool FXGraph::setParameters(FXChain chain, const std::string& nodeId,
+                            const std::vector<std::pair<std::string, float>>& values) {
+    if (!isInitialized_) return false;
+    // Sérialisé avec configureChain : la publication ne peut pas viser un graphe en cours de remplacement.
+    std::lock_guard<std::mutex> lock(configureMutex_);
+    NodeParameters* params = chains_[static_cast<size_t>(chain)].load()->graph->findParameters(nodeId);
+    if (params == nullptr || !params->set(values)) {
+        LOGE("Paramètre refusé pour le nœud '%s'.", nodeId.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool FXGraph::setBypass(FXChain chain, const std::string& nodeId, bool bypass) {
+    if (!isInitialized_) return false;
+    std::lock_guard<std::mutex> lock(configureMutex_);
+    if (!chains_[static_cast<size_t>(chain)].load()->graph->setBypass(nodeId, bypass)) {
+        LOGE("Contournement refusé : nœud '%s' inconnu.", nodeId.c_str());
+        return false;
+    }
+    LOGI("Nœud '%s' %s.", nodeId.c_str(), bypass ? "contourné" : "réactivé");
+    return true;
+}
+
+/**
+ * Deux passes sous configureMutex_ : compilation des chaînes dont la topologie change et
+ * validation de tous les paramètres (rien n'est encore visible), puis installation et
+ * publication. Un preset refusé laisse donc toutes les chaînes intactes.
+ */
+bool FXGraph::applyPreset(const PresetFile& preset, std::string* error) {
+    if (!isInitialized_) return false;
+    std::lock_guard<std::mutex> lock(configureMutex_);
+
+    bool seen[kNumChains] = {};
+    std::unique_ptr<ChainState> built[kNumChains];
+    for (size_t c = 0; c < preset.numChains(); ++c) {
+        const PresetFile::ChainRecord& record = preset.chain(c);
+        if (record.chain >= kNumChains || seen[record.chain]) {
+            if (error) *error = "chaîne d'effets " + std::to_string(record.chain) + " inconnue ou en double";
+            return false;
+        }
+        seen[record.chain] = true;
+        if (record.numNodes == 0 && record.numEdges == 0) continue;
+
+        if (!sameTopology(chains_[record.chain].load()->description, preset, record)) {
+            built[record.chain] = buildChain(preset.description(record), error);
+            if (!built[record.chain]) return false;
+        }
+        const CompiledGraph& graph =
+            built[record.chain] ? *built[record.chain]->graph : *chains_[record.chain].load()->graph;
+        for (size_t n = 0; n < record.numNodes; ++n) {
+            const PresetFile::NodeRecord& node = preset.node(record, n);
+            if (node.numParams == 0) continue;
+            const NodeParameters* params = graph.findParameters(preset.string(node.id));
+            for (size_t p = 0; p < node.numParams; ++p) {
+                const char* name = preset.string(preset.param(node, p).name);
+                if (params == nullptr || params->indexOf(name) < 0) {
+                    if (error) {
+                        *error = std::string("paramètre '") + name + "' inconnu pour le nœud '" +
+                                 preset.string(node.id) + "'";
+                    }
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (size_t c = 0; c < preset.numChains(); ++c) {
+        const PresetFile::ChainRecord& record = preset.chain(c);
+        if (record.numNodes == 0 && record.numEdges == 0) continue;
+        if (built[record.chain]) {
+            installChain(static_cast<FXChain>(record.chain), std::move(built[record.chain]));
+            LOGI("Chaîne %u reconfigurée par le preset.", record.chain);
+        }
+
+        CompiledGraph& graph = *chains_[record.chain].load()->graph;
+        for (size_t n = 0; n < record.numNodes; ++n) {
+            const PresetFile::NodeRecord& node = preset.node(record, n);
+            const char* id = preset.string(node.id);
+            if (node.numParams > 0) {
+                NodeParameters* params = graph.findParameters(id);
+                NodeParameters::Values values = params->staged();
+                for (size_t p = 0; p < node.numParams; ++p) {
+                    const PresetFile::ParamRecord& param = preset.param(node, p);
+                    values[params->indexOf(preset.string(param.name))] = param.value;
+                }
+                params->publish(values);
+            }
+            const int index = graph.nodeIndexOf(graph.findNode(id));
+            const bool bypass = (node.flags & 1u) != 0;
+            if (index >= 0 && graph.isBypassRequested(static_cast<size_t>(index)) != bypass) {
+                graph.setBypass(id, bypass);
+            }
+        }
+    }
+    return true;
+}
+
+void FXGraph::setEqualizerBand(size_t index, const ParametricEQ::Band& band) {
+    const std::string prefix = "band" + std::to_string(index) + "_";
+    setParameters(FXChain::PostProcessing, "eq", {
+        {prefix + "type", static_cast<float>(band.type)},
+        {prefix + "freq", band.frequencyHz},
+        {prefix + "gain", band.gainDb},
+        {prefix + "q", band.q},
+        {prefix + "enabled", band.enabled ? 1.0f : 0.0f},
+    });
+}
 
-    // Applique seulement le Noise Gate (AEC) et le Limiteur de Crête pour la communication simple.
-    aec_->process(buffer, numSamples); 
-    compressor_->process(buffer, numSamples);
+void FXGraph::setReverbSettings(const FDNReverb::Settings& settings) {
+    setParameters(FXChain::PostProcessing, "reverb", {
+        {"room_size", settings.roomSize},
+        {"decay_s", settings.decaySeconds},
+        {"damping_hz", settings.dampingHz},
+        {"wet", settings.wet},
+        {"dry", settings.dry},
+    });
 }
 
 } // namespace rvc
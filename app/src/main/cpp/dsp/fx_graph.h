@@ -1,41 +1,31 @@
 #pragma once
 
+#include "dsp/audio_graph.h"
+#include "dsp/fdn_reverb.h"
+#include "dsp/noise_gate.h"
+#include "dsp/packet_loss_concealer.h"
+#include "dsp/parametric_eq.h"
+#include "dsp/spectral_analyzer.h"
+#include "dsp/worker_pool.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <stddef.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace rvc {
 
-// Interface de base pour tous les processeurs d'effets
-class AudioProcessor {
-public:
-    virtual ~AudioProcessor() = default;
-    virtual void process(float* buffer, size_t numSamples) = 0;
-};
-
-// Déclarations des effets (Stubs)
-class AcousticEchoCanceller : public AudioProcessor {
-public:
-    void process(float* buffer, size_t numSamples) override;
-};
-
-class NoiseSuppressor : public AudioProcessor {
-public:
-    void process(float* buffer, size_t numSamples) override;
-};
+class PresetFile;
 
-class MultibandCompressor : public AudioProcessor {
-public:
-    void process(float* buffer, size_t numSamples) override;
-};
-
-class PacketLossConcealer : public AudioProcessor {
-public:
-    void process(float* buffer, size_t numSamples) override;
-    void activate() { isActive = true; }
-    void deactivate() { isActive = false; }
-private:
-    bool isActive = false;
+/**
+ * Les trois chaînes du pipeline, chacune décrite par un graphe configurable.
+ */
+enum class FXChain {
+    Preprocessing = 0, // Avant le moteur RVC
+    PostProcessing,    // Après le moteur RVC
+    LowPower,          // Mode Pass-Through
 };
 
 /**
@@ -43,27 +33,100 @@ private:
  */
 class FXGraph {
 public:
+    static constexpr size_t kNumChains = 3;
+    // Plus grand bloc reçu par l'IPC (Ashmem de 64 Ko en float) : les buffers de travail
+    // sont dimensionnés une fois pour toutes.
+    static constexpr size_t kMaxBlockSize = 16384;
+
     FXGraph(int sampleRate);
     ~FXGraph();
 
     // Appliqué avant le moteur RVC
     void applyAcousticPreprocessing(float* buffer, size_t numSamples);
-    
+
     // Appliqué après le moteur RVC
     void applyPostProcessing(float* buffer, size_t numSamples);
 
     // Utilisé en mode Pass-Through
     void applyLowPowerDSP(float* buffer, size_t numSamples);
 
+    // Remplace le graphe d'une chaîne (hors thread audio). La chaîne courante reste en place
+    // si la description est invalide ; l'ancienne est libérée après le bloc en cours.
+    bool configureChain(FXChain chain, const GraphDescription& description, std::string* error = nullptr);
+
+    // Recompile les trois chaînes à une autre fréquence (nouvelle session de capture, hors
+    // thread audio), en conservant topologies, réglages et contournements.
+    bool setSampleRate(int sampleRate);
+    int sampleRate() const { return sampleRate_; }
+
+    // Graphes par défaut (ordre historique du pipeline).
+    static GraphDescription defaultDescription(FXChain chain);
+
+    // Vrai si le Noise Gate a entièrement fermé le dernier bloc, ou si la chaîne de
+    // pré-traitement a produit un bloc silencieux : l'appelant peut sauter l'inférence RVC.
+    bool isInputGated() const;
+
+    // Latence d'une chaîne en échantillons (chemin le plus long, branches déjà alignées).
+    size_t latencySamples(FXChain chain) const;
+
+    // Paramètres d'un nœud (thread UI/JNI) : publiés sans verrou, récupérés par le thread
+    // audio au bloc suivant puis lissés. Faux si le nœud ou un paramètre est inconnu.
+    bool setParameter(FXChain chain, const std::string& nodeId, const std::string& name, float value);
+    bool setParameters(FXChain chain, const std::string& nodeId,
+                       const std::vector<std::pair<std::string, float>>& values);
+
+    // Réglage d'une bande de l'égaliseur utilisateur (appliqué avec lissage des coefficients).
+    void setEqualizerBand(size_t index, const ParametricEQ::Band& band);
+
+    // Réglages de la réverbération utilisateur (wet = 0 la retire de la chaîne).
+    void setReverbSettings(const FDNReverb::Settings& settings);
+
+    // Contournement d'un nœud (fondu enchaîné, puis le nœud ne coûte plus rien) ;
+    // faux si le nœud est inconnu. Conservé lors d'une reconfiguration de la chaîne.
+    bool setBypass(FXChain chain, const std::string& nodeId, bool bypass);
+
+    // Applique les chaînes d'un preset binaire (hors thread audio). Une chaîne de même
+    // topologie que la chaîne courante ne reçoit que ses paramètres et contournements
+    // (quelques µs, sans allocation) ; sinon elle est recompilée. Une chaîne vide du preset
+    // garde la chaîne courante, les paramètres absents gardent leur valeur. Tout ou rien :
+    // chaînes compilées et paramètres validés avant d'installer quoi que ce soit.
+    bool applyPreset(const PresetFile& preset, std::string* error = nullptr);
+
 private:
+    // Graphe compilé et nœuds pilotés directement par FXGraph (nullptr si absents).
+    struct ChainState {
+        GraphDescription description; // Topologie compilée (comparée aux presets)
+        std::unique_ptr<SpectralAnalyzer> analyzer; // Analyse STFT partagée par les nœuds spectraux
+        std::unique_ptr<CompiledGraph> graph;
+        NoiseGate* gate = nullptr;
+        int gateIndex = -1;
+        PacketLossConcealer* plc = nullptr;
+    };
+
+    // Le thread audio signale sa lecture d'une chaîne : configureChain attend la fin du
+    // bloc en cours avant de libérer l'ancien graphe (aucun verrou côté audio).
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const FXGraph& graph) : readers_(graph.activeReaders_) { readers_.fetch_add(1); }
+        ~ReadGuard() { readers_.fetch_sub(1); }
+    private:
+        std::atomic<int>& readers_;
+    };
+
+    // Appelées sous configureMutex_ (sampleRate_, chaînes courantes et workers_ stables).
+    std::unique_ptr<ChainState> buildChain(const GraphDescription& description, std::string* error);
+    void installChain(FXChain chain, std::unique_ptr<ChainState> state);
+
     bool isInitialized_ = false;
-    int sampleRate_;
-    
-    // Modules d'effets
-    std::unique_ptr<AcousticEchoCanceller> aec_;
-    std::unique_ptr<NoiseSuppressor> ns_;
-    std::unique_ptr<PacketLossConcealer> plc_;
-    std::unique_ptr<MultibandCompressor> compressor_;
+    std::atomic<int> sampleRate_; // Écrit sous configureMutex_, lu aussi par les JNI
+
+    // Workers partagés par les trois chaînes (toutes exécutées sur le thread audio), créés
+    // par buildChain à la première chaîne qui a des vagues parallèles.
+    std::unique_ptr<WorkerPool> workers_;
+
+    std::atomic<ChainState*> chains_[kNumChains] = {};
+    mutable std::atomic<int> activeReaders_{0};
+    std::mutex configureMutex_;
 };
 
 } // namespace rvc
@@ -0,0 +1,218 @@
+#include "dsp/harmonic_corrector.h"
+#include "dsp/spectral_analyzer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+// Bandes d'octave utilisées pour la régression de pente (centres en Hz).
+constexpr float kOctaveCenters[] = {250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f};
+constexpr size_t kNumOctaves = sizeof(kOctaveCenters) / sizeof(kOctaveCenters[0]);
+
+constexpr float kTiltSmoothing = 0.05f;    // ~0.5 s à un saut de 10 ms
+constexpr float kPersistenceSmoothing = 0.02f; // ~0.5 s de mémoire à un saut de 10 ms
+constexpr float kPersistenceThreshold = 0.85f; // Fraction des trames où la raie doit être présente
+constexpr float kShelfUpdateStepDb = 0.25f; // Recalcul du plateau au-delà de cet écart
+constexpr float kBuzzLowHz = 50.0f;
+constexpr float kBuzzHighHz = 4000.0f;
+constexpr size_t kNeighborInner = 2; // Bins ignorés autour de la raie (lobe principal)
+constexpr size_t kNeighborOuter = 5; // Étendue du voisinage de référence
+constexpr size_t kWarmupFrames = 50;  // La moyenne long terme doit être établie
+constexpr float kMinPowerPerSample = 1e-7f;
+
+constexpr ParameterInfo kParameters[] = {
+    {"target_tilt_db_per_octave", -12.0f, 0.0f, -4.5f, 0.0f},
+    {"max_tilt_correction_db", 0.0f, 12.0f, 4.0f, 0.0f},
+    {"buzz_threshold_db", 3.0f, 20.0f, 6.0f, 0.0f},
+    {"notch_depth_db", -30.0f, 0.0f, -12.0f, 0.0f},
+};
+
+} // namespace
+
+HarmonicCorrector::HarmonicCorrector(int sampleRate, const SpectralAnalyzer& analyzer)
+    : sampleRate_(sampleRate),
+      analyzer_(analyzer),
+      lastFrame_(analyzer.frameCount()),
+      measuredTilt_(Settings().targetTiltDbPerOctave),
+      frameDb_(analyzer.numBins(), -120.0f),
+      persistence_(analyzer.numBins(), 0.0f) {
+}
+
+void HarmonicCorrector::setSettings(const Settings& settings) {
+    settings_ = settings;
+    appliedShelfDb_ = 0.0f;
+    tiltShelf_.c = BiquadCoefficients();
+    for (size_t i = 0; i < kMaxNotches; ++i) {
+        notchActive_[i] = false;
+    }
+}
+
+size_t HarmonicCorrector::numParameters() const {
+    return sizeof(kParameters) / sizeof(kParameters[0]);
+}
+
+const ParameterInfo* HarmonicCorrector::parameterInfo() const {
+    return kParameters;
+}
+
+/**
+ * Réglages pendant le traitement (jusqu'à un appel par tranche de 32 échantillons pendant
+ * un lissage) : rien n'est réinitialisé. Le plateau rejoint la nouvelle cible par pas de
+ * kShelfUpdateStepDb, les encoches actives changent de profondeur sans perdre leur état.
+ */
+void HarmonicCorrector::setParameters(const float* values) {
+    const bool depthChanged = values[3] != settings_.notchDepthDb;
+    settings_.targetTiltDbPerOctave = values[0];
+    settings_.maxTiltCorrectionDb = values[1];
+    settings_.buzzThresholdDb = values[2];
+    settings_.notchDepthDb = values[3];
+    if (!depthChanged) return;
+    for (size_t slot = 0; slot < kMaxNotches; ++slot) {
+        if (!notchActive_[slot]) continue;
+        notches_[slot].c =
+            designBiquad(BiquadType::Peaking, sampleRate_, notchHz_[slot], settings_.notchDepthDb, settings_.notchQ);
+    }
+}
+
+// Trame d'analyse, puis encoches étroites (Q 20) : jusqu'à ~1 s pour passer sous -120 dB
+// dans le grave.
+size_t HarmonicCorrector::tailSamples() const {
+    return analyzer_.fftSize() + static_cast<size_t>(sampleRate_);
+}
+
+void HarmonicCorrector::updateDetector(const SpectralAnalyzer& analyzer) {
+    const float floor = kMinPowerPerSample * static_cast<float>(analyzer.fftSize() * analyzer.fftSize());
+    if (analyzer.bandEnergy(kOctaveCenters[0], kOctaveCenters[2]) < floor) {
+        return; // Silence ou souffle : les mesures n'ont pas de sens
+    }
+    updateTilt(analyzer);
+    updateBuzz(analyzer);
+}
+
+/**
+ * Régression linéaire du niveau par octave en fonction de l'indice d'octave.
+ */
+void HarmonicCorrector::updateTilt(const SpectralAnalyzer& analyzer) {
+    const float nyquist = 0.5f * static_cast<float>(sampleRate_);
+    float sumX = 0.0f, sumY = 0.0f, sumXX = 0.0f, sumXY = 0.0f;
+    size_t count = 0;
+    for (size_t i = 0; i < kNumOctaves; ++i) {
+        const float high = kOctaveCenters[i] * std::sqrt(2.0f);
+        if (high > nyquist) break;
+        const float energy = analyzer.bandEnergy(kOctaveCenters[i] / std::sqrt(2.0f), high);
+        const float x = static_cast<float>(i);
+        const float y = 10.0f * std::log10(energy + 1e-12f);
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        ++count;
+    }
+    if (count < 3) return;
+
+    const float n = static_cast<float>(count);
+    const float slope = (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+    measuredTilt_ += kTiltSmoothing * (slope - measuredTilt_);
+
+    // Le plateau aigu agit sur ~2 octaves au-dessus du pivot.
+    const float correction = (settings_.targetTiltDbPerOctave - measuredTilt_) * 2.0f;
+    const float shelfDb = std::clamp(correction, -settings_.maxTiltCorrectionDb, settings_.maxTiltCorrectionDb);
+    if (std::fabs(shelfDb - appliedShelfDb_) >= kShelfUpdateStepDb) {
+        // Pas de 0.25 dB au plus par trame : transitions inaudibles.
+        if (appliedShelfDb_ == 0.0f) tiltShelf_.reset();
+        appliedShelfDb_ += std::clamp(shelfDb - appliedShelfDb_, -kShelfUpdateStepDb, kShelfUpdateStepDb);
+        tiltShelf_.c = designBiquad(BiquadType::HighShelf, sampleRate_, settings_.pivotHz, appliedShelfDb_, 0.5f);
+    }
+}
+
+/**
+ * Recherche des raies stables : un bin qui reste un pic spectral marqué sur la quasi-totalité
+ * des trames récentes est un bourdonnement (les harmoniques de la voix, elles, se déplacent
+ * avec l'intonation et ne restent pas sur le même bin).
+ */
+void HarmonicCorrector::updateBuzz(const SpectralAnalyzer& analyzer) {
+    const float* power = analyzer.powerSpectrum();
+    const size_t bins = std::min(frameDb_.size(), analyzer.numBins());
+    for (size_t k = 0; k < bins; ++k) {
+        frameDb_[k] = 10.0f * std::log10(power[k] + 1e-12f);
+    }
+
+    const size_t first = std::max(analyzer.binForFrequency(kBuzzLowHz), kNeighborOuter);
+    const size_t last = std::min(analyzer.binForFrequency(kBuzzHighHz), bins - 1 - kNeighborOuter);
+    for (size_t k = first; k <= last; ++k) {
+        const float center = frameDb_[k];
+        bool isPeak = center >= frameDb_[k - 1] && center >= frameDb_[k + 1];
+        if (isPeak) {
+            float neighbors = 0.0f;
+            for (size_t d = kNeighborInner; d <= kNeighborOuter; ++d) {
+                neighbors += frameDb_[k - d] + frameDb_[k + d];
+            }
+            neighbors /= static_cast<float>(2 * (kNeighborOuter - kNeighborInner + 1));
+            isPeak = center - neighbors >= settings_.buzzThresholdDb;
+        }
+        persistence_[k] += kPersistenceSmoothing * ((isPeak ? 1.0f : 0.0f) - persistence_[k]);
+    }
+    if (++framesSeen_ < kWarmupFrames) return;
+
+    // Les raies les plus persistantes au-delà du seuil.
+    size_t found[kMaxNotches] = {};
+    float score[kMaxNotches] = {};
+    for (size_t k = first; k <= last; ++k) {
+        const float p = persistence_[k];
+        if (p < kPersistenceThreshold || p < persistence_[k - 1] || p < persistence_[k + 1]) continue;
+        for (size_t slot = 0; slot < kMaxNotches; ++slot) {
+            if (p > score[slot]) {
+                for (size_t s = kMaxNotches - 1; s > slot; --s) {
+                    score[s] = score[s - 1];
+                    found[s] = found[s - 1];
+                }
+                score[slot] = p;
+                found[slot] = k;
+                break;
+            }
+        }
+    }
+
+    for (size_t slot = 0; slot < kMaxNotches; ++slot) {
+        if (score[slot] <= 0.0f) {
+            notchActive_[slot] = false;
+            continue;
+        }
+        if (notchActive_[slot] && notchBins_[slot] == found[slot]) continue; // Inchangé : état conservé
+        // Interpolation parabolique de la fréquence de la raie sur la trame courante.
+        const size_t k = found[slot];
+        const float a = frameDb_[k - 1], b = frameDb_[k], c = frameDb_[k + 1];
+        const float denom = a - 2.0f * b + c;
+        const float offset = (std::fabs(denom) > 1e-6f) ? std::clamp(0.5f * (a - c) / denom, -0.5f, 0.5f) : 0.0f;
+        const float hz = (static_cast<float>(k) + offset) * static_cast<float>(sampleRate_) / static_cast<float>(analyzer.fftSize());
+        if (!notchActive_[slot]) notches_[slot].reset();
+        notches_[slot].c = designBiquad(BiquadType::Peaking, sampleRate_, hz, settings_.notchDepthDb, settings_.notchQ);
+        notchBins_[slot] = k;
+        notchHz_[slot] = hz;
+        notchActive_[slot] = true;
+    }
+}
+
+void HarmonicCorrector::process(float* buffer, size_t numSamples) {
+    if (analyzer_.frameCount() != lastFrame_) {
+        lastFrame_ = analyzer_.frameCount();
+        updateDetector(analyzer_);
+    }
+    const bool tilt = appliedShelfDb_ != 0.0f;
+    if (tilt) {
+        for (size_t i = 0; i < numSamples; ++i) {
+            buffer[i] = tiltShelf_.process(buffer[i]);
+        }
+    }
+    for (size_t slot = 0; slot < kMaxNotches; ++slot) {
+        if (!notchActive_[slot]) continue;
+        Biquad& notch = notches_[slot];
+        for (size_t i = 0; i < numSamples; ++i) {
+            buffer[i] = notch.process(buffer[i]);
+        }
+    }
+}
+
+} // namespace rvc
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/biquad.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rvc {
+
+class SpectralAnalyzer;
+
+/**
+ * Correction de la distorsion harmonique après le RVC (V9.0).
+ *
+ * Deux corrections pilotées par l'analyse STFT partagée :
+ *  - pente spectrale : la pente mesurée (dB/octave, moyennée lentement) est ramenée vers
+ *    une pente cible de voix naturelle par un plateau aigu autour du pivot ;
+ *  - bourdonnement : les raies stables (qui ne suivent pas le pitch, contrairement aux
+ *    harmoniques de la voix) restent des pics sur le même bin trame après trame et sont
+ *    atténuées par des filtres en cloche étroits.
+ */
+class HarmonicCorrector : public AudioProcessor {
+public:
+    static constexpr size_t kMaxNotches = 2;
+
+    struct Settings {
+        float targetTiltDbPerOctave = -4.5f;
+        float maxTiltCorrectionDb = 4.0f;
+        float pivotHz = 1500.0f;
+        float buzzThresholdDb = 6.0f;  // Émergence d'un pic au-dessus de son voisinage
+        float notchDepthDb = -12.0f;
+        float notchQ = 20.0f;
+    };
+
+    // Les détecteurs lisent l'analyse partagée à chaque nouvelle trame (nœud "stft_analysis" en amont).
+    HarmonicCorrector(int sampleRate, const SpectralAnalyzer& analyzer);
+
+    // Nouveaux réglages, corrections repartant de zéro (plateau neutre, aucune encoche).
+    void setSettings(const Settings& settings);
+
+    void process(float* buffer, size_t numSamples) override;
+
+    // Paramètres publiés par NodeParameters (voir ParameterInfo).
+    size_t numParameters() const override;
+    const ParameterInfo* parameterInfo() const override;
+    void setParameters(const float* values) override;
+    size_t primingSamples() const override { return 512; }
+    size_t tailSamples() const override;
+    const void* sharedState() const override { return &analyzer_; }
+
+private:
+    void updateDetector(const SpectralAnalyzer& analyzer);
+    void updateTilt(const SpectralAnalyzer& analyzer);
+    void updateBuzz(const SpectralAnalyzer& analyzer);
+
+    int sampleRate_;
+    const SpectralAnalyzer& analyzer_;
+    uint64_t lastFrame_;
+    Settings settings_;
+
+    // Pente
+    Biquad tiltShelf_;
+    float measuredTilt_;
+    float appliedShelfDb_ = 0.0f;
+
+    // Bourdonnement
+    std::vector<float> frameDb_;     // Spectre de la trame courante (dB)
+    std::vector<float> persistence_; // Fraction récente des trames où le bin est un pic marqué
+    Biquad notches_[kMaxNotches];
+    size_t notchBins_[kMaxNotches] = {};
+    float notchHz_[kMaxNotches] = {};
+    bool notchActive_[kMaxNotches] = {};
+    size_t framesSeen_ = 0;
+};
+
+} // namespace rvc
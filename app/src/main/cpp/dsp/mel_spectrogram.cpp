@@ -0,0 +1,189 @@
+#include "dsp/mel_spectrogram.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+// Échantillons ajoutés d'une traite (au-delà d'une trame) : borne le buffer d'entrée.
+constexpr size_t kChunkSamples = 4096;
+
+// Échelle de Slaney : linéaire jusqu'à 1 kHz, logarithmique au-delà.
+constexpr float kSlaneyLinearHz = 1000.0f;
+constexpr float kSlaneyHzPerMel = 200.0f / 3.0f;
+constexpr float kSlaneyLinearMels = kSlaneyLinearHz / kSlaneyHzPerMel;
+constexpr float kSlaneyLogStep = 0.068751777f; // ln(6.4) / 27
+
+constexpr float kLn2 = 0.69314718f;
+constexpr float kLog10Of2 = 0.30103f;
+
+} // namespace
+
+float MelSpectrogram::hzToMel(float hz, MelScale scale) {
+    if (scale == MelScale::Htk) return 2595.0f * std::log10(1.0f + hz / 700.0f);
+    if (hz < kSlaneyLinearHz) return hz / kSlaneyHzPerMel;
+    return kSlaneyLinearMels + std::log(hz / kSlaneyLinearHz) / kSlaneyLogStep;
+}
+
+float MelSpectrogram::melToHz(float mel, MelScale scale) {
+    if (scale == MelScale::Htk) return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f);
+    if (mel < kSlaneyLinearMels) return mel * kSlaneyHzPerMel;
+    return kSlaneyLinearHz * std::exp(kSlaneyLogStep * (mel - kSlaneyLinearMels));
+}
+
+/**
+ * settings.fftSize : puissance de 2 (RealFFT), windowSize <= fftSize.
+ */
+MelSpectrogram::MelSpectrogram(int sampleRate, const Settings& settings)
+    : settings_(settings), fft_(settings.fftSize) {
+    const size_t n = settings_.fftSize;
+    const size_t windowSize = std::min(settings_.windowSize, n);
+    window_.assign(n, 0.0f);
+    const size_t offset = (n - windowSize) / 2;
+    for (size_t i = 0; i < windowSize; ++i) {
+        window_[offset + i] = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * static_cast<float>(i) /
+                                                     static_cast<float>(windowSize));
+    }
+
+    // Banc de filtres triangulaires (librosa.filters.mel) : numMels + 2 points équidistants
+    // en mel ; seuls les bins de poids non nul sont gardés.
+    const float nyquist = static_cast<float>(sampleRate) / 2.0f;
+    const float maxHz = settings_.maxHz > 0.0f ? std::min(settings_.maxHz, nyquist) : nyquist;
+    const float minMel = hzToMel(settings_.minHz, settings_.scale);
+    const float maxMel = hzToMel(maxHz, settings_.scale);
+    std::vector<float> points(settings_.numMels + 2);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const float mel = minMel + (maxMel - minMel) * static_cast<float>(i) / static_cast<float>(points.size() - 1);
+        points[i] = melToHz(mel, settings_.scale);
+    }
+    const float binHz = static_cast<float>(sampleRate) / static_cast<float>(n);
+    bands_.resize(settings_.numMels);
+    for (size_t m = 0; m < settings_.numMels; ++m) {
+        const float lower = points[m];
+        const float center = points[m + 1];
+        const float upper = points[m + 2];
+        const float norm = settings_.slaneyNorm ? 2.0f / (upper - lower) : 1.0f;
+        Band& band = bands_[m];
+        band.firstBin = 0;
+        band.numBins = 0;
+        band.offset = static_cast<uint32_t>(weights_.size());
+        for (size_t k = 0; k < fft_.numBins(); ++k) {
+            const float hz = static_cast<float>(k) * binHz;
+            const float weight = std::max(0.0f, std::min((hz - lower) / (center - lower), (upper - hz) / (upper - center)));
+            if (weight <= 0.0f) {
+                if (band.numBins > 0) break;
+                continue;
+            }
+            if (band.numBins == 0) band.firstBin = static_cast<uint32_t>(k);
+            weights_.push_back(weight * norm);
+            ++band.numBins;
+        }
+        maxBin_ = std::max<size_t>(maxBin_, band.firstBin + band.numBins);
+    }
+
+    input_.assign(n + kChunkSamples, 0.0f);
+    frame_.assign(n, 0.0f);
+    spectrum_.assign(fft_.numBins(), {0.0f, 0.0f});
+    power_.assign(fft_.numBins(), 0.0f);
+    discarded_.assign(settings_.numMels, 0.0f);
+    reset();
+}
+
+void MelSpectrogram::reset() {
+    // Trames centrées : la première est centrée sur le premier échantillon (padding avant,
+    // zéros ou réflexion écrite par reflectPadding() dès que le signal la permet).
+    count_ = settings_.centered ? settings_.fftSize / 2 : 0;
+    reflectPending_ = settings_.centered && settings_.reflectPad;
+    std::fill(input_.begin(), input_.begin() + count_, 0.0f);
+}
+
+/**
+ * Réflexion sans répétition du bord (torch.nn.functional.pad, mode "reflect") : les
+ * fftSize / 2 échantillons de tête sont x[fftSize / 2] ... x[1]. Appelée dès que
+ * x[fftSize / 2] est reçu, soit un échantillon après la première trame en zéros.
+ */
+void MelSpectrogram::reflectPadding() {
+    const size_t half = settings_.fftSize / 2;
+    for (size_t i = 0; i < half; ++i) input_[i] = input_[2 * half - i];
+    reflectPending_ = false;
+}
+
+size_t MelSpectrogram::maxFrames(size_t numSamples) const {
+    const size_t available = count_ + numSamples;
+    return available >= settings_.fftSize ? (available - settings_.fftSize) / settings_.hopSize + 1 : 0;
+}
+
+size_t MelSpectrogram::process(const float* in, size_t numSamples, const TensorView& tensor, size_t firstFrame) {
+    const size_t n = settings_.fftSize;
+    const size_t hop = settings_.hopSize;
+    const size_t numMels = settings_.numMels;
+    size_t frames = 0;
+    while (numSamples > 0) {
+        const size_t take = std::min(numSamples, input_.size() - count_);
+        std::copy(in, in + take, input_.data() + count_);
+        count_ += take;
+        in += take;
+        numSamples -= take;
+
+        if (reflectPending_) {
+            if (count_ <= n) continue; // Pas encore de x[n / 2] : aucune trame
+            reflectPadding();
+        }
+
+        size_t start = 0;
+        for (; start + n <= count_; start += hop) {
+            const size_t index = firstFrame + frames;
+            float* mel = discarded_.data();
+            size_t stride = 1;
+            if (index < tensor.numFrames) {
+                if (tensor.layout == Layout::MelMajor) {
+                    mel = tensor.data + index;
+                    stride = tensor.numFrames;
+                } else {
+                    mel = tensor.data + index * numMels;
+                }
+            }
+            analyzeFrame(input_.data() + start, mel, stride);
+            ++frames;
+        }
+        std::copy(input_.begin() + static_cast<ptrdiff_t>(start), input_.begin() + static_cast<ptrdiff_t>(count_),
+                  input_.begin());
+        count_ -= start;
+    }
+
+    // Compression en place, sur les plages contiguës du tenseur.
+    if (settings_.compression == Compression::None || firstFrame >= tensor.numFrames) return frames;
+    const float scale = settings_.compression == Compression::Log ? kLn2 : kLog10Of2;
+    const size_t written = std::min(frames, tensor.numFrames - firstFrame);
+    if (tensor.layout == Layout::MelMajor) {
+        for (size_t m = 0; m < numMels; ++m) {
+            simd::logCompress(tensor.data + m * tensor.numFrames + firstFrame, written, settings_.floor, scale);
+        }
+    } else {
+        simd::logCompress(tensor.data + firstFrame * numMels, written * numMels, settings_.floor, scale);
+    }
+    return frames;
+}
+
+/**
+ * Une trame : fenêtre, FFT, module (ou puissance) jusqu'au dernier bin utile, puis une
+ * bande creuse par filtre. mel[m * melStride] reçoit le filtre m (avant compression).
+ */
+void MelSpectrogram::analyzeFrame(const float* samples, float* mel, size_t melStride) {
+    simd::multiply(frame_.data(), samples, window_.data(), settings_.fftSize);
+    fft_.forward(frame_.data(), spectrum_.data());
+    for (size_t k = 0; k < maxBin_; ++k) {
+        power_[k] = std::norm(spectrum_[k]);
+    }
+    if (settings_.magnitude) {
+        for (size_t k = 0; k < maxBin_; ++k) power_[k] = std::sqrt(power_[k]);
+    }
+    for (size_t m = 0; m < bands_.size(); ++m) {
+        const Band& band = bands_[m];
+        mel[m * melStride] = simd::dot(power_.data() + band.firstBin, weights_.data() + band.offset, band.numBins);
+    }
+}
+
+} // namespace rvc
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "dsp/fft.h"
+#include <complex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Front-end mel en flux pour les modèles (V16.0) : découpage en trames, fenêtre de Hann,
+ * FFT, banc de filtres mel, compression logarithmique. Conventions de librosa/torchaudio
+ * (échelle et normalisation Slaney ou HTK), réglages par défaut de RMVPE : échelle HTK
+ * (librosa htk=True) et filtres normalisés Slaney, module de torch.stft(center=True) avec
+ * padding en tête par réflexion. En flux, seul le début est paddé : la dernière trame d'un
+ * signal fini, centrée au-delà de sa fin, n'est jamais calculée.
+ *
+ * Le banc de filtres est stocké en bandes creuses : chaque filtre triangulaire ne garde que
+ * ses bins non nuls (contigus), une bande est un produit scalaire SIMD sur le spectre. Le
+ * log est une approximation SIMD (simd::logCompress). Les trames sont écrites directement
+ * dans le tenseur d'entrée du modèle, à la position demandée : aucune copie intermédiaire.
+ * Aucune allocation dans process().
+ */
+class MelSpectrogram {
+public:
+    enum class MelScale { Slaney, Htk };
+    enum class Compression {
+        None,
+        Log,   // ln(max(x, floor)) (RMVPE, HiFi-GAN)
+        Log10, // log10(max(x, floor)) (Whisper)
+    };
+    // Disposition du tenseur d'entrée : [mel][trame] (PyTorch [1, n_mels, T]) ou [trame][mel].
+    enum class Layout { MelMajor, FrameMajor };
+
+    struct Settings {
+        size_t fftSize = 1024;
+        size_t windowSize = 1024; // Hann périodique, centrée dans fftSize
+        size_t hopSize = 160;
+        size_t numMels = 128;
+        float minHz = 30.0f;
+        float maxHz = 8000.0f;    // 0 : Nyquist
+        MelScale scale = MelScale::Htk;
+        bool slaneyNorm = true;   // Filtres d'aire constante (norm="slaney")
+        bool magnitude = true;    // |X| ; sinon puissance |X|^2
+        Compression compression = Compression::Log;
+        float floor = 1e-5f;
+        bool centered = true;     // Trame t centrée sur l'échantillon t * hop (fftSize / 2 de padding en tête)
+        bool reflectPad = true;   // Padding en tête par réflexion (pad_mode="reflect") ; sinon zéros
+    };
+
+    // Tenseur préalloué par le moteur : numFrames trames de numMels valeurs.
+    struct TensorView {
+        float* data = nullptr;
+        size_t numFrames = 0;
+        Layout layout = Layout::MelMajor;
+    };
+
+    MelSpectrogram(int sampleRate, const Settings& settings);
+
+    const Settings& settings() const { return settings_; }
+    size_t numMels() const { return settings_.numMels; }
+    size_t hopSize() const { return settings_.hopSize; }
+    // Trames au plus terminées par un bloc de numSamples échantillons.
+    size_t maxFrames(size_t numSamples) const;
+
+    // Thread audio / d'inférence. Ajoute un bloc ; les trames terminées sont écrites dans
+    // tensor à partir de firstFrame (celles au-delà de tensor.numFrames sont calculées mais
+    // pas écrites). Retourne le nombre de trames terminées.
+    size_t process(const float* in, size_t numSamples, const TensorView& tensor, size_t firstFrame);
+
+    void reset();
+
+    // Fréquences (Hz) <-> mel selon l'échelle choisie.
+    static float hzToMel(float hz, MelScale scale);
+    static float melToHz(float mel, MelScale scale);
+
+private:
+    struct Band {
+        uint32_t firstBin;
+        uint32_t numBins;
+        uint32_t offset; // Dans weights_
+    };
+
+    void analyzeFrame(const float* samples, float* mel, size_t melStride);
+    void reflectPadding();
+
+    Settings settings_;
+    RealFFT fft_;
+    std::vector<float> window_; // fftSize, nulle hors de la fenêtre
+    std::vector<Band> bands_;
+    std::vector<float> weights_;
+    size_t maxBin_ = 0; // Bins au-delà : aucun filtre
+
+    std::vector<float> input_; // Échantillons reçus, pas encore sortis de toutes leurs trames
+    size_t count_ = 0;
+    bool reflectPending_ = false; // Padding par réflexion en attente de l'échantillon fftSize / 2
+    std::vector<float> frame_;
+    std::vector<std::complex<float>> spectrum_;
+    std::vector<float> power_;
+    std::vector<float> discarded_; // Trame calculée au-delà de la capacité du tenseur
+};
+
+} // namespace rvc
@@ -0,0 +1,128 @@
+#include "dsp/node_parameters.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace rvc {
+
+namespace {
+
+// Écart relatif (à l'étendue du paramètre) sous lequel le lissage est considéré terminé.
+constexpr float kSmoothingEpsilon = 1e-4f;
+
+NodeParameters::Values defaultValues(const AudioProcessor& node) {
+    NodeParameters::Values values = {};
+    const ParameterInfo* info = node.parameterInfo();
+    const size_t count = std::min(node.numParameters(), NodeParameters::kMaxParameters);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = info[i].defaultValue;
+    }
+    return values;
+}
+
+} // namespace
+
+NodeParameters::NodeParameters(AudioProcessor& node, int sampleRate)
+    : node_(node),
+      info_(node.parameterInfo()),
+      count_(std::min(node.numParameters(), kMaxParameters)),
+      staged_(defaultValues(node)),
+      block_(staged_),
+      target_(staged_),
+      current_(staged_) {
+    for (size_t i = 0; i < count_; ++i) {
+        smoothingSamples_[i] = info_[i].smoothingMs * 0.001f * static_cast<float>(sampleRate);
+    }
+}
+
+int NodeParameters::indexOf(const std::string& name) const {
+    return indexOf(name.c_str());
+}
+
+int NodeParameters::indexOf(const char* name) const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (std::strcmp(info_[i].name, name) == 0) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+bool NodeParameters::set(const std::string& name, float value) {
+    return set({{name, value}});
+}
+
+bool NodeParameters::set(const std::vector<std::pair<std::string, float>>& values) {
+    std::vector<int> indices;
+    indices.reserve(values.size());
+    for (const auto& entry : values) {
+        const int index = indexOf(entry.first);
+        if (index < 0) return false;
+        indices.push_back(index);
+    }
+
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    for (size_t k = 0; k < values.size(); ++k) {
+        const ParameterInfo& p = info_[indices[k]];
+        staged_[indices[k]] = std::clamp(values[k].second, p.minValue, p.maxValue);
+    }
+    block_.publish(staged_);
+    return true;
+}
+
+NodeParameters::Values NodeParameters::staged() const {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    return staged_;
+}
+
+void NodeParameters::publish(const Values& values) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    for (size_t i = 0; i < count_; ++i) {
+        staged_[i] = std::clamp(values[i], info_[i].minValue, info_[i].maxValue);
+    }
+    block_.publish(staged_);
+}
+
+void NodeParameters::restore(const Values& values) {
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    staged_ = values;
+    target_ = values;
+    current_ = values;
+    isSmoothing_ = false;
+    node_.setParameters(current_.data());
+}
+
+void NodeParameters::acquire() {
+    if (!block_.acquire()) return;
+
+    target_ = block_.read();
+    bool changed = false;
+    for (size_t i = 0; i < count_; ++i) {
+        if (current_[i] == target_[i]) continue;
+        if (smoothingSamples_[i] <= 0.0f) {
+            current_[i] = target_[i];
+            changed = true;
+        } else {
+            isSmoothing_ = true;
+        }
+    }
+    if (changed) node_.setParameters(current_.data());
+}
+
+void NodeParameters::advance(size_t numSamples) {
+    if (!isSmoothing_) return;
+
+    isSmoothing_ = false;
+    for (size_t i = 0; i < count_; ++i) {
+        if (current_[i] == target_[i]) continue;
+        const float coef = std::exp(-static_cast<float>(numSamples) / smoothingSamples_[i]);
+        current_[i] = target_[i] + (current_[i] - target_[i]) * coef;
+        const float range = info_[i].maxValue - info_[i].minValue;
+        if (std::fabs(current_[i] - target_[i]) <= kSmoothingEpsilon * range) {
+            current_[i] = target_[i];
+        } else {
+            isSmoothing_ = true;
+        }
+    }
+    node_.setParameters(current_.data());
+}
+
+} // namespace rvc
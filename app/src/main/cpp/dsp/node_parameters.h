@@ -0,0 +1,72 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/triple_buffer.h"
+#include <array>
+#include <mutex>
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Bloc de paramètres d'un nœud du graphe, publié sans verrou vers le thread audio.
+ *
+ * Le thread UI (JNI) modifie une copie "préparée" puis la publie en entier dans un
+ * TripleBuffer ; le thread audio la récupère une fois par bloc, avant process(). Les
+ * paramètres avec smoothingMs > 0 rejoignent leur cible par un passe-bas du premier ordre :
+ * tant qu'un lissage est en cours, le graphe traite le nœud par tranches de kSmoothingSlice
+ * échantillons pour éviter l'effet "zipper".
+ */
+class NodeParameters {
+public:
+    static constexpr size_t kMaxParameters = 64;
+    static constexpr size_t kSmoothingSlice = 32;
+
+    using Values = std::array<float, kMaxParameters>;
+
+    NodeParameters(AudioProcessor& node, int sampleRate);
+
+    size_t size() const { return count_; }
+    const ParameterInfo& info(size_t index) const { return info_[index]; }
+    int indexOf(const std::string& name) const; // -1 si inconnu
+    int indexOf(const char* name) const;
+
+    // --- Thread UI ---
+    // Les valeurs sont bornées à [min, max] ; faux si un nom est inconnu (rien n'est publié).
+    bool set(const std::string& name, float value);
+    bool set(const std::vector<std::pair<std::string, float>>& values);
+    Values staged() const;
+    // Publication de toutes les valeurs d'un coup (bornées), sans allocation : staged(),
+    // valeurs modifiées par indexOf(), puis publish().
+    void publish(const Values& values);
+    // Reprise des réglages d'un graphe précédent, appliqués sans lissage. Uniquement avant
+    // que le graphe soit visible du thread audio.
+    void restore(const Values& values);
+
+    // --- Thread audio ---
+    // Récupère la dernière publication ; les paramètres non lissés sont appliqués aussitôt.
+    void acquire();
+    // Avance le lissage de numSamples puis applique les valeurs intermédiaires au nœud.
+    void advance(size_t numSamples);
+    bool isSmoothing() const { return isSmoothing_; }
+
+private:
+    AudioProcessor& node_;
+    const ParameterInfo* info_;
+    size_t count_;
+    float smoothingSamples_[kMaxParameters] = {}; // Constante de temps (échantillons), 0 = immédiat
+
+    mutable std::mutex writerMutex_; // Sérialise les écrivains, jamais pris par le thread audio
+    Values staged_ = {};
+    TripleBuffer<Values> block_;
+
+    // Thread audio
+    Values target_ = {};
+    Values current_ = {};
+    bool isSmoothing_ = false;
+};
+
+} // namespace rvc
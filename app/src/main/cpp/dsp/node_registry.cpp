@@ -0,0 +1,107 @@
+#include "dsp/node_registry.h"
+#include "dsp/builtin_nodes.h"
+#include "dsp/deesser.h"
+#include "dsp/fdn_reverb.h"
+#include "dsp/formant_shifter.h"
+#include "dsp/fused_nodes.h"
+#include "dsp/harmonic_corrector.h"
+#include "dsp/noise_gate.h"
+#include "dsp/packet_loss_concealer.h"
+#include "dsp/parametric_eq.h"
+#include "dsp/spectral_analyzer.h"
+#include <android/log.h>
+
+#define LOG_TAG "RVC_NODE_REGISTRY"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace rvc {
+
+NodeRegistry* NodeRegistry::instance_ = nullptr;
+std::mutex NodeRegistry::mutex_;
+
+NodeRegistry* NodeRegistry::getInstance() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (instance_ == nullptr) {
+        instance_ = new NodeRegistry();
+    }
+    return instance_;
+}
+
+NodeRegistry::NodeRegistry() {
+    registerBuiltinNodes();
+    LOGI("Registre de nœuds initialisé (%zu types).", factories_.size());
+}
+
+bool NodeRegistry::registerNode(const std::string& type, Factory factory) {
+    std::lock_guard<std::mutex> lock(factoriesMutex_);
+    if (!factory || !factories_.emplace(type, std::move(factory)).second) {
+        LOGE("Type de nœud '%s' refusé (déjà enregistré ou fabrique vide).", type.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool NodeRegistry::contains(const std::string& type) const {
+    std::lock_guard<std::mutex> lock(factoriesMutex_);
+    return factories_.count(type) != 0;
+}
+
+std::unique_ptr<AudioProcessor> NodeRegistry::create(const std::string& type, const NodeContext& context) const {
+    Factory factory;
+    {
+        std::lock_guard<std::mutex> lock(factoriesMutex_);
+        auto it = factories_.find(type);
+        if (it == factories_.end()) return nullptr;
+        factory = it->second;
+    }
+    return factory(context);
+}
+
+/**
+ * Nœuds intégrés. Les nœuds spectraux exigent l'analyse partagée dans le contexte.
+ */
+void NodeRegistry::registerBuiltinNodes() {
+    factories_["aec"] = [](const NodeContext&) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<AcousticEchoCanceller>();
+    };
+    factories_["noise_gate"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<NoiseGate>(ctx.sampleRate);
+    };
+    factories_["noise_suppressor"] = [](const NodeContext&) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<NoiseSuppressor>();
+    };
+    factories_["gate_limiter"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<GateLimiterNode>(ctx.sampleRate);
+    };
+    factories_["compressor"] = [](const NodeContext&) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<MultibandCompressor>();
+    };
+    factories_["plc"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<PacketLossConcealer>(ctx.sampleRate);
+    };
+    factories_["stft_analysis"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        if (ctx.analyzer == nullptr) return nullptr;
+        return std::make_unique<SpectralAnalysisNode>(*ctx.analyzer);
+    };
+    factories_["formant_shifter"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        if (ctx.analyzer == nullptr) return nullptr;
+        return std::make_unique<FormantShifter>(ctx.sampleRate, *ctx.analyzer);
+    };
+    factories_["harmonic_corrector"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        if (ctx.analyzer == nullptr) return nullptr;
+        return std::make_unique<HarmonicCorrector>(ctx.sampleRate, *ctx.analyzer);
+    };
+    factories_["deesser"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        if (ctx.analyzer == nullptr) return nullptr;
+        return std::make_unique<DeEsser>(ctx.sampleRate, *ctx.analyzer);
+    };
+    factories_["parametric_eq"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<ParametricEQ>(ctx.sampleRate);
+    };
+    factories_["fdn_reverb"] = [](const NodeContext& ctx) -> std::unique_ptr<AudioProcessor> {
+        return std::make_unique<FDNReverb>(ctx.sampleRate);
+    };
+}
+
+} // namespace rvc
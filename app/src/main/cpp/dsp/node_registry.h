@@ -0,0 +1,58 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+
+namespace rvc {
+
+class SpectralAnalyzer;
+class WorkerPool;
+
+/**
+ * Contexte transmis aux fabriques de nœuds lors de la compilation d'un graphe.
+ */
+struct NodeContext {
+    int sampleRate = 48000;
+    size_t maxBlockSize = 0;              // Taille maximale d'un bloc passé à process()
+    SpectralAnalyzer* analyzer = nullptr; // Analyse STFT partagée (mise à jour par "stft_analysis")
+    WorkerPool* workers = nullptr;        // Exécution parallèle des branches indépendantes (optionnel)
+};
+
+/**
+ * Registre des types de nœuds du graphe d'effets (V7.0 : architecture de plugins).
+ * Les nœuds intégrés sont enregistrés à la création ; un nouvel effet s'ajoute par
+ * registerNode() sans modifier FXGraph.
+ */
+class NodeRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<AudioProcessor>(const NodeContext&)>;
+
+    static NodeRegistry* getInstance();
+
+    NodeRegistry(NodeRegistry const&) = delete;
+    void operator=(NodeRegistry const&) = delete;
+
+    // Retourne faux si le type est déjà enregistré.
+    bool registerNode(const std::string& type, Factory factory);
+    bool contains(const std::string& type) const;
+
+    // nullptr si le type est inconnu ou si la fabrique refuse le contexte.
+    std::unique_ptr<AudioProcessor> create(const std::string& type, const NodeContext& context) const;
+
+private:
+    NodeRegistry();
+    void registerBuiltinNodes();
+
+    static NodeRegistry* instance_;
+    static std::mutex mutex_;
+
+    mutable std::mutex factoriesMutex_;
+    std::unordered_map<std::string, Factory> factories_;
+};
+
+} // namespace rvc
@@ -0,0 +1,192 @@
+#include "dsp/noise_gate.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+// En dessous de ce gain, le gate est considéré comme complètement fermé (-60 dB).
+constexpr float kClosedGain = 1e-3f;
+
+float dbToLinear(float db) {
+    return std::pow(10.0f, db / 20.0f);
+}
+
+// Coefficient de lissage exponentiel, appliqué tous les `step` échantillons, tel que
+// l'écart à la cible diminue de 60 dB en `timeMs` (les temps d'attaque/relâchement
+// correspondent ainsi à la durée complète de la rampe jusqu'à kClosedGain).
+float smoothingCoef(float timeMs, size_t step, int sampleRate) {
+    const float samples = std::max(1.0f, timeMs * 0.001f * static_cast<float>(sampleRate));
+    return std::exp(-6.9078f * static_cast<float>(step) / samples);
+}
+
+constexpr ParameterInfo kParameters[] = {
+    {"open_threshold_db", -90.0f, 0.0f, -45.0f, 0.0f},
+    {"close_threshold_db", -96.0f, 0.0f, -52.0f, 0.0f},
+    {"attack_ms", 0.1f, 50.0f, 1.0f, 0.0f},
+    {"hold_ms", 0.0f, 500.0f, 60.0f, 0.0f},
+    {"release_ms", 5.0f, 1000.0f, 80.0f, 0.0f},
+};
+
+} // namespace
+
+NoiseGate::NoiseGate(int sampleRate) : NoiseGate(sampleRate, Settings()) {}
+
+NoiseGate::NoiseGate(int sampleRate, const Settings& settings)
+    : sampleRate_(sampleRate), settings_(settings) {
+    updateCoefficients();
+}
+
+void NoiseGate::setSettings(const Settings& settings) {
+    settings_ = settings;
+    updateCoefficients();
+}
+
+size_t NoiseGate::numParameters() const {
+    return sizeof(kParameters) / sizeof(kParameters[0]);
+}
+
+const ParameterInfo* NoiseGate::parameterInfo() const {
+    return kParameters;
+}
+
+void NoiseGate::setParameters(const float* values) {
+    Settings settings = settings_;
+    settings.openThresholdDb = values[0];
+    settings.closeThresholdDb = values[1];
+    settings.attackMs = values[2];
+    settings.holdMs = values[3];
+    settings.releaseMs = values[4];
+    setSettings(settings);
+}
+
+void NoiseGate::updateCoefficients() {
+    openThreshold_ = dbToLinear(settings_.openThresholdDb);
+    // L'hystérésis n'a de sens que si le seuil de fermeture est sous celui d'ouverture.
+    closeThreshold_ = std::min(openThreshold_, dbToLinear(settings_.closeThresholdDb));
+
+    // Décroissance du détecteur de crête (60 dB en ~50ms) : suit les creux entre les périodes sans battre.
+    envelopeDecay_ = smoothingCoef(50.0f, kSubBlock, sampleRate_);
+    attackCoef_ = smoothingCoef(settings_.attackMs, kSubBlock, sampleRate_);
+    releaseCoef_ = smoothingCoef(settings_.releaseMs, kSubBlock, sampleRate_);
+    holdSamples_ = static_cast<size_t>(settings_.holdMs * 0.001f * static_cast<float>(sampleRate_));
+    // Entrée silencieuse : la sortie l'est aussitôt, mais l'état ne revient au repos (gate
+    // fermé, enveloppe nulle) qu'après le maintien, le relâchement et la décroissance du détecteur.
+    tailSamples_ = holdSamples_ +
+                   static_cast<size_t>((settings_.releaseMs + 50.0f) * 0.001f * static_cast<float>(sampleRate_));
+
+    // Filtres du sidechain : passe-haut et passe-bas du premier ordre.
+    const float nyquist = 0.5f * static_cast<float>(sampleRate_);
+    const float low = std::clamp(settings_.sidechainLowHz, 1.0f, nyquist * 0.9f);
+    const float high = std::clamp(settings_.sidechainHighHz, low, nyquist * 0.9f);
+    hpCoef_ = std::exp(-2.0f * static_cast<float>(M_PI) * low / static_cast<float>(sampleRate_));
+    lpCoef_ = 1.0f - std::exp(-2.0f * static_cast<float>(M_PI) * high / static_cast<float>(sampleRate_));
+}
+
+/**
+ * Filtre le sous-bloc pour la détection uniquement (le signal audio n'est pas modifié).
+ * Retourne la crête absolue du signal filtré.
+ */
+float NoiseGate::filterSidechain(const float* in, float* out, size_t n) {
+    float hpIn = hpPrevIn_;
+    float hpOut = hpPrevOut_;
+    float lp = lpState_;
+    for (size_t i = 0; i < n; ++i) {
+        hpOut = hpCoef_ * (hpOut + in[i] - hpIn);
+        hpIn = in[i];
+        lp += lpCoef_ * (hpOut - lp);
+        out[i] = lp;
+    }
+    hpPrevIn_ = hpIn;
+    hpPrevOut_ = hpOut;
+    lpState_ = lp;
+    return simd::peakAbs(out, n);
+}
+
+/**
+ * Détection par sous-blocs : détecteur de crête sur le sidechain filtré, machine à états
+ * (ouvert / maintien / relâchement) puis lissage du gain. Le signal n'est pas modifié :
+ * seules les rampes de gain de la tranche sont mémorisées.
+ */
+void NoiseGate::analyze(const float* in, size_t numSamples) {
+    float sidechain[kSubBlock];
+    chunkUnity_ = true;
+    chunkClosed_ = true;
+
+    for (size_t offset = 0; offset < numSamples; offset += kSubBlock) {
+        const size_t n = std::min(kSubBlock, numSamples - offset);
+        // Coefficients prévus pour kSubBlock échantillons : un sous-bloc partiel (fin d'un
+        // bloc de taille quelconque) n'avance les constantes de temps que de sa durée.
+        float envelopeDecay = envelopeDecay_;
+        float attackCoef = attackCoef_;
+        float releaseCoef = releaseCoef_;
+        if (n < kSubBlock) {
+            const float fraction = static_cast<float>(n) / static_cast<float>(kSubBlock);
+            envelopeDecay = std::pow(envelopeDecay, fraction);
+            attackCoef = std::pow(attackCoef, fraction);
+            releaseCoef = std::pow(releaseCoef, fraction);
+        }
+
+        // 1. Détecteur de crête à attaque instantanée et décroissance exponentielle.
+        const float peak = filterSidechain(in + offset, sidechain, n);
+        envelope_ = std::max(peak, envelope_ * envelopeDecay);
+
+        // 2. Hystérésis et maintien.
+        if (envelope_ >= openThreshold_) {
+            isOpen_ = true;
+            holdCounter_ = holdSamples_;
+        } else if (isOpen_ && envelope_ < closeThreshold_) {
+            if (holdCounter_ > n) {
+                holdCounter_ -= n;
+            } else {
+                holdCounter_ = 0;
+                isOpen_ = false;
+            }
+        }
+
+        // 3. Lissage du gain vers sa cible (attaque rapide, relâchement lent).
+        const float target = isOpen_ ? 1.0f : 0.0f;
+        const float coef = (target > gain_) ? attackCoef : releaseCoef;
+        const float previousGain = gain_;
+        gain_ = target + (gain_ - target) * coef;
+        if (!isOpen_ && gain_ < kClosedGain) {
+            gain_ = 0.0f; // Évite une queue dénormale et permet de signaler la fermeture complète
+        }
+
+        // 4. Rampe linéaire de previousGain (exclu) à gain_ (dernier échantillon), calculée
+        //    ici une seule fois (multiplication puis addition) pour les deux chemins d'application.
+        const float step = (gain_ - previousGain) / static_cast<float>(n);
+        for (size_t j = 0; j < n; ++j) {
+            const float scaled = step * static_cast<float>(j + 1);
+            gains_[offset + j] = previousGain + scaled;
+        }
+        chunkUnity_ = chunkUnity_ && previousGain == 1.0f && gain_ == 1.0f;
+        chunkClosed_ = chunkClosed_ && previousGain == 0.0f && gain_ == 0.0f;
+    }
+
+    isClosed_ = isClosed_ && chunkClosed_;
+}
+
+void NoiseGate::process(float* buffer, size_t numSamples) {
+    if (numSamples == 0) return;
+
+    FusedStage stage(*this);
+    stage.begin();
+    for (size_t offset = 0; offset < numSamples; offset += kMaxAnalysisBlock) {
+        const size_t n = std::min(kMaxAnalysisBlock, numSamples - offset);
+        float* x = buffer + offset;
+        analyze(x, n);
+
+        if (chunkUnity_) {
+            continue; // Gain unitaire : rien à faire
+        } else if (chunkClosed_) {
+            std::fill(x, x + n, 0.0f);
+        } else {
+            fused::applyChunk(x, n, stage);
+        }
+    }
+}
+
+} // namespace rvc
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/elementwise.h"
+#include "dsp/simd.h"
+#include <stddef.h>
+
+namespace rvc {
+
+/**
+ * Noise Gate à suivi d'enveloppe (V15.1).
+ * Hystérésis ouverture/fermeture, temps d'attaque/maintien/relâchement et filtrage
+ * passe-bande du signal de détection (sidechain), pour ne plus couper les formes d'onde
+ * au milieu d'une période comme le faisait l'ancien seuil par échantillon.
+ */
+class NoiseGate : public AudioProcessor {
+public:
+    struct Settings {
+        float openThresholdDb = -45.0f;  // L'enveloppe doit dépasser ce seuil pour ouvrir
+        float closeThresholdDb = -52.0f; // ...et passer sous celui-ci pour refermer (hystérésis)
+        float attackMs = 1.0f;
+        float holdMs = 60.0f;
+        float releaseMs = 80.0f;
+        float sidechainLowHz = 100.0f;   // Coupe le ronflement et les chocs de manipulation
+        float sidechainHighHz = 6000.0f; // Ignore le souffle haute fréquence
+    };
+
+    explicit NoiseGate(int sampleRate);
+    NoiseGate(int sampleRate, const Settings& settings);
+
+    void setSettings(const Settings& settings);
+
+    void process(float* buffer, size_t numSamples) override;
+
+    // Paramètres publiés par NodeParameters (voir ParameterInfo).
+    size_t numParameters() const override;
+    const ParameterInfo* parameterInfo() const override;
+    void setParameters(const float* values) override;
+    size_t primingSamples() const override { return 1024; }
+    size_t tailSamples() const override { return tailSamples_; }
+
+    // Vrai si le dernier bloc traité était entièrement fermé (sortie nulle) :
+    // les étapes en aval (DNS, inférence) peuvent alors sauter leur travail.
+    bool isClosed() const { return isClosed_; }
+
+    // Taille des sous-blocs sur lesquels l'enveloppe et la rampe de gain sont évaluées.
+    static constexpr size_t kSubBlock = 32;
+    // Plus grande tranche analysée d'un coup (une tranche de chaîne fusionnée).
+    static constexpr size_t kMaxAnalysisBlock = fused::kChunkSize;
+    static_assert(kMaxAnalysisBlock % kSubBlock == 0, "les tranches doivent suivre les sous-blocs");
+
+    /**
+     * Le gate comme premier étage d'une chaîne fusionnée (voir fused::run) : la détection
+     * lit la tranche d'entrée dans prepare(), le gain est ensuite appliqué élément par élément.
+     */
+    struct FusedStage : fused::Stage {
+        static constexpr bool kReadsInput = true;
+        NoiseGate& gate;
+
+        explicit FusedStage(NoiseGate& g) : gate(g) {}
+        void begin() { gate.isClosed_ = true; }
+        void prepare(const float* in, size_t n) { gate.analyze(in, n); }
+        simd::float4 apply(simd::float4 x, size_t i) const { return x * gate.gainAt(i); }
+        float apply(float x, size_t i) const { return x * gate.gainAtSample(i); }
+    };
+
+private:
+    // Détection seule sur une tranche (n <= kMaxAnalysisBlock) : fixe la rampe de gain de
+    // chaque sous-bloc sans modifier le signal.
+    void analyze(const float* in, size_t n);
+
+    // Gain de l'échantillon i de la tranche analysée, lu dans la table remplie par analyze() :
+    // chemins vectoriel et scalaire identiques au bit près, quelles que soient les options de
+    // l'unité de compilation qui instancie ces fonctions inline (contraction en FMA comprise).
+    float gainAtSample(size_t i) const { return gains_[i]; }
+    // Gains des échantillons i..i+3.
+    simd::float4 gainAt(size_t i) const { return simd::load(gains_ + i); }
+
+    void updateCoefficients();
+    float filterSidechain(const float* in, float* out, size_t n);
+
+    int sampleRate_;
+    Settings settings_;
+
+    // Coefficients dérivés (par sous-bloc)
+    float openThreshold_ = 0.0f;
+    float closeThreshold_ = 0.0f;
+    float envelopeDecay_ = 0.0f;
+    float attackCoef_ = 0.0f;
+    float releaseCoef_ = 0.0f;
+    size_t holdSamples_ = 0;
+    size_t tailSamples_ = 0; // Maintien + relâchement + décroissance du détecteur
+    float hpCoef_ = 0.0f;
+    float lpCoef_ = 0.0f;
+
+    // État
+    float hpPrevIn_ = 0.0f;
+    float hpPrevOut_ = 0.0f;
+    float lpState_ = 0.0f;
+    float envelope_ = 0.0f;
+    float gain_ = 0.0f;
+    size_t holdCounter_ = 0;
+    bool isOpen_ = false;
+    bool isClosed_ = true;
+
+    // Gains de la dernière tranche analysée : rampe linéaire par sous-bloc
+    alignas(16) float gains_[kMaxAnalysisBlock] = {};
+    bool chunkUnity_ = false;  // Gain 1 sur toute la tranche
+    bool chunkClosed_ = false; // Gain 0 sur toute la tranche
+};
+
+} // namespace rvc
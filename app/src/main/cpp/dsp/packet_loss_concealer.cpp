@@ -0,0 +1,179 @@
+#include "dsp/packet_loss_concealer.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+constexpr float kMinF0Hz = 50.0f;
+constexpr float kMaxF0Hz = 400.0f;
+constexpr size_t kMaxVoicedAgeHops = 2;   // F0 voisée au plus 20 ms avant la perte
+constexpr float kHoldMs = 10.0f;          // Gain plein pendant les 10 premières ms de perte
+constexpr float kVoicedFadeMs = 60.0f;    // Puis -60 dB en 60ms (segment voisé)
+constexpr float kUnvoicedFadeMs = 20.0f;  // ...ou en 20ms (bruit, consonnes)
+constexpr float kCrossfadeMs = 5.0f;
+constexpr float kMuteGain = 1e-3f;
+
+size_t msToSamples(float ms, int sampleRate) {
+    return static_cast<size_t>(ms * 0.001f * static_cast<float>(sampleRate));
+}
+
+float decayPerSample(float fadeMs, int sampleRate) {
+    return std::exp(-6.9078f / std::max(1.0f, fadeMs * 0.001f * static_cast<float>(sampleRate)));
+}
+
+PitchTracker::Settings pitchSettings() {
+    PitchTracker::Settings settings;
+    settings.minF0Hz = kMinF0Hz;
+    settings.maxF0Hz = kMaxF0Hz;
+    return settings;
+}
+
+} // namespace
+
+PacketLossConcealer::PacketLossConcealer(int sampleRate)
+    : sampleRate_(sampleRate),
+      minPeriod_(static_cast<size_t>(static_cast<float>(sampleRate) / kMaxF0Hz)),
+      maxPeriod_(static_cast<size_t>(static_cast<float>(sampleRate) / kMinF0Hz)),
+      holdSamples_(msToSamples(kHoldMs, sampleRate)),
+      voicedDecay_(decayPerSample(kVoicedFadeMs, sampleRate)),
+      unvoicedDecay_(decayPerSample(kUnvoicedFadeMs, sampleRate)),
+      crossfadeSamples_(std::max<size_t>(1, msToSamples(kCrossfadeMs, sampleRate))),
+      pitchTracker_(sampleRate, pitchSettings()) {
+    // Historique : segment de synthèse (une période max + recouvrement), avec marge.
+    history_.assign(maxPeriod_ * 2, 0.0f);
+    // Tous les buffers sont alloués ici : aucune allocation dans le thread audio.
+    segment_.assign(history_.size(), 0.0f);
+    fadeIn_.assign(maxPeriod_ / 4 + 1, 0.0f);
+}
+
+void PacketLossConcealer::pushHistory(const float* buffer, size_t numSamples) {
+    const size_t size = history_.size();
+    if (numSamples >= size) {
+        std::copy(buffer + numSamples - size, buffer + numSamples, history_.begin());
+        historyWrite_ = 0;
+        historyFilled_ = size;
+        return;
+    }
+    const size_t first = std::min(numSamples, size - historyWrite_);
+    std::copy(buffer, buffer + first, history_.begin() + historyWrite_);
+    std::copy(buffer + first, buffer + numSamples, history_.begin());
+    historyWrite_ = (historyWrite_ + numSamples) % size;
+    historyFilled_ = std::min(size, historyFilled_ + numSamples);
+}
+
+/**
+ * Période issue du suivi de F0 (déjà à jour au moment de la perte : aucune recherche dans
+ * le callback), puis préparation du segment (période + recouvrement) à répéter.
+ */
+void PacketLossConcealer::startConcealment() {
+    const size_t size = history_.size();
+    const size_t n = historyFilled_;
+
+    // 1. Linéarisation de l'historique (du plus ancien au plus récent) dans segment_.
+    float* linear = segment_.data();
+    const size_t start = (historyWrite_ + size - n) % size;
+    for (size_t i = 0; i < n; ++i) {
+        linear[i] = history_[(start + i) % size];
+    }
+
+    // 2. Période : dernière F0 voisée du suivi en flux, si elle est récente.
+    period_ = maxPeriod_ / 2;
+    isVoiced_ = false;
+    const float f0 = pitchTracker_.lastVoicedF0();
+    if (f0 > 0.0f && pitchTracker_.hopsSinceVoiced() <= kMaxVoicedAgeHops) {
+        const size_t period = static_cast<size_t>(static_cast<float>(sampleRate_) / f0 + 0.5f);
+        period_ = std::clamp(period, minPeriod_, maxPeriod_);
+        isVoiced_ = true;
+    }
+
+    // 3. Segment de synthèse : h[N-P-L .. N-1], recouvrement L = P/4.
+    overlap_ = std::max<size_t>(1, period_ / 4);
+    const size_t segmentLength = period_ + overlap_;
+    if (n >= segmentLength) {
+        std::copy(linear + n - segmentLength, linear + n, segment_.begin());
+        gain_ = 1.0f;
+    } else {
+        gain_ = 0.0f; // Pas assez d'historique (démarrage) : silence
+    }
+    for (size_t j = 0; j < overlap_; ++j) {
+        const float s = std::sin(0.5f * static_cast<float>(M_PI) * (static_cast<float>(j) + 0.5f) / static_cast<float>(overlap_));
+        fadeIn_[j] = s * s;
+    }
+
+    synthPosition_ = 0;
+    isConcealing_ = true;
+}
+
+/**
+ * Répétition de période par OLA : des trames de longueur P+L sont posées toutes les P
+ * échantillons, la trame 0 commençant L échantillons avant la perte pour prolonger
+ * exactement le dernier échantillon réel.
+ */
+float PacketLossConcealer::synthesizeSample() {
+    const size_t t = synthPosition_ + overlap_;
+    const size_t j = t % period_;
+    float out = segment_[j];
+    if (j < overlap_ && t >= period_) {
+        const float w = fadeIn_[j];
+        out = w * out + (1.0f - w) * segment_[j + period_];
+    }
+    out *= gain_;
+
+    ++synthPosition_;
+    if (synthPosition_ > holdSamples_) {
+        gain_ *= isVoiced_ ? voicedDecay_ : unvoicedDecay_;
+        if (gain_ < kMuteGain) gain_ = 0.0f;
+    }
+    return out;
+}
+
+void PacketLossConcealer::conceal(float* buffer, size_t numSamples) {
+    if (!isConcealing_) {
+        startConcealment();
+    }
+    if (gain_ == 0.0f) {
+        std::fill(buffer, buffer + numSamples, 0.0f);
+        return;
+    }
+    for (size_t i = 0; i < numSamples; ++i) {
+        buffer[i] = synthesizeSample();
+    }
+}
+
+/**
+ * Fondu enchaîné à puissance constante de la synthèse vers le signal réel.
+ */
+void PacketLossConcealer::crossfadeToReal(float* buffer, size_t numSamples) {
+    const size_t fade = std::min(numSamples, crossfadeSamples_);
+    if (gain_ > 0.0f) {
+        for (size_t i = 0; i < fade; ++i) {
+            const float phase = 0.5f * static_cast<float>(M_PI) * (static_cast<float>(i) + 0.5f) / static_cast<float>(fade);
+            buffer[i] = buffer[i] * std::sin(phase) + synthesizeSample() * std::cos(phase);
+        }
+    } else {
+        // La synthèse était déjà muette : simple rampe d'entrée du signal réel.
+        simd::applyGainRamp(buffer, fade, 0.0f, 1.0f);
+    }
+    isConcealing_ = false;
+}
+
+void PacketLossConcealer::process(float* buffer, size_t numSamples) {
+    if (numSamples == 0) return;
+
+    if (isActive) {
+        // Le contenu du buffer (inférence en retard ou invalide) est remplacé.
+        conceal(buffer, numSamples);
+        return;
+    }
+
+    if (isConcealing_) {
+        crossfadeToReal(buffer, numSamples);
+    }
+    pushHistory(buffer, numSamples);
+    pitchTracker_.process(buffer, numSamples);
+}
+
+} // namespace rvc
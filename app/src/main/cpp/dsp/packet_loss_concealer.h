@@ -0,0 +1,67 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/pitch_tracker.h"
+#include <stddef.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Algorithme de Compensation de Perte de Paquets (PLC - Packet Loss Concealment), V12.1.
+ *
+ * Tant que le PLC est inactif, la sortie réelle du RVC est mémorisée dans un historique
+ * circulaire court et suivie par un PitchTracker (V16.0). Lorsqu'une perte est signalée
+ * (activate()), la dernière période voisée est répétée par recouvrement-addition (OLA) à
+ * la période de la dernière F0 voisée, avec une atténuation progressive au fil des pertes
+ * consécutives. Au retour du signal réel (deactivate()), un fondu enchaîné masque la
+ * transition.
+ */
+class PacketLossConcealer : public AudioProcessor {
+public:
+    explicit PacketLossConcealer(int sampleRate);
+
+    void process(float* buffer, size_t numSamples) override;
+    void activate() { isActive = true; }
+    void deactivate() { isActive = false; }
+
+    // Dernière période de pitch détectée (en échantillons), 0 si le segment était non voisé.
+    size_t lastPitchPeriod() const { return isVoiced_ ? period_ : 0; }
+
+private:
+    void pushHistory(const float* buffer, size_t numSamples);
+    void startConcealment();
+    float synthesizeSample();
+    void conceal(float* buffer, size_t numSamples);
+    void crossfadeToReal(float* buffer, size_t numSamples);
+
+    bool isActive = false;
+    int sampleRate_;
+
+    // Historique circulaire de la sortie réelle
+    std::vector<float> history_;
+    size_t historyWrite_ = 0;
+    size_t historyFilled_ = 0;
+
+    // Segment de synthèse (période + recouvrement), linéarisé au début de chaque perte
+    std::vector<float> segment_;
+    std::vector<float> fadeIn_; // Fenêtre de recouvrement (demi-Hann croissante)
+    size_t minPeriod_;
+    size_t maxPeriod_;
+    size_t period_ = 0;
+    size_t overlap_ = 0;
+    bool isVoiced_ = false;
+
+    // État de la synthèse
+    bool isConcealing_ = false;
+    size_t synthPosition_ = 0; // Échantillons synthétisés depuis le début de la perte
+    float gain_ = 1.0f;
+    size_t holdSamples_;      // Durée à gain plein avant l'atténuation
+    float voicedDecay_;       // Atténuation par échantillon (segment voisé)
+    float unvoicedDecay_;     // Atténuation plus rapide pour un segment non voisé
+    size_t crossfadeSamples_; // Durée du fondu au retour du signal réel
+
+    PitchTracker pitchTracker_; // Alimenté par la sortie réelle uniquement
+};
+
+} // namespace rvc
@@ -0,0 +1,258 @@
+#include "dsp/parametric_eq.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace rvc {
+
+namespace {
+
+constexpr float kSmoothingMs = 20.0f;
+constexpr float kConvergence = 1e-5f; // Au-delà, le pas de lissage tombe sous la résolution du float
+
+// Paramètres par bande : type, fréquence, gain, Q, activation. Le lissage des coefficients
+// est fait par le nœud lui-même (aucun lissage côté graphe).
+constexpr size_t kParametersPerBand = 5;
+constexpr size_t kNumParameters = ParametricEQ::kMaxBands * kParametersPerBand;
+
+struct ParameterTable {
+    std::string names[kNumParameters];
+    ParameterInfo info[kNumParameters];
+
+    ParameterTable() {
+        const ParametricEQ::Band defaults;
+        for (size_t b = 0; b < ParametricEQ::kMaxBands; ++b) {
+            const std::string prefix = "band" + std::to_string(b) + "_";
+            const size_t i = b * kParametersPerBand;
+            names[i] = prefix + "type";
+            names[i + 1] = prefix + "freq";
+            names[i + 2] = prefix + "gain";
+            names[i + 3] = prefix + "q";
+            names[i + 4] = prefix + "enabled";
+            info[i] = {names[i].c_str(), 0.0f, static_cast<float>(BiquadType::Notch),
+                       static_cast<float>(defaults.type), 0.0f};
+            info[i + 1] = {names[i + 1].c_str(), 20.0f, 20000.0f, defaults.frequencyHz, 0.0f};
+            info[i + 2] = {names[i + 2].c_str(), -24.0f, 24.0f, defaults.gainDb, 0.0f};
+            info[i + 3] = {names[i + 3].c_str(), 0.1f, 20.0f, defaults.q, 0.0f};
+            info[i + 4] = {names[i + 4].c_str(), 0.0f, 1.0f, defaults.enabled ? 1.0f : 0.0f, 0.0f};
+        }
+    }
+};
+
+const ParameterTable& parameterTable() {
+    static const ParameterTable table;
+    return table;
+}
+
+} // namespace
+
+ParametricEQ::ParametricEQ(int sampleRate) : sampleRate_(sampleRate) {
+    // Tous les étages démarrent à l'identité (b0 = 1).
+    for (size_t s = 0; s < kStages; ++s) {
+        target_.b0[s] = 1.0f;
+        target_.b1[s] = target_.b2[s] = target_.a1[s] = target_.a2[s] = 0.0f;
+    }
+    current_ = target_;
+    smoothingCoef_ = 1.0f - std::exp(-static_cast<float>(kSmoothingInterval) /
+                                     (kSmoothingMs * 0.001f * static_cast<float>(sampleRate)));
+}
+
+void ParametricEQ::setBand(size_t index, const Band& band) {
+    if (index >= kMaxBands) return;
+    bands_[index] = band;
+    computeTarget(index, band);
+    isSmoothing_ = true;
+    updateActiveStages();
+    updateTail();
+}
+
+void ParametricEQ::disableAllBands() {
+    for (size_t i = 0; i < kMaxBands; ++i) {
+        bands_[i].enabled = false;
+        computeTarget(i, bands_[i]);
+    }
+    isSmoothing_ = true;
+    updateActiveStages();
+    updateTail();
+}
+
+/**
+ * Traîne de la bande la plus résonante : constante de temps d'un pôle de facteur Q à f,
+ * τ = Q / (π f), et 14 τ pour descendre de -120 dB. Au moins 50 ms (lissage des coefficients).
+ */
+void ParametricEQ::updateTail() {
+    float tailSeconds = 0.05f;
+    for (const Band& band : bands_) {
+        if (!band.enabled) continue;
+        const float tau = std::max(band.q, 0.5f) / (static_cast<float>(M_PI) * std::max(band.frequencyHz, 20.0f));
+        tailSeconds = std::max(tailSeconds, 14.0f * tau);
+    }
+    tailSamples_ = static_cast<size_t>(tailSeconds * static_cast<float>(sampleRate_));
+}
+
+size_t ParametricEQ::numParameters() const {
+    return kNumParameters;
+}
+
+const ParameterInfo* ParametricEQ::parameterInfo() const {
+    return parameterTable().info;
+}
+
+void ParametricEQ::setParameters(const float* values) {
+    for (size_t b = 0; b < kMaxBands; ++b) {
+        const float* v = values + b * kParametersPerBand;
+        Band band;
+        band.type = static_cast<BandType>(std::lround(v[0]));
+        band.frequencyHz = v[1];
+        band.gainDb = v[2];
+        band.q = v[3];
+        band.enabled = v[4] >= 0.5f;
+        const Band& current = bands_[b];
+        if (band.type != current.type || band.frequencyHz != current.frequencyHz ||
+            band.gainDb != current.gainDb || band.q != current.q || band.enabled != current.enabled) {
+            setBand(b, band);
+        }
+    }
+}
+
+void ParametricEQ::computeTarget(size_t stage, const Band& band) {
+    BiquadCoefficients c; // Identité pour une bande désactivée
+    if (band.enabled) {
+        c = designBiquad(band.type, sampleRate_, band.frequencyHz, band.gainDb, band.q);
+    }
+    target_.b0[stage] = c.b0;
+    target_.b1[stage] = c.b1;
+    target_.b2[stage] = c.b2;
+    target_.a1[stage] = c.a1;
+    target_.a2[stage] = c.a2;
+}
+
+/**
+ * Un pas de lissage exponentiel des coefficients vers leur cible.
+ * Retourne vrai tant que la convergence n'est pas atteinte.
+ */
+bool ParametricEQ::smoothCoefficients() {
+    float* cur[] = {current_.b0, current_.b1, current_.b2, current_.a1, current_.a2};
+    const float* tgt[] = {target_.b0, target_.b1, target_.b2, target_.a1, target_.a2};
+    const simd::float4 k = simd::set1(smoothingCoef_);
+    float maxDelta = 0.0f;
+
+    for (size_t c = 0; c < 5; ++c) {
+        for (size_t s = 0; s < kStages; s += kLanes) {
+            const simd::float4 t = simd::load(tgt[c] + s);
+            const simd::float4 x = simd::load(cur[c] + s);
+            const simd::float4 delta = t - x;
+            maxDelta = std::max(maxDelta, simd::hmax(simd::abs(delta)));
+            simd::store(cur[c] + s, simd::madd(delta, k, x));
+        }
+    }
+
+    if (maxDelta < kConvergence) {
+        current_ = target_;
+        return false;
+    }
+    return true;
+}
+
+void ParametricEQ::updateActiveStages() {
+    // Une bande désactivée reste exécutée tant que ses coefficients rejoignent l'identité.
+    size_t lastStage = 0;
+    for (size_t s = 0; s < kMaxBands; ++s) {
+        const bool identity = target_.b0[s] == 1.0f && current_.b0[s] == 1.0f &&
+                              target_.b1[s] == 0.0f && current_.b1[s] == 0.0f &&
+                              target_.b2[s] == 0.0f && current_.b2[s] == 0.0f &&
+                              target_.a1[s] == 0.0f && current_.a1[s] == 0.0f &&
+                              target_.a2[s] == 0.0f && current_.a2[s] == 0.0f;
+        if (!identity) lastStage = s + 1;
+    }
+    const size_t stages = (lastStage + kLanes - 1) / kLanes * kLanes;
+    // Les étages qui quittent la cascade repartent d'un état nul s'ils sont réactivés.
+    for (size_t s = stages; s < activeStages_; ++s) {
+        z1_[s] = z2_[s] = 0.0f;
+    }
+    activeStages_ = stages;
+}
+
+void ParametricEQ::process(float* buffer, size_t numSamples) {
+    if (activeStages_ == 0 || numSamples == 0) return;
+
+    using simd::float4;
+    const size_t groups = activeStages_ / kLanes;
+    const size_t latency = activeStages_ - 1; // Décalage entre la première et la dernière voie
+    const size_t totalSteps = numSamples + latency;
+
+    float4 b0[kGroups], b1[kGroups], b2[kGroups], a1[kGroups], a2[kGroups];
+    float4 z1[kGroups], z2[kGroups], y[kGroups], lane[kGroups];
+    for (size_t g = 0; g < groups; ++g) {
+        z1[g] = simd::load(z1_ + g * kLanes);
+        z2[g] = simd::load(z2_ + g * kLanes);
+        y[g] = simd::set1(0.0f);
+        lane[g] = simd::set(g * kLanes + 0.0f, g * kLanes + 1.0f, g * kLanes + 2.0f, g * kLanes + 3.0f);
+    }
+
+    const float4 zero = simd::set1(0.0f);
+    const float4 one = simd::set1(1.0f);
+
+    for (size_t step = 0; step < totalSteps; ++step) {
+        if (step % kSmoothingInterval == 0) {
+            if (isSmoothing_) {
+                isSmoothing_ = smoothCoefficients();
+            }
+            for (size_t g = 0; g < groups; ++g) {
+                b0[g] = simd::load(current_.b0 + g * kLanes);
+                b1[g] = simd::load(current_.b1 + g * kLanes);
+                b2[g] = simd::load(current_.b2 + g * kLanes);
+                a1[g] = simd::load(current_.a1 + g * kLanes);
+                a2[g] = simd::load(current_.a2 + g * kLanes);
+            }
+        }
+
+        // Entrées du front d'onde : l'échantillon courant en voie 0, puis la sortie
+        // de chaque voie décalée d'un cran (y compris d'un groupe au suivant).
+        const float x = (step < numSamples) ? buffer[step] : 0.0f;
+        float4 in[kGroups];
+        in[0] = simd::shiftIn(simd::set1(x), y[0]);
+        for (size_t g = 1; g < groups; ++g) {
+            in[g] = simd::shiftIn(y[g - 1], y[g]);
+        }
+
+        // Voies valides : étage k actif si l'échantillon n-k existe dans ce bloc.
+        const bool partial = step < latency || step >= numSamples;
+        const float4 firstValid = simd::set1(static_cast<float>(step) - static_cast<float>(numSamples) + 1.0f);
+        const float4 lastValid = simd::set1(static_cast<float>(step));
+
+        for (size_t g = 0; g < groups; ++g) {
+            const float4 out = in[g] * b0[g] + z1[g];
+            const float4 nz1 = in[g] * b1[g] - out * a1[g] + z2[g];
+            const float4 nz2 = in[g] * b2[g] - out * a2[g];
+            if (partial) {
+                // m = 1 pour les voies valides, 0 sinon (leur état ne doit pas avancer).
+                const float4 m = simd::min(simd::max(lastValid - lane[g] + one, zero), one) *
+                                 simd::min(simd::max(lane[g] - firstValid + one, zero), one);
+                const float4 keep = one - m;
+                z1[g] = nz1 * m + z1[g] * keep;
+                z2[g] = nz2 * m + z2[g] * keep;
+            } else {
+                z1[g] = nz1;
+                z2[g] = nz2;
+            }
+            y[g] = out;
+        }
+
+        if (step >= latency) {
+            buffer[step - latency] = simd::lastLane(y[groups - 1]);
+        }
+    }
+
+    for (size_t g = 0; g < groups; ++g) {
+        simd::store(z1_ + g * kLanes, z1[g]);
+        simd::store(z2_ + g * kLanes, z2[g]);
+    }
+
+    if (!isSmoothing_) {
+        updateActiveStages();
+    }
+}
+
+} // namespace rvc
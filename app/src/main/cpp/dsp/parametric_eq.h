@@ -0,0 +1,83 @@
+#pragma once
+
+#include "dsp/audio_processor.h"
+#include "dsp/biquad.h"
+#include <stddef.h>
+
+namespace rvc {
+
+/**
+ * Égaliseur paramétrique utilisateur (jusqu'à 10 bandes), étape finale du post-traitement.
+ *
+ * Les biquads de la cascade sont répartis sur les voies SIMD et exécutés en "front d'onde" :
+ * à chaque pas, la voie k filtre l'échantillon n-k avec la sortie de la voie k-1 du pas
+ * précédent. Toute la cascade avance donc en une seule passe vectorisée ; les phases de
+ * remplissage et de vidange sont masquées pour ne pas introduire de latence.
+ */
+class ParametricEQ : public AudioProcessor {
+public:
+    static constexpr size_t kMaxBands = 10;
+
+    using BandType = BiquadType;
+
+    struct Band {
+        BandType type = BandType::Peaking;
+        float frequencyHz = 1000.0f;
+        float gainDb = 0.0f;
+        float q = 0.707f;
+        bool enabled = false;
+    };
+
+    explicit ParametricEQ(int sampleRate);
+
+    // Les nouveaux coefficients sont rejoints progressivement (pas de clic ni d'effet "zipper").
+    void setBand(size_t index, const Band& band);
+    void disableAllBands();
+
+    void process(float* buffer, size_t numSamples) override;
+
+    // Paramètres publiés par NodeParameters (voir ParameterInfo).
+    size_t numParameters() const override;
+    const ParameterInfo* parameterInfo() const override;
+    void setParameters(const float* values) override;
+    size_t primingSamples() const override { return 1024; }
+    size_t tailSamples() const override { return tailSamples_; }
+
+    // Vrai si aucune bande n'est active et que le lissage est terminé (nœud transparent).
+    bool isBypassed() const { return activeStages_ == 0; }
+
+private:
+    static constexpr size_t kLanes = 4;
+    static constexpr size_t kGroups = (kMaxBands + kLanes - 1) / kLanes;
+    static constexpr size_t kStages = kGroups * kLanes;
+    static constexpr size_t kSmoothingInterval = 32; // Échantillons entre deux pas de lissage
+
+    // Coefficients normalisés (a0 = 1), une entrée par étage de la cascade.
+    struct Coefficients {
+        float b0[kStages];
+        float b1[kStages];
+        float b2[kStages];
+        float a1[kStages];
+        float a2[kStages];
+    };
+
+    void computeTarget(size_t stage, const Band& band);
+    bool smoothCoefficients();
+    void updateActiveStages();
+    void updateTail();
+
+    int sampleRate_;
+    Band bands_[kMaxBands];
+    Coefficients target_;
+    Coefficients current_;
+    float smoothingCoef_;
+    bool isSmoothing_ = false;
+    size_t activeStages_ = 0; // Multiple de kLanes (groupes SIMD effectivement exécutés)
+    size_t tailSamples_ = 0;
+
+    // État TDF-II de chaque étage
+    float z1_[kStages] = {};
+    float z2_[kStages] = {};
+};
+
+} // namespace rvc
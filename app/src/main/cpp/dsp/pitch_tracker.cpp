@@ -0,0 +1,209 @@
+#include "dsp/pitch_tracker.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+constexpr float kBetaShape = 18.0f;      // Seuils ~ Beta(2, 18) : moyenne 0.1 (pYIN)
+constexpr size_t kMaxCandidates = 8;
+constexpr size_t kContinuityHops = 3;    // F0 précédente prise en compte pendant 30 ms
+constexpr float kContinuityOctaves = 0.25f;
+constexpr float kContinuityFloor = 0.3f; // Une preuve forte peut toujours sauter d'octave
+
+size_t nextPowerOfTwo(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Fonction de répartition de Beta(2, b) : 1 - (1 - s)^b (1 + b s).
+float thresholdCdf(float s) {
+    if (s <= 0.0f) return 0.0f;
+    if (s >= 1.0f) return 1.0f;
+    return 1.0f - std::pow(1.0f - s, kBetaShape) * (1.0f + kBetaShape * s);
+}
+
+} // namespace
+
+PitchTracker::PitchTracker(int sampleRate) : PitchTracker(sampleRate, Settings()) {}
+
+PitchTracker::PitchTracker(int sampleRate, const Settings& settings)
+    : sampleRate_(sampleRate),
+      analysisRate_(std::min(sampleRate, kAnalysisRate)),
+      settings_(settings),
+      decimator_(sampleRate, analysisRate_, PolyphaseResampler::Quality::Low),
+      minLag_(std::max<size_t>(2, static_cast<size_t>(analysisRate_ / settings.maxF0Hz))),
+      maxLag_(static_cast<size_t>(std::ceil(analysisRate_ / settings.minF0Hz))),
+      window_(maxLag_),
+      frameSize_(window_ + maxLag_ + 1),
+      hop_(std::max<size_t>(1, static_cast<size_t>(settings.hopMs * 0.001f * analysisRate_ + 0.5f))),
+      fft_(nextPowerOfTwo(frameSize_)) {
+    decimated_.assign(decimator_.maxOutputSamples(PolyphaseResampler::kChunk), 0.0f);
+    frame_.assign(frameSize_ + hop_, 0.0f);
+    padded_.assign(fft_.size(), 0.0f);
+    windowSpectrum_.resize(fft_.numBins());
+    frameSpectrum_.resize(fft_.numBins());
+    correlation_.assign(fft_.size(), 0.0f);
+    energy_.assign(maxLag_ + 2, 0.0f);
+    difference_.assign(maxLag_ + 2, 0.0f);
+    silenceEnergy_ = static_cast<float>(window_) * std::pow(10.0f, settings.silenceDb / 10.0f);
+}
+
+size_t PitchTracker::hopSamples() const {
+    return static_cast<size_t>(static_cast<double>(hop_) * sampleRate_ / analysisRate_ + 0.5);
+}
+
+size_t PitchTracker::latencySamples() const {
+    const double frameCenter = 0.5 * static_cast<double>(frameSize_) / analysisRate_;
+    return static_cast<size_t>((decimator_.latencySeconds() + frameCenter) * sampleRate_ + 0.5);
+}
+
+void PitchTracker::reset() {
+    decimator_.reset();
+    std::fill(frame_.begin(), frame_.end(), 0.0f);
+    hopFill_ = 0;
+    frameFill_ = 0;
+    latest_ = Estimate();
+    lastVoicedF0_ = 0.0f;
+    hopsSinceVoiced_ = 0;
+}
+
+size_t PitchTracker::process(const float* in, size_t numSamples, Estimate* estimates, size_t maxEstimates) {
+    size_t produced = 0;
+    for (size_t done = 0; done < numSamples;) {
+        const size_t len = std::min(PolyphaseResampler::kChunk, numSamples - done);
+        const size_t count = decimator_.process(in + done, len, decimated_.data());
+        pushAnalysis(decimated_.data(), count, estimates, maxEstimates, produced);
+        done += len;
+    }
+    return produced;
+}
+
+void PitchTracker::pushAnalysis(const float* samples, size_t count, Estimate* estimates, size_t maxEstimates,
+                                size_t& produced) {
+    while (count > 0) {
+        const size_t take = std::min(hop_ - hopFill_, count);
+        std::copy(samples, samples + take, frame_.data() + frameSize_ + hopFill_);
+        samples += take;
+        count -= take;
+        hopFill_ += take;
+        if (hopFill_ < hop_) break;
+
+        // Pas complet : la trame avance de hop_ échantillons.
+        std::copy(frame_.begin() + hop_, frame_.end(), frame_.begin());
+        hopFill_ = 0;
+        frameFill_ = std::min(frameSize_, frameFill_ + hop_);
+
+        latest_ = frameFill_ == frameSize_ ? analyze() : Estimate();
+        if (latest_.voiced) {
+            lastVoicedF0_ = latest_.f0Hz;
+            hopsSinceVoiced_ = 0;
+        } else if (lastVoicedF0_ > 0.0f) {
+            ++hopsSinceVoiced_;
+        }
+        if (estimates != nullptr && produced < maxEstimates) {
+            estimates[produced] = latest_;
+        }
+        ++produced;
+    }
+}
+
+PitchTracker::Estimate PitchTracker::analyze() {
+    const float* x = frame_.data();
+    const size_t lastLag = maxLag_ + 1;
+    Estimate estimate;
+
+    // 1. Énergies glissantes e(tau) = somme des x[j]^2, j dans [tau, tau + W).
+    float e = simd::dot(x, x, window_);
+    if (e < silenceEnergy_) return estimate;
+    energy_[0] = e;
+    for (size_t tau = 1; tau <= lastLag; ++tau) {
+        e += x[tau + window_ - 1] * x[tau + window_ - 1] - x[tau - 1] * x[tau - 1];
+        energy_[tau] = std::max(e, 0.0f);
+    }
+
+    // 2. Corrélation croisée fenêtre / trame par FFT : r(tau) = somme x[j] x[j + tau], j < W.
+    std::copy(x, x + window_, padded_.begin());
+    std::fill(padded_.begin() + window_, padded_.end(), 0.0f);
+    fft_.forward(padded_.data(), windowSpectrum_.data());
+    std::copy(x, x + frameSize_, padded_.begin());
+    fft_.forward(padded_.data(), frameSpectrum_.data());
+    for (size_t k = 0; k < frameSpectrum_.size(); ++k) {
+        frameSpectrum_[k] *= std::conj(windowSpectrum_[k]);
+    }
+    fft_.inverse(frameSpectrum_.data(), correlation_.data());
+
+    // 3. Différence d(tau) = e(0) + e(tau) - 2 r(tau), vectorisée.
+    const simd::float4 e0 = simd::set1(energy_[0]);
+    const simd::float4 two = simd::set1(2.0f);
+    size_t tau = 0;
+    for (; tau + simd::kWidth <= lastLag + 1; tau += simd::kWidth) {
+        const simd::float4 d = e0 + simd::load(energy_.data() + tau) - two * simd::load(correlation_.data() + tau);
+        simd::store(difference_.data() + tau, simd::max(d, simd::set1(0.0f)));
+    }
+    for (; tau <= lastLag; ++tau) {
+        difference_[tau] = std::max(energy_[0] + energy_[tau] - 2.0f * correlation_[tau], 0.0f);
+    }
+
+    // 4. Normalisation par la moyenne cumulée (CMND).
+    difference_[0] = 1.0f;
+    float sum = 0.0f;
+    for (tau = 1; tau <= lastLag; ++tau) {
+        sum += difference_[tau];
+        difference_[tau] = sum > 0.0f ? difference_[tau] * static_cast<float>(tau) / sum : 1.0f;
+    }
+
+    // 5. pYIN : masse des seuils attribuée à chaque creux (premier creux sous le seuil).
+    size_t lags[kMaxCandidates];
+    float probabilities[kMaxCandidates];
+    size_t numCandidates = 0;
+    float lowest = 1.0f;
+    for (tau = minLag_; tau <= maxLag_ && numCandidates < kMaxCandidates; ++tau) {
+        const float value = difference_[tau];
+        if (value >= lowest || value >= difference_[tau - 1] || value > difference_[tau + 1]) continue;
+        lags[numCandidates] = tau;
+        probabilities[numCandidates] = thresholdCdf(lowest) - thresholdCdf(value);
+        lowest = value;
+        ++numCandidates;
+    }
+    if (numCandidates == 0) return estimate;
+
+    // 6. Choix du candidat : probabilité, pondérée par la continuité avec la F0 précédente.
+    const bool hasPrevious = lastVoicedF0_ > 0.0f && hopsSinceVoiced_ < kContinuityHops;
+    const float previousLag = hasPrevious ? analysisRate_ / lastVoicedF0_ : 0.0f;
+    float voicing = 0.0f;
+    float bestScore = -1.0f;
+    size_t best = 0;
+    for (size_t c = 0; c < numCandidates; ++c) {
+        voicing += probabilities[c];
+        float score = probabilities[c];
+        if (hasPrevious) {
+            const float octaves = std::log2(static_cast<float>(lags[c]) / previousLag) / kContinuityOctaves;
+            score *= kContinuityFloor + (1.0f - kContinuityFloor) * std::exp(-0.5f * octaves * octaves);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            best = c;
+        }
+    }
+
+    // 7. Interpolation parabolique du creux.
+    const size_t lag = lags[best];
+    const float a = difference_[lag - 1];
+    const float b = difference_[lag];
+    const float c = difference_[lag + 1];
+    const float curvature = a - 2.0f * b + c;
+    const float offset = curvature > 0.0f ? std::clamp(0.5f * (a - c) / curvature, -0.5f, 0.5f) : 0.0f;
+
+    estimate.f0Hz = analysisRate_ / (static_cast<float>(lag) + offset);
+    estimate.voicingProbability = std::min(voicing, 1.0f);
+    estimate.periodicity = std::clamp(1.0f - b, 0.0f, 1.0f);
+    const float threshold = latest_.voiced ? settings_.unvoicedProbability : settings_.voicedProbability;
+    estimate.voiced = estimate.voicingProbability > threshold;
+    return estimate;
+}
+
+} // namespace rvc
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "dsp/fft.h"
+#include "dsp/resampler.h"
+#include <complex>
+#include <stddef.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Suivi de F0 en flux, YIN probabiliste (pYIN) (V16.0).
+ *
+ * Le signal est décimé vers kAnalysisRate (la voix ne dépasse pas 1 kHz de F0), puis une
+ * estimation est produite à chaque pas de ~10 ms sur une trame de deux périodes maximales :
+ *   - fonction de différence de YIN par autocorrélation FFT (corrélation croisée) et
+ *     énergies glissantes, normalisée par sa moyenne cumulée (CMND) ;
+ *   - pYIN : le seuil absolu de YIN suit une loi Beta(2, 18) ; chaque creux de la CMND
+ *     reçoit la masse des seuils pour lesquels il serait le premier retenu. La somme de ces
+ *     masses est la probabilité de voisement ;
+ *   - correction d'octave : retenir le premier creux sous le seuil écarte déjà les
+ *     sous-harmoniques ; entre creux, la continuité avec la F0 précédente départage les
+ *     sauts d'octave isolés ;
+ *   - interpolation parabolique du creux retenu (précision sous-échantillon).
+ */
+class PitchTracker {
+public:
+    static constexpr int kAnalysisRate = 16000;
+
+    struct Settings {
+        float minF0Hz = 50.0f;
+        float maxF0Hz = 1000.0f;
+        float hopMs = 10.0f;
+        float voicedProbability = 0.5f;   // Début de segment voisé...
+        float unvoicedProbability = 0.3f; // ...maintenu jusqu'à passer sous ce seuil
+        float silenceDb = -60.0f;         // Trame plus faible : non voisée sans analyse
+    };
+
+    struct Estimate {
+        float f0Hz = 0.0f;               // Meilleur candidat (0 si aucun creux)
+        float voicingProbability = 0.0f;
+        float periodicity = 0.0f;        // 1 - CMND au creux retenu
+        bool voiced = false;
+    };
+
+    explicit PitchTracker(int sampleRate);
+    PitchTracker(int sampleRate, const Settings& settings);
+
+    // Thread audio. Retourne le nombre de pas terminés pendant ce bloc et écrit leurs
+    // estimations dans estimates (si fourni, au plus maxEstimates).
+    size_t process(const float* in, size_t numSamples, Estimate* estimates = nullptr, size_t maxEstimates = 0);
+
+    const Estimate& latest() const { return latest_; }
+    // Dernière F0 voisée (0 si aucune) et nombre de pas écoulés depuis.
+    float lastVoicedF0() const { return lastVoicedF0_; }
+    size_t hopsSinceVoiced() const { return hopsSinceVoiced_; }
+
+    // Pas entre deux estimations et retard du centre de la trame analysée, en échantillons
+    // à la fréquence d'entrée.
+    size_t hopSamples() const;
+    size_t latencySamples() const;
+
+    void reset();
+
+private:
+    void pushAnalysis(const float* samples, size_t count, Estimate* estimates, size_t maxEstimates, size_t& produced);
+    Estimate analyze();
+
+    int sampleRate_;
+    int analysisRate_;
+    Settings settings_;
+    PolyphaseResampler decimator_;
+    std::vector<float> decimated_;
+
+    size_t minLag_;
+    size_t maxLag_;
+    size_t window_;      // Fenêtre d'intégration de YIN (période maximale)
+    size_t frameSize_;   // window_ + maxLag_ + 1 (interpolation)
+    size_t hop_;
+    std::vector<float> frame_; // Trame d'analyse, échantillon le plus récent en dernier
+    size_t hopFill_ = 0;       // Échantillons reçus depuis la dernière analyse
+    size_t frameFill_ = 0;     // Trame complète après le démarrage
+
+    RealFFT fft_;
+    std::vector<float> padded_;
+    std::vector<std::complex<float>> windowSpectrum_;
+    std::vector<std::complex<float>> frameSpectrum_;
+    std::vector<float> correlation_;
+    std::vector<float> energy_;     // Énergie de la fenêtre décalée de tau
+    std::vector<float> difference_; // d(tau), puis CMND d'(tau)
+
+    float silenceEnergy_;
+    Estimate latest_;
+    float lastVoicedF0_ = 0.0f;
+    size_t hopsSinceVoiced_ = 0;
+};
+
+} // namespace rvc
@@ -0,0 +1,173 @@
+#include "dsp/preset_file.h"
+#include "dsp/crc32.h"
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rvc {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "le format RVCP est petit-boutiste");
+static_assert(sizeof(PresetFile::Header) == 56 && sizeof(PresetFile::ChainRecord) == 24 &&
+                  sizeof(PresetFile::NodeRecord) == 20 && sizeof(PresetFile::ParamRecord) == 8 &&
+                  sizeof(PresetFile::EdgeRecord) == 8,
+              "disposition figée par la version du format (voir PresetWriter.kt)");
+
+namespace {
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+} // namespace
+
+std::unique_ptr<PresetFile> PresetFile::open(const std::string& path, std::string* error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fail(error, "preset introuvable '" + path + "'");
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        fail(error, "preset tronqué '" + path + "'");
+        return nullptr;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // La projection reste valide après la fermeture
+    if (data == MAP_FAILED) {
+        fail(error, "mmap du preset refusé '" + path + "'");
+        return nullptr;
+    }
+
+    std::unique_ptr<PresetFile> preset(new PresetFile());
+    preset->data_ = data;
+    preset->size_ = size;
+    preset->isMapped_ = true;
+    if (!preset->validate(error)) return nullptr;
+    return preset;
+}
+
+std::unique_ptr<PresetFile> PresetFile::fromBytes(const void* data, size_t size, std::string* error) {
+    if (size < sizeof(Header)) {
+        fail(error, "preset tronqué");
+        return nullptr;
+    }
+    // new[] de uint32_t : alignement des enregistrements garanti.
+    uint32_t* copy = new uint32_t[(size + 3) / 4];
+    std::memcpy(copy, data, size);
+
+    std::unique_ptr<PresetFile> preset(new PresetFile());
+    preset->data_ = copy;
+    preset->size_ = size;
+    if (!preset->validate(error)) return nullptr;
+    return preset;
+}
+
+PresetFile::~PresetFile() {
+    if (isMapped_) {
+        munmap(const_cast<void*>(data_), size_);
+    } else {
+        delete[] static_cast<const uint32_t*>(data_);
+    }
+}
+
+const char* PresetFile::modelPath() const {
+    return header().modelPath == kNoString ? nullptr : string(header().modelPath);
+}
+
+/**
+ * Validation complète à l'ouverture : en-tête et sommes de contrôle, puis bornes et
+ * alignement de chaque tableau d'enregistrements et de chaque référence de chaîne.
+ */
+bool PresetFile::validate(std::string* error) const {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data_);
+    Header header;
+    std::memcpy(&header, bytes, sizeof(Header));
+    if (header.magic != kMagic) return fail(error, "signature RVCP absente");
+    if (header.version != kVersion) {
+        return fail(error, "version de preset " + std::to_string(header.version) + " non supportée");
+    }
+    if (header.headerSize != sizeof(Header) || header.fileSize != size_) {
+        return fail(error, "taille de preset incohérente");
+    }
+
+    const uint32_t headerCrc = header.headerCrc;
+    header.headerCrc = 0;
+    if (crc32(reinterpret_cast<const uint8_t*>(&header), sizeof(Header)) != headerCrc) {
+        return fail(error, "somme de contrôle de l'en-tête invalide");
+    }
+    if (crc32(bytes + sizeof(Header), size_ - sizeof(Header)) != header.payloadCrc) {
+        return fail(error, "somme de contrôle du contenu invalide");
+    }
+
+    // Tableau de count enregistrements de recordSize octets dans le fichier, aligné.
+    auto inBounds = [&](uint32_t offset, uint64_t count, uint64_t recordSize) {
+        return offset % 4 == 0 && offset >= sizeof(Header) &&
+               static_cast<uint64_t>(offset) + count * recordSize <= size_;
+    };
+    if (header.stringsSize == 0 || !inBounds(header.stringsOffset, header.stringsSize, 1) ||
+        bytes[header.stringsOffset + header.stringsSize - 1] != 0) {
+        return fail(error, "table des chaînes invalide");
+    }
+    // Le dernier octet de la table est nul : toute chaîne qui y commence y est terminée.
+    auto validString = [&](uint32_t offset) { return offset < header.stringsSize; };
+
+    if (header.modelPath != kNoString && !validString(header.modelPath)) {
+        return fail(error, "chemin du modèle invalide");
+    }
+    if (!std::isfinite(header.pitchSemitones) || !std::isfinite(header.indexRate)) {
+        return fail(error, "réglages de voix invalides");
+    }
+    if (!inBounds(header.chainsOffset, header.numChains, sizeof(ChainRecord))) {
+        return fail(error, "table des chaînes d'effets hors du fichier");
+    }
+    for (size_t c = 0; c < header.numChains; ++c) {
+        const ChainRecord& chainRecord = chain(c);
+        if (!inBounds(chainRecord.nodesOffset, chainRecord.numNodes, sizeof(NodeRecord)) ||
+            !inBounds(chainRecord.edgesOffset, chainRecord.numEdges, sizeof(EdgeRecord))) {
+            return fail(error, "chaîne d'effets " + std::to_string(c) + " hors du fichier");
+        }
+        for (size_t n = 0; n < chainRecord.numNodes; ++n) {
+            const NodeRecord& nodeRecord = node(chainRecord, n);
+            if (!validString(nodeRecord.id) || !validString(nodeRecord.type) ||
+                !inBounds(nodeRecord.paramsOffset, nodeRecord.numParams, sizeof(ParamRecord))) {
+                return fail(error, "nœud " + std::to_string(n) + " de la chaîne " + std::to_string(c) + " invalide");
+            }
+            for (size_t p = 0; p < nodeRecord.numParams; ++p) {
+                const ParamRecord& paramRecord = param(nodeRecord, p);
+                if (!validString(paramRecord.name) || !std::isfinite(paramRecord.value)) {
+                    return fail(error, std::string("paramètre invalide pour le nœud '") + string(nodeRecord.id) + "'");
+                }
+            }
+        }
+        for (size_t e = 0; e < chainRecord.numEdges; ++e) {
+            const EdgeRecord& edgeRecord = edge(chainRecord, e);
+            if (!validString(edgeRecord.from) || !validString(edgeRecord.to)) {
+                return fail(error, "arête " + std::to_string(e) + " de la chaîne " + std::to_string(c) + " invalide");
+            }
+        }
+    }
+    return true;
+}
+
+GraphDescription PresetFile::description(const ChainRecord& chainRecord) const {
+    GraphDescription description;
+    description.nodes.reserve(chainRecord.numNodes);
+    for (size_t n = 0; n < chainRecord.numNodes; ++n) {
+        const NodeRecord& nodeRecord = node(chainRecord, n);
+        description.nodes.push_back({string(nodeRecord.id), string(nodeRecord.type)});
+    }
+    description.edges.reserve(chainRecord.numEdges);
+    for (size_t e = 0; e < chainRecord.numEdges; ++e) {
+        const EdgeRecord& edgeRecord = edge(chainRecord, e);
+        description.edges.push_back({string(edgeRecord.from), string(edgeRecord.to)});
+    }
+    return description;
+}
+
+} // namespace rvc
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "dsp/audio_graph.h"
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace rvc {
+
+/**
+ * Preset binaire projeté en mémoire (format "RVCP", V16.0).
+ *
+ * Écrit côté application (PresetWriter.kt) à chaque sauvegarde d'un profil ; le moteur le
+ * reçoit par IPC (fromBytes : le fichier est privé à l'application) ou le projette en lecture
+ * seule (open), et lit les enregistrements en place, sans analyse : après
+ * la validation de open() (en-tête, sommes de contrôle, bornes de chaque enregistrement),
+ * les accesseurs ne vérifient plus rien.
+ *
+ * Disposition (petit-boutiste, enregistrements alignés sur 4 octets, décalages absolus sauf
+ * les chaînes, relatives à la table des chaînes) :
+ *   Header         56 octets
+ *   ChainRecord    [numChains]   -> NodeRecord[numNodes] -> ParamRecord[numParams]
+ *                                -> EdgeRecord[numEdges]
+ *   Table des chaînes de caractères (UTF-8, terminées par 0)
+ * headerCrc couvre l'en-tête (champ lui-même à 0), payloadCrc le reste du fichier
+ * (CRC-32 IEEE, identique à java.util.zip.CRC32).
+ */
+class PresetFile {
+public:
+    static constexpr uint32_t kMagic = 0x50435652; // "RVCP"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint32_t kNoString = 0xFFFFFFFFu;
+
+    enum Flags : uint32_t {
+        kExcluded = 1u << 0, // Application exclue du traitement RVC
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint32_t fileSize;
+        uint32_t headerCrc;
+        uint32_t payloadCrc;
+        float pitchSemitones;
+        float indexRate;
+        uint32_t flags;
+        uint32_t modelPath; // Chaîne, ou kNoString
+        uint32_t numChains;
+        uint32_t chainsOffset;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+        uint32_t reserved;
+    };
+
+    struct ChainRecord {
+        uint32_t chain; // FXChain
+        uint32_t numNodes;
+        uint32_t nodesOffset;
+        uint32_t numEdges;
+        uint32_t edgesOffset;
+        uint32_t reserved;
+    };
+
+    struct NodeRecord {
+        uint32_t id;
+        uint32_t type;
+        uint32_t flags; // Bit 0 : contourné
+        uint32_t numParams;
+        uint32_t paramsOffset;
+    };
+
+    struct ParamRecord {
+        uint32_t name;
+        float value;
+    };
+
+    struct EdgeRecord {
+        uint32_t from;
+        uint32_t to;
+    };
+
+    // nullptr (et message dans error) si le fichier est absent, tronqué, d'une autre
+    // version ou corrompu.
+    static std::unique_ptr<PresetFile> open(const std::string& path, std::string* error = nullptr);
+    // Même validation sur un contenu déjà en mémoire (copié : le preset reste valide seul).
+    static std::unique_ptr<PresetFile> fromBytes(const void* data, size_t size, std::string* error = nullptr);
+
+    ~PresetFile();
+    PresetFile(PresetFile const&) = delete;
+    void operator=(PresetFile const&) = delete;
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+    bool isExcluded() const { return (header().flags & kExcluded) != 0; }
+    // nullptr si absent
+    const char* modelPath() const;
+
+    size_t numChains() const { return header().numChains; }
+    const ChainRecord& chain(size_t index) const { return at<ChainRecord>(header().chainsOffset)[index]; }
+    const NodeRecord& node(const ChainRecord& chain, size_t index) const {
+        return at<NodeRecord>(chain.nodesOffset)[index];
+    }
+    const ParamRecord& param(const NodeRecord& node, size_t index) const {
+        return at<ParamRecord>(node.paramsOffset)[index];
+    }
+    const EdgeRecord& edge(const ChainRecord& chain, size_t index) const {
+        return at<EdgeRecord>(chain.edgesOffset)[index];
+    }
+    const char* string(uint32_t offset) const {
+        return reinterpret_cast<const char*>(data_) + header().stringsOffset + offset;
+    }
+
+    // Description de graphe d'une chaîne (allocation : seulement si la topologie change).
+    GraphDescription description(const ChainRecord& chain) const;
+
+private:
+    PresetFile() = default;
+    bool validate(std::string* error) const;
+
+    template <typename T>
+    const T* at(uint32_t offset) const {
+        return reinterpret_cast<const T*>(static_cast<const uint8_t*>(data_) + offset);
+    }
+
+    const void* data_ = nullptr;
+    size_t size_ = 0;
+    bool isMapped_ = false;
+};
+
+} // namespace rvc
@@ -0,0 +1,281 @@
+#include "dsp/resampler.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace rvc {
+
+namespace {
+
+using Quality = PolyphaseResampler::Quality;
+
+struct QualitySettings {
+    size_t taps;   // Prises par phase pour un rapport >= 1 (allongé d'autant en décimation)
+    double rolloff; // Coupure, relative à la plus basse des deux fréquences de Nyquist
+    double beta;   // Paramètre de la fenêtre de Kaiser
+};
+
+constexpr QualitySettings settingsFor(Quality quality) {
+    switch (quality) {
+        case Quality::Low: return {16, 0.80, 6.0};
+        case Quality::High: return {64, 0.92, 10.0};
+        case Quality::Medium:
+        default: return {32, 0.88, 8.5};
+    }
+}
+
+constexpr size_t kMaxTaps = 1024;
+
+constexpr size_t tapsFor(uint32_t up, uint32_t down, Quality quality) {
+    const size_t base = settingsFor(quality).taps;
+    // Décimation : la bande de transition se rétrécit d'autant en échantillons d'entrée.
+    size_t taps = down > up ? (base * down + up - 1) / up : base;
+    taps = (taps + simd::kWidth - 1) / simd::kWidth * simd::kWidth;
+    return std::min(taps, kMaxTaps);
+}
+
+// Fonctions évaluables à la compilation (std::sin & co ne sont pas constexpr).
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double sinPi(double x) {
+    // Réduction à [-0.5, 0.5] : sin(pi x) est de période 2 et symétrique autour de 0.5.
+    const double k = static_cast<double>(static_cast<long long>(x / 2.0 + (x >= 0.0 ? 0.5 : -0.5)));
+    x -= 2.0 * k;
+    if (x > 0.5) x = 1.0 - x;
+    if (x < -0.5) x = -1.0 - x;
+    const double y = kPi * x;
+    const double y2 = y * y;
+    double term = y;
+    double sum = y;
+    for (int n = 1; n < 12; ++n) {
+        term *= -y2 / static_cast<double>((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double sqrtNewton(double x) {
+    if (x <= 0.0) return 0.0;
+    double r = x > 1.0 ? x : 1.0;
+    for (int i = 0; i < 40; ++i) r = 0.5 * (r + x / r);
+    return r;
+}
+
+// Fonction de Bessel modifiée I0 (série entière).
+constexpr double besselI0(double x) {
+    const double q = x * x / 4.0;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int k = 1; k < 64 && term > sum * 1e-12; ++k) {
+        term *= q / static_cast<double>(k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * Coefficients d'une phase : prise j appliquée à l'échantillon d'entrée situé
+ * (taps - 1 - j) + frac échantillons avant l'instant de sortie. Sinus cardinal centré sur
+ * taps/2 (retard de groupe), fenêtre de Kaiser, gain continu normalisé à 1 par phase.
+ */
+constexpr void designPhase(double frac, size_t taps, double cutoff, double beta, float* out) {
+    const double center = static_cast<double>(taps) / 2.0;
+    const double i0Beta = besselI0(beta);
+    double coefficients[kMaxTaps] = {};
+    double sum = 0.0;
+    for (size_t j = 0; j < taps; ++j) {
+        const double t = static_cast<double>(taps - 1 - j) + frac - center;
+        const double x = cutoff * t;
+        const double sinc = (x > -1e-9 && x < 1e-9) ? 1.0 : sinPi(x) / (kPi * x);
+        const double u = t / center;
+        const double window = besselI0(beta * sqrtNewton(1.0 - u * u)) / i0Beta;
+        coefficients[j] = cutoff * sinc * window;
+        sum += coefficients[j];
+    }
+    for (size_t j = 0; j < taps; ++j) {
+        out[j] = static_cast<float>(coefficients[j] / sum);
+    }
+}
+
+constexpr double cutoffFor(uint32_t up, uint32_t down, Quality quality) {
+    const double ratio = down > up ? static_cast<double>(up) / down : 1.0;
+    return settingsFor(quality).rolloff * ratio;
+}
+
+// Table complète : numPhases phases de fraction p / numPhases (numPhases + 1 en mode interpolé).
+constexpr void designTable(uint32_t up, uint32_t down, Quality quality, size_t numPhases, size_t numTables,
+                           float* out) {
+    const size_t taps = tapsFor(up, down, quality);
+    const double cutoff = cutoffFor(up, down, quality);
+    const double beta = settingsFor(quality).beta;
+    for (size_t p = 0; p < numTables; ++p) {
+        designPhase(static_cast<double>(p) / static_cast<double>(numPhases), taps, cutoff, beta, out + p * taps);
+    }
+}
+
+// Tables des rapports courants, générées à la compilation (données en lecture seule).
+template <uint32_t kUp, uint32_t kDown, Quality kQuality>
+struct PrecomputedTable {
+    static constexpr size_t kSize = kUp * tapsFor(kUp, kDown, kQuality);
+    static constexpr std::array<float, kSize> make() {
+        std::array<float, kSize> table = {};
+        designTable(kUp, kDown, kQuality, kUp, kUp, table.data());
+        return table;
+    }
+    static constexpr std::array<float, kSize> kCoefficients = make();
+};
+
+struct TableEntry {
+    uint32_t up;
+    uint32_t down;
+    Quality quality;
+    const float* coefficients;
+};
+
+template <uint32_t kUp, uint32_t kDown>
+constexpr std::array<TableEntry, 3> entriesFor() {
+    return {{
+        {kUp, kDown, Quality::Low, PrecomputedTable<kUp, kDown, Quality::Low>::kCoefficients.data()},
+        {kUp, kDown, Quality::Medium, PrecomputedTable<kUp, kDown, Quality::Medium>::kCoefficients.data()},
+        {kUp, kDown, Quality::High, PrecomputedTable<kUp, kDown, Quality::High>::kCoefficients.data()},
+    }};
+}
+
+// 48 kHz <-> 16 kHz (encodeur de contenu), 32/40 kHz (synthétiseurs), 8 kHz (téléphonie),
+// 32 -> 16 kHz et 16 -> 8 kHz.
+constexpr std::array<std::array<TableEntry, 3>, 10> kPrecomputed = {{
+    entriesFor<1, 3>(), entriesFor<3, 1>(),
+    entriesFor<2, 3>(), entriesFor<3, 2>(),
+    entriesFor<5, 6>(), entriesFor<6, 5>(),
+    entriesFor<1, 6>(), entriesFor<6, 1>(),
+    entriesFor<1, 2>(), entriesFor<2, 1>(),
+}};
+
+const float* findPrecomputed(uint32_t up, uint32_t down, Quality quality) {
+    for (const auto& entries : kPrecomputed) {
+        for (const TableEntry& entry : entries) {
+            if (entry.up == up && entry.down == down && entry.quality == quality) return entry.coefficients;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+PolyphaseResampler::PolyphaseResampler(int inputRate, int outputRate, Quality quality)
+    : inputRate_(inputRate), outputRate_(outputRate), quality_(quality) {
+    const int divisor = std::gcd(std::max(inputRate, 1), std::max(outputRate, 1));
+    up_ = static_cast<uint32_t>(std::max(outputRate, 1) / divisor);
+    down_ = static_cast<uint32_t>(std::max(inputRate, 1) / divisor);
+    if (isPassthrough()) {
+        up_ = down_ = 1;
+        return;
+    }
+
+    taps_ = tapsFor(up_, down_, quality);
+    interpolated_ = up_ > kMaxPhases;
+    coefficients_ = interpolated_ ? nullptr : findPrecomputed(up_, down_, quality);
+    if (!coefficients_) {
+        const size_t numPhases = interpolated_ ? kInterpolatedPhases : up_;
+        const size_t numTables = interpolated_ ? kInterpolatedPhases + 1 : up_;
+        ownedCoefficients_.resize(numTables * taps_);
+        designTable(up_, down_, quality, numPhases, numTables, ownedCoefficients_.data());
+        coefficients_ = ownedCoefficients_.data();
+    }
+    work_.assign(taps_ - 1 + kChunk, 0.0f);
+}
+
+size_t PolyphaseResampler::latencySamples() const {
+    return static_cast<size_t>(latencySeconds() * outputRate_ + 0.5);
+}
+
+double PolyphaseResampler::latencySeconds() const {
+    if (isPassthrough()) return 0.0;
+    return static_cast<double>(taps_) / 2.0 / inputRate_;
+}
+
+size_t PolyphaseResampler::maxOutputSamples(size_t numSamples) const {
+    if (isPassthrough()) return numSamples;
+    return (static_cast<uint64_t>(numSamples) * up_ + down_ - 1) / down_;
+}
+
+void PolyphaseResampler::reset() {
+    std::fill(work_.begin(), work_.end(), 0.0f);
+    index_ = 0;
+    phase_ = 0;
+}
+
+inline float PolyphaseResampler::filter(const float* history, uint32_t phase) const {
+    if (!interpolated_) {
+        return simd::dot(history, coefficients_ + static_cast<size_t>(phase) * taps_, taps_);
+    }
+    // Phase approchée entre deux tables voisines (interpolation linéaire des coefficients,
+    // donc des deux produits scalaires).
+    const uint64_t scaled = static_cast<uint64_t>(phase) * kInterpolatedPhases;
+    const size_t table = static_cast<size_t>(scaled / up_);
+    const float weight = static_cast<float>(scaled % up_) / static_cast<float>(up_);
+    const float* c0 = coefficients_ + table * taps_;
+    const float a = simd::dot(history, c0, taps_);
+    const float b = simd::dot(history, c0 + taps_, taps_);
+    return a + weight * (b - a);
+}
+
+/**
+ * Traitement par tranches de kChunk (comme DelayLine) : aucune allocation, taille de bloc
+ * libre. L'avance de down_ phases par sortie est décomposée en pas entier + reste, sans
+ * division dans la boucle.
+ */
+size_t PolyphaseResampler::process(const float* in, size_t numSamples, float* out) {
+    if (isPassthrough()) {
+        std::copy(in, in + numSamples, out);
+        return numSamples;
+    }
+
+    const size_t history = taps_ - 1;
+    const size_t stepIndex = down_ / up_;
+    const uint32_t stepPhase = down_ % up_;
+    size_t produced = 0;
+    for (size_t done = 0; done < numSamples;) {
+        const size_t len = std::min(kChunk, numSamples - done);
+        std::copy(in + done, in + done + len, work_.data() + history);
+
+        while (index_ < len) {
+            out[produced++] = filter(work_.data() + index_, phase_);
+            index_ += stepIndex;
+            phase_ += stepPhase;
+            if (phase_ >= up_) {
+                phase_ -= up_;
+                ++index_;
+            }
+        }
+        index_ -= len;
+
+        // Les taps_ - 1 derniers échantillons deviennent l'historique de la tranche suivante.
+        std::copy(work_.data() + len, work_.data() + len + history, work_.data());
+        done += len;
+    }
+    return produced;
+}
+
+RateBridge::RateBridge(int outerRate, int innerRate, size_t maxBlockSize, Quality quality)
+    : toInner_(outerRate, innerRate, quality), fromInner_(innerRate, outerRate, quality) {
+    if (isPassthrough()) return;
+    inner_.resize(toInner_.maxOutputSamples(maxBlockSize));
+    // Excédent d'un bloc (< outer/inner + 1) + sortie d'un bloc intérieur complet.
+    const size_t excess = static_cast<size_t>(outerRate / std::max(innerRate, 1)) + 2;
+    returned_.resize(fromInner_.maxOutputSamples(inner_.size()) + excess);
+}
+
+size_t RateBridge::latencySamples() const {
+    const double seconds = toInner_.latencySeconds() + fromInner_.latencySeconds();
+    return static_cast<size_t>(seconds * toInner_.inputRate() + 0.5);
+}
+
+void RateBridge::reset() {
+    toInner_.reset();
+    fromInner_.reset();
+    pending_ = 0;
+}
+
+} // namespace rvc
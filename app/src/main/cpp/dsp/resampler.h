@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Rééchantillonneur polyphase en flux, rapport rationnel quelconque (V16.0).
+ *
+ * Conversion entre la fréquence du graphe et la fréquence native du modèle (16 kHz pour
+ * l'encodeur de contenu, 32/40/48 kHz pour le synthétiseur). Le rapport est réduit à
+ * up/down ; chaque échantillon de sortie est un produit scalaire vectorisé (simd::dot) entre
+ * l'historique d'entrée et la phase du filtre (sinus cardinal fenêtré par Kaiser) qui lui
+ * correspond. Les tables des rapports courants (48 kHz <-> 8/16/32/40 kHz, 32 -> 16 kHz...)
+ * sont calculées à la compilation ; les autres à la construction, hors du thread audio.
+ * Au-delà de kMaxPhases phases (ex. 48000 -> 47999), kInterpolatedPhases phases sont
+ * interpolées linéairement : la position reste exacte, seule la phase est approchée.
+ *
+ * Le filtre est causal : latencySamples() est son retard de groupe, constant.
+ */
+class PolyphaseResampler {
+public:
+    enum class Quality {
+        Low,    // 16 prises, ~60 dB de réjection (aperçu, modes économes)
+        Medium, // 32 prises, ~80 dB
+        High,   // 64 prises, ~100 dB
+    };
+
+    static constexpr size_t kChunk = 256;
+    static constexpr size_t kMaxPhases = 1024;
+    static constexpr size_t kInterpolatedPhases = 256;
+
+    PolyphaseResampler(int inputRate, int outputRate, Quality quality = Quality::Medium);
+
+    int inputRate() const { return inputRate_; }
+    int outputRate() const { return outputRate_; }
+    Quality quality() const { return quality_; }
+    bool isPassthrough() const { return up_ == down_; }
+
+    // Prises du filtre par phase (en échantillons d'entrée).
+    size_t numTaps() const { return taps_; }
+    bool usesPrecomputedTable() const { return ownedCoefficients_.empty() && !isPassthrough(); }
+
+    // Retard de groupe, en échantillons de sortie (arrondi) et en secondes.
+    size_t latencySamples() const;
+    double latencySeconds() const;
+
+    // Borne haute (atteinte) du nombre d'échantillons produits pour numSamples en entrée.
+    size_t maxOutputSamples(size_t numSamples) const;
+
+    // Consomme toute l'entrée et écrit la sortie disponible ; retourne le nombre
+    // d'échantillons écrits (au plus maxOutputSamples(numSamples)). in et out distincts.
+    size_t process(const float* in, size_t numSamples, float* out);
+
+    // Historique à zéro (nouveau flux).
+    void reset();
+
+private:
+    float filter(const float* history, uint32_t phase) const;
+
+    int inputRate_;
+    int outputRate_;
+    Quality quality_;
+    uint32_t up_;   // Phases par échantillon d'entrée
+    uint32_t down_; // Pas de sortie, en phases
+    size_t taps_ = 0;
+    bool interpolated_ = false;
+
+    const float* coefficients_ = nullptr; // [phase][prise], prise 0 = échantillon le plus ancien
+    std::vector<float> ownedCoefficients_;
+
+    std::vector<float> work_; // taps_ - 1 échantillons d'historique, puis la tranche en cours
+    size_t index_ = 0;        // Position de la prochaine sortie : échantillon d'entrée...
+    uint32_t phase_ = 0;      // ...et phase (0..up_-1)
+};
+
+/**
+ * Aller-retour par une autre fréquence autour d'un traitement en place, à taille de bloc
+ * constante (V16.0) : le modèle tourne à sa fréquence native, le graphe à celle de la
+ * session. Bloc de n échantillons -> conversion -> traitement -> conversion retour -> n
+ * échantillons. Les deux conversions partant de la position 0, la sortie cumulée du retour
+ * couvre toujours l'entrée cumulée (ceil(ceil(N·b/a)·a/b) >= N) : l'excédent (au plus a/b
+ * échantillons) est gardé pour le bloc suivant, sans pré-remplissage ni sous-alimentation,
+ * et le retard total reste celui des deux filtres.
+ */
+class RateBridge {
+public:
+    using Quality = PolyphaseResampler::Quality;
+
+    RateBridge(int outerRate, int innerRate, size_t maxBlockSize, Quality quality = Quality::Medium);
+
+    bool isPassthrough() const { return toInner_.isPassthrough(); }
+    int innerRate() const { return toInner_.outputRate(); }
+
+    // Retard de l'aller-retour, en échantillons à la fréquence extérieure.
+    size_t latencySamples() const;
+
+    // Plus grand bloc passé au traitement intérieur.
+    size_t maxInnerSamples() const { return inner_.size(); }
+
+    // inner(float* samples, size_t count) : traitement en place à la fréquence intérieure.
+    template <typename Process>
+    void process(float* buffer, size_t numSamples, Process&& inner) {
+        if (isPassthrough()) {
+            inner(buffer, numSamples);
+            return;
+        }
+        const size_t innerCount = toInner_.process(buffer, numSamples, inner_.data());
+        inner(inner_.data(), innerCount);
+        pending_ += fromInner_.process(inner_.data(), innerCount, returned_.data() + pending_);
+        std::copy(returned_.data(), returned_.data() + numSamples, buffer);
+        std::copy(returned_.data() + numSamples, returned_.data() + pending_, returned_.data());
+        pending_ -= numSamples;
+    }
+
+    // Nouveau flux (le traitement intérieur a été sauté) : historiques et excédent effacés.
+    void reset();
+
+private:
+    PolyphaseResampler toInner_;
+    PolyphaseResampler fromInner_;
+    std::vector<float> inner_;
+    std::vector<float> returned_;
+    size_t pending_ = 0;
+};
+
+} // namespace rvc
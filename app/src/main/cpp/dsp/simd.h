@@ -0,0 +1,387 @@
+#pragma once
+
+#include <stddef.h>
+#include <cmath>
+
+// Sélection du jeu d'instructions vectoriel (NEON sur ARM64, SSE sur les émulateurs x86).
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RVC_SIMD_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RVC_SIMD_SSE 1
+#endif
+
+namespace rvc {
+namespace simd {
+
+/**
+ * Vecteur de 4 floats. Abstraction minimale au-dessus de NEON/SSE pour que les nœuds DSP
+ * restent écrits une seule fois (avec un repli scalaire pour les autres architectures).
+ */
+struct float4 {
+#if defined(RVC_SIMD_NEON)
+    float32x4_t v;
+#elif defined(RVC_SIMD_SSE)
+    __m128 v;
+#else
+    float v[4];
+#endif
+};
+
+constexpr size_t kWidth = 4;
+
+inline float4 load(const float* p) {
+#if defined(RVC_SIMD_NEON)
+    return {vld1q_f32(p)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_loadu_ps(p)};
+#else
+    return {{p[0], p[1], p[2], p[3]}};
+#endif
+}
+
+inline void store(float* p, float4 a) {
+#if defined(RVC_SIMD_NEON)
+    vst1q_f32(p, a.v);
+#elif defined(RVC_SIMD_SSE)
+    _mm_storeu_ps(p, a.v);
+#else
+    for (int i = 0; i < 4; ++i) p[i] = a.v[i];
+#endif
+}
+
+inline float4 set1(float x) {
+#if defined(RVC_SIMD_NEON)
+    return {vdupq_n_f32(x)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_set1_ps(x)};
+#else
+    return {{x, x, x, x}};
+#endif
+}
+
+// Construit {a, b, c, d} (a dans la voie 0).
+inline float4 set(float a, float b, float c, float d) {
+    const float tmp[4] = {a, b, c, d};
+    return load(tmp);
+}
+
+inline float4 operator+(float4 a, float4 b) {
+#if defined(RVC_SIMD_NEON)
+    return {vaddq_f32(a.v, b.v)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_add_ps(a.v, b.v)};
+#else
+    return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+#endif
+}
+
+inline float4 operator-(float4 a, float4 b) {
+#if defined(RVC_SIMD_NEON)
+    return {vsubq_f32(a.v, b.v)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_sub_ps(a.v, b.v)};
+#else
+    return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+#endif
+}
+
+inline float4 operator*(float4 a, float4 b) {
+#if defined(RVC_SIMD_NEON)
+    return {vmulq_f32(a.v, b.v)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_mul_ps(a.v, b.v)};
+#else
+    return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+#endif
+}
+
+inline float4 min(float4 a, float4 b) {
+#if defined(RVC_SIMD_NEON)
+    return {vminq_f32(a.v, b.v)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_min_ps(a.v, b.v)};
+#else
+    float4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+    return r;
+#endif
+}
+
+inline float4 max(float4 a, float4 b) {
+#if defined(RVC_SIMD_NEON)
+    return {vmaxq_f32(a.v, b.v)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_max_ps(a.v, b.v)};
+#else
+    float4 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+    return r;
+#endif
+}
+
+inline float4 abs(float4 a) {
+#if defined(RVC_SIMD_NEON)
+    return {vabsq_f32(a.v)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+#else
+    return {{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}};
+#endif
+}
+
+// Multiplication-addition a * b + c (FMA sur ARM64).
+inline float4 madd(float4 a, float4 b, float4 c) {
+#if defined(RVC_SIMD_NEON) && defined(__aarch64__)
+    return {vfmaq_f32(c.v, a.v, b.v)};
+#else
+    return a * b + c;
+#endif
+}
+
+// Décalage d'une voie : {prev[3], cur[0], cur[1], cur[2]} (chaînage de voies entre vecteurs).
+inline float4 shiftIn(float4 prev, float4 cur) {
+#if defined(RVC_SIMD_NEON)
+    return {vextq_f32(prev.v, cur.v, 3)};
+#elif defined(RVC_SIMD_SSE)
+    const __m128 t = _mm_shuffle_ps(prev.v, cur.v, _MM_SHUFFLE(0, 0, 3, 3));
+    return {_mm_shuffle_ps(t, cur.v, _MM_SHUFFLE(2, 1, 2, 0))};
+#else
+    return {{prev.v[3], cur.v[0], cur.v[1], cur.v[2]}};
+#endif
+}
+
+// Échange des voies deux à deux : {a[1], a[0], a[3], a[2]}.
+inline float4 swapPairs(float4 a) {
+#if defined(RVC_SIMD_NEON)
+    return {vrev64q_f32(a.v)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1))};
+#else
+    return {{a.v[1], a.v[0], a.v[3], a.v[2]}};
+#endif
+}
+
+// Échange des deux moitiés : {a[2], a[3], a[0], a[1]}.
+inline float4 swapHalves(float4 a) {
+#if defined(RVC_SIMD_NEON)
+    return {vextq_f32(a.v, a.v, 2)};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(1, 0, 3, 2))};
+#else
+    return {{a.v[2], a.v[3], a.v[0], a.v[1]}};
+#endif
+}
+
+// Dernière voie (voie 3) du vecteur.
+inline float lastLane(float4 a) {
+#if defined(RVC_SIMD_NEON)
+    return vgetq_lane_f32(a.v, 3);
+#elif defined(RVC_SIMD_SSE)
+    return _mm_cvtss_f32(_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(3, 3, 3, 3)));
+#else
+    return a.v[3];
+#endif
+}
+
+// Diffuse la voie `lane` sur les quatre voies.
+template <int lane>
+inline float4 broadcast(float4 a) {
+    static_assert(lane >= 0 && lane < 4, "voie hors limites");
+#if defined(RVC_SIMD_NEON) && defined(__aarch64__)
+    return {vdupq_laneq_f32(a.v, lane)};
+#elif defined(RVC_SIMD_NEON)
+    return {vdupq_n_f32(vgetq_lane_f32(a.v, lane))};
+#elif defined(RVC_SIMD_SSE)
+    return {_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(lane, lane, lane, lane))};
+#else
+    return {{a.v[lane], a.v[lane], a.v[lane], a.v[lane]}};
+#endif
+}
+
+// Réductions horizontales.
+inline float hmax(float4 a) {
+    float tmp[4];
+    store(tmp, a);
+    return std::fmax(std::fmax(tmp[0], tmp[1]), std::fmax(tmp[2], tmp[3]));
+}
+
+inline float hsum(float4 a) {
+    float tmp[4];
+    store(tmp, a);
+    return (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+}
+
+/**
+ * log2 approché (erreur absolue < 1e-5) pour x > 0 normalisé : exposant lu dans les bits,
+ * log2 de la mantisse [1, 2) par un polynôme de degré 6 (moindres carrés, nul en 1).
+ */
+inline float4 log2Approx(float4 x) {
+#if defined(RVC_SIMD_NEON)
+    const int32x4_t bits = vreinterpretq_s32_f32(x.v);
+    const float4 exponent = {vcvtq_f32_s32(vsubq_s32(vshrq_n_s32(bits, 23), vdupq_n_s32(127)))};
+    const float4 mantissa = {
+        vreinterpretq_f32_s32(vorrq_s32(vandq_s32(bits, vdupq_n_s32(0x007FFFFF)), vdupq_n_s32(0x3F800000)))};
+#elif defined(RVC_SIMD_SSE)
+    const __m128i bits = _mm_castps_si128(x.v);
+    const float4 exponent = {_mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)))};
+    const float4 mantissa = {
+        _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)))};
+#else
+    float4 exponent;
+    float4 mantissa;
+    for (int i = 0; i < 4; ++i) {
+        int e = 0;
+        mantissa.v[i] = 2.0f * std::frexp(x.v[i], &e);
+        exponent.v[i] = static_cast<float>(e - 1);
+    }
+#endif
+    const float4 t = mantissa - set1(1.0f);
+    float4 p = set1(-0.0260674775f);
+    p = madd(p, t, set1(0.121917308f));
+    p = madd(p, t, set1(-0.27736822f));
+    p = madd(p, t, set1(0.456895616f));
+    p = madd(p, t, set1(-0.71789867f));
+    p = madd(p, t, set1(1.44251705f));
+    return madd(p, t, exponent);
+}
+
+/**
+ * x <- scale * log2(max(x, floor)) : compression logarithmique des features (scale = ln 2
+ * pour le log naturel, log10(2) pour log10).
+ */
+inline void logCompress(float* x, size_t n, float floor, float scale) {
+    size_t i = 0;
+    const float4 f = set1(floor);
+    const float4 s = set1(scale);
+    for (; i + kWidth <= n; i += kWidth) {
+        store(x + i, log2Approx(max(load(x + i), f)) * s);
+    }
+    for (; i < n; ++i) {
+        x[i] = std::log2(std::fmax(x[i], floor)) * scale;
+    }
+}
+
+/**
+ * dst = a * b, terme à terme (fenêtrage).
+ */
+inline void multiply(float* dst, const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    for (; i + kWidth <= n; i += kWidth) {
+        store(dst + i, load(a + i) * load(b + i));
+    }
+    for (; i < n; ++i) {
+        dst[i] = a[i] * b[i];
+    }
+}
+
+/**
+ * Crête absolue d'un bloc (vectorisée, reste traité en scalaire).
+ */
+inline float peakAbs(const float* x, size_t n) {
+    size_t i = 0;
+    float4 acc = set1(0.0f);
+    for (; i + kWidth <= n; i += kWidth) {
+        acc = max(acc, abs(load(x + i)));
+    }
+    float peak = hmax(acc);
+    for (; i < n; ++i) {
+        peak = std::fmax(peak, std::fabs(x[i]));
+    }
+    return peak;
+}
+
+/**
+ * Produit scalaire de deux vecteurs (accumulateurs multiples pour masquer la latence FMA).
+ */
+inline float dot(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    float4 acc0 = set1(0.0f);
+    float4 acc1 = set1(0.0f);
+    for (; i + 2 * kWidth <= n; i += 2 * kWidth) {
+        acc0 = madd(load(a + i), load(b + i), acc0);
+        acc1 = madd(load(a + i + kWidth), load(b + i + kWidth), acc1);
+    }
+    for (; i + kWidth <= n; i += kWidth) {
+        acc0 = madd(load(a + i), load(b + i), acc0);
+    }
+    float sum = hsum(acc0 + acc1);
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/**
+ * Distance euclidienne au carré (recherche de plus proches voisins).
+ */
+inline float squaredDistance(const float* a, const float* b, size_t n) {
+    size_t i = 0;
+    float4 acc0 = set1(0.0f);
+    float4 acc1 = set1(0.0f);
+    for (; i + 2 * kWidth <= n; i += 2 * kWidth) {
+        const float4 d0 = load(a + i) - load(b + i);
+        const float4 d1 = load(a + i + kWidth) - load(b + i + kWidth);
+        acc0 = madd(d0, d0, acc0);
+        acc1 = madd(d1, d1, acc1);
+    }
+    for (; i + kWidth <= n; i += kWidth) {
+        const float4 d = load(a + i) - load(b + i);
+        acc0 = madd(d, d, acc0);
+    }
+    float sum = hsum(acc0 + acc1);
+    for (; i < n; ++i) {
+        const float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+/**
+ * dst += gain * src (moyenne pondérée de vecteurs).
+ */
+inline void accumulateScaled(float* dst, const float* src, float gain, size_t n) {
+    size_t i = 0;
+    const float4 g = set1(gain);
+    for (; i + kWidth <= n; i += kWidth) {
+        store(dst + i, madd(load(src + i), g, load(dst + i)));
+    }
+    for (; i < n; ++i) {
+        dst[i] += gain * src[i];
+    }
+}
+
+/**
+ * dst += src (mixage de plusieurs entrées d'un nœud).
+ */
+inline void accumulate(float* dst, const float* src, size_t n) {
+    size_t i = 0;
+    for (; i + kWidth <= n; i += kWidth) {
+        store(dst + i, load(dst + i) + load(src + i));
+    }
+    for (; i < n; ++i) {
+        dst[i] += src[i];
+    }
+}
+
+/**
+ * Applique une rampe de gain linéaire partant de g0 et atteignant g1 au dernier échantillon.
+ */
+inline void applyGainRamp(float* x, size_t n, float g0, float g1) {
+    if (n == 0) return;
+    const float step = (g1 - g0) / static_cast<float>(n);
+    size_t i = 0;
+    float4 g = set(g0 + step, g0 + 2.0f * step, g0 + 3.0f * step, g0 + 4.0f * step);
+    const float4 gStep = set1(4.0f * step);
+    for (; i + kWidth <= n; i += kWidth) {
+        store(x + i, load(x + i) * g);
+        g = g + gStep;
+    }
+    for (; i < n; ++i) {
+        x[i] *= g0 + step * static_cast<float>(i + 1);
+    }
+}
+
+} // namespace simd
+} // namespace rvc
@@ -0,0 +1,84 @@
+#include "dsp/spectral_analyzer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+// Taille de FFT puissance de 2 la plus proche de ~21ms (1024 à 48 kHz, 256 à 8 kHz).
+size_t fftSizeForRate(int sampleRate) {
+    size_t size = 256;
+    while (size * 2 <= static_cast<size_t>(sampleRate) / 40) size *= 2;
+    return size;
+}
+
+} // namespace
+
+SpectralAnalyzer::SpectralAnalyzer(int sampleRate)
+    : sampleRate_(sampleRate),
+      fft_(fftSizeForRate(sampleRate)),
+      hop_(fft_.size() / 2) {
+    const size_t n = fft_.size();
+    window_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        window_[i] = 0.5f - 0.5f * std::cos(2.0f * static_cast<float>(M_PI) * static_cast<float>(i) / static_cast<float>(n));
+    }
+    input_.assign(n, 0.0f);
+    frame_.assign(n, 0.0f);
+    spectrum_.assign(fft_.numBins(), {0.0f, 0.0f});
+    power_.assign(fft_.numBins(), 0.0f);
+}
+
+size_t SpectralAnalyzer::analyze(const float* samples, size_t numSamples) {
+    const size_t n = input_.size();
+    size_t frames = 0;
+    while (numSamples > 0) {
+        // Décale l'entrée et ajoute au plus jusqu'à la fin du saut courant.
+        const size_t take = std::min(numSamples, hop_ - pending_);
+        std::copy(input_.begin() + take, input_.end(), input_.begin());
+        std::copy(samples, samples + take, input_.begin() + (n - take));
+        samples += take;
+        numSamples -= take;
+        pending_ += take;
+        if (pending_ == hop_) {
+            analyzeFrame();
+            pending_ = 0;
+            ++frames;
+        }
+    }
+    return frames;
+}
+
+void SpectralAnalyzer::analyzeFrame() {
+    const size_t n = input_.size();
+    for (size_t i = 0; i < n; ++i) {
+        frame_[i] = input_[i] * window_[i];
+    }
+    fft_.forward(frame_.data(), spectrum_.data());
+    for (size_t k = 0; k < spectrum_.size(); ++k) {
+        power_[k] = std::norm(spectrum_[k]);
+    }
+    ++frameCount_;
+}
+
+float SpectralAnalyzer::binFrequency(size_t bin) const {
+    return static_cast<float>(bin) * static_cast<float>(sampleRate_) / static_cast<float>(fft_.size());
+}
+
+size_t SpectralAnalyzer::binForFrequency(float hz) const {
+    const float bin = hz * static_cast<float>(fft_.size()) / static_cast<float>(sampleRate_);
+    return std::min(numBins() - 1, static_cast<size_t>(std::max(0.0f, std::round(bin))));
+}
+
+float SpectralAnalyzer::bandEnergy(float lowHz, float highHz) const {
+    const size_t first = binForFrequency(lowHz);
+    const size_t last = binForFrequency(highHz);
+    float sum = 0.0f;
+    for (size_t k = first; k <= last; ++k) {
+        sum += power_[k];
+    }
+    return sum;
+}
+
+} // namespace rvc
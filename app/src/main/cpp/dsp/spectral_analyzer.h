@@ -0,0 +1,54 @@
+#pragma once
+
+#include "dsp/fft.h"
+#include <complex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Analyse STFT partagée du pipeline (fenêtre de Hann ~21ms, recouvrement 50%).
+ * Calculée une seule fois par bloc par FXGraph ; les nœuds spectraux (dé-esseur,
+ * correction harmonique...) lisent la dernière trame au lieu de refaire leur propre FFT.
+ */
+class SpectralAnalyzer {
+public:
+    explicit SpectralAnalyzer(int sampleRate);
+
+    // Ajoute un bloc d'échantillons ; retourne le nombre de nouvelles trames analysées.
+    size_t analyze(const float* samples, size_t numSamples);
+
+    int sampleRate() const { return sampleRate_; }
+    size_t fftSize() const { return fft_.size(); }
+    size_t hopSize() const { return hop_; }
+    size_t numBins() const { return fft_.numBins(); }
+    uint64_t frameCount() const { return frameCount_; }
+
+    float binFrequency(size_t bin) const;
+    size_t binForFrequency(float hz) const;
+
+    // Dernière trame analysée.
+    const std::complex<float>* spectrum() const { return spectrum_.data(); }
+    const float* powerSpectrum() const { return power_.data(); }
+
+    // Énergie de la dernière trame entre deux fréquences (bornes incluses).
+    float bandEnergy(float lowHz, float highHz) const;
+
+private:
+    void analyzeFrame();
+
+    int sampleRate_;
+    RealFFT fft_;
+    size_t hop_;
+    std::vector<float> window_;
+    std::vector<float> input_; // Dernières fftSize() entrées (linéaire)
+    size_t pending_ = 0;       // Échantillons reçus depuis la dernière trame
+    std::vector<float> frame_;
+    std::vector<std::complex<float>> spectrum_;
+    std::vector<float> power_;
+    uint64_t frameCount_ = 0;
+};
+
+} // namespace rvc
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "dsp/worker_pool.h" // FutexWord
+#include <atomic>
+#include <stddef.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * File bornée sans verrou à un producteur et un consommateur (anneau de puissance de 2).
+ *
+ * Les cases sont allouées à la construction ; push() et tryPop() ne font ni allocation ni
+ * appel système. Le consommateur qui n'a rien à faire attend dans pop() sur un compteur de
+ * publications (FutexWord : attente active courte, puis futex), et le producteur ne réveille
+ * que si un consommateur dort réellement.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return slots_.size(); }
+
+    // --- Producteur ---
+    // Faux si la file est pleine.
+    bool push(const T& value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == slots_.size()) return false;
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        published_.fetchAdd(1);
+        published_.wakeAll();
+        return true;
+    }
+
+    // --- Consommateur ---
+    bool tryPop(T& value) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return false;
+        value = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Attend un élément.
+    T pop() {
+        T value;
+        while (true) {
+            const uint32_t seen = published_.load();
+            if (tryPop(value)) return value;
+            published_.waitWhileEqual(seen);
+        }
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0}; // Propriété du consommateur
+    alignas(64) std::atomic<size_t> tail_{0}; // Propriété du producteur
+    FutexWord published_;
+};
+
+} // namespace rvc
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+namespace rvc {
+
+/**
+ * Triple buffer sans verrou : un seul écrivain (thread UI/JNI) publie des valeurs complètes,
+ * un seul lecteur (thread audio) récupère la plus récente une fois par bloc.
+ *
+ * L'écrivain remplit sa copie puis l'échange avec la copie "intermédiaire" ; le lecteur
+ * échange sa copie avec l'intermédiaire seulement si elle a été publiée depuis (bit "nouveau").
+ * Aucun des deux n'attend l'autre, et aucune valeur n'est lue à moitié écrite.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    explicit TripleBuffer(const T& initial = T()) : slots_{initial, initial, initial} {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // --- Écrivain ---
+    T& writeSlot() { return slots_[back_]; }
+
+    void publish() {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    void publish(const T& value) {
+        writeSlot() = value;
+        publish();
+    }
+
+    // --- Lecteur ---
+    // Vrai si une nouvelle valeur a été récupérée depuis le dernier appel.
+    bool acquire() {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+
+    const T& read() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t kFresh = 0x4;
+    static constexpr uint8_t kIndexMask = 0x3;
+
+    T slots_[3];
+    uint8_t back_ = 0;                 // Propriété de l'écrivain
+    uint8_t front_ = 1;                // Propriété du lecteur
+    std::atomic<uint8_t> middle_{2};   // Échangé entre les deux (index | kFresh)
+};
+
+} // namespace rvc
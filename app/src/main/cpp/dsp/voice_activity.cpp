@@ -0,0 +1,290 @@
+#include "dsp/voice_activity.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace rvc {
+
+namespace {
+
+constexpr float kFrameMs = 10.0f;
+constexpr float kBandLowHz = 100.0f;
+constexpr float kBandHighHz = 4000.0f;
+
+constexpr float kFloorFall = 0.3f;           // Suivi rapide vers le bas (minimum)
+constexpr float kFloorTrack = 0.1f;          // Suivi du bruit sur les trames hors parole
+constexpr float kFloorRiseDbPerSecond = 3.0f; // Remontée lente pendant la parole (bruit qui augmente)
+constexpr float kMinFloorDb = -100.0f;
+constexpr float kOnsetExtraDb = 6.0f;        // Début de parole sur une trame incomplète : énergie seule
+constexpr float kLoudMarginDb = 20.0f;       // Au-delà, parole quelle que soit la forme du spectre
+
+constexpr float kFadeMs = 5.0f;
+constexpr float kMaxComfortNoiseDb = -50.0f; // Jamais de souffle audible, même dans une pièce bruyante
+constexpr float kComfortNoiseOffsetDb = -3.0f;
+constexpr float kNoiseLowpass = 0.6f;        // Pente douce : moins sifflant qu'un bruit blanc
+constexpr float kCostSmoothing = 0.1f;
+
+constexpr float kHalfPi = 1.57079632679f;
+
+size_t nextPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+float toDb(float meanSquare) {
+    return 10.0f * std::log10(meanSquare + 1e-12f);
+}
+
+} // namespace
+
+// --- VoiceActivityDetector ---
+
+VoiceActivityDetector::VoiceActivityDetector(int sampleRate)
+    : VoiceActivityDetector(sampleRate, Settings()) {}
+
+VoiceActivityDetector::VoiceActivityDetector(int sampleRate, const Settings& settings)
+    : settings_(settings),
+      frameSize_(nextPow2(static_cast<size_t>(kFrameMs * 0.001f * static_cast<float>(sampleRate)))),
+      fft_(frameSize_) {
+    const float frameSeconds = static_cast<float>(frameSize_) / static_cast<float>(sampleRate);
+    hangoverFrames_ = std::max<size_t>(1, static_cast<size_t>(settings_.hangoverMs * 0.001f / frameSeconds));
+    floorRiseDb_ = kFloorRiseDbPerSecond * frameSeconds;
+
+    const float binHz = static_cast<float>(sampleRate) / static_cast<float>(frameSize_);
+    bandStart_ = std::max<size_t>(1, static_cast<size_t>(std::ceil(kBandLowHz / binHz)));
+    bandEnd_ = std::min(fft_.numBins(), static_cast<size_t>(kBandHighHz / binHz) + 1);
+
+    // Fenêtre de Hann, buffers alloués ici : aucune allocation dans le thread audio.
+    window_.resize(frameSize_);
+    for (size_t i = 0; i < frameSize_; ++i) {
+        window_[i] = 0.5f - 0.5f * std::cos(2.0f * 3.14159265f * static_cast<float>(i) / static_cast<float>(frameSize_));
+    }
+    frame_.assign(frameSize_, 0.0f);
+    windowed_.assign(frameSize_, 0.0f);
+    spectrum_.assign(fft_.numBins(), {0.0f, 0.0f});
+}
+
+float VoiceActivityDetector::noiseFloor() const {
+    return std::sqrt(std::pow(10.0f, floorDb_ * 0.1f));
+}
+
+bool VoiceActivityDetector::process(const float* in, size_t numSamples) {
+    size_t pos = 0;
+    while (pos < numSamples) {
+        const size_t count = std::min(numSamples - pos, frameSize_ - frameFill_);
+        for (size_t i = 0; i < count; ++i) {
+            const float x = in[pos + i];
+            frame_[frameFill_ + i] = x;
+            frameEnergy_ += x * x;
+        }
+        frameFill_ += count;
+        pos += count;
+
+        if (frameFill_ == frameSize_) {
+            if (isSpeechFrame()) {
+                markSpeech();
+            } else if (hangoverCounter_ > 0) {
+                --hangoverCounter_;
+            }
+            frameFill_ = 0;
+            frameEnergy_ = 0.0f;
+        }
+    }
+
+    // Début de parole dans la trame incomplète : décision anticipée sur l'énergie seule
+    // (au moins un quart de trame), la trame complète confirmera au bloc suivant.
+    if (!isSpeech() && frameFill_ >= frameSize_ / 4) {
+        const float energyDb = toDb(frameEnergy_ / static_cast<float>(frameFill_));
+        if (energyDb > floorDb_ + settings_.marginDb + kOnsetExtraDb && energyDb > settings_.minSpeechDb) {
+            markSpeech();
+        }
+    }
+    return isSpeech();
+}
+
+/**
+ * Décision sur une trame complète, puis mise à jour du plancher de bruit : suivi rapide
+ * vers le bas, suivi normal sur les trames de bruit, remontée bornée sur les trames de
+ * parole (pour sortir d'un plancher trop bas si le bruit de fond augmente durablement).
+ */
+bool VoiceActivityDetector::isSpeechFrame() {
+    const float energyDb = toDb(frameEnergy_ / static_cast<float>(frameSize_));
+    const float aboveFloor = energyDb - floorDb_;
+
+    bool speech = false;
+    if (aboveFloor > settings_.marginDb && energyDb > settings_.minSpeechDb) {
+        if (aboveFloor > kLoudMarginDb) {
+            speech = true;
+        } else {
+            // Passages par zéro
+            size_t crossings = 0;
+            for (size_t i = 1; i < frameSize_; ++i) {
+                crossings += (frame_[i] >= 0.0f) != (frame_[i - 1] >= 0.0f);
+            }
+            const float zcr = static_cast<float>(crossings) / static_cast<float>(frameSize_);
+
+            // Platitude spectrale : moyenne géométrique / moyenne arithmétique de la puissance
+            for (size_t i = 0; i < frameSize_; ++i) {
+                windowed_[i] = frame_[i] * window_[i];
+            }
+            fft_.forward(windowed_.data(), spectrum_.data());
+            float logSum = 0.0f;
+            float powerSum = 0.0f;
+            for (size_t k = bandStart_; k < bandEnd_; ++k) {
+                const float power = std::norm(spectrum_[k]) + 1e-12f;
+                logSum += std::log(power);
+                powerSum += power;
+            }
+            const float bins = static_cast<float>(bandEnd_ - bandStart_);
+            const float flatness = std::exp(logSum / bins) / (powerSum / bins);
+
+            speech = flatness < settings_.maxFlatness ||
+                     (zcr > settings_.fricativeZcr && aboveFloor > settings_.fricativeMarginDb);
+        }
+    }
+
+    if (energyDb < floorDb_) {
+        floorDb_ += kFloorFall * (energyDb - floorDb_);
+    } else if (!speech) {
+        floorDb_ += kFloorTrack * (energyDb - floorDb_);
+    } else {
+        floorDb_ += std::min(floorRiseDb_, kFloorTrack * (energyDb - floorDb_));
+    }
+    floorDb_ = std::max(floorDb_, kMinFloorDb);
+    return speech;
+}
+
+// --- VoiceActivityGate ---
+
+VoiceActivityGate::VoiceActivityGate(int sampleRate)
+    : detector_(sampleRate),
+      fadeSamples_(std::max<size_t>(1, static_cast<size_t>(kFadeMs * 0.001f * static_cast<float>(sampleRate)))) {
+    std::fill(std::begin(pending_), std::end(pending_), Action::Fill);
+}
+
+void VoiceActivityGate::setDecisionDelay(size_t blocks) {
+    blocks = std::min(blocks, kMaxDecisionDelay);
+    if (blocks == decisionDelay_) return;
+    decisionDelay_ = blocks;
+    std::fill(std::begin(pending_), std::end(pending_), Action::Fill);
+}
+
+bool VoiceActivityGate::analyze(const float* in, size_t numSamples, bool gated) {
+    Action action;
+    if (gated) {
+        // Entrée nulle : le VAD voit du silence, le plancher de bruit n'est pas mis à jour.
+        action = Action::Gated;
+        wasActive_ = false;
+    } else {
+        // Le modèle tourne encore sur le bloc de fin de parole, pour le fondu sortant.
+        const bool speech = detector_.process(in, numSamples);
+        if (speech) {
+            action = wasActive_ ? Action::Pass : Action::FadeIn;
+        } else {
+            action = wasActive_ ? Action::FadeOut : Action::Fill;
+        }
+        wasActive_ = speech;
+    }
+
+    // La sortie de ce bloc est celle du modèle decisionDelay_ blocs plus tôt : finish()
+    // applique la décision prise alors. Le modèle tourne tant qu'un bloc en transit en a besoin.
+    constexpr size_t kRing = kMaxDecisionDelay + 1;
+    pendingHead_ = (pendingHead_ + 1) % kRing;
+    pending_[pendingHead_] = action;
+    action_ = pending_[(pendingHead_ + kRing - decisionDelay_) % kRing];
+    bool runModel = false;
+    for (size_t i = 0; i <= decisionDelay_; ++i) {
+        runModel = runModel || usesModel(pending_[(pendingHead_ + kRing - i) % kRing]);
+    }
+
+    // Niveau du bruit de confort : plancher mesuré sur l'entrée, borné.
+    const float maxLevel = std::pow(10.0f, kMaxComfortNoiseDb / 20.0f);
+    noiseLevel_ = comfortNoise_.load()
+        ? std::min(maxLevel, detector_.noiseFloor() * std::pow(10.0f, kComfortNoiseOffsetDb / 20.0f))
+        : 0.0f;
+
+    speech_.store(detector_.isSpeech(), std::memory_order_relaxed);
+    blocks_.fetch_add(1, std::memory_order_relaxed);
+    if (!runModel) {
+        skippedBlocks_.fetch_add(1, std::memory_order_relaxed);
+        savedUs_ += inferenceUsPerSample_ * static_cast<float>(numSamples);
+        savedInferenceMs_.store(savedUs_ * 0.001f, std::memory_order_relaxed);
+    }
+    return runModel;
+}
+
+void VoiceActivityGate::recordInference(float durationUs, size_t numSamples) {
+    if (numSamples == 0) return;
+    const float perSample = durationUs / static_cast<float>(numSamples);
+    inferenceUsPerSample_ = inferenceUsPerSample_ == 0.0f
+        ? perSample
+        : inferenceUsPerSample_ + kCostSmoothing * (perSample - inferenceUsPerSample_);
+}
+
+/**
+ * Générateur xorshift32, filtré par un passe-bas à un pôle. La variance d'un tel filtre
+ * vaut (1 - a) / (1 + a) fois celle de l'entrée : le gain la ramène au niveau visé.
+ */
+float VoiceActivityGate::nextNoise() {
+    noiseState_ ^= noiseState_ << 13;
+    noiseState_ ^= noiseState_ >> 17;
+    noiseState_ ^= noiseState_ << 5;
+    // Uniforme sur [-1, 1) : valeur efficace 1/sqrt(3)
+    const float white = static_cast<float>(static_cast<int32_t>(noiseState_)) * (1.0f / 2147483648.0f);
+    noiseLowpass_ += (1.0f - kNoiseLowpass) * (white - noiseLowpass_);
+    constexpr float kNormalization = 1.7320508f * 2.0f; // sqrt(3) * sqrt((1 + a) / (1 - a)), a = 0.6
+    return noiseLowpass_ * kNormalization * noiseLevel_;
+}
+
+// Fondu à puissance constante (signaux décorrélés) entre la sortie du modèle et le bruit
+// de confort, au début du bloc ; le reste du bloc est le signal d'arrivée.
+void VoiceActivityGate::crossfade(float* buffer, size_t numSamples, bool fadeIn) {
+    const size_t fade = std::min(fadeSamples_, numSamples);
+    const float step = kHalfPi / static_cast<float>(fade);
+    for (size_t i = 0; i < fade; ++i) {
+        const float theta = (static_cast<float>(i) + 0.5f) * step;
+        const float modelGain = fadeIn ? std::sin(theta) : std::cos(theta);
+        const float noiseGain = fadeIn ? std::cos(theta) : std::sin(theta);
+        buffer[i] = buffer[i] * modelGain + nextNoise() * noiseGain;
+    }
+    if (!fadeIn) {
+        for (size_t i = fade; i < numSamples; ++i) buffer[i] = nextNoise();
+    }
+}
+
+void VoiceActivityGate::finish(float* buffer, size_t numSamples) {
+    switch (action_) {
+    case Action::Pass:
+        break;
+    case Action::Gated:
+        // Nul à l'entrée ; avec un retard de décision, le modèle a pu tourner sur ce bloc.
+        std::fill(buffer, buffer + numSamples, 0.0f);
+        break;
+    case Action::FadeIn:
+        crossfade(buffer, numSamples, true);
+        break;
+    case Action::FadeOut:
+        crossfade(buffer, numSamples, false);
+        break;
+    case Action::Fill:
+        if (noiseLevel_ == 0.0f) {
+            std::fill(buffer, buffer + numSamples, 0.0f);
+        } else {
+            for (size_t i = 0; i < numSamples; ++i) buffer[i] = nextNoise();
+        }
+        break;
+    }
+}
+
+VoiceActivityGate::Stats VoiceActivityGate::stats() const {
+    Stats stats;
+    stats.speech = speech_.load(std::memory_order_relaxed);
+    stats.blocks = blocks_.load(std::memory_order_relaxed);
+    stats.skippedBlocks = skippedBlocks_.load(std::memory_order_relaxed);
+    stats.skipRatio = stats.blocks > 0 ? static_cast<float>(stats.skippedBlocks) / static_cast<float>(stats.blocks) : 0.0f;
+    stats.savedInferenceMs = savedInferenceMs_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace rvc
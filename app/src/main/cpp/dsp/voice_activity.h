@@ -0,0 +1,161 @@
+#pragma once
+
+#include "dsp/fft.h"
+#include <atomic>
+#include <complex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Détecteur d'activité vocale en flux (V16.0).
+ *
+ * Trames d'~10 ms (puissance de 2 pour la FFT) : énergie comparée à un plancher de bruit
+ * adaptatif, platitude spectrale entre 100 Hz et 4 kHz (spectre harmonique des voyelles)
+ * et taux de passages par zéro (consonnes sifflantes). Après la dernière trame de parole,
+ * la décision est maintenue (hangover) pour ne pas couper les fins de mots ni les pauses
+ * courtes. Une trame incomplète en fin de bloc peut déclencher le début de parole sur son
+ * énergie seule, sans attendre le bloc suivant.
+ */
+class VoiceActivityDetector {
+public:
+    struct Settings {
+        float marginDb = 9.0f;           // Écart minimal au plancher de bruit
+        float minSpeechDb = -55.0f;      // Jamais de parole sous ce niveau (dBFS)
+        float maxFlatness = 0.4f;        // Voyelles : spectre harmonique, platitude basse
+        float fricativeZcr = 0.15f;      // Sifflantes : spectre plat mais passages par zéro fréquents...
+        float fricativeMarginDb = 15.0f; // ...acceptées seulement nettement au-dessus du bruit
+        float hangoverMs = 200.0f;
+    };
+
+    explicit VoiceActivityDetector(int sampleRate);
+    VoiceActivityDetector(int sampleRate, const Settings& settings);
+
+    // Analyse un bloc sans le modifier ; retourne isSpeech().
+    bool process(const float* in, size_t numSamples);
+
+    bool isSpeech() const { return hangoverCounter_ > 0; }
+
+    // Plancher de bruit estimé (valeur efficace, linéaire).
+    float noiseFloor() const;
+
+    size_t frameSize() const { return frameSize_; }
+
+private:
+    bool isSpeechFrame();
+    void markSpeech() { hangoverCounter_ = hangoverFrames_; }
+
+    Settings settings_;
+    size_t frameSize_;
+    size_t hangoverFrames_;
+    float floorRiseDb_; // Remontée max du plancher par trame de parole
+    size_t bandStart_;  // Bins de la bande d'analyse de la platitude
+    size_t bandEnd_;
+
+    RealFFT fft_;
+    std::vector<float> window_;
+    std::vector<float> frame_;
+    std::vector<float> windowed_;
+    std::vector<std::complex<float>> spectrum_;
+    size_t frameFill_ = 0;
+    float frameEnergy_ = 0.0f; // Somme des carrés de la trame en cours
+
+    float floorDb_ = -70.0f; // Énergie moyenne du bruit (dBFS)
+    size_t hangoverCounter_ = 0;
+};
+
+/**
+ * Saut de l'inférence hors parole (V16.0).
+ *
+ * analyze() reçoit l'entrée du modèle (après le pré-traitement) et décide si le modèle doit
+ * tourner ; finish() reçoit le bloc après l'inférence (ou à sa place). Hors parole, la sortie
+ * est un bruit de confort au niveau du bruit de fond mesuré (ou du silence), avec un fondu
+ * enchaîné à puissance constante à chaque transition : au début de parole depuis le bruit
+ * de confort, et à la fin de parole, où le modèle tourne un dernier bloc pour le fondu.
+ * Les blocs déjà fermés par le Noise Gate restent nuls, comme avant.
+ *
+ * Inférence pipelinée (voir InferencePipeline) : la sortie du modèle pour le bloc k arrive
+ * au bloc k + delay. Les décisions sont alors retardées d'autant (setDecisionDelay) pour
+ * s'appliquer au bloc qu'elles concernent, et le modèle continue de tourner tant qu'un bloc
+ * de parole est en transit : la fin de la parole sort du pipeline avant qu'il soit réinitialisé.
+ */
+class VoiceActivityGate {
+public:
+    struct Stats {
+        bool speech;            // Dernière décision du VAD
+        uint32_t blocks;        // Blocs traités depuis l'initialisation
+        uint32_t skippedBlocks; // ...dont blocs où le modèle n'a pas tourné
+        float skipRatio;
+        float savedInferenceMs; // Temps d'inférence évité (estimé sur la durée mesurée du modèle)
+    };
+
+    // Plus grand retard de décision, en blocs.
+    static constexpr size_t kMaxDecisionDelay = 4;
+
+    explicit VoiceActivityGate(int sampleRate);
+
+    // N'importe quel thread : bruit de confort (défaut) ou silence hors parole.
+    void setComfortNoise(bool enabled) { comfortNoise_.store(enabled); }
+
+    // Thread audio, avant analyze() : retard en blocs entre l'entrée et la sortie du modèle
+    // (0 : inférence synchrone). Un changement oublie les décisions en transit.
+    void setDecisionDelay(size_t blocks);
+
+    // Thread audio. gated : bloc déjà fermé par le Noise Gate (buffer nul).
+    // Retourne vrai si le modèle doit tourner sur ce bloc.
+    bool analyze(const float* in, size_t numSamples, bool gated);
+
+    // Thread audio : durée mesurée de l'inférence du bloc (sert à l'estimation du gain).
+    void recordInference(float durationUs, size_t numSamples);
+
+    // Thread audio, après analyze() (et l'inférence éventuelle).
+    void finish(float* buffer, size_t numSamples);
+
+    // N'importe quel thread.
+    Stats stats() const;
+
+private:
+    enum class Action {
+        Pass,    // Parole : sortie du modèle inchangée
+        Gated,   // Bloc nul du Noise Gate : inchangé
+        FadeIn,  // Début de parole : bruit de confort -> modèle
+        FadeOut, // Fin de parole : modèle -> bruit de confort
+        Fill,    // Hors parole : bruit de confort seul
+    };
+
+    static bool usesModel(Action action) {
+        return action == Action::Pass || action == Action::FadeIn || action == Action::FadeOut;
+    }
+    float nextNoise();
+    void crossfade(float* buffer, size_t numSamples, bool fadeIn);
+
+    VoiceActivityDetector detector_;
+    size_t fadeSamples_;
+    Action action_ = Action::Fill; // Décision appliquée par finish() (retardée)
+    bool wasActive_ = false; // Sortie du modèle utilisée au bloc précédent
+
+    // Décisions des derniers blocs (anneau, la plus récente en pendingHead_)
+    Action pending_[kMaxDecisionDelay + 1] = {};
+    size_t pendingHead_ = 0;
+    size_t decisionDelay_ = 0;
+
+    // Bruit de confort : blanc légèrement filtré passe-bas, gain normalisé
+    uint32_t noiseState_ = 0x2545F491u;
+    float noiseLowpass_ = 0.0f;
+    float noiseLevel_ = 0.0f;
+    std::atomic<bool> comfortNoise_{true};
+
+    // Estimation du coût de l'inférence (thread audio)
+    float inferenceUsPerSample_ = 0.0f;
+    float savedUs_ = 0.0f;
+
+    // Statistiques publiées
+    std::atomic<bool> speech_{false};
+    std::atomic<uint32_t> blocks_{0};
+    std::atomic<uint32_t> skippedBlocks_{0};
+    std::atomic<float> savedInferenceMs_{0.0f};
+};
+
+} // namespace rvc
@@ -0,0 +1,195 @@
+#include "dsp/worker_pool.h"
+#include "dsp/denormals.h"
+#include "security/lock_manager.h" // Priorité SCHED_FIFO des workers
+#include <algorithm>
+#include <android/log.h>
+#include <chrono>
+#include <climits>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define LOG_TAG "RVC_WORKER_POOL"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace rvc {
+
+namespace {
+
+// Itérations d'attente active avant le futex (~10-50 µs selon le cœur) : couvre l'écart
+// entre deux vagues d'un bloc, pas l'écart entre deux blocs.
+constexpr int kSpinIterations = 4096;
+
+// Mesures de calibration du coût de distribution (médiane).
+constexpr int kCalibrationRuns = 9;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "le futex opère directement sur le mot atomique");
+
+inline void cpuRelax() {
+#if defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+long futex(std::atomic<uint32_t>* word, int op, uint32_t value) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+// --- FutexWord ---
+
+void FutexWord::waitWhileEqual(uint32_t value) {
+    for (int i = 0; i < kSpinIterations; ++i) {
+        if (value_.load() != value) return;
+        cpuRelax();
+    }
+    // Ordre séquentiel : soit l'écrivain voit sleepers_ > 0 et réveille, soit ce thread
+    // voit la nouvelle valeur (le futex revérifie la valeur de manière atomique).
+    sleepers_.fetch_add(1);
+    while (value_.load() == value) {
+        futex(&value_, FUTEX_WAIT_PRIVATE, value);
+    }
+    sleepers_.fetch_sub(1);
+}
+
+void FutexWord::wakeAll() {
+    if (sleepers_.load() != 0) {
+        futex(&value_, FUTEX_WAKE_PRIVATE, INT_MAX);
+    }
+}
+
+// --- WorkerPool ---
+
+size_t WorkerPool::defaultWorkerCount() {
+    const unsigned cores = std::thread::hardware_concurrency();
+    return cores > 2 ? std::min<size_t>(3, cores - 2) : 0;
+}
+
+WorkerPool::WorkerPool(size_t numWorkers) {
+    // Les index de tâches tiennent sur 16 bits (voir ticket_).
+    numWorkers = std::min<size_t>(numWorkers, 64);
+    threads_.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+    if (numWorkers > 0) calibrate();
+    LOGI("Pool de %zu workers, coût de distribution %.1f µs.", numWorkers, dispatchOverheadNs_ / 1000.0f);
+}
+
+WorkerPool::~WorkerPool() {
+    stop_.store(true);
+    wake_.fetchAdd(1);
+    wake_.wakeAll();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::workerLoop(size_t index) {
+    // Épinglage : worker i sur le cœur (N - 1 - i).
+    const unsigned cores = std::thread::hardware_concurrency();
+    if (cores > index) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cores - 1 - index, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            LOGE("Worker %zu : épinglage sur le cœur %zu refusé.", index, static_cast<size_t>(cores - 1 - index));
+        }
+    }
+    // Peut échouer hors thread audio système : le worker reste alors en priorité normale.
+    LockManager::getInstance()->setRealTimePriority();
+    ScopedFlushDenormals::enableForCurrentThread();
+
+    uint32_t seen = 0;
+    while (true) {
+        wake_.waitWhileEqual(seen);
+        seen = wake_.load();
+        if (stop_.load()) return;
+        drain();
+    }
+}
+
+/**
+ * Prend des tâches de la vague courante jusqu'à épuisement. Le CAS sur le ticket complet
+ * (génération incluse) empêche un thread en retard de consommer un index d'une vague
+ * suivante avec les paramètres de la précédente.
+ */
+void WorkerPool::drain() {
+    uint64_t ticket = ticket_.load(std::memory_order_acquire);
+    while (true) {
+        const uint64_t index = ticket & kIndexMask;
+        const uint64_t count = (ticket >> kCountShift) & kIndexMask;
+        if (index >= count) return;
+        if (!ticket_.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+            continue;
+        }
+        task_(context_, static_cast<size_t>(index));
+        if (remaining_.fetchSub(1) == 1) {
+            remaining_.wakeAll();
+        }
+        ticket = ticket_.load(std::memory_order_acquire);
+    }
+}
+
+void WorkerPool::run(Task task, void* context, size_t count) {
+    if (threads_.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i) task(context, i);
+        return;
+    }
+
+    task_ = task;
+    context_ = context;
+    remaining_.store(static_cast<uint32_t>(count));
+    ++generation_;
+    ticket_.store((static_cast<uint64_t>(generation_) << 32) | (static_cast<uint64_t>(count) << kCountShift),
+                  std::memory_order_release);
+    wake_.fetchAdd(1);
+    wake_.wakeAll();
+
+    // Le thread appelant participe, puis attend la barrière de fin.
+    drain();
+    uint32_t left;
+    while ((left = remaining_.load()) != 0) {
+        remaining_.waitWhileEqual(left);
+    }
+}
+
+/**
+ * Mesure du pire cas réaliste : workers endormis sur le futex (début de bloc audio).
+ * Chaque participant prend exactement une tâche et attend les autres, le temps mesuré
+ * couvre donc le réveil du worker le plus lent et la barrière.
+ */
+void WorkerPool::calibrate() {
+    struct Rendezvous {
+        std::atomic<size_t> arrived{0};
+        size_t count = 0;
+    };
+    Rendezvous rendezvous;
+    rendezvous.count = threads_.size() + 1;
+    auto meet = [](void* context, size_t) {
+        Rendezvous* r = static_cast<Rendezvous*>(context);
+        r->arrived.fetch_add(1);
+        while (r->arrived.load() < r->count) cpuRelax();
+    };
+
+    std::vector<float> samples;
+    for (int run = 0; run < kCalibrationRuns; ++run) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2)); // Laisse les workers s'endormir
+        rendezvous.arrived.store(0);
+        const auto start = std::chrono::steady_clock::now();
+        this->run(meet, &rendezvous, rendezvous.count);
+        const auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<float, std::nano>(end - start).count());
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    dispatchOverheadNs_ = samples[samples.size() / 2];
+}
+
+} // namespace rvc
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Mot de synchronisation 32 bits : attente active courte, puis futex.
+ *
+ * Entre deux vagues d'un même bloc, l'attente active évite le coût d'un appel système ;
+ * entre deux blocs audio (plusieurs ms), l'attente bascule sur le futex et le cœur est
+ * rendu au système. wakeAll() ne fait d'appel système que si un thread dort réellement.
+ */
+class FutexWord {
+public:
+    uint32_t load() const { return value_.load(); }
+    void store(uint32_t value) { value_.store(value); }
+    uint32_t fetchAdd(uint32_t delta) { return value_.fetch_add(delta); }
+    uint32_t fetchSub(uint32_t delta) { return value_.fetch_sub(delta); }
+
+    // Retourne dès que la valeur diffère de `value`.
+    void waitWhileEqual(uint32_t value);
+    void wakeAll();
+
+private:
+    std::atomic<uint32_t> value_{0};
+    std::atomic<uint32_t> sleepers_{0};
+};
+
+/**
+ * Pool fixe de workers temps réel pour les branches indépendantes du graphe d'effets.
+ *
+ * Chaque worker est épinglé sur un cœur (les plus hauts indices : cœurs "big" sur les SoC
+ * big.LITTLE) et demande SCHED_FIFO via le LockManager. Un seul thread (le thread audio)
+ * appelle run() à la fois : il publie la vague, y participe lui-même, puis attend la
+ * barrière de fin. Aucune allocation ni verrou dans run().
+ */
+class WorkerPool {
+public:
+    using Task = void (*)(void* context, size_t index);
+
+    // Nombre de workers par défaut : laisse au moins deux cœurs au système et au thread audio.
+    static size_t defaultWorkerCount();
+
+    explicit WorkerPool(size_t numWorkers);
+    ~WorkerPool();
+
+    WorkerPool(WorkerPool const&) = delete;
+    void operator=(WorkerPool const&) = delete;
+
+    size_t numWorkers() const { return threads_.size(); }
+
+    // Exécute task(context, i) pour i dans [0, count) et retourne quand tout est terminé.
+    void run(Task task, void* context, size_t count);
+
+    // Coût mesuré d'une distribution (réveil des workers endormis + barrière), en ns :
+    // le graphe ne parallélise une vague que si le travail déporté le dépasse.
+    float dispatchOverheadNs() const { return dispatchOverheadNs_; }
+
+private:
+    // Ticket de la vague en cours : [génération:32][nombre de tâches:16][prochain index:16].
+    static constexpr int kCountShift = 16;
+    static constexpr uint64_t kIndexMask = 0xFFFF;
+
+    void workerLoop(size_t index);
+    void drain();
+    void calibrate();
+
+    std::vector<std::thread> threads_;
+    std::atomic<bool> stop_{false};
+
+    FutexWord wake_;      // Incrémenté à chaque vague publiée
+    FutexWord remaining_; // Tâches non terminées de la vague en cours
+    std::atomic<uint64_t> ticket_{0};
+    uint32_t generation_ = 0;
+
+    // Vague en cours (publiée avant le ticket, stable jusqu'à la fin de la barrière)
+    Task task_ = nullptr;
+    void* context_ = nullptr;
+
+    float dispatchOverheadNs_ = 0.0f;
+};
+
+} // namespace rvc
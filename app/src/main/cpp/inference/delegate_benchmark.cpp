@@ -0,0 +1,141 @@
+#include "inference/delegate_benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace rvc {
+
+namespace {
+
+// Inférence de chauffe au-delà de kWarmupAbortFactor fois la limite : configuration hors
+// course, sans chronométrer la série (un CPU sur un thread peut prendre des centaines de ms).
+constexpr float kWarmupAbortFactor = 4.0f;
+constexpr float kPercentile = 0.95f;
+
+// Rang le plus proche sur des valeurs triées.
+float percentile(const std::vector<float>& sorted, float p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<float>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+float elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+float DelegateBenchmark::deadlineMs(size_t blockSamples, int sampleRate) {
+    if (sampleRate <= 0) return 0.0f;
+    return kDeadlineFraction * 1000.0f * static_cast<float>(blockSamples) / static_cast<float>(sampleRate);
+}
+
+float DelegateBenchmark::stageDeadlineMs(size_t blockSamples, int sampleRate) {
+    if (sampleRate <= 0) return 0.0f;
+    return kStageDeadlineFraction * 1000.0f * static_cast<float>(blockSamples) / static_cast<float>(sampleRate);
+}
+
+std::vector<BackendConfig> DelegateBenchmark::candidates() {
+    const unsigned cores = std::thread::hardware_concurrency();
+    const int maxThreads = cores > 2 ? static_cast<int>(cores - 2) : 1;
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::vector<BackendConfig> configs;
+#ifdef __ANDROID__
+    // Délégués : le CPU ne porte que les partitions non déléguées, deux threads suffisent.
+    const int delegateThreads = std::min(2, maxThreads);
+    configs.push_back({DelegateType::DSP, CpuProvider::Default, delegateThreads});
+    configs.push_back({DelegateType::GPU, CpuProvider::Default, delegateThreads});
+#endif
+    for (CpuProvider provider : {CpuProvider::XNNPack, CpuProvider::Default}) {
+        for (int threads : threadCounts) {
+            configs.push_back({DelegateType::CPU, provider, threads});
+        }
+    }
+    return configs;
+}
+
+LatencyStats DelegateBenchmark::measure(const std::function<void()>& run) const {
+    LatencyStats stats;
+    const float deadline = settings_.deadlineMs;
+    for (size_t i = 0; i < settings_.warmupRuns; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const float ms = elapsedMs(start);
+        if (deadline > 0.0f && ms > kWarmupAbortFactor * deadline) {
+            stats.runs = 1;
+            stats.meanMs = stats.p50Ms = stats.p95Ms = stats.maxMs = ms;
+            stats.overruns = 1;
+            stats.rejected = true;
+            return stats;
+        }
+    }
+
+    // Au-delà de allowed dépassements, le p95 (rang ceil(0.95 n)) dépasse la limite.
+    const size_t n = std::max<size_t>(1, settings_.timedRuns);
+    const size_t allowed = n - static_cast<size_t>(std::ceil(kPercentile * static_cast<float>(n)));
+    std::vector<float> samples;
+    samples.reserve(n);
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const float ms = elapsedMs(start);
+        samples.push_back(ms);
+        total += ms;
+        if (deadline > 0.0f && ms > deadline && ++stats.overruns > allowed) {
+            stats.rejected = true;
+            break;
+        }
+    }
+
+    std::sort(samples.begin(), samples.end());
+    stats.runs = samples.size();
+    stats.meanMs = static_cast<float>(total / static_cast<double>(samples.size()));
+    stats.p50Ms = percentile(samples, 0.5f);
+    stats.p95Ms = percentile(samples, kPercentile);
+    stats.maxMs = samples.back();
+    return stats;
+}
+
+const BackendResult* DelegateBenchmark::select(const std::vector<BackendResult>& results) const {
+    const float deadline = settings_.deadlineMs;
+    auto meets = [&](const BackendResult& result) {
+        return !result.stats.rejected && (deadline <= 0.0f || result.stats.p95Ms <= deadline);
+    };
+    const BackendResult* best = nullptr;
+    bool bestMeets = false;
+    for (const BackendResult& result : results) {
+        if (!result.available) continue;
+        const bool resultMeets = meets(result);
+        if (best == nullptr || (resultMeets && !bestMeets) ||
+            (resultMeets == bestMeets && result.stats.p95Ms < best->stats.p95Ms)) {
+            best = &result;
+            bestMeets = resultMeets;
+        }
+    }
+    if (best == nullptr || !bestMeets) return best;
+
+    const BackendResult* chosen = best;
+    for (const BackendResult& result : results) {
+        if (result.available && meets(result) && result.stats.p95Ms <= kThreadTolerance * best->stats.p95Ms &&
+            result.backend.numThreads < chosen->backend.numThreads) {
+            chosen = &result;
+        }
+    }
+    return chosen;
+}
+
+std::string DelegateBenchmark::describe(const BackendConfig& backend) {
+    std::string name;
+    switch (backend.delegate) {
+        case DelegateType::DSP: name = "DSP (Hexagon)"; break;
+        case DelegateType::GPU: name = "GPU"; break;
+        case DelegateType::CPU: name = backend.provider == CpuProvider::XNNPack ? "CPU XNNPACK" : "CPU"; break;
+    }
+    return name + " x" + std::to_string(backend.numThreads);
+}
+
+} // namespace rvc
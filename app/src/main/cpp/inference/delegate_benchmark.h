@@ -0,0 +1,99 @@
+#pragma once
+
+#include <functional>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace rvc {
+
+enum class DelegateType { DSP, GPU, CPU };
+// Noyaux CPU : ceux du moteur (TFLite intégré, ONNX Runtime CPU EP) ou XNNPACK.
+enum class CpuProvider { Default, XNNPack };
+
+/**
+ * Configuration d'exécution d'un modèle : délégué, noyaux CPU et threads du CPU (noyaux CPU,
+ * ou partitions non déléguées du graphe).
+ */
+struct BackendConfig {
+    DelegateType delegate = DelegateType::CPU;
+    CpuProvider provider = CpuProvider::Default;
+    int numThreads = 1;
+};
+
+/**
+ * Latences d'une série d'inférences, en ms. Percentiles au rang le plus proche.
+ */
+struct LatencyStats {
+    size_t runs = 0;
+    float meanMs = 0.0f;
+    float p50Ms = 0.0f;
+    float p95Ms = 0.0f;
+    float maxMs = 0.0f;
+    size_t overruns = 0;    // Inférences au-delà de la limite
+    bool rejected = false;  // Mesure arrêtée : le p95 ne pouvait plus tenir la limite
+};
+
+struct BackendResult {
+    BackendConfig backend;
+    bool available = false; // Refusé par le moteur (délégué absent)
+    LatencyStats stats;     // Pipeliné : celles de l'étage limitant
+    // Inférence pipelinée : chaque étage mesuré seul, contre la limite d'un étage.
+    bool pipelined = false;
+    LatencyStats encoderStats;
+    LatencyStats synthesizerStats;
+};
+
+/**
+ * Benchmark des backends d'inférence au chargement du modèle (V16.0) : chaque configuration
+ * fait warmupRuns inférences non mesurées (compilation des noyaux GPU/DSP, caches, montée en
+ * fréquence du CPU), puis timedRuns inférences chronométrées, à la taille de bloc réelle.
+ *
+ * Le choix se fait sur le p95 et non sur la moyenne : un délégué rapide en moyenne mais
+ * irrégulier (GPU partagé avec l'affichage, DSP qui se réveille) fait des blocs en retard,
+ * donc des craquements. Une configuration est arrêtée dès que plus de 5 % des mesures
+ * dépassent la limite : son p95 ne peut plus la tenir, inutile de finir la série.
+ */
+class DelegateBenchmark {
+public:
+    struct Settings {
+        size_t warmupRuns = 5;
+        size_t timedRuns = 50;
+        float deadlineMs = 0.0f; // Limite par inférence ; 0 : pas de limite
+    };
+
+    // Part de la durée du bloc laissée à l'inférence : le reste va à la chaîne d'effets et
+    // à la gigue de l'ordonnanceur.
+    static constexpr float kDeadlineFraction = 0.8f;
+    // p95 à 5 % près du meilleur : la configuration avec le moins de threads l'emporte
+    // (cœurs laissés au thread audio et aux workers).
+    static constexpr float kThreadTolerance = 1.05f;
+
+    // Étage du pipeline d'inférence : sur son propre thread, en parallèle de la chaîne d'effets,
+    // il dispose de la durée du bloc, moins la gigue de l'ordonnanceur.
+    static constexpr float kStageDeadlineFraction = 0.9f;
+
+    static float deadlineMs(size_t blockSamples, int sampleRate);
+    static float stageDeadlineMs(size_t blockSamples, int sampleRate);
+
+    // Configurations candidates sur cette plateforme. Android : DSP (Hexagon), GPU, puis les
+    // noyaux CPU ; ailleurs (Linux hôte), les noyaux CPU seulement. Noyaux CPU avec 1, 2, 4...
+    // threads, sans dépasser les cœurs moins deux (comme WorkerPool).
+    static std::vector<BackendConfig> candidates();
+
+    explicit DelegateBenchmark(const Settings& settings) : settings_(settings) {}
+
+    // Chronomètre run() (une inférence complète) selon les réglages.
+    LatencyStats measure(const std::function<void()>& run) const;
+
+    // Configuration retenue : p95 minimal parmi celles qui tiennent la limite ; à défaut
+    // (aucune ne la tient), p95 minimal. nullptr si aucune n'est disponible.
+    const BackendResult* select(const std::vector<BackendResult>& results) const;
+
+    static std::string describe(const BackendConfig& backend);
+
+private:
+    Settings settings_;
+};
+
+} // namespace rvc
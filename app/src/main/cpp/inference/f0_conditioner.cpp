@@ -0,0 +1,98 @@
+#include "inference/f0_conditioner.h"
+#include <algorithm>
+#include <cmath>
+
+namespace rvc {
+
+namespace {
+
+// Degrés de chaque gamme (bit n : n demi-tons au-dessus de la tonique).
+constexpr uint16_t kChromaticMask = 0x0FFF;
+constexpr uint16_t kMajorMask = (1 << 0) | (1 << 2) | (1 << 4) | (1 << 5) | (1 << 7) | (1 << 9) | (1 << 11);
+constexpr uint16_t kMinorMask = (1 << 0) | (1 << 2) | (1 << 3) | (1 << 5) | (1 << 7) | (1 << 8) | (1 << 10);
+
+uint16_t scaleMask(PitchScale scale) {
+    switch (scale) {
+        case PitchScale::Major: return kMajorMask;
+        case PitchScale::Minor: return kMinorMask;
+        case PitchScale::Chromatic:
+        default: return kChromaticMask;
+    }
+}
+
+float melScale(float f0Hz) {
+    return 1127.0f * std::log(1.0f + f0Hz / 700.0f);
+}
+
+} // namespace
+
+void F0Conditioner::setVoice(const VoiceParameters& voice) {
+    ratio_ = std::exp2(std::clamp(voice.pitchSemitones, -12.0f, 12.0f) / 12.0f);
+    scale_ = voice.scale;
+    scaleRoot_ = ((voice.scaleRoot % 12) + 12) % 12;
+}
+
+void F0Conditioner::reset() {
+    historySize_ = 0;
+    historyWrite_ = 0;
+    heldF0_ = 0.0f;
+    gapHops_ = 0;
+}
+
+F0Frame F0Conditioner::condition(const PitchTracker::Estimate& estimate) {
+    F0Frame frame;
+    if (estimate.voiced && estimate.f0Hz > 0.0f) {
+        history_[historyWrite_] = std::log2(estimate.f0Hz);
+        historyWrite_ = (historyWrite_ + 1) % kMedianHops;
+        historySize_ = std::min(historySize_ + 1, kMedianHops);
+
+        float sorted[kMedianHops];
+        std::copy(history_, history_ + historySize_, sorted);
+        std::nth_element(sorted, sorted + historySize_ / 2, sorted + historySize_);
+        heldF0_ = std::exp2(sorted[historySize_ / 2]);
+        gapHops_ = 0;
+    } else if (heldF0_ > 0.0f && gapHops_ < kMaxGapHops) {
+        // Trou court (consonne voisée faible, chute de probabilité) : F0 maintenue.
+        ++gapHops_;
+    } else {
+        reset();
+        return frame;
+    }
+
+    frame.f0Hz = quantize(heldF0_ * ratio_);
+    frame.coarse = coarsePitch(frame.f0Hz);
+    return frame;
+}
+
+/**
+ * Note autorisée la plus proche (en demi-tons tempérés, la 440 Hz) de la F0 transposée.
+ */
+float F0Conditioner::quantize(float f0Hz) const {
+    if (scale_ == PitchScale::Off) return f0Hz;
+
+    const float note = 69.0f + 12.0f * std::log2(f0Hz / 440.0f);
+    const uint16_t mask = scaleMask(scale_);
+    const int nearest = static_cast<int>(std::lround(note));
+    int best = nearest;
+    float bestDistance = 12.0f;
+    // Deux degrés consécutifs d'une gamme sont au plus à 2 demi-tons : ±2 suffit.
+    for (int candidate = nearest - 2; candidate <= nearest + 2; ++candidate) {
+        const int degree = ((candidate - scaleRoot_) % 12 + 12) % 12;
+        const float distance = std::fabs(static_cast<float>(candidate) - note);
+        if ((mask & (1 << degree)) != 0 && distance < bestDistance) {
+            best = candidate;
+            bestDistance = distance;
+        }
+    }
+    return 440.0f * std::exp2((static_cast<float>(best) - 69.0f) / 12.0f);
+}
+
+int F0Conditioner::coarsePitch(float f0Hz) {
+    if (f0Hz <= 0.0f) return 1;
+    const float melMin = melScale(kCoarseMinHz);
+    const float melMax = melScale(kCoarseMaxHz);
+    const float coarse = (melScale(f0Hz) - melMin) * 254.0f / (melMax - melMin) + 1.0f;
+    return std::clamp(static_cast<int>(std::lround(coarse)), 1, 255);
+}
+
+} // namespace rvc
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "dsp/pitch_tracker.h"
+#include "inference/voice_parameters.h"
+#include <stddef.h>
+
+namespace rvc {
+
+// F0 d'une trame du modèle (10 ms), sous les deux formes d'entrée de RVC.
+struct F0Frame {
+    float f0Hz = 0.0f; // pitchf : 0 si non voisé
+    int coarse = 1;    // pitch : échelle mel quantifiée sur 1..255 (1 = non voisé)
+};
+
+/**
+ * Conditionnement du contour de F0 avant la synthèse (V16.0), une trame par pas du
+ * PitchTracker (même cadence que les trames du modèle) :
+ *   - lissage médian causal (log-fréquence) des trames voisées, contre les sauts isolés ;
+ *   - segments non voisés : les trous courts dans une voyelle gardent la dernière F0,
+ *     au-delà la trame est non voisée et le lissage repart de zéro ;
+ *   - transposition (demi-tons et cents du profil), puis quantification optionnelle sur
+ *     une gamme.
+ * Thread audio uniquement ; setVoice() est assez léger pour être appelé à chaque bloc.
+ */
+class F0Conditioner {
+public:
+    static constexpr size_t kMedianHops = 5;
+    // Retard du médian causal : la trame lissée décrit le centre de sa fenêtre.
+    static constexpr size_t kMedianDelayHops = kMedianHops / 2;
+    static constexpr size_t kMaxGapHops = 3; // Trou comblé jusqu'à 30 ms
+    // Bornes de l'échelle coarse de RVC (f0_min / f0_max).
+    static constexpr float kCoarseMinHz = 50.0f;
+    static constexpr float kCoarseMaxHz = 1100.0f;
+
+    void setVoice(const VoiceParameters& voice);
+    F0Frame condition(const PitchTracker::Estimate& estimate);
+    void reset();
+
+    static int coarsePitch(float f0Hz);
+
+private:
+    float quantize(float f0Hz) const;
+
+    float ratio_ = 1.0f; // 2^(demi-tons / 12)
+    PitchScale scale_ = PitchScale::Off;
+    int scaleRoot_ = 0;
+
+    float history_[kMedianHops] = {}; // log2(F0) des dernières trames voisées
+    size_t historySize_ = 0;
+    size_t historyWrite_ = 0;
+    float heldF0_ = 0.0f; // Dernière F0 lissée (avant transposition)
+    size_t gapHops_ = 0;
+};
+
+} // namespace rvc
@@ -0,0 +1,283 @@
+#include "inference/feature_index.h"
+#include "dsp/crc32.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rvc {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "le format RVCI est petit-boutiste");
+static_assert(sizeof(FeatureIndex::Header) == 80,
+              "disposition figée par la version du format (voir tools/feature_index)");
+
+namespace {
+
+constexpr uint32_t kMaxDim = 4096;
+constexpr float kMinDistance = 1e-8f;
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+bool allFinite(const float* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(values[i])) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::unique_ptr<FeatureIndex> FeatureIndex::open(const std::string& path, std::string* error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fail(error, "index introuvable '" + path + "'");
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        fail(error, "index tronqué '" + path + "'");
+        return nullptr;
+    }
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // La projection reste valide après la fermeture
+    if (data == MAP_FAILED) {
+        fail(error, "mmap de l'index refusé '" + path + "'");
+        return nullptr;
+    }
+
+    std::unique_ptr<FeatureIndex> index(new FeatureIndex());
+    index->data_ = data;
+    index->size_ = size;
+    if (!index->validate(error)) return nullptr;
+
+    index->centroidNorms_.resize(index->numLists());
+    for (size_t list = 0; list < index->numLists(); ++list) {
+        const float* c = index->centroid(list);
+        index->centroidNorms_[list] = simd::dot(c, c, index->dim());
+    }
+    return index;
+}
+
+FeatureIndex::~FeatureIndex() {
+    munmap(const_cast<void*>(data_), size_);
+}
+
+/**
+ * Validation de la structure : en-tête, bornes et alignement de chaque tableau, listes
+ * croissantes couvrant tous les vecteurs, centroïdes et dictionnaires finis. Les vecteurs
+ * eux-mêmes ne sont pas lus (voir la description du format).
+ */
+bool FeatureIndex::validate(std::string* error) const {
+    Header header;
+    std::memcpy(&header, data_, sizeof(Header));
+    if (header.magic != kMagic) return fail(error, "signature RVCI absente");
+    if (header.version != kVersion) {
+        return fail(error, "version d'index " + std::to_string(header.version) + " non supportée");
+    }
+    if (header.headerSize != sizeof(Header) || header.fileSize != size_) {
+        return fail(error, "taille d'index incohérente");
+    }
+    const uint32_t headerCrc = header.headerCrc;
+    header.headerCrc = 0;
+    if (crc32(&header, sizeof(Header)) != headerCrc) {
+        return fail(error, "somme de contrôle de l'en-tête invalide");
+    }
+
+    const bool quantized = header.encoding == static_cast<uint32_t>(Encoding::ProductQuantized);
+    if (header.encoding > static_cast<uint32_t>(Encoding::ProductQuantized) ||
+        header.metric > static_cast<uint32_t>(Metric::InnerProduct)) {
+        return fail(error, "encodage ou métrique inconnu");
+    }
+    if (header.dim == 0 || header.dim > kMaxDim || header.numLists == 0 || header.numVectors == 0) {
+        return fail(error, "dimensions d'index invalides");
+    }
+    if (quantized ? (header.pqSubspaces == 0 || header.dim % header.pqSubspaces != 0) : header.pqSubspaces != 0) {
+        return fail(error, "quantification par produit invalide");
+    }
+
+    auto inBounds = [&](uint64_t offset, uint64_t count, uint64_t recordSize) {
+        return offset % kAlignment == 0 && offset >= sizeof(Header) && offset <= size_ &&
+               count <= (size_ - offset) / recordSize;
+    };
+    const uint64_t vectorSize = quantized ? header.pqSubspaces : static_cast<uint64_t>(header.dim) * sizeof(float);
+    if (!inBounds(header.centroidsOffset, static_cast<uint64_t>(header.numLists) * header.dim, sizeof(float)) ||
+        !inBounds(header.listsOffset, static_cast<uint64_t>(header.numLists) + 1, sizeof(uint32_t)) ||
+        !inBounds(header.vectorsOffset, header.numVectors, vectorSize) ||
+        (quantized && !inBounds(header.codebooksOffset, static_cast<uint64_t>(kCodebookSize) * header.dim,
+                                sizeof(float)))) {
+        return fail(error, "tableaux de l'index hors du fichier");
+    }
+
+    const uint32_t* lists = at<uint32_t>(header.listsOffset);
+    if (lists[0] != 0 || lists[header.numLists] != header.numVectors) {
+        return fail(error, "listes inversées incomplètes");
+    }
+    for (size_t list = 0; list < header.numLists; ++list) {
+        if (lists[list + 1] < lists[list]) return fail(error, "listes inversées non croissantes");
+    }
+    if (!allFinite(at<float>(header.centroidsOffset), static_cast<size_t>(header.numLists) * header.dim) ||
+        (quantized && !allFinite(at<float>(header.codebooksOffset), kCodebookSize * header.dim))) {
+        return fail(error, "centroïdes non finis");
+    }
+    return true;
+}
+
+void FeatureIndex::reconstruct(size_t index, float* out) const {
+    if (encoding() == Encoding::Flat) {
+        std::memcpy(out, vector(index), dim() * sizeof(float));
+        return;
+    }
+    const size_t sub = subspaceDim();
+    const uint8_t* code = codes(index);
+    for (size_t m = 0; m < pqSubspaces(); ++m) {
+        std::memcpy(out + m * sub, codebook(m) + static_cast<size_t>(code[m]) * sub, sub * sizeof(float));
+    }
+}
+
+FeatureRetriever::FeatureRetriever(const FeatureIndex& index) : FeatureRetriever(index, Settings()) {}
+
+FeatureRetriever::FeatureRetriever(const FeatureIndex& index, const Settings& settings)
+    : index_(index), settings_(settings) {
+    settings_.k = std::clamp<size_t>(settings_.k, 1, kMaxNeighbors);
+    settings_.nprobe = std::clamp<size_t>(settings_.nprobe, 1, index.numLists());
+    settings_.maxScanned = std::max<size_t>(settings_.maxScanned, settings_.k);
+    listDistances_.resize(index.numLists());
+    listOrder_.resize(index.numLists());
+    if (index.encoding() == FeatureIndex::Encoding::ProductQuantized) {
+        lookupTable_.resize(index.pqSubspaces() * FeatureIndex::kCodebookSize);
+    }
+    neighborVector_.resize(index.dim());
+    blended_.resize(index.dim());
+}
+
+/**
+ * Listes triées par distance de la requête à leur centroïde (les nprobe premières
+ * seulement). En L2, ||q||^2 est commun à toutes les listes : ||c||^2 - 2 q.c suffit.
+ */
+void FeatureRetriever::rankLists(const float* query) {
+    const size_t dim = index_.dim();
+    const bool l2 = index_.metric() == FeatureIndex::Metric::L2;
+    for (size_t list = 0; list < index_.numLists(); ++list) {
+        const float product = simd::dot(query, index_.centroid(list), dim);
+        listDistances_[list] = l2 ? index_.centroidNorm(list) - 2.0f * product : -product;
+    }
+    std::iota(listOrder_.begin(), listOrder_.end(), 0u);
+    std::partial_sort(listOrder_.begin(), listOrder_.begin() + settings_.nprobe, listOrder_.end(),
+                      [&](uint32_t a, uint32_t b) { return listDistances_[a] < listDistances_[b]; });
+}
+
+// PQ : distance partielle de chaque sous-vecteur de la requête à chaque code (ADC).
+void FeatureRetriever::buildLookupTable(const float* query) {
+    const size_t sub = index_.subspaceDim();
+    const bool l2 = index_.metric() == FeatureIndex::Metric::L2;
+    for (size_t m = 0; m < index_.pqSubspaces(); ++m) {
+        const float* q = query + m * sub;
+        const float* codebook = index_.codebook(m);
+        float* table = lookupTable_.data() + m * FeatureIndex::kCodebookSize;
+        for (size_t code = 0; code < FeatureIndex::kCodebookSize; ++code) {
+            const float* c = codebook + code * sub;
+            table[code] = l2 ? simd::squaredDistance(q, c, sub) : -simd::dot(q, c, sub);
+        }
+    }
+}
+
+// Insertion triée dans les count meilleurs voisins (au plus k).
+void FeatureRetriever::insert(Neighbor* neighbors, size_t& count, uint32_t index, float distance) const {
+    if (count == settings_.k && distance >= neighbors[count - 1].distance) return;
+    size_t position = count < settings_.k ? count++ : count - 1;
+    while (position > 0 && neighbors[position - 1].distance > distance) {
+        neighbors[position] = neighbors[position - 1];
+        --position;
+    }
+    neighbors[position] = {index, distance};
+}
+
+size_t FeatureRetriever::search(const float* query, Neighbor* neighbors) {
+    rankLists(query);
+    const bool quantized = index_.encoding() == FeatureIndex::Encoding::ProductQuantized;
+    if (quantized) buildLookupTable(query);
+
+    const size_t dim = index_.dim();
+    const size_t subspaces = index_.pqSubspaces();
+    const bool l2 = index_.metric() == FeatureIndex::Metric::L2;
+    size_t count = 0;
+    size_t scanned = 0;
+    for (size_t p = 0; p < settings_.nprobe && scanned < settings_.maxScanned; ++p) {
+        const size_t list = listOrder_[p];
+        const size_t begin = index_.listBegin(list);
+        const size_t end = std::min(index_.listEnd(list), begin + (settings_.maxScanned - scanned));
+        for (size_t i = begin; i < end; ++i) {
+            float distance;
+            if (quantized) {
+                const uint8_t* code = index_.codes(i);
+                const float* table = lookupTable_.data();
+                distance = 0.0f;
+                for (size_t m = 0; m < subspaces; ++m, table += FeatureIndex::kCodebookSize) {
+                    distance += table[code[m]];
+                }
+            } else {
+                const float* v = index_.vector(i);
+                distance = l2 ? simd::squaredDistance(query, v, dim) : -simd::dot(query, v, dim);
+            }
+            insert(neighbors, count, static_cast<uint32_t>(i), distance);
+        }
+        scanned += end - begin;
+    }
+    lastScanned_ = scanned;
+    return count;
+}
+
+/**
+ * Mélange de RVC : poids 1 / d^2 (d : distance L2 au carré) normalisés ; en produit
+ * scalaire, poids similarité^2 (similarités négatives ignorées).
+ */
+void FeatureRetriever::blend(float* features, size_t numFrames, float indexRate) {
+    indexRate = std::clamp(indexRate, 0.0f, 1.0f);
+    if (indexRate <= 0.0f) return;
+
+    const size_t dim = index_.dim();
+    const bool l2 = index_.metric() == FeatureIndex::Metric::L2;
+    const bool flat = index_.encoding() == FeatureIndex::Encoding::Flat;
+    Neighbor neighbors[kMaxNeighbors];
+    for (size_t frame = 0; frame < numFrames; ++frame) {
+        float* f = features + frame * dim;
+        const size_t count = search(f, neighbors);
+
+        float weights[kMaxNeighbors];
+        float total = 0.0f;
+        for (size_t n = 0; n < count; ++n) {
+            const float w = l2 ? 1.0f / std::max(neighbors[n].distance, kMinDistance)
+                               : std::max(-neighbors[n].distance, 0.0f);
+            weights[n] = w * w;
+            total += weights[n];
+        }
+        if (total <= 0.0f) continue;
+
+        std::fill(blended_.begin(), blended_.end(), 0.0f);
+        for (size_t n = 0; n < count; ++n) {
+            const float* v = neighborVector_.data();
+            if (flat) {
+                v = index_.vector(neighbors[n].index);
+            } else {
+                index_.reconstruct(neighbors[n].index, neighborVector_.data());
+            }
+            simd::accumulateScaled(blended_.data(), v, weights[n] / total, dim);
+        }
+        // f <- f + indexRate (voisins - f)
+        for (size_t i = 0; i < dim; ++i) {
+            f[i] += indexRate * (blended_[i] - f[i]);
+        }
+    }
+}
+
+} // namespace rvc
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Index des features de contenu du locuteur cible (format "RVCI", V16.0), projeté en
+ * mémoire (mmap) : IVF (listes inversées autour de centroïdes k-means), vecteurs stockés
+ * en clair (IVF-flat) ou quantifiés par produit (IVF-PQ, 8 bits par sous-espace).
+ *
+ * Construit hors ligne depuis les features exportées de l'entraînement par
+ * tools/feature_index/build_feature_index.cpp. Les vecteurs d'une même liste sont contigus
+ * (ordre des listes), ce qui rend le parcours d'une liste séquentiel.
+ *
+ * Disposition (petit-boutiste, tableaux alignés sur 64 octets, décalages absolus) :
+ *   Header           80 octets
+ *   Centroïdes       float[numLists][dim]
+ *   Début des listes uint32[numLists + 1] (indice du premier vecteur de chaque liste)
+ *   Dictionnaires    float[pqSubspaces][256][dim / pqSubspaces] (IVF-PQ seulement)
+ *   Vecteurs         float[numVectors][dim] (flat) ou uint8[numVectors][pqSubspaces] (PQ)
+ * headerCrc couvre l'en-tête (champ lui-même à 0). Le contenu (plusieurs centaines de Mo
+ * en flat) n'a pas de somme de contrôle : la vérifier lirait tout le fichier à l'ouverture
+ * au lieu de laisser le noyau charger les pages parcourues. Sa structure est validée.
+ */
+class FeatureIndex {
+public:
+    static constexpr uint32_t kMagic = 0x49435652; // "RVCI"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr size_t kCodebookSize = 256;
+    static constexpr size_t kAlignment = 64;
+
+    enum class Encoding : uint32_t { Flat = 0, ProductQuantized = 1 };
+    enum class Metric : uint32_t { L2 = 0, InnerProduct = 1 };
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t headerSize;
+        uint32_t headerCrc;
+        uint32_t encoding; // Encoding
+        uint32_t metric;   // Metric
+        uint32_t dim;
+        uint32_t numLists;
+        uint32_t numVectors;
+        uint32_t pqSubspaces; // 0 en flat
+        uint32_t reserved;
+        uint64_t fileSize;
+        uint64_t centroidsOffset;
+        uint64_t listsOffset;
+        uint64_t codebooksOffset; // 0 en flat
+        uint64_t vectorsOffset;
+    };
+
+    // nullptr (et message dans error) si le fichier est absent, tronqué, d'une autre
+    // version ou incohérent.
+    static std::unique_ptr<FeatureIndex> open(const std::string& path, std::string* error = nullptr);
+
+    ~FeatureIndex();
+    FeatureIndex(FeatureIndex const&) = delete;
+    void operator=(FeatureIndex const&) = delete;
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(data_); }
+    Encoding encoding() const { return static_cast<Encoding>(header().encoding); }
+    Metric metric() const { return static_cast<Metric>(header().metric); }
+    size_t dim() const { return header().dim; }
+    size_t numLists() const { return header().numLists; }
+    size_t numVectors() const { return header().numVectors; }
+    size_t pqSubspaces() const { return header().pqSubspaces; }
+    size_t subspaceDim() const { return dim() / pqSubspaces(); }
+
+    const float* centroid(size_t list) const { return at<float>(header().centroidsOffset) + list * dim(); }
+    // Vecteurs de la liste : [listBegin, listEnd).
+    size_t listBegin(size_t list) const { return at<uint32_t>(header().listsOffset)[list]; }
+    size_t listEnd(size_t list) const { return at<uint32_t>(header().listsOffset)[list + 1]; }
+    // ||centroïde||^2, calculés à l'ouverture (distance L2 par produit scalaire).
+    float centroidNorm(size_t list) const { return centroidNorms_[list]; }
+
+    const float* vector(size_t index) const { return at<float>(header().vectorsOffset) + index * dim(); }
+    const uint8_t* codes(size_t index) const { return at<uint8_t>(header().vectorsOffset) + index * pqSubspaces(); }
+    // Dictionnaire du sous-espace m : kCodebookSize centroïdes de subspaceDim() floats.
+    const float* codebook(size_t m) const {
+        return at<float>(header().codebooksOffset) + m * kCodebookSize * subspaceDim();
+    }
+    // Vecteur stocké (décodé en PQ).
+    void reconstruct(size_t index, float* out) const;
+
+private:
+    FeatureIndex() = default;
+    bool validate(std::string* error) const;
+
+    template <typename T>
+    const T* at(uint64_t offset) const {
+        return reinterpret_cast<const T*>(static_cast<const uint8_t*>(data_) + offset);
+    }
+
+    const void* data_ = nullptr;
+    size_t size_ = 0;
+    std::vector<float> centroidNorms_;
+};
+
+/**
+ * Recherche des k plus proches voisins d'une trame de features dans un FeatureIndex et
+ * mélange des features avec leurs voisins (index rate de RVC, naturalityValue).
+ *
+ * Budget fixe par trame : les listes sont parcourues de la plus proche à la plus lointaine
+ * (au plus nprobe) jusqu'à maxScanned vecteurs, quelle que soit la taille des listes. Tous
+ * les buffers sont alloués à la construction : aucune allocation dans le thread audio.
+ */
+class FeatureRetriever {
+public:
+    static constexpr size_t kMaxNeighbors = 16;
+
+    struct Settings {
+        size_t k = 8;            // Voisins mélangés (comme RVC)
+        size_t nprobe = 8;       // Listes visitées au plus
+        size_t maxScanned = 4096; // Vecteurs comparés au plus par trame
+    };
+
+    struct Neighbor {
+        uint32_t index;
+        float distance; // L2 au carré, ou -produit scalaire (plus petit = plus proche)
+    };
+
+    explicit FeatureRetriever(const FeatureIndex& index);
+    FeatureRetriever(const FeatureIndex& index, const Settings& settings);
+
+    // Voisins de query (dim() floats), du plus proche au plus lointain ; retourne leur nombre.
+    size_t search(const float* query, Neighbor* neighbors);
+
+    // Thread d'inférence. features : numFrames trames de dim() floats, modifiées en place :
+    // f <- (1 - indexRate) f + indexRate * moyenne des voisins pondérée par 1 / distance^2.
+    void blend(float* features, size_t numFrames, float indexRate);
+
+    const FeatureIndex& index() const { return index_; }
+    // Vecteurs comparés lors de la dernière recherche.
+    size_t lastScanned() const { return lastScanned_; }
+
+private:
+    void rankLists(const float* query);
+    void buildLookupTable(const float* query);
+    void insert(Neighbor* neighbors, size_t& count, uint32_t index, float distance) const;
+
+    const FeatureIndex& index_;
+    Settings settings_;
+    std::vector<float> listDistances_;
+    std::vector<uint32_t> listOrder_;
+    std::vector<float> lookupTable_; // PQ : distance partielle [sous-espace][code]
+    std::vector<float> neighborVector_;
+    std::vector<float> blended_;
+    size_t lastScanned_ = 0;
+};
+
+} // namespace rvc
@@ -1,10 +1,22 @@
 #include "inference/ie_manager.h"
+#include "inference/model_blender.h"
+#include "inference/streaming_encoder.h"
+#include "dsp/denormals.h"
+#include "security/lock_manager.h" // Priorité SCHED_FIFO des threads de mesure des étages
 #include <android/log.h>
+#include <algorithm>
 #include <string>
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <chrono>
+#include <cmath>
+#include <dirent.h>
 #include <sys/mman.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 // Définitions pour les Logs Android
 #define LOG_TAG "RVC_IE_MANAGER"
@@ -21,15 +33,50 @@ public:
         // Logique de chargement de TFLite, initialisation de l'interpréteur.
         // Tentative d'attachement du délégué Hexagon (DSP) ici.
         LOGI("TFLite: Tentative de chargement du modèle '%s' et attachement du DSP.", path.c_str());
+        // V16.0: Retard algorithmique lu dans les métadonnées du modèle ("rvc.latency_samples").
+        latencySamples_ = 0;
+        // V16.0: Signatures "encoder" et "synthesizer" du modèle, si l'export les fournit.
+        hasSplitGraph_ = false;
         return true; 
     }
-    float benchmark() {
-        // Exécute une micro-inférence et retourne le temps en ms.
-        return 15.0f; // Exemple: 15ms sur le DSP.
+    // Retard propre au modèle à sa fréquence native (contexte à droite de l'encodeur,
+    // anticipation du vocodeur) : la voix rendue pour un bloc est en retard d'autant.
+    size_t latencySamples() const { return latencySamples_; }
+    // Modèle exporté en sous-graphes (encodeur de contenu, synthétiseur) : encode() et
+    // synthesize() sont utilisables par le pipeline. Sinon seul run() existe.
+    bool hasSplitGraph() const { return hasSplitGraph_; }
+    bool configure(const rvc::BackendConfig& backend) {
+        // Reconstruction de l'interpréteur : délégué Hexagon ou GPU, ou XNNPACK pour les
+        // noyaux CPU ; SetNumThreads(backend.numThreads). Faux si le délégué est absent.
+        return true;
     }
-    void run(float* buffer, size_t numSamples) {
+    void run(float* buffer, size_t numSamples, const rvc::ModelConditioning& conditioning,
+             rvc::FeatureRetriever* retriever) {
         // Exécution de l'inférence TFLite (en place sur le buffer Ashmem)
+        // Entrées pitch/pitchf du modèle alimentées par conditioning.f0 (coarse, f0Hz).
+        // Entre l'encodeur de contenu et le synthétiseur, si un index est chargé :
+        // retriever->blend(features, numFrames, conditioning.indexRate).
+    }
+    // V16.0: Graphe découpé pour le pipeline, un interpréteur et un délégué par sous-graphe.
+    void encode(const float* audio, size_t numSamples, float* features, size_t numFrames) {
+        // Encodeur de contenu (HuBERT) sur le DSP : numFrames trames (interpolées x2, 10 ms),
+        // fenêtre de contexte complète réencodée à chaque bloc.
+    }
+    // Tenseurs constants de l'encodeur, si son graphe est causal (front-end "layer_norm",
+    // convolution positionnelle causale, attention masquée à gauche) : il peut alors tourner
+    // en flux (StreamingContentEncoder). HuBERT/ContentVec tels qu'exportés par RVC ont une
+    // convolution positionnelle centrée : nullptr, la fenêtre complète est réencodée.
+    const rvc::ContentEncoderWeights* encoderWeights() const {
+        return nullptr;
+    }
+    void synthesize(const float* features, const rvc::F0Frame* f0, size_t numFrames, float* audio,
+                    size_t numSamples) {
+        // Synthétiseur (entrées phone, pitch, pitchf) sur le délégué du benchmark, sortie en place.
     }
+
+private:
+    size_t latencySamples_ = 0;
+    bool hasSplitGraph_ = false;
 };
 
 // Interface simplifiée pour ONNX Runtime (GPU/CPU)
@@ -39,19 +86,242 @@ public:
         // Logique de chargement d'ONNX Runtime.
         // Tentative d'attachement du délégué GPU ou CPU.
         LOGI("ONNX: Chargement du modèle '%s' et attachement du GPU/CPU.", path.c_str());
+        // V16.0: Retard algorithmique lu dans custom_metadata_map ("rvc.latency_samples").
+        latencySamples_ = 0;
+        // V16.0: Sessions de l'encodeur et du synthétiseur, si le modèle est livré découpé.
+        hasSplitGraph_ = false;
         return true;
     }
-    float benchmark() {
-        return 18.0f; // Exemple: 18ms sur le GPU.
+    size_t latencySamples() const { return latencySamples_; }
+    bool hasSplitGraph() const { return hasSplitGraph_; }
+    bool configure(const rvc::BackendConfig& backend) {
+        // Nouvelle session : SessionOptions::SetIntraOpNumThreads(backend.numThreads), EP
+        // XNNPACK ou NNAPI (GPU) ; pas de délégué Hexagon pour ONNX Runtime.
+        return backend.delegate != rvc::DelegateType::DSP;
+    }
+    void run(float* buffer, size_t numSamples, const rvc::ModelConditioning& conditioning,
+             rvc::FeatureRetriever* retriever) {
+        // Exécution de l'inférence ONNX (tenseurs pitch/pitchf depuis conditioning.f0,
+        // features mélangées par retriever comme pour TFLite)
+    }
+    void encode(const float* audio, size_t numSamples, float* features, size_t numFrames) {
+        // Session de l'encodeur de contenu (graphe découpé, V16.0).
     }
-    void run(float* buffer, size_t numSamples) {
-        // Exécution de l'inférence ONNX
+    const rvc::ContentEncoderWeights* encoderWeights() const {
+        return nullptr; // Initialiseurs de l'encodeur, si son graphe est causal
     }
+    void synthesize(const float* features, const rvc::F0Frame* f0, size_t numFrames, float* audio,
+                    size_t numSamples) {
+        // Session du synthétiseur (graphe découpé, V16.0).
+    }
+
+private:
+    size_t latencySamples_ = 0;
+    bool hasSplitGraph_ = false;
 };
 // --- Fin des Stubs ---
 
 namespace rvc {
 
+namespace {
+
+// Dimension des features de contenu produites par l'encodeur (RVC v2).
+constexpr size_t kFeatureDim = 768;
+
+// Dossier des modèles de l'utilisateur (ModelScannerService.MODELS_DIR_NAME).
+constexpr const char* kDefaultModelDir = "/sdcard/RVC_Voice_Models";
+
+/**
+ * Étages du pipeline sur le moteur du modèle : features de contenu (mélangées avec l'index
+ * du locuteur sur le même thread), puis synthèse.
+ */
+template <typename Engine>
+class ContentEncoderStage : public InferenceStage {
+public:
+    ContentEncoderStage(Engine& engine, const std::unique_ptr<FeatureRetriever>& retriever,
+                        std::unique_ptr<StreamingContentEncoder> streaming)
+        : engine_(engine), retriever_(retriever), streaming_(std::move(streaming)) {}
+
+    void process(InferenceBlock& block) override {
+        if (streaming_) {
+            // V16.0: Seules les trames nouvelles du bloc sont encodées (caches entre les blocs).
+            if (block.discontinuity) streaming_->reset();
+            streaming_->encode(block.audio.data(), block.numSamples, block.features.data(), block.numFrames);
+        } else {
+            engine_.encode(block.audio.data(), block.numSamples, block.features.data(), block.numFrames);
+        }
+        if (retriever_ && retriever_->index().dim() == kFeatureDim && block.indexRate > 0.0f) {
+            retriever_->blend(block.features.data(), block.numFrames, block.indexRate);
+        }
+    }
+
+private:
+    Engine& engine_;
+    const std::unique_ptr<FeatureRetriever>& retriever_; // Remplacé hors traitement seulement
+    std::unique_ptr<StreamingContentEncoder> streaming_;  // nullptr : fenêtre complète (moteur)
+};
+
+template <typename Engine>
+class SynthesizerStage : public InferenceStage {
+public:
+    explicit SynthesizerStage(Engine& engine) : engine_(engine) {}
+
+    void process(InferenceBlock& block) override {
+        engine_.synthesize(block.features.data(), block.alignedF0.data(), block.numFrames, block.audio.data(),
+                           block.numSamples);
+    }
+
+private:
+    Engine& engine_;
+};
+
+/**
+ * Encodeur en flux si le moteur expose des poids d'encodeur causal et que le flux reproduit
+ * la fenêtre complète sur ces poids ; sinon nullptr (le moteur réencode la fenêtre).
+ */
+template <typename Engine>
+std::unique_ptr<StreamingContentEncoder> makeStreamingEncoder(const InferencePipeline::Config& config, Engine& engine) {
+    const ContentEncoderWeights* weights = engine.encoderWeights();
+    if (weights == nullptr || weights->dim != config.featureDim) return nullptr;
+    std::string error;
+    if (!StreamingContentEncoder::selfCheck(*weights, &error)) {
+        LOGE("Encodeur de contenu en flux refusé (%s) : fenêtre complète.", error.c_str());
+        return nullptr;
+    }
+    LOGI("Encodeur de contenu en flux : %zu couches convolutives, %zu couches d'attention.", weights->conv.size(),
+         weights->layers.size());
+    return std::make_unique<StreamingContentEncoder>(*weights, config.sampleRate, config.maxBlockSamples);
+}
+
+template <typename Engine>
+std::unique_ptr<InferencePipeline> makePipeline(const InferencePipeline::Config& config, Engine& engine,
+                                                const std::unique_ptr<FeatureRetriever>& retriever) {
+    return std::make_unique<InferencePipeline>(config,
+                                               std::make_unique<ContentEncoderStage<Engine>>(
+                                                   engine, retriever, makeStreamingEncoder(config, engine)),
+                                               std::make_unique<F0AlignmentStage>(),
+                                               std::make_unique<SynthesizerStage<Engine>>(engine));
+}
+
+// Étage limitant d'une inférence pipelinée : écarté s'il l'est, sinon p95 le plus haut
+// (les deux étages ont la même limite).
+const LatencyStats& slowestStage(const LatencyStats& encoder, const LatencyStats& synthesizer) {
+    if (encoder.rejected != synthesizer.rejected) return encoder.rejected ? encoder : synthesizer;
+    return encoder.p95Ms >= synthesizer.p95Ms ? encoder : synthesizer;
+}
+
+// Mesure sur un thread réglé comme ceux des étages (InferencePipeline::stageLoop).
+std::thread stageBenchmarkThread(const std::function<LatencyStats()>& measure, LatencyStats* stats) {
+    return std::thread([measure, stats] {
+        LockManager::getInstance()->setRealTimePriority();
+        ScopedFlushDenormals::enableForCurrentThread();
+        *stats = measure();
+    });
+}
+
+/**
+ * Benchmark de chaque configuration candidate sur le moteur chargé, à la taille de bloc
+ * réelle, sur un signal voisé (contour de F0 à 10 ms) et l'index chargé : inférences
+ * complètes (run), ou, si l'inférence sera pipelinée (pipeline non nul), les étages que
+ * buildPipeline construira (encodeur en flux et index, synthétiseur), chacun contre la limite
+ * d'un étage. Les deux étages tournent en même temps sur deux threads réglés comme ceux du
+ * pipeline : ils se disputent les cœurs, les caches et le délégué comme en traitement, sans
+ * être synchronisés bloc à bloc.
+ */
+template <typename Engine>
+std::vector<BackendResult> benchmarkEngine(Engine& engine, const DelegateBenchmark& benchmark, size_t blockSamples,
+                                           int sampleRate, const std::unique_ptr<FeatureRetriever>& retriever,
+                                           const InferencePipeline::Config* pipeline) {
+    if (blockSamples == 0 || sampleRate <= 0) return {};
+    std::vector<float> input(blockSamples);
+    for (size_t i = 0; i < blockSamples; ++i) {
+        input[i] = 0.1f * std::sin(2.0f * static_cast<float>(M_PI) * 150.0f * static_cast<float>(i) /
+                                   static_cast<float>(sampleRate));
+    }
+    std::vector<float> buffer(blockSamples);
+    std::vector<F0Frame> f0(blockSamples * InferencePipeline::kFrameRateHz / static_cast<size_t>(sampleRate) + 1);
+    for (F0Frame& frame : f0) {
+        frame.f0Hz = 150.0f;
+        frame.coarse = 60;
+    }
+    ModelConditioning conditioning;
+    conditioning.f0 = f0.data();
+    conditioning.numF0Frames = f0.size();
+    conditioning.indexRate = retriever ? 0.5f : 0.0f;
+
+    // Étages du pipeline et leurs blocs (encodeur, synthétiseur), dimensionnés comme par
+    // InferencePipeline::process.
+    std::unique_ptr<InferenceStage> encoder;
+    std::unique_ptr<InferenceStage> synthesizer;
+    InferenceBlock encoded;
+    InferenceBlock synthesized;
+    if (pipeline) {
+        encoder = std::make_unique<ContentEncoderStage<Engine>>(engine, retriever,
+                                                                makeStreamingEncoder(*pipeline, engine));
+        synthesizer = std::make_unique<SynthesizerStage<Engine>>(engine);
+        const size_t numFrames =
+            (blockSamples * InferencePipeline::kFrameRateHz + static_cast<size_t>(sampleRate) - 1) /
+            static_cast<size_t>(sampleRate);
+        for (InferenceBlock* block : {&encoded, &synthesized}) {
+            block->audio = input;
+            block->numSamples = blockSamples;
+            block->f0 = f0;
+            block->numF0Frames = f0.size();
+            block->indexRate = conditioning.indexRate;
+            block->numFrames = numFrames;
+            block->features.assign(numFrames * pipeline->featureDim, 0.0f);
+            block->alignedF0.assign(numFrames, f0.front());
+        }
+    }
+
+    std::vector<BackendResult> results;
+    for (const BackendConfig& backend : DelegateBenchmark::candidates()) {
+        BackendResult result;
+        result.backend = backend;
+        result.available = engine.configure(backend);
+        result.pipelined = pipeline != nullptr;
+        if (result.available && pipeline) {
+            // Nouveau flux pour chaque backend ; les features de ce premier bloc alimentent
+            // le synthétiseur.
+            encoded.discontinuity = true;
+            encoder->process(encoded);
+            encoded.discontinuity = false;
+            synthesized.features = encoded.features;
+            const std::function<LatencyStats()> measureEncoder = [&] {
+                return benchmark.measure([&] { encoder->process(encoded); });
+            };
+            const std::function<LatencyStats()> measureSynthesizer = [&] {
+                return benchmark.measure([&] {
+                    std::copy(input.begin(), input.end(), synthesized.audio.begin()); // Sortie en place
+                    synthesizer->process(synthesized);
+                });
+            };
+            std::vector<std::thread> threads;
+            try {
+                threads.push_back(stageBenchmarkThread(measureEncoder, &result.encoderStats));
+                threads.push_back(stageBenchmarkThread(measureSynthesizer, &result.synthesizerStats));
+            } catch (const std::system_error& e) {
+                LOGE("Threads de mesure non créés (%s) : étages mesurés l'un après l'autre.", e.what());
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            if (threads.empty()) result.encoderStats = measureEncoder();
+            if (threads.size() < 2) result.synthesizerStats = measureSynthesizer();
+            result.stats = slowestStage(result.encoderStats, result.synthesizerStats);
+        } else if (result.available) {
+            result.stats = benchmark.measure([&] {
+                std::copy(input.begin(), input.end(), buffer.begin()); // Inférence en place
+                engine.run(buffer.data(), blockSamples, conditioning, retriever.get());
+            });
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+} // namespace
+
 InferenceEngineManager::InferenceEngineManager() 
     : tfliteEngine_(std::make_unique<TFLiteEngine>()), 
       onnxEngine_(std::make_unique<ONNXEngine>()),
@@ -67,7 +337,8 @@ InferenceEngineManager::~InferenceEngineManager() {
 /**
  * Lit les métadonnées pour déterminer le type de modèle et la meilleure cible.
  */
-bool InferenceEngineManager::loadModel(const std::string& modelPath, size_t bufferSize, int sampleRate) {
+bool InferenceEngineManager::loadModel(const std::string& modelPath, size_t blockSamples, int sampleRate,
+                                       const std::string& indexPath) {
     if (isModelLoaded_) {
         // V13.0: Verrouillage de Fichiers Modèles. On doit décharger l'ancien avant de charger le nouveau.
         unloadModel(); 
@@ -79,27 +350,35 @@ bool InferenceEngineManager::loadModel(const std::string& modelPath, size_t buff
     // 2. Tenter de charger le modèle
     bool loadSuccess = false;
     currentModelPath_ = modelPath;
-    
-    // Déterminer le délégué (V11.0: Auto-Adaptation Neuronale au Matériel)
-    DelegateType bestDelegate = benchmarkAllDelegates(modelPath, bufferSize, sampleRate);
-    currentDelegate_ = bestDelegate; // Définit le délégué le plus rapide (DSP, GPU, CPU)
 
     if (type == ModelType::TFLITE) {
-        loadSuccess = tfliteEngine_->loadModel(modelPath, bufferSize, sampleRate);
+        loadSuccess = tfliteEngine_->loadModel(modelPath, blockSamples, sampleRate);
         currentEngine_ = EngineType::TFLITE;
     } else if (type == ModelType::ONNX) {
-        loadSuccess = onnxEngine_->loadModel(modelPath, bufferSize, sampleRate);
+        loadSuccess = onnxEngine_->loadModel(modelPath, blockSamples, sampleRate);
         currentEngine_ = EngineType::ONNX;
     }
 
     if (loadSuccess) {
         isModelLoaded_ = true;
-        LOGI("Modèle '%s' chargé avec succès sur la cible: %s", modelPath.c_str(), 
-             (bestDelegate == DelegateType::DSP) ? "DSP (Hexagon)" : 
-             (bestDelegate == DelegateType::GPU) ? "GPU" : "CPU");
-        
+        sampleRate_ = sampleRate;
+
         // V13.0: Verrouillage du fichier modèle (flock) ici.
 
+        // V16.0: Index de features du locuteur, donné ou à côté du modèle (facultatif). Chargé
+        // avant le benchmark : la recherche fait partie de l'inférence mesurée.
+        const std::string index =
+            indexPath.empty() ? modelPath.substr(0, modelPath.find_last_of('.')) + ".rvci" : indexPath;
+        if (access(index.c_str(), R_OK) == 0) {
+            loadFeatureIndex(index);
+        }
+
+        // Déterminer le backend (V11.0: Auto-Adaptation Neuronale au Matériel)
+        currentBackend_ = benchmarkAllDelegates(blockSamples, sampleRate);
+        LOGI("Modèle '%s' chargé avec succès sur la cible: %s", modelPath.c_str(),
+             DelegateBenchmark::describe(currentBackend_).c_str());
+
+        buildPipeline();
         return true;
     } else {
         LOGE("Échec du chargement du modèle ou du délégué.");
@@ -108,32 +387,120 @@ bool InferenceEngineManager::loadModel(const std::string& modelPath, size_t buff
 }
 
 /**
- * Benchmark simple des différents délégués pour trouver le plus rapide.
- * (Fonctionnalité V11.0: Test Benchmark Automatique)
+ * Modèle chargé à l'initialisation du moteur, en attendant celui du profil : le premier
+ * (ordre alphabétique) du dossier scanné par ModelScannerService.
  */
-DelegateType InferenceEngineManager::benchmarkAllDelegates(const std::string& modelPath, size_t bufferSize, int sampleRate) {
-    LOGI("Démarrage du Benchmark des Délégués...");
-    
-    // Simuler les temps de latence après avoir chargé le modèle avec différentes options
-    float dspTime = tfliteEngine_->benchmark(); // Temps DSP (cible 5-20ms)
-    float gpuTime = onnxEngine_->benchmark();  // Temps GPU
-    float cpuTime = 25.0f; // Temps CPU (plus lent)
+bool InferenceEngineManager::loadDefaultModel(size_t blockSamples, int sampleRate) {
+    std::vector<std::string> models;
+    if (DIR* directory = opendir(kDefaultModelDir)) {
+        while (const dirent* entry = readdir(directory)) {
+            const std::string path = std::string(kDefaultModelDir) + "/" + entry->d_name;
+            if (determineModelType(path) != ModelType::UNKNOWN) models.push_back(path);
+        }
+        closedir(directory);
+    }
+    if (models.empty()) {
+        LOGE("Aucun modèle dans '%s'.", kDefaultModelDir);
+        return false;
+    }
+    std::sort(models.begin(), models.end());
+    return loadModel(models.front(), blockSamples, sampleRate);
+}
 
-    LOGI("Résultats Benchmark: DSP: %.1fms, GPU: %.1fms, CPU: %.1fms", dspTime, gpuTime, cpuTime);
+bool InferenceEngineManager::loadBlendedModel(const std::string& modelPathA, const std::string& modelPathB,
+                                              float ratio, const std::string& cacheDir, size_t blockSamples,
+                                              int sampleRate) {
+    if (!blendedModels_ || blendedModels_->directory() != cacheDir) {
+        blendedModels_ = std::make_unique<BlendedModelCache>(cacheDir);
+    }
+    std::string error;
+    const std::string blendedPath = blendedModels_->acquire(modelPathA, modelPathB, ratio, &error);
+    if (blendedPath.empty()) {
+        LOGE("Mélange de modèles impossible : %s", error.c_str());
+        return false;
+    }
+    // Pas d'index à côté du mélange : celui du modèle dominant, mesuré avec le modèle.
+    const std::string& dominant = ratio < 0.5f ? modelPathA : modelPathB;
+    const std::string indexPath = dominant.substr(0, dominant.find_last_of('.')) + ".rvci";
+    if (!loadModel(blendedPath, blockSamples, sampleRate, indexPath)) return false;
+    LOGI("Modèle mélangé chargé (%.2f) : '%s'", ratio, blendedPath.c_str());
+    return true;
+}
 
-    if (dspTime < gpuTime && dspTime < cpuTime && dspTime <= 20.0f) {
-        return DelegateType::DSP;
-    } else if (gpuTime < cpuTime && gpuTime <= 20.0f) {
-        return DelegateType::GPU;
-    } else {
-        return DelegateType::CPU;
+/**
+ * Benchmark des backends (V11.0: Test Benchmark Automatique ; V16.0: mesures réelles, voir
+ * DelegateBenchmark), puis moteur configuré sur le backend retenu.
+ */
+BackendConfig InferenceEngineManager::benchmarkAllDelegates(size_t blockSamples, int sampleRate) {
+    // Mêmes conditions que buildPipeline : les étages mesurés sont ceux qui tourneront.
+    const bool pipelined = pipelineBlockSamples_ > 0 && hasSplitGraph() && InferencePipeline::isWorthwhile();
+    DelegateBenchmark::Settings settings;
+    settings.deadlineMs = pipelined ? DelegateBenchmark::stageDeadlineMs(blockSamples, sampleRate)
+                                    : DelegateBenchmark::deadlineMs(blockSamples, sampleRate);
+    const DelegateBenchmark benchmark(settings);
+    LOGI("Démarrage du Benchmark des Délégués (bloc de %zu échantillons, limite %.1f ms%s)...", blockSamples,
+         settings.deadlineMs, pipelined ? " par étage" : "");
+
+    const InferencePipeline::Config config = pipelineConfig();
+    const InferencePipeline::Config* pipeline = pipelined ? &config : nullptr;
+    const std::vector<BackendResult> results =
+        currentEngine_ == EngineType::TFLITE
+            ? benchmarkEngine(*tfliteEngine_, benchmark, blockSamples, sampleRate, featureRetriever_, pipeline)
+            : benchmarkEngine(*onnxEngine_, benchmark, blockSamples, sampleRate, featureRetriever_, pipeline);
+    auto log = [](const std::string& name, const LatencyStats& stats) {
+        LOGI("  %s : moyenne %.2f ms, p50 %.2f ms, p95 %.2f ms, max %.2f ms (%zu mesures, %zu hors limite)%s",
+             name.c_str(), stats.meanMs, stats.p50Ms, stats.p95Ms, stats.maxMs, stats.runs, stats.overruns,
+             stats.rejected ? ", écarté" : "");
+    };
+    for (const BackendResult& result : results) {
+        const std::string name = DelegateBenchmark::describe(result.backend);
+        if (!result.available) {
+            LOGI("  %s : indisponible", name.c_str());
+        } else if (result.pipelined) {
+            log(name + ", encodeur", result.encoderStats);
+            log(name + ", synthétiseur", result.synthesizerStats);
+        } else {
+            log(name, result.stats);
+        }
+    }
+
+    const BackendResult* selected = benchmark.select(results);
+    BackendConfig backend = selected ? selected->backend : BackendConfig{};
+    if (selected == nullptr) {
+        LOGE("Aucun backend disponible : CPU par défaut.");
+    } else if (selected->stats.rejected || selected->stats.p95Ms > settings.deadlineMs) {
+        LOGE("Aucun backend ne tient %.1f ms au p95 : %s (p95 %.2f ms), des blocs seront en retard.",
+             settings.deadlineMs, DelegateBenchmark::describe(backend).c_str(), selected->stats.p95Ms);
+    }
+
+    // Le dernier candidat mesuré reste configuré : retour au backend retenu.
+    const bool configured = currentEngine_ == EngineType::TFLITE ? tfliteEngine_->configure(backend)
+                                                                 : onnxEngine_->configure(backend);
+    if (!configured) {
+        LOGE("Backend %s refusé à la configuration : CPU par défaut.", DelegateBenchmark::describe(backend).c_str());
+        backend = BackendConfig{};
+        if (currentEngine_ == EngineType::TFLITE) {
+            tfliteEngine_->configure(backend);
+        } else {
+            onnxEngine_->configure(backend);
+        }
     }
+    return backend;
+}
+
+bool InferenceEngineManager::hasSplitGraph() const {
+    return currentEngine_ == EngineType::TFLITE ? tfliteEngine_->hasSplitGraph() : onnxEngine_->hasSplitGraph();
+}
+
+size_t InferenceEngineManager::modelLatencySamples() const {
+    if (!isModelLoaded_) return 0;
+    return currentEngine_ == EngineType::TFLITE ? tfliteEngine_->latencySamples() : onnxEngine_->latencySamples();
 }
 
 /**
  * Exécute l'inférence RVC en temps réel. C'est l'étape la plus critique du pipeline.
  */
-void InferenceEngineManager::runInference(float* buffer, size_t numSamples) {
+void InferenceEngineManager::runInference(float* buffer, size_t numSamples, const ModelConditioning& conditioning) {
     if (!isModelLoaded_) {
         LOGE("Aucun modèle chargé. Inférer impossible.");
         return;
@@ -142,14 +509,17 @@ void InferenceEngineManager::runInference(float* buffer, size_t numSamples) {
     // V14.0: Mécanisme de Vote à la Majorité désactivé si la latence est critique.
     
     try {
-        if (currentEngine_ == EngineType::TFLITE) {
-            tfliteEngine_->run(buffer, numSamples);
+        if (pipeline_) {
+            // V16.0: Encodeur, F0 et synthétiseur sur leurs threads, décalés d'un bloc.
+            pipeline_->process(buffer, numSamples, conditioning);
+        } else if (currentEngine_ == EngineType::TFLITE) {
+            tfliteEngine_->run(buffer, numSamples, conditioning, featureRetriever_.get());
         } else if (currentEngine_ == EngineType::ONNX) {
-            onnxEngine_->run(buffer, numSamples);
+            onnxEngine_->run(buffer, numSamples, conditioning, featureRetriever_.get());
         }
         
         // V9.0: Logique de basculement FP32 -> FP16/INT8 (Degradation Gratuite)
-        if (currentDelegate_ != DelegateType::CPU) {
+        if (currentBackend_.delegate != DelegateType::CPU) {
             // Si le Watchdog demande la dégradation, on active le mode ultra-rapide du délégué.
             // ieManager->setPrecision(Precision::INT8); 
         }
@@ -162,11 +532,80 @@ void InferenceEngineManager::runInference(float* buffer, size_t numSamples) {
 
 void InferenceEngineManager::unloadModel() {
     // V13.0: Libération du verrouillage de fichier (funlock) ici.
+    pipeline_.reset(); // Ses étages utilisent les moteurs et l'index
+    unloadFeatureIndex();
     isModelLoaded_ = false;
     currentModelPath_ = "";
     LOGI("Modèle déchargé et ressources libérées.");
 }
 
+/**
+ * Projection et validation de l'index (voir FeatureIndex) ; le retriever alloue ses buffers
+ * ici, une fois pour toutes.
+ */
+bool InferenceEngineManager::loadFeatureIndex(const std::string& indexPath) {
+    unloadFeatureIndex();
+    std::string error;
+    std::unique_ptr<FeatureIndex> index = FeatureIndex::open(indexPath, &error);
+    if (!index) {
+        LOGE("Index de features refusé : %s", error.c_str());
+        return false;
+    }
+    featureRetriever_ = std::make_unique<FeatureRetriever>(*index);
+    featureIndex_ = std::move(index);
+    LOGI("Index de features '%s' : %zu vecteurs de dimension %zu, %zu listes (%s).", indexPath.c_str(),
+         featureIndex_->numVectors(), featureIndex_->dim(), featureIndex_->numLists(),
+         featureIndex_->encoding() == FeatureIndex::Encoding::Flat ? "flat" : "PQ");
+    return true;
+}
+
+void InferenceEngineManager::unloadFeatureIndex() {
+    featureRetriever_.reset();
+    featureIndex_.reset();
+}
+
+void InferenceEngineManager::enablePipeline(size_t maxBlockSamples) {
+    pipelineBlockSamples_ = maxBlockSamples;
+    buildPipeline();
+}
+
+InferencePipeline::Config InferenceEngineManager::pipelineConfig() const {
+    InferencePipeline::Config config;
+    config.sampleRate = sampleRate_;
+    config.maxBlockSamples = pipelineBlockSamples_;
+    config.featureDim = kFeatureDim;
+    return config;
+}
+
+/**
+ * Pipeline sur le moteur du modèle chargé. Sans graphe découpé (encode/synthesize), sans
+ * assez de cœurs, ou si ses threads ne peuvent pas être créés, l'inférence reste synchrone
+ * (run), sans latence ajoutée.
+ */
+void InferenceEngineManager::buildPipeline() {
+    pipeline_.reset();
+    if (pipelineBlockSamples_ == 0 || !isModelLoaded_) return;
+    if (!hasSplitGraph()) {
+        LOGI("Pipeline d'inférence désactivé : graphe du modèle non découpé.");
+        return;
+    }
+    if (!InferencePipeline::isWorthwhile()) {
+        LOGI("Pipeline d'inférence désactivé : %u cœurs.", std::thread::hardware_concurrency());
+        return;
+    }
+
+    const InferencePipeline::Config config = pipelineConfig();
+    try {
+        if (currentEngine_ == EngineType::TFLITE) {
+            pipeline_ = makePipeline(config, *tfliteEngine_, featureRetriever_);
+        } else {
+            pipeline_ = makePipeline(config, *onnxEngine_, featureRetriever_);
+        }
+    } catch (const std::exception& e) {
+        LOGE("Pipeline d'inférence non créé (%s) : inférence synchrone.", e.what());
+    }
+}
+
 ModelType InferenceEngineManager::determineModelType(const std::string& path) {
     // Logique simplifiée basée sur l'extension du fichier
     if (path.length() >= 7 && path.substr(path.length() - 7) == ".tflite") {
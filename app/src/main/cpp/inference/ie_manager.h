@@ -0,0 +1,94 @@
+#pragma once
+
+#include "inference/delegate_benchmark.h"
+#include "inference/feature_index.h"
+#include "inference/inference_pipeline.h"
+#include "inference/model_conditioning.h"
+#include <memory>
+#include <stddef.h>
+#include <string>
+
+// Moteurs d'exécution (stubs définis dans ie_manager.cpp).
+class TFLiteEngine;
+class ONNXEngine;
+
+namespace rvc {
+
+class BlendedModelCache;
+
+enum class ModelType { TFLITE, ONNX, UNKNOWN };
+enum class EngineType { TFLITE, ONNX };
+
+/**
+ * Gestionnaire d'inférence RVC : choix du moteur (TFLite/ONNX) selon le modèle et du
+ * backend (délégué DSP/GPU, noyaux CPU, threads) par benchmark au chargement (voir
+ * DelegateBenchmark).
+ */
+class InferenceEngineManager {
+public:
+    InferenceEngineManager();
+    ~InferenceEngineManager();
+
+    // blockSamples : échantillons d'un bloc à la fréquence du modèle (celui de la session de
+    // capture), taille à laquelle les backends sont mesurés. indexPath : index de features à
+    // charger avant le benchmark ; vide, "<modèle>.rvci" s'il existe.
+    bool loadModel(const std::string& modelPath, size_t blockSamples, int sampleRate,
+                   const std::string& indexPath = {});
+    // Premier modèle du dossier des modèles de l'utilisateur.
+    bool loadDefaultModel(size_t blockSamples, int sampleRate);
+    // Mélange de deux voix de même architecture (V16.0, voir ModelBlender) : modèle mélangé
+    // pris dans cacheDir ou construit, puis chargé comme un autre (une inférence par bloc).
+    // Index de features : celui du modèle dominant, chargé avant le benchmark. Hors
+    // traitement (pas encore appelé par le JNI). Un seul cache, recréé si cacheDir change.
+    bool loadBlendedModel(const std::string& modelPathA, const std::string& modelPathB, float ratio,
+                          const std::string& cacheDir, size_t blockSamples, int sampleRate);
+    void unloadModel();
+
+    // Index de features du locuteur (V16.0) : "<modèle>.rvci" est chargé avec le modèle
+    // s'il existe. Comme loadModel, hors traitement.
+    bool loadFeatureIndex(const std::string& indexPath);
+    void unloadFeatureIndex();
+    bool hasFeatureIndex() const { return featureRetriever_ != nullptr; }
+
+    // Étages du modèle pipelinés (V16.0, voir InferencePipeline) sur les SoC qui ont assez de
+    // cœurs, si le modèle est exporté en sous-graphes (encodeur, synthétiseur) : construit avec
+    // le modèle, pour des blocs d'au plus maxBlockSamples. Hors traitement ; à appeler avant
+    // loadModel pour que le benchmark mesure les étages du pipeline.
+    void enablePipeline(size_t maxBlockSamples);
+    bool isPipelined() const { return pipeline_ != nullptr; }
+    // Retard algorithmique du modèle chargé (déclaré par le moteur), en échantillons à la
+    // fréquence du modèle.
+    size_t modelLatencySamples() const;
+    // Retard ajouté par le pipeline, en échantillons à la fréquence du modèle.
+    size_t pipelineLatencySamples() const { return pipeline_ ? pipeline_->latencySamples() : 0; }
+
+    // Inférence en place à la fréquence native du modèle, avec les entrées de la session
+    // (contour de F0, index rate). Pipelinée : la voix rendue est celle de kDepth blocs plus tôt.
+    void runInference(float* buffer, size_t numSamples, const ModelConditioning& conditioning = {});
+
+private:
+    BackendConfig benchmarkAllDelegates(size_t blockSamples, int sampleRate);
+    bool hasSplitGraph() const;
+    ModelType determineModelType(const std::string& path);
+    // Pipeline du modèle chargé, mesuré par benchmarkAllDelegates et construit par buildPipeline.
+    InferencePipeline::Config pipelineConfig() const;
+    void buildPipeline();
+
+    std::unique_ptr<TFLiteEngine> tfliteEngine_;
+    std::unique_ptr<ONNXEngine> onnxEngine_;
+    bool isModelLoaded_;
+    std::string currentModelPath_;
+    EngineType currentEngine_ = EngineType::TFLITE;
+    BackendConfig currentBackend_;
+    std::unique_ptr<FeatureIndex> featureIndex_;
+    std::unique_ptr<FeatureRetriever> featureRetriever_;
+    std::unique_ptr<BlendedModelCache> blendedModels_;
+    int sampleRate_ = 0;
+    size_t pipelineBlockSamples_ = 0; // 0 : pipeline non demandé
+    std::unique_ptr<InferencePipeline> pipeline_;
+};
+
+} // namespace rvc
+
+// Le moteur JNI (rvc_engine.cpp) manipule le gestionnaire hors du namespace.
+using rvc::InferenceEngineManager;
@@ -0,0 +1,171 @@
+#include "inference/inference_pipeline.h"
+#include "dsp/denormals.h"
+#include "security/lock_manager.h" // Priorité SCHED_FIFO des étages
+#include <algorithm>
+#include <android/log.h>
+
+#define LOG_TAG "RVC_INFERENCE_PIPELINE"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace rvc {
+
+// --- F0AlignmentStage ---
+
+void F0AlignmentStage::process(InferenceBlock& block) {
+    if (block.discontinuity) last_ = F0Frame();
+    for (size_t frame = 0; frame < block.numFrames; ++frame) {
+        if (block.numF0Frames > 0) {
+            const size_t source = std::min(frame * block.numF0Frames / block.numFrames, block.numF0Frames - 1);
+            block.alignedF0[frame] = block.f0[source];
+        } else {
+            block.alignedF0[frame] = last_;
+        }
+    }
+    if (block.numF0Frames > 0) last_ = block.f0[block.numF0Frames - 1];
+}
+
+// --- InferencePipeline ---
+
+bool InferencePipeline::isWorthwhile() {
+    return std::thread::hardware_concurrency() >= 4;
+}
+
+InferencePipeline::InferencePipeline(const Config& config, std::unique_ptr<InferenceStage> encoder,
+                                     std::unique_ptr<InferenceStage> pitch,
+                                     std::unique_ptr<InferenceStage> synthesizer)
+    : config_(config),
+      encoder_(std::move(encoder)),
+      pitch_(std::move(pitch)),
+      synthesizer_(std::move(synthesizer)),
+      blocks_(kNumBlocks),
+      toEncoder_(kNumBlocks + 1),
+      toPitch_(kNumBlocks + 1),
+      encoded_(kNumBlocks + 1),
+      pitched_(kNumBlocks + 1),
+      synthesized_(kNumBlocks + 1),
+      fifo_((kDepth + 2) * config.maxBlockSamples) {
+    const size_t maxFrames = (config_.maxBlockSamples * kFrameRateHz + config_.sampleRate - 1) / config_.sampleRate;
+    for (InferenceBlock& block : blocks_) {
+        block.audio.resize(config_.maxBlockSamples);
+        block.f0.resize(maxFrames + 2);
+        block.features.resize(maxFrames * config_.featureDim);
+        block.alignedF0.resize(maxFrames);
+        free_.push_back(&block);
+    }
+
+    threads_.emplace_back(&InferencePipeline::stageLoop, this, encoder_.get(), &toEncoder_, &encoded_);
+    threads_.emplace_back(&InferencePipeline::stageLoop, this, pitch_.get(), &toPitch_, &pitched_);
+    threads_.emplace_back(&InferencePipeline::synthesizerLoop, this);
+    LOGI("Pipeline d'inférence : %zu niveaux, blocs de %zu échantillons au plus (%zu trames).", kDepth,
+         config_.maxBlockSamples, maxFrames);
+}
+
+InferencePipeline::~InferencePipeline() {
+    reset();
+    toEncoder_.push(nullptr);
+    toPitch_.push(nullptr);
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void InferencePipeline::stageLoop(InferenceStage* stage, SpscQueue<InferenceBlock*>* input,
+                                  SpscQueue<InferenceBlock*>* output) {
+    // Peut échouer hors thread audio système : l'étage reste alors en priorité normale.
+    LockManager::getInstance()->setRealTimePriority();
+    ScopedFlushDenormals::enableForCurrentThread();
+
+    while (true) {
+        InferenceBlock* block = input->pop();
+        if (block != nullptr) stage->process(*block);
+        output->push(block);
+        if (block == nullptr) return;
+    }
+}
+
+/**
+ * Les deux étages parallèles reçoivent les blocs dans le même ordre : les têtes de leurs
+ * files de sortie désignent toujours le même bloc.
+ */
+void InferencePipeline::synthesizerLoop() {
+    LockManager::getInstance()->setRealTimePriority();
+    ScopedFlushDenormals::enableForCurrentThread();
+
+    while (true) {
+        InferenceBlock* block = encoded_.pop();
+        pitched_.pop();
+        if (block == nullptr) return;
+        synthesizer_->process(*block);
+        synthesized_.push(block);
+    }
+}
+
+void InferencePipeline::process(float* samples, size_t numSamples, const ModelConditioning& conditioning) {
+    if (conditioning.discontinuity) reset();
+    if (numSamples > config_.maxBlockSamples) {
+        LOGE("Bloc de %zu échantillons au-delà du maximum du pipeline (%zu) : silence.", numSamples,
+             config_.maxBlockSamples);
+        std::fill(samples, samples + numSamples, 0.0f);
+        return;
+    }
+
+    if (free_.empty()) collect();
+    InferenceBlock* block = free_.back();
+    free_.pop_back();
+
+    std::copy(samples, samples + numSamples, block->audio.data());
+    block->numSamples = numSamples;
+    block->numF0Frames = std::min(conditioning.numF0Frames, block->f0.size());
+    if (conditioning.f0 != nullptr) {
+        std::copy(conditioning.f0, conditioning.f0 + block->numF0Frames, block->f0.data());
+    } else {
+        block->numF0Frames = 0;
+    }
+    block->indexRate = conditioning.indexRate;
+    block->numFrames = (numSamples * kFrameRateHz + config_.sampleRate - 1) / config_.sampleRate;
+    block->discontinuity = !primed_;
+
+    if (!primed_) {
+        // Retard fixé par le premier bloc : kDepth blocs de silence d'avance.
+        fifoCount_ = kDepth * numSamples;
+        std::fill(fifo_.begin(), fifo_.begin() + fifoCount_, 0.0f);
+        latency_.store(fifoCount_, std::memory_order_relaxed);
+        primed_ = true;
+    }
+
+    ++inFlight_;
+    toEncoder_.push(block);
+    toPitch_.push(block);
+
+    while (fifoCount_ < numSamples && inFlight_ > 0) {
+        collect();
+    }
+    const size_t available = std::min(fifoCount_, numSamples);
+    std::copy(fifo_.data(), fifo_.data() + available, samples);
+    std::fill(samples + available, samples + numSamples, 0.0f);
+    std::copy(fifo_.data() + available, fifo_.data() + fifoCount_, fifo_.data());
+    fifoCount_ -= available;
+}
+
+/**
+ * Récupère le plus ancien bloc en transit (attente si le synthétiseur ne l'a pas rendu).
+ */
+void InferencePipeline::collect() {
+    InferenceBlock* block = synthesized_.pop();
+    const size_t count = std::min(block->numSamples, fifo_.size() - fifoCount_);
+    std::copy(block->audio.data(), block->audio.data() + count, fifo_.data() + fifoCount_);
+    fifoCount_ += count;
+    free_.push_back(block);
+    --inFlight_;
+}
+
+void InferencePipeline::reset() {
+    while (inFlight_ > 0) {
+        collect();
+    }
+    fifoCount_ = 0;
+    primed_ = false;
+}
+
+} // namespace rvc
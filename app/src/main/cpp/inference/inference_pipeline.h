@@ -0,0 +1,139 @@
+#pragma once
+
+#include "dsp/spsc_queue.h"
+#include "inference/model_conditioning.h"
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <thread>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Bloc en transit dans le pipeline d'inférence : audio à la fréquence du modèle, entrées
+ * copiées du bloc de la session (son contour de F0 ne vit que le temps du bloc) et tenseurs
+ * intermédiaires entre les étages. Alloué une fois, recyclé.
+ */
+struct InferenceBlock {
+    std::vector<float> audio; // Entrée, puis voix synthétisée (en place)
+    size_t numSamples = 0;
+
+    std::vector<F0Frame> f0; // Contour de la session (une trame par 10 ms)
+    size_t numF0Frames = 0;
+    float indexRate = 0.0f;
+    bool discontinuity = false; // Premier bloc d'un nouveau flux : les étages repartent de zéro
+
+    // Sorties des étages parallèles, une trame par 10 ms (numFrames).
+    size_t numFrames = 0;
+    std::vector<float> features;  // Encodeur de contenu : numFrames x featureDim
+    std::vector<F0Frame> alignedF0; // Étage F0 : une trame par trame de features
+};
+
+/**
+ * Étage du graphe RVC, exécuté sur son propre thread (et son propre moteur/délégué) : les
+ * blocs lui arrivent dans l'ordre, un à la fois, ce qui lui permet de garder un état.
+ */
+class InferenceStage {
+public:
+    virtual ~InferenceStage() = default;
+    virtual void process(InferenceBlock& block) = 0;
+};
+
+/**
+ * Étage F0 par défaut : le contour est déjà estimé et conditionné par la session
+ * (PitchTracker + F0Conditioner) ; il est aligné sur les trames de features (pitch et
+ * pitchf du synthétiseur). Un modèle avec estimateur neuronal (RMVPE) le remplace.
+ */
+class F0AlignmentStage : public InferenceStage {
+public:
+    void process(InferenceBlock& block) override;
+
+private:
+    F0Frame last_; // Dernière trame reçue, pour les blocs plus courts qu'un pas de 10 ms
+};
+
+/**
+ * Graphe RVC découpé en étages pipelinés (V16.0) :
+ *
+ *     bloc k   --> encodeur de contenu --+
+ *              --> F0                 --+--> synthétiseur --> bloc k (retardé)
+ *
+ * L'encodeur et l'étage F0 ne dépendent que de l'audio : ils traitent le bloc k en
+ * parallèle, pendant que le synthétiseur traite le bloc k - 1. Chaque étage a son thread
+ * (SCHED_FIFO, denormals à zéro), relié aux autres par des files SPSC sans verrou ; le
+ * thread audio ne fait que soumettre et récupérer. Sur un SoC multicœur, le débit devient
+ * celui de l'étage le plus lent au lieu de la somme des étages, à taille de bloc constante.
+ *
+ * Contrepartie : la sortie est retardée de kDepth blocs (latencySamples()), le temps que
+ * chaque bloc traverse les deux niveaux. Le premier bloc fixe ce retard (pré-remplissage
+ * de silence) ; les blocs suivants peuvent varier d'un échantillon (RateBridge) sans le
+ * modifier, la sortie passant par une FIFO.
+ */
+class InferencePipeline {
+public:
+    // Niveaux en série : (encodeur || F0), puis synthétiseur.
+    static constexpr size_t kDepth = 2;
+    // Trames de features et de F0 par seconde (HuBERT interpolé x2, pas du PitchTracker).
+    static constexpr int kFrameRateHz = 100;
+
+    struct Config {
+        int sampleRate = 48000;     // Fréquence native du modèle
+        size_t maxBlockSamples = 0; // Plus grand bloc soumis (contrat de l'appelant)
+        size_t featureDim = 768;    // Dimension des features de contenu (RVC v2)
+    };
+
+    // Assez de cœurs pour trois étages en plus du thread audio ; sinon le pipeline ne ferait
+    // que se disputer les cœurs et ajouter kDepth blocs de latence.
+    static bool isWorthwhile();
+
+    InferencePipeline(const Config& config, std::unique_ptr<InferenceStage> encoder,
+                      std::unique_ptr<InferenceStage> pitch, std::unique_ptr<InferenceStage> synthesizer);
+    ~InferencePipeline();
+
+    InferencePipeline(InferencePipeline const&) = delete;
+    void operator=(InferencePipeline const&) = delete;
+
+    // --- Thread audio ---
+    // Soumet le bloc et le remplace par la voix synthétisée kDepth blocs plus tôt. Aucune
+    // allocation ; n'attend que si un bloc n'a pas fini de traverser le pipeline à temps.
+    void process(float* samples, size_t numSamples, const ModelConditioning& conditioning);
+    // Nouveau flux : attend les blocs en transit, vide la FIFO ; le prochain bloc refixe le retard.
+    void reset();
+
+    // Retard ajouté, en échantillons à la fréquence du modèle (0 avant le premier bloc).
+    size_t latencySamples() const { return latency_.load(std::memory_order_relaxed); }
+
+private:
+    // Blocs en circulation : kDepth en transit, un en cours de soumission, un de marge.
+    static constexpr size_t kNumBlocks = kDepth + 2;
+
+    void stageLoop(InferenceStage* stage, SpscQueue<InferenceBlock*>* input, SpscQueue<InferenceBlock*>* output);
+    void synthesizerLoop();
+    void collect();
+
+    Config config_;
+    std::unique_ptr<InferenceStage> encoder_;
+    std::unique_ptr<InferenceStage> pitch_;
+    std::unique_ptr<InferenceStage> synthesizer_;
+
+    std::vector<InferenceBlock> blocks_;
+    std::vector<InferenceBlock*> free_; // Propriété du thread audio
+    size_t inFlight_ = 0;
+
+    // Thread audio -> étages parallèles -> synthétiseur -> thread audio. nullptr : arrêt.
+    SpscQueue<InferenceBlock*> toEncoder_;
+    SpscQueue<InferenceBlock*> toPitch_;
+    SpscQueue<InferenceBlock*> encoded_;
+    SpscQueue<InferenceBlock*> pitched_;
+    SpscQueue<InferenceBlock*> synthesized_;
+
+    std::vector<float> fifo_; // Voix synthétisée pas encore rendue
+    size_t fifoCount_ = 0;
+    bool primed_ = false;
+    std::atomic<size_t> latency_{0};
+
+    std::vector<std::thread> threads_;
+};
+
+} // namespace rvc
@@ -0,0 +1,599 @@
+#include "inference/model_blender.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <numeric>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rvc {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "FlatBuffers et protobuf sont petit-boutistes");
+
+namespace {
+
+constexpr size_t kChunkValues = 16384; // Valeurs mélangées par passage (buffers alignés)
+constexpr const char* kEntryPrefix = "blend_";
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+bool endsWith(const std::string& text, const char* suffix) {
+    const size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+// --- Projection en lecture seule ---
+
+class MappedFile {
+public:
+    ~MappedFile() {
+        if (data_ != nullptr) munmap(const_cast<uint8_t*>(data_), size_);
+    }
+
+    bool open(const std::string& path, std::string* error) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return fail(error, "modèle introuvable '" + path + "'");
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return fail(error, "modèle vide '" + path + "'");
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // La projection reste valide après la fermeture
+        if (data == MAP_FAILED) return fail(error, "mmap du modèle refusé '" + path + "'");
+        data_ = static_cast<const uint8_t*>(data);
+        madvise(data, size_, MADV_SEQUENTIAL); // Lu une fois, dans l'ordre
+        return true;
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// --- FlatBuffer TFLite (schema.fbs) ---
+
+/**
+ * Lecture bornée d'un FlatBuffer : toute lecture hors du fichier rend le lecteur invalide
+ * (ok() faux) et retourne 0, le parcours se termine alors sans accès hors limites.
+ */
+class FlatReader {
+public:
+    FlatReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    bool ok() const { return ok_; }
+
+    template <typename T>
+    T read(uint64_t position) {
+        T value = 0;
+        if (position > size_ || sizeof(T) > size_ - position) {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, data_ + position, sizeof(T));
+        return value;
+    }
+
+    uint64_t deref(uint64_t position) { return position + read<uint32_t>(position); }
+
+    // Position absolue du champ id de la table, 0 s'il est absent (valeur par défaut).
+    uint64_t field(uint64_t table, size_t id) {
+        const uint64_t vtable = table - static_cast<uint64_t>(static_cast<int64_t>(read<int32_t>(table)));
+        const uint16_t vtableSize = read<uint16_t>(vtable);
+        const uint64_t entry = 4 + 2 * id;
+        if (entry + 2 > vtableSize) return 0;
+        const uint16_t offset = read<uint16_t>(vtable + entry);
+        return offset == 0 ? 0 : table + offset;
+    }
+
+    // Vecteur désigné par le champ : position du premier élément et nombre d'éléments.
+    uint64_t vector(uint64_t table, size_t id, uint32_t& length) {
+        length = 0;
+        const uint64_t position = field(table, id);
+        if (position == 0) return 0;
+        const uint64_t vector = deref(position);
+        length = read<uint32_t>(vector);
+        return vector + 4;
+    }
+
+    std::string string(uint64_t table, size_t id) {
+        uint32_t length = 0;
+        const uint64_t begin = vector(table, id, length);
+        if (begin == 0 || begin > size_ || length > size_ - begin) return std::string();
+        return std::string(reinterpret_cast<const char*>(data_ + begin), length);
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    bool ok_ = true;
+};
+
+// Champs des tables du schéma TFLite utilisés ici.
+constexpr size_t kModelSubgraphs = 2, kModelBuffers = 4;
+constexpr size_t kSubgraphTensors = 0;
+constexpr size_t kTensorShape = 0, kTensorType = 1, kTensorBuffer = 2, kTensorName = 3;
+constexpr size_t kBufferData = 0, kBufferOffset = 1, kBufferSize = 2;
+constexpr uint8_t kTfliteFloat32 = 0, kTfliteFloat16 = 1;
+
+bool readTflite(const uint8_t* data, size_t size, std::vector<WeightTensor>& tensors, std::string* error) {
+    if (size < 8 || std::memcmp(data + 4, "TFL3", 4) != 0) return fail(error, "identifiant TFL3 absent");
+    FlatReader reader(data, size);
+    const uint64_t model = reader.deref(0);
+    uint32_t numBuffers = 0, numSubgraphs = 0;
+    const uint64_t buffers = reader.vector(model, kModelBuffers, numBuffers);
+    const uint64_t subgraphs = reader.vector(model, kModelSubgraphs, numSubgraphs);
+    std::vector<bool> seen(numBuffers, false); // Buffers partagés par plusieurs tenseurs
+
+    for (uint32_t s = 0; s < numSubgraphs && reader.ok(); ++s) {
+        const uint64_t subgraph = reader.deref(subgraphs + 4ull * s);
+        uint32_t numTensors = 0;
+        const uint64_t list = reader.vector(subgraph, kSubgraphTensors, numTensors);
+        for (uint32_t t = 0; t < numTensors && reader.ok(); ++t) {
+            const uint64_t tensor = reader.deref(list + 4ull * t);
+            const uint64_t bufferField = reader.field(tensor, kTensorBuffer);
+            const uint32_t index = bufferField ? reader.read<uint32_t>(bufferField) : 0;
+            if (index == 0 || index >= numBuffers || seen[index]) continue; // 0 : tenseur d'activation
+            seen[index] = true;
+
+            // Données dans le buffer, ou après le FlatBuffer (offset > 1, modèles > 2 Go).
+            const uint64_t buffer = reader.deref(buffers + 4ull * index);
+            WeightTensor weight;
+            uint32_t length = 0;
+            weight.offset = reader.vector(buffer, kBufferData, length);
+            weight.size = length;
+            const uint64_t offsetField = reader.field(buffer, kBufferOffset);
+            const uint64_t external = offsetField ? reader.read<uint64_t>(offsetField) : 0;
+            if (external > 1) {
+                const uint64_t sizeField = reader.field(buffer, kBufferSize);
+                weight.offset = external;
+                weight.size = sizeField ? reader.read<uint64_t>(sizeField) : 0;
+            }
+            if (weight.size == 0) continue;
+            if (weight.offset > size || weight.size > size - weight.offset) {
+                return fail(error, "buffer " + std::to_string(index) + " hors du fichier");
+            }
+
+            const uint64_t typeField = reader.field(tensor, kTensorType);
+            const uint8_t type = typeField ? reader.read<uint8_t>(typeField) : kTfliteFloat32;
+            weight.type = type == kTfliteFloat32   ? WeightTensor::Type::Float32
+                          : type == kTfliteFloat16 ? WeightTensor::Type::Float16
+                                                   : WeightTensor::Type::Other;
+            weight.name = std::to_string(s) + "/" + reader.string(tensor, kTensorName);
+            uint32_t rank = 0;
+            const uint64_t shape = reader.vector(tensor, kTensorShape, rank);
+            for (uint32_t d = 0; d < rank && reader.ok(); ++d) {
+                weight.shape.push_back(reader.read<int32_t>(shape + 4ull * d));
+            }
+            tensors.push_back(std::move(weight));
+        }
+    }
+    if (!reader.ok()) return fail(error, "FlatBuffer tronqué");
+    return true;
+}
+
+// --- Protobuf ONNX (onnx.proto) ---
+
+/**
+ * Parcours des champs d'un message protobuf : (numéro, type de fil, valeur ou contenu).
+ */
+class ProtoReader {
+public:
+    ProtoReader(const uint8_t* data, uint64_t begin, uint64_t end) : data_(data), position_(begin), end_(end) {}
+
+    bool ok() const { return ok_; }
+    bool done() const { return !ok_ || position_ >= end_; }
+
+    // Champ suivant ; pour le type 2 (longueur), [begin, end) délimite son contenu.
+    bool next(uint32_t& number, uint32_t& wireType, uint64_t& value, uint64_t& begin, uint64_t& end) {
+        const uint64_t key = varint();
+        number = static_cast<uint32_t>(key >> 3);
+        wireType = static_cast<uint32_t>(key & 7);
+        value = begin = end = 0;
+        switch (wireType) {
+            case 0: value = varint(); break;
+            case 1: skip(8); break;
+            case 2:
+                value = varint();
+                begin = position_;
+                skip(value);
+                end = position_;
+                break;
+            case 5: skip(4); break;
+            default: ok_ = false; break;
+        }
+        return ok_;
+    }
+
+    uint64_t varint() {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position_ >= end_) break;
+            const uint8_t byte = data_[position_++];
+            result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return result;
+        }
+        ok_ = false;
+        return 0;
+    }
+
+private:
+    void skip(uint64_t count) {
+        if (count > end_ - position_) {
+            ok_ = false;
+            return;
+        }
+        position_ += count;
+    }
+
+    const uint8_t* data_;
+    uint64_t position_;
+    uint64_t end_;
+    bool ok_ = true;
+};
+
+constexpr uint32_t kModelGraph = 7;
+constexpr uint32_t kGraphInitializer = 5;
+constexpr uint32_t kTensorProtoDims = 1, kTensorProtoDataType = 2, kTensorProtoFloatData = 4,
+                   kTensorProtoName = 8, kTensorProtoRawData = 9, kTensorProtoDataLocation = 14;
+constexpr uint64_t kOnnxFloat = 1, kOnnxFloat16 = 10, kOnnxExternal = 1;
+
+bool readOnnxTensor(const uint8_t* data, uint64_t begin, uint64_t end, WeightTensor& weight, std::string* error) {
+    ProtoReader reader(data, begin, end);
+    uint64_t dataType = 0, payloadBegin = 0, payloadEnd = 0;
+    bool hasPayload = false;
+    while (!reader.done()) {
+        uint32_t number, wireType;
+        uint64_t value, fieldBegin, fieldEnd;
+        if (!reader.next(number, wireType, value, fieldBegin, fieldEnd)) break;
+        if (number == kTensorProtoDims) {
+            if (wireType == 0) {
+                weight.shape.push_back(static_cast<int64_t>(value));
+            } else if (wireType == 2) {
+                ProtoReader packed(data, fieldBegin, fieldEnd);
+                while (!packed.done()) weight.shape.push_back(static_cast<int64_t>(packed.varint()));
+            }
+        } else if (number == kTensorProtoDataType && wireType == 0) {
+            dataType = value;
+        } else if (number == kTensorProtoName && wireType == 2) {
+            weight.name.assign(reinterpret_cast<const char*>(data + fieldBegin), fieldEnd - fieldBegin);
+        } else if ((number == kTensorProtoRawData || number == kTensorProtoFloatData) && wireType == 2) {
+            payloadBegin = fieldBegin; // float_data empaqueté : floats contigus, comme raw_data
+            payloadEnd = fieldEnd;
+            hasPayload = true;
+        } else if (number == kTensorProtoDataLocation && wireType == 0 && value == kOnnxExternal) {
+            return fail(error, "initialiseur externe non pris en charge");
+        }
+    }
+    if (!reader.ok()) return fail(error, "initialiseur tronqué");
+
+    // FLOAT16 hors raw_data (int32_data, un varint par valeur) : comparé comme un tenseur entier.
+    const bool isFloat = hasPayload && (dataType == kOnnxFloat || (dataType == kOnnxFloat16 && payloadEnd > payloadBegin));
+    if (isFloat) {
+        weight.type = dataType == kOnnxFloat ? WeightTensor::Type::Float32 : WeightTensor::Type::Float16;
+        weight.offset = payloadBegin;
+        weight.size = payloadEnd - payloadBegin;
+    } else {
+        weight.type = WeightTensor::Type::Other; // Message entier
+        weight.offset = begin;
+        weight.size = end - begin;
+    }
+    return true;
+}
+
+bool readOnnx(const uint8_t* data, size_t size, std::vector<WeightTensor>& tensors, std::string* error) {
+    ProtoReader model(data, 0, size);
+    while (!model.done()) {
+        uint32_t number, wireType;
+        uint64_t value, begin, end;
+        if (!model.next(number, wireType, value, begin, end)) break;
+        if (number != kModelGraph || wireType != 2) continue;
+
+        ProtoReader graph(data, begin, end);
+        while (!graph.done()) {
+            uint64_t tensorBegin, tensorEnd;
+            if (!graph.next(number, wireType, value, tensorBegin, tensorEnd)) break;
+            if (number != kGraphInitializer || wireType != 2) continue;
+            WeightTensor weight;
+            if (!readOnnxTensor(data, tensorBegin, tensorEnd, weight, error)) return false;
+            tensors.push_back(std::move(weight));
+        }
+        if (!graph.ok()) return fail(error, "graphe ONNX tronqué");
+    }
+    if (!model.ok()) return fail(error, "protobuf ONNX tronqué");
+    if (tensors.empty()) return fail(error, "aucun initialiseur ONNX");
+    return true;
+}
+
+// --- Demi-précision (IEEE 754 binary16) ---
+
+float halfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1Fu;
+    const uint32_t mantissa = half & 0x3FFu;
+    if (exponent == 0) {
+        const float value = std::ldexp(static_cast<float>(mantissa), -24); // Sous-normal
+        return sign ? -value : value;
+    }
+    const uint32_t bits = exponent == 0x1Fu ? sign | 0x7F800000u | (mantissa << 13)
+                                            : sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Arrondi au plus proche (pair), saturation à l'infini.
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) return static_cast<uint16_t>(sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u));
+    if (magnitude >= 0x477FF000u) return static_cast<uint16_t>(sign | 0x7C00u); // >= 65520
+    if (magnitude < 0x38800000u) {
+        float absolute;
+        std::memcpy(&absolute, &magnitude, sizeof(absolute));
+        return static_cast<uint16_t>(sign | static_cast<uint32_t>(std::lrint(std::ldexp(absolute, 24))));
+    }
+    const uint32_t rounded = magnitude + 0xC8000FFFu + ((magnitude >> 13) & 1u); // Biais 127 -> 15
+    return static_cast<uint16_t>(sign | (rounded >> 13));
+}
+
+// --- Écriture ---
+
+bool writeAll(int fd, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * Mélange d'un tenseur par paquets : les données du fichier (alignement quelconque en ONNX)
+ * sont copiées dans des buffers alignés, mélangées puis écrites.
+ */
+bool writeBlended(int fd, const WeightTensor& tensor, const uint8_t* a, const uint8_t* b, float ratio,
+                  std::vector<float>& blended, std::vector<float>& other, std::vector<uint16_t>& halves) {
+    const size_t valueSize = tensor.type == WeightTensor::Type::Float32 ? sizeof(float) : sizeof(uint16_t);
+    const size_t count = static_cast<size_t>(tensor.size) / valueSize;
+    for (size_t done = 0; done < count; done += kChunkValues) {
+        const size_t n = std::min(kChunkValues, count - done);
+        const size_t offset = done * valueSize;
+        if (tensor.type == WeightTensor::Type::Float32) {
+            std::memcpy(blended.data(), a + offset, n * sizeof(float));
+            std::memcpy(other.data(), b + offset, n * sizeof(float));
+        } else {
+            std::memcpy(halves.data(), a + offset, n * sizeof(uint16_t));
+            for (size_t i = 0; i < n; ++i) blended[i] = halfToFloat(halves[i]);
+            std::memcpy(halves.data(), b + offset, n * sizeof(uint16_t));
+            for (size_t i = 0; i < n; ++i) other[i] = halfToFloat(halves[i]);
+        }
+        simd::applyGainRamp(blended.data(), n, 1.0f - ratio, 1.0f - ratio);
+        simd::accumulateScaled(blended.data(), other.data(), ratio, n);
+        bool ok;
+        if (tensor.type == WeightTensor::Type::Float32) {
+            ok = writeAll(fd, blended.data(), n * sizeof(float));
+        } else {
+            for (size_t i = 0; i < n; ++i) halves[i] = floatToHalf(blended[i]);
+            ok = writeAll(fd, halves.data(), n * sizeof(uint16_t));
+        }
+        if (!ok) return false;
+    }
+    // Octets restants (taille non multiple de la valeur) : ceux de A.
+    const size_t tail = static_cast<size_t>(tensor.size) - count * valueSize;
+    return writeAll(fd, a + count * valueSize, tail);
+}
+
+// FNV-1a 64 bits (clé de cache, non cryptographique).
+uint64_t fnv1a(const std::string& text) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+// --- ModelWeights ---
+
+ModelWeights::Format ModelWeights::formatOf(const std::string& path) {
+    if (endsWith(path, ".tflite")) return Format::TFLite;
+    if (endsWith(path, ".onnx")) return Format::Onnx;
+    return Format::Unknown;
+}
+
+bool ModelWeights::read(const uint8_t* data, size_t size, Format format, std::vector<WeightTensor>& tensors,
+                        std::string* error) {
+    tensors.clear();
+    switch (format) {
+        case Format::TFLite: return readTflite(data, size, tensors, error);
+        case Format::Onnx: return readOnnx(data, size, tensors, error);
+        case Format::Unknown: break;
+    }
+    return fail(error, "format de modèle inconnu");
+}
+
+// --- ModelBlender ---
+
+bool ModelBlender::blend(const std::string& pathA, const std::string& pathB, float ratio, const std::string& outPath,
+                         std::string* error) {
+    const ModelWeights::Format format = ModelWeights::formatOf(pathA);
+    if (format != ModelWeights::formatOf(pathB)) return fail(error, "modèles de formats différents");
+    MappedFile a, b;
+    if (!a.open(pathA, error) || !b.open(pathB, error)) return false;
+    std::vector<WeightTensor> tensorsA, tensorsB;
+    std::string readError;
+    if (!ModelWeights::read(a.data(), a.size(), format, tensorsA, &readError)) {
+        return fail(error, "'" + pathA + "' : " + readError);
+    }
+    if (!ModelWeights::read(b.data(), b.size(), format, tensorsB, &readError)) {
+        return fail(error, "'" + pathB + "' : " + readError);
+    }
+
+    // Mêmes tenseurs constants des deux côtés ; seuls les flottants peuvent différer.
+    if (tensorsA.size() != tensorsB.size()) return fail(error, "architectures différentes (nombre de poids)");
+    size_t numBlended = 0;
+    for (size_t i = 0; i < tensorsA.size(); ++i) {
+        const WeightTensor& ta = tensorsA[i];
+        const WeightTensor& tb = tensorsB[i];
+        if (ta.name != tb.name || ta.type != tb.type || ta.shape != tb.shape || ta.size != tb.size) {
+            return fail(error, "architectures différentes (tenseur '" + ta.name + "')");
+        }
+        if (ta.type == WeightTensor::Type::Other) {
+            if (std::memcmp(a.data() + ta.offset, b.data() + tb.offset, static_cast<size_t>(ta.size)) != 0) {
+                return fail(error, "tenseur non flottant '" + ta.name + "' différent (quantifié ?)");
+            }
+        } else {
+            ++numBlended;
+        }
+    }
+    if (numBlended == 0) return fail(error, "aucun poids flottant à mélanger");
+
+    // Copie de A dans l'ordre du fichier, poids flottants remplacés par le mélange.
+    std::vector<size_t> order(tensorsA.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(),
+              [&](size_t x, size_t y) { return tensorsA[x].offset < tensorsA[y].offset; });
+
+    const std::string temporary = outPath + ".tmp";
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) return fail(error, "écriture impossible '" + temporary + "' : " + std::strerror(errno));
+    std::vector<float> blended(kChunkValues), other(kChunkValues);
+    std::vector<uint16_t> halves(kChunkValues);
+    const float r = std::clamp(ratio, 0.0f, 1.0f);
+    uint64_t position = 0;
+    bool ok = true;
+    for (size_t i : order) {
+        const WeightTensor& ta = tensorsA[i];
+        if (ta.type == WeightTensor::Type::Other || ta.offset < position) continue;
+        ok = writeAll(fd, a.data() + position, static_cast<size_t>(ta.offset - position)) &&
+             writeBlended(fd, ta, a.data() + ta.offset, b.data() + tensorsB[i].offset, r, blended, other, halves);
+        if (!ok) break;
+        position = ta.offset + ta.size;
+    }
+    ok = ok && writeAll(fd, a.data() + position, a.size() - static_cast<size_t>(position));
+    ok = (fsync(fd) == 0) && ok;
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || std::rename(temporary.c_str(), outPath.c_str()) != 0) {
+        const std::string reason = std::strerror(errno);
+        unlink(temporary.c_str());
+        return fail(error, "écriture du mélange échouée '" + outPath + "' : " + reason);
+    }
+    return true;
+}
+
+// --- BlendedModelCache ---
+
+BlendedModelCache::BlendedModelCache(std::string directory, size_t maxEntries)
+    : directory_(std::move(directory)), maxEntries_(std::max<size_t>(1, maxEntries)) {}
+
+int BlendedModelCache::ratioStep(float ratio) {
+    return static_cast<int>(std::lround(std::clamp(ratio, 0.0f, 1.0f) * kRatioSteps));
+}
+
+BlendedModelCache::Entry BlendedModelCache::canonical(const std::string& pathA, const std::string& pathB,
+                                                      float ratio) {
+    const int step = ratioStep(ratio);
+    if (pathB < pathA) return Entry{pathB, pathA, kRatioSteps - step};
+    return Entry{pathA, pathB, step};
+}
+
+/**
+ * Fichier de l'entrée ; chaîne vide si un modèle est introuvable.
+ */
+std::string BlendedModelCache::entryPath(const Entry& entry) const {
+    std::string key;
+    for (const std::string* path : {&entry.first, &entry.second}) {
+        struct stat info;
+        if (stat(path->c_str(), &info) != 0) return std::string();
+        key += *path + '\n' + std::to_string(info.st_size) + ' ' + std::to_string(info.st_mtime) + ' ' +
+               std::to_string(info.st_ino) + '\n';
+    }
+    key += std::to_string(entry.step);
+
+    char name[40];
+    std::snprintf(name, sizeof(name), "%s%016llx", kEntryPrefix, static_cast<unsigned long long>(fnv1a(key)));
+    const size_t extension = entry.first.find_last_of('.');
+    return directory_ + "/" + name + (extension == std::string::npos ? "" : entry.first.substr(extension));
+}
+
+std::string BlendedModelCache::find(const std::string& pathA, const std::string& pathB, float ratio) const {
+    const int step = ratioStep(ratio);
+    if (step == 0) return pathA;
+    if (step == kRatioSteps) return pathB;
+    const std::string path = entryPath(canonical(pathA, pathB, ratio));
+    return !path.empty() && access(path.c_str(), R_OK) == 0 ? path : std::string();
+}
+
+std::string BlendedModelCache::acquire(const std::string& pathA, const std::string& pathB, float ratio,
+                                       std::string* error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string path = find(pathA, pathB, ratio);
+    if (path == pathA || path == pathB) return path;
+    if (!path.empty()) {
+        utimensat(AT_FDCWD, path.c_str(), nullptr, 0); // Récemment utilisé
+        return path;
+    }
+
+    const Entry entry = canonical(pathA, pathB, ratio);
+    path = entryPath(entry);
+    if (path.empty()) {
+        fail(error, "modèle introuvable '" + pathA + "' ou '" + pathB + "'");
+        return std::string();
+    }
+    if (mkdir(directory_.c_str(), 0700) != 0 && errno != EEXIST) {
+        fail(error, "répertoire de cache inaccessible '" + directory_ + "'");
+        return std::string();
+    }
+    const float stepRatio = static_cast<float>(entry.step) / static_cast<float>(kRatioSteps);
+    if (!ModelBlender::blend(entry.first, entry.second, stepRatio, path, error)) return std::string();
+    evict(path);
+    return path;
+}
+
+/**
+ * Au-delà de maxEntries mélanges, les moins récemment utilisés (date de modification,
+ * rafraîchie à chaque accès) sont supprimés.
+ */
+void BlendedModelCache::evict(const std::string& keep) {
+    DIR* directory = opendir(directory_.c_str());
+    if (directory == nullptr) return;
+    std::vector<std::pair<time_t, std::string>> entries;
+    while (const dirent* entry = readdir(directory)) {
+        const std::string name = entry->d_name;
+        if (name.compare(0, std::strlen(kEntryPrefix), kEntryPrefix) != 0 || endsWith(name, ".tmp")) continue;
+        const std::string path = directory_ + "/" + name;
+        struct stat info;
+        if (path != keep && stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+            entries.emplace_back(info.st_mtime, path);
+        }
+    }
+    closedir(directory);
+    if (entries.size() < maxEntries_) return;
+    std::sort(entries.begin(), entries.end(), [](const auto& x, const auto& y) { return x.first > y.first; });
+    for (size_t i = maxEntries_ - 1; i < entries.size(); ++i) {
+        unlink(entries[i].second.c_str());
+    }
+}
+
+} // namespace rvc
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Tenseur constant (poids) d'un fichier modèle : emplacement de ses données dans le fichier.
+ */
+struct WeightTensor {
+    enum class Type { Float32, Float16, Other };
+
+    std::string name;
+    Type type = Type::Other;
+    std::vector<int64_t> shape;
+    uint64_t offset = 0; // Octets, depuis le début du fichier
+    uint64_t size = 0;
+};
+
+/**
+ * Table des poids d'un modèle TFLite (FlatBuffer "TFL3" : buffers référencés par les tenseurs
+ * des sous-graphes) ou ONNX (protobuf : initialiseurs du graphe principal, raw_data ou
+ * float_data). Les données restent en place : seuls les emplacements sont relevés.
+ * Les données externes (modèles > 2 Go) ne sont pas prises en charge.
+ */
+class ModelWeights {
+public:
+    enum class Format { TFLite, Onnx, Unknown };
+
+    static Format formatOf(const std::string& path);
+
+    // Tenseurs dans l'ordre du fichier modèle, sans doublon d'emplacement (buffers partagés).
+    // Faux (et message dans error) si le fichier est tronqué ou mal formé.
+    static bool read(const uint8_t* data, size_t size, Format format, std::vector<WeightTensor>& tensors,
+                     std::string* error = nullptr);
+};
+
+/**
+ * Mélange de deux modèles de même architecture (V16.0) : les poids flottants sont interpolés
+ * linéairement, (1 - ratio) * A + ratio * B, dans une copie de A. Le résultat est un modèle
+ * du même format, chargé (et projeté en mémoire) comme les autres : le mélange de voix coûte
+ * une seule inférence par bloc au lieu de deux.
+ *
+ * Les deux modèles doivent avoir les mêmes tenseurs constants (noms, types, formes, dans le
+ * même ordre) ; les tenseurs non flottants (quantifiés, entiers) doivent être identiques,
+ * leurs échelles ne se mélangent pas. Hors thread audio : lit et écrit tout le modèle.
+ */
+class ModelBlender {
+public:
+    // Écrit outPath (fichier temporaire renommé : jamais de modèle partiel visible).
+    static bool blend(const std::string& pathA, const std::string& pathB, float ratio, const std::string& outPath,
+                      std::string* error = nullptr);
+};
+
+/**
+ * Cache des modèles mélangés dans un répertoire, par (modèle A, modèle B, ratio). La clé
+ * couvre la taille et la date de modification des deux modèles (un modèle remplacé invalide
+ * ses mélanges) ; le ratio est arrondi au centième et (A, B, r) équivaut à (B, A, 1 - r).
+ * Le mélange est construit pour la clé elle-même (ratio arrondi, chemins ordonnés) : une
+ * entrée ne dépend pas de la requête qui l'a créée. Les maxEntries mélanges les plus
+ * récemment utilisés sont gardés. Une instance par répertoire, partagée par ses utilisateurs
+ * (son verrou ne sérialise que les acquire() qui passent par elle).
+ */
+class BlendedModelCache {
+public:
+    static constexpr size_t kDefaultMaxEntries = 4;
+    static constexpr int kRatioSteps = 100;
+
+    explicit BlendedModelCache(std::string directory, size_t maxEntries = kDefaultMaxEntries);
+
+    // Chemin du mélange s'il est déjà en cache, sinon chaîne vide. Ratio 0 ou 1 : le modèle
+    // d'origine lui-même.
+    std::string find(const std::string& pathA, const std::string& pathB, float ratio) const;
+
+    // Chemin du mélange, construit au besoin (thread de fond : plusieurs centaines de ms pour
+    // un modèle RVC). Chaîne vide (et message dans error) si les modèles sont incompatibles.
+    std::string acquire(const std::string& pathA, const std::string& pathB, float ratio,
+                        std::string* error = nullptr);
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    // (A, B, r) sous forme canonique : chemins ordonnés, ratio en pas de 1 / kRatioSteps.
+    struct Entry {
+        const std::string& first;
+        const std::string& second;
+        int step;
+    };
+
+    static int ratioStep(float ratio);
+    static Entry canonical(const std::string& pathA, const std::string& pathB, float ratio);
+    std::string entryPath(const Entry& entry) const;
+    void evict(const std::string& keep);
+
+    std::string directory_;
+    size_t maxEntries_;
+    std::mutex mutex_; // Une construction à la fois
+};
+
+} // namespace rvc
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "inference/f0_conditioner.h"
+#include <stddef.h>
+
+namespace rvc {
+
+/**
+ * Entrées du modèle qui accompagnent l'audio d'un bloc (V16.0) : contour de F0 conditionné
+ * et réglages de la voix de la session.
+ */
+struct ModelConditioning {
+    const F0Frame* f0 = nullptr; // Une trame par 10 ms ; absent pour un modèle sans F0
+    size_t numF0Frames = 0;
+    float indexRate = 0.0f;      // Part des features issues de l'index (FeatureRetriever)
+    bool discontinuity = false;  // Premier bloc d'un nouveau flux (modèle sauté avant)
+};
+
+} // namespace rvc
@@ -0,0 +1,513 @@
+#include "inference/streaming_encoder.h"
+#include "dsp/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+namespace rvc {
+
+namespace {
+
+// Échantillons d'entrée traités d'une traite (les buffers des couches en découlent).
+constexpr size_t kChunkSamples = 4096;
+constexpr float kNormEpsilon = 1e-5f;
+
+// Trames produites gardées au plus avant d'être rendues (dérive entre les deux cadences).
+constexpr size_t kMaxPendingFrames = 8;
+
+// Signal et découpage du self-check : blocs irréguliers, dont des blocs plus courts qu'un
+// pas et un bloc plus long que kChunkSamples.
+constexpr size_t kCheckSamples = StreamingContentEncoder::kInputRate;
+constexpr size_t kCheckChunks[] = {160, 333, 17, 1, 5000, 480, 1024, 91};
+constexpr float kCheckTolerance = 1e-3f;
+
+inline float gelu(float x) {
+    return 0.5f * x * (1.0f + std::erf(x * 0.70710678f));
+}
+
+void layerNorm(float* x, size_t n, const float* gamma, const float* beta) {
+    float mean = 0.0f;
+    for (size_t i = 0; i < n; ++i) mean += x[i];
+    mean /= static_cast<float>(n);
+    float variance = 0.0f;
+    for (size_t i = 0; i < n; ++i) variance += (x[i] - mean) * (x[i] - mean);
+    const float scale = 1.0f / std::sqrt(variance / static_cast<float>(n) + kNormEpsilon);
+    for (size_t i = 0; i < n; ++i) x[i] = (x[i] - mean) * scale * gamma[i] + beta[i];
+}
+
+// y = W x + b, W [outputs][inputs].
+void linear(const float* weight, const float* bias, const float* x, size_t inputs, size_t outputs, float* y) {
+    for (size_t o = 0; o < outputs; ++o) {
+        y[o] = simd::dot(weight + o * inputs, x, inputs) + (bias ? bias[o] : 0.0f);
+    }
+}
+
+bool fail(std::string* error, const char* message) {
+    if (error) *error = message;
+    return false;
+}
+
+bool validate(const ContentEncoderWeights& weights, std::string* error) {
+    if (weights.conv.empty()) return fail(error, "front-end convolutif vide");
+    size_t channels = 1;
+    for (const ContentEncoderWeights::ConvLayer& layer : weights.conv) {
+        if (layer.inChannels != channels || layer.outChannels == 0 || layer.kernel == 0 || layer.stride == 0 ||
+            layer.weight == nullptr || (layer.normGamma == nullptr) != (layer.normBeta == nullptr)) {
+            return fail(error, "couche convolutive incohérente");
+        }
+        channels = layer.outChannels;
+    }
+    if (weights.projection == nullptr || weights.dim == 0 || weights.heads == 0 || weights.dim % weights.heads != 0 ||
+        weights.contextFrames == 0 || (weights.projectionNormGamma == nullptr) != (weights.projectionNormBeta == nullptr)) {
+        return fail(error, "projection ou dimensions incohérentes");
+    }
+    const ContentEncoderWeights::PositionalConv& positional = weights.positionalConv;
+    if (positional.kernel > 0) {
+        if (!positional.causal) return fail(error, "convolution positionnelle centrée (non causale)");
+        if (positional.weight == nullptr || positional.groups == 0 || weights.dim % positional.groups != 0) {
+            return fail(error, "convolution positionnelle incohérente");
+        }
+    }
+    if ((weights.encoderNormGamma == nullptr) != (weights.encoderNormBeta == nullptr)) {
+        return fail(error, "normalisation de l'encodeur incomplète");
+    }
+    for (const ContentEncoderWeights::TransformerLayer& layer : weights.layers) {
+        if (!layer.inProj || !layer.outProj || !layer.norm1Gamma || !layer.norm1Beta || !layer.ffn1 || !layer.ffn2 ||
+            !layer.norm2Gamma || !layer.norm2Beta || weights.ffnDim == 0) {
+            return fail(error, "couche de transformer incomplète");
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+StreamingContentEncoder::StreamingContentEncoder(const ContentEncoderWeights& weights, int modelSampleRate,
+                                                 size_t maxBlockSamples)
+    : weights_(weights) {
+    // Pas et champ récepteur d'une trame, en échantillons d'entrée.
+    for (const ContentEncoderWeights::ConvLayer& layer : weights_.conv) {
+        receptiveField_ += (layer.kernel - 1) * hop_;
+        hop_ *= layer.stride;
+    }
+
+    conv_.resize(weights_.conv.size());
+    convOut_.resize(weights_.conv.size());
+    size_t newFrames = kChunkSamples;
+    for (size_t l = 0; l < conv_.size(); ++l) {
+        const ContentEncoderWeights::ConvLayer& layer = weights_.conv[l];
+        ConvState& state = conv_[l];
+        // Noyau réordonné [sortie][prise][entrée] : chaque prise est un produit scalaire
+        // contigu avec une trame d'entrée.
+        state.packed.resize(layer.outChannels * layer.kernel * layer.inChannels);
+        for (size_t o = 0; o < layer.outChannels; ++o) {
+            for (size_t c = 0; c < layer.inChannels; ++c) {
+                for (size_t k = 0; k < layer.kernel; ++k) {
+                    state.packed[(o * layer.kernel + k) * layer.inChannels + c] =
+                        layer.weight[(o * layer.inChannels + c) * layer.kernel + k];
+                }
+            }
+        }
+        const size_t capacity = layer.kernel - 1 + newFrames;
+        state.input.resize(capacity * layer.inChannels);
+        newFrames = capacity >= layer.kernel ? (capacity - layer.kernel) / layer.stride + 1 : 0;
+        convOut_[l].resize(std::max<size_t>(newFrames, 1) * layer.outChannels);
+    }
+
+    const ContentEncoderWeights::PositionalConv& positional = weights_.positionalConv;
+    if (positional.kernel > 0) {
+        // Même réordonnancement que le front-end, par groupe de canaux : [sortie][prise][entrée].
+        const size_t groupChannels = weights_.dim / positional.groups;
+        positionalPacked_.resize(weights_.dim * positional.kernel * groupChannels);
+        for (size_t o = 0; o < weights_.dim; ++o) {
+            for (size_t c = 0; c < groupChannels; ++c) {
+                for (size_t k = 0; k < positional.kernel; ++k) {
+                    positionalPacked_[(o * positional.kernel + k) * groupChannels + c] =
+                        positional.weight[(o * groupChannels + c) * positional.kernel + k];
+                }
+            }
+        }
+        positionalHistory_.assign(2 * positional.kernel * weights_.dim, 0.0f);
+    }
+
+    attention_.resize(weights_.layers.size());
+    for (AttentionState& state : attention_) {
+        state.keys.resize(weights_.contextFrames * weights_.dim);
+        state.values.resize(weights_.contextFrames * weights_.dim);
+    }
+    const size_t convChannels = weights_.conv.back().outChannels;
+    scratch_.resize(convChannels + 5 * weights_.dim + weights_.ffnDim + weights_.contextFrames);
+    frame_.resize(weights_.dim);
+
+    if (modelSampleRate != kInputRate) {
+        toInput_ = std::make_unique<PolyphaseResampler>(modelSampleRate, kInputRate);
+    }
+    const size_t maxInput = toInput_ ? toInput_->maxOutputSamples(maxBlockSamples) : maxBlockSamples;
+    resampled_.resize(toInput_ ? maxInput : 0);
+    const size_t maxProduced = maxInput / hop_ + 2;
+    produced_.resize(maxProduced * weights_.dim);
+    pending_.resize((maxProduced + kMaxPendingFrames) * weights_.dim);
+}
+
+bool StreamingContentEncoder::selfCheck(const ContentEncoderWeights& weights, std::string* error) {
+    if (!validate(weights, error)) return false;
+
+    StreamingContentEncoder encoder(weights, kInputRate, kCheckSamples);
+    std::vector<float> signal(kCheckSamples);
+    uint32_t seed = 0x2545F491;
+    for (size_t i = 0; i < signal.size(); ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const float noise = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) - 0.5f;
+        signal[i] = 0.3f * std::sin(0.05f * static_cast<float>(i)) + 0.2f * noise;
+    }
+
+    const std::vector<float> reference = encoder.encodeFullWindow(signal.data(), signal.size());
+    std::vector<float> streamed(reference.size() + weights.dim);
+    size_t numStreamed = 0;
+    size_t position = 0;
+    for (size_t chunk = 0; position < signal.size(); ++chunk) {
+        const size_t count = std::min(kCheckChunks[chunk % std::size(kCheckChunks)], signal.size() - position);
+        const size_t room = streamed.size() / weights.dim - numStreamed;
+        numStreamed += encoder.process(signal.data() + position, count, streamed.data() + numStreamed * weights.dim, room);
+        position += count;
+    }
+
+    if (numStreamed * weights.dim != reference.size()) {
+        return fail(error, "nombre de trames différent de la fenêtre complète");
+    }
+    float peak = 1.0f;
+    float worst = 0.0f;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        peak = std::max(peak, std::fabs(reference[i]));
+        worst = std::max(worst, std::fabs(reference[i] - streamed[i]));
+    }
+    if (worst > kCheckTolerance * peak) {
+        return fail(error, "trames en flux différentes de la fenêtre complète");
+    }
+    return true;
+}
+
+void StreamingContentEncoder::reset() {
+    for (ConvState& state : conv_) state.count = 0;
+    std::fill(positionalHistory_.begin(), positionalHistory_.end(), 0.0f);
+    positionalWrite_ = 0;
+    for (AttentionState& state : attention_) {
+        state.write = 0;
+        state.size = 0;
+    }
+    if (toInput_) toInput_->reset();
+    pendingCount_ = 0;
+    headUses_ = 0;
+}
+
+size_t StreamingContentEncoder::process(const float* in, size_t numSamples, float* frames, size_t maxFrames) {
+    const size_t dim = weights_.dim;
+    const size_t last = conv_.size() - 1;
+    size_t written = 0;
+    for (size_t offset = 0; offset < numSamples; offset += kChunkSamples) {
+        // Chaque couche consomme les sorties de la précédente ; seules les trames complètes
+        // sortent du front-end.
+        const float* input = in + offset;
+        size_t count = std::min(kChunkSamples, numSamples - offset);
+        for (size_t l = 0; l <= last; ++l) {
+            size_t produced = 0;
+            runConv(l, input, count, convOut_[l].data(), produced);
+            input = convOut_[l].data();
+            count = produced;
+        }
+        const size_t convChannels = weights_.conv[last].outChannels;
+        for (size_t t = 0; t < count; ++t) {
+            const float* frame = finishFrame(convOut_[last].data() + t * convChannels);
+            if (written < maxFrames) {
+                std::copy(frame, frame + dim, frames + written * dim);
+                ++written;
+            }
+        }
+    }
+    return written;
+}
+
+/**
+ * Couche convolutive en flux : les trames reçues complètent l'entrée gardée, chaque sortie
+ * complète est calculée une seule fois et l'entrée qui ne servira plus est abandonnée.
+ */
+void StreamingContentEncoder::runConv(size_t layer, const float* frames, size_t numFrames, float* out,
+                                      size_t& produced) {
+    const ContentEncoderWeights::ConvLayer& weights = weights_.conv[layer];
+    ConvState& state = conv_[layer];
+    const size_t in = weights.inChannels;
+    std::copy(frames, frames + numFrames * in, state.input.data() + state.count * in);
+    state.count += numFrames;
+
+    size_t position = 0;
+    produced = 0;
+    while (state.count - position >= weights.kernel) {
+        float* y = out + produced * weights.outChannels;
+        const float* x = state.input.data() + position * in;
+        for (size_t o = 0; o < weights.outChannels; ++o) {
+            const float* w = state.packed.data() + o * weights.kernel * in;
+            float sum = weights.bias ? weights.bias[o] : 0.0f;
+            for (size_t k = 0; k < weights.kernel; ++k) {
+                sum += simd::dot(w + k * in, x + k * in, in);
+            }
+            y[o] = sum;
+        }
+        if (weights.normGamma) layerNorm(y, weights.outChannels, weights.normGamma, weights.normBeta);
+        for (size_t o = 0; o < weights.outChannels; ++o) y[o] = gelu(y[o]);
+        position += weights.stride;
+        ++produced;
+    }
+    position = std::min(position, state.count);
+    std::copy(state.input.data() + position * in, state.input.data() + state.count * in, state.input.data());
+    state.count -= position;
+}
+
+/**
+ * Trame du front-end -> projection -> couches du transformer ; retourne les dim() floats de
+ * sortie (valides jusqu'à la trame suivante).
+ */
+const float* StreamingContentEncoder::finishFrame(const float* frame) {
+    const size_t convChannels = weights_.conv.back().outChannels;
+    float* normalized = scratch_.data() + 5 * weights_.dim + weights_.ffnDim + weights_.contextFrames;
+    std::copy(frame, frame + convChannels, normalized);
+    if (weights_.projectionNormGamma) {
+        layerNorm(normalized, convChannels, weights_.projectionNormGamma, weights_.projectionNormBeta);
+    }
+    float* x = frame_.data();
+    linear(weights_.projection, weights_.projectionBias, normalized, convChannels, weights_.dim, x);
+    if (weights_.positionalConv.kernel > 0) positionalConv(x);
+    if (weights_.encoderNormGamma) layerNorm(x, weights_.dim, weights_.encoderNormGamma, weights_.encoderNormBeta);
+    for (size_t l = 0; l < weights_.layers.size(); ++l) {
+        transformerLayer(l, x, attention_[l]);
+    }
+    return x;
+}
+
+/**
+ * Convolution positionnelle causale de la trame projetée x : chaque trame est écrite deux
+ * fois dans l'anneau (à w et w + kernel), les kernel dernières sont donc contiguës, de la
+ * plus ancienne à x (zéros avant le début du flux, comme le padding à gauche).
+ */
+void StreamingContentEncoder::positionalConv(float* x) {
+    const ContentEncoderWeights::PositionalConv& positional = weights_.positionalConv;
+    const size_t dim = weights_.dim;
+    const size_t kernel = positional.kernel;
+    const size_t groupChannels = dim / positional.groups;
+    float* history = positionalHistory_.data();
+    std::copy(x, x + dim, history + positionalWrite_ * dim);
+    std::copy(x, x + dim, history + (positionalWrite_ + kernel) * dim);
+    positionalWrite_ = (positionalWrite_ + 1) % kernel;
+    const float* window = history + positionalWrite_ * dim;
+
+    float* out = scratch_.data(); // Libre hors des couches du transformer
+    for (size_t o = 0; o < dim; ++o) {
+        const float* w = positionalPacked_.data() + o * kernel * groupChannels;
+        const float* column = window + (o / groupChannels) * groupChannels;
+        float sum = positional.bias ? positional.bias[o] : 0.0f;
+        for (size_t k = 0; k < kernel; ++k) {
+            sum += simd::dot(w + k * groupChannels, column + k * dim, groupChannels);
+        }
+        out[o] = sum;
+    }
+    for (size_t o = 0; o < dim; ++o) x[o] += gelu(out[o]);
+}
+
+/**
+ * Attention multi-tête d'une requête sur numKeys clés/valeurs (ordre indifférent) ;
+ * scores : numKeys floats de travail.
+ */
+void StreamingContentEncoder::attend(const float* query, const float* keys, const float* values, size_t numKeys,
+                                     float* scores, float* out) const {
+    const size_t dim = weights_.dim;
+    const size_t headDim = dim / weights_.heads;
+    const float scale = 1.0f / std::sqrt(static_cast<float>(headDim));
+    for (size_t h = 0; h < weights_.heads; ++h) {
+        const size_t offset = h * headDim;
+        float peak = -INFINITY;
+        for (size_t j = 0; j < numKeys; ++j) {
+            scores[j] = simd::dot(query + offset, keys + j * dim + offset, headDim) * scale;
+            peak = std::max(peak, scores[j]);
+        }
+        float total = 0.0f;
+        for (size_t j = 0; j < numKeys; ++j) {
+            scores[j] = std::exp(scores[j] - peak);
+            total += scores[j];
+        }
+        std::fill(out + offset, out + offset + headDim, 0.0f);
+        for (size_t j = 0; j < numKeys; ++j) {
+            simd::accumulateScaled(out + offset, values + j * dim + offset, scores[j] / total, headDim);
+        }
+    }
+}
+
+void StreamingContentEncoder::transformerLayer(size_t layer, float* x, AttentionState& state) {
+    const ContentEncoderWeights::TransformerLayer& weights = weights_.layers[layer];
+    const size_t dim = weights_.dim;
+    float* qkv = scratch_.data();
+    float* attended = qkv + 3 * dim;
+    float* projected = attended + dim;
+    float* hidden = projected + dim;
+
+    linear(weights.inProj, weights.inBias, x, dim, 3 * dim, qkv);
+    // Clé et valeur de la trame nouvelle : seule entrée du cache calculée à cet appel.
+    std::copy(qkv + dim, qkv + 2 * dim, state.keys.data() + state.write * dim);
+    std::copy(qkv + 2 * dim, qkv + 3 * dim, state.values.data() + state.write * dim);
+    state.write = (state.write + 1) % weights_.contextFrames;
+    state.size = std::min(state.size + 1, weights_.contextFrames);
+
+    float* scores = hidden + weights_.ffnDim;
+    attend(qkv, state.keys.data(), state.values.data(), state.size, scores, attended);
+    linear(weights.outProj, weights.outBias, attended, dim, dim, projected);
+    simd::accumulate(x, projected, dim);
+    layerNorm(x, dim, weights.norm1Gamma, weights.norm1Beta);
+
+    linear(weights.ffn1, weights.ffn1Bias, x, dim, weights_.ffnDim, hidden);
+    for (size_t i = 0; i < weights_.ffnDim; ++i) hidden[i] = gelu(hidden[i]);
+    linear(weights.ffn2, weights.ffn2Bias, hidden, weights_.ffnDim, dim, projected);
+    simd::accumulate(x, projected, dim);
+    layerNorm(x, dim, weights.norm2Gamma, weights.norm2Beta);
+}
+
+void StreamingContentEncoder::encode(const float* audio, size_t numSamples, float* features, size_t numFrames) {
+    const size_t dim = weights_.dim;
+    const float* input = audio;
+    size_t count = numSamples;
+    if (toInput_) {
+        count = toInput_->process(audio, numSamples, resampled_.data());
+        input = resampled_.data();
+    }
+
+    const size_t produced = process(input, count, produced_.data(), produced_.size() / dim);
+    const size_t capacity = pending_.size() / dim;
+    if (pendingCount_ + produced > capacity) {
+        // Encodeur en avance (dérive des deux cadences) : les trames les plus anciennes sautent.
+        const size_t dropped = pendingCount_ + produced - capacity;
+        std::copy(pending_.begin() + static_cast<ptrdiff_t>(dropped * dim),
+                  pending_.begin() + static_cast<ptrdiff_t>(pendingCount_ * dim), pending_.begin());
+        pendingCount_ -= dropped;
+        headUses_ = 0;
+    }
+    std::copy(produced_.data(), produced_.data() + produced * dim, pending_.data() + pendingCount_ * dim);
+    pendingCount_ += produced;
+
+    // La trame en tête est rendue kFrameRepeat fois, puis cède la place à la suivante ; sans
+    // suivante, elle est maintenue.
+    for (size_t j = 0; j < numFrames; ++j) {
+        if (headUses_ >= kFrameRepeat && pendingCount_ > 1) {
+            std::copy(pending_.begin() + static_cast<ptrdiff_t>(dim),
+                      pending_.begin() + static_cast<ptrdiff_t>(pendingCount_ * dim), pending_.begin());
+            --pendingCount_;
+            headUses_ = 0;
+        }
+        if (pendingCount_ > 0) {
+            std::copy(pending_.data(), pending_.data() + dim, features + j * dim);
+            ++headUses_;
+        } else {
+            std::fill(features + j * dim, features + (j + 1) * dim, 0.0f);
+        }
+    }
+}
+
+std::vector<float> StreamingContentEncoder::encodeFullWindow(const float* in, size_t numSamples) const {
+    // Front-end : chaque couche sur toute la séquence.
+    std::vector<float> sequence(in, in + numSamples);
+    size_t numFrames = numSamples;
+    for (size_t l = 0; l < weights_.conv.size(); ++l) {
+        const ContentEncoderWeights::ConvLayer& layer = weights_.conv[l];
+        const size_t outputs = numFrames >= layer.kernel ? (numFrames - layer.kernel) / layer.stride + 1 : 0;
+        std::vector<float> next(outputs * layer.outChannels);
+        for (size_t t = 0; t < outputs; ++t) {
+            float* y = next.data() + t * layer.outChannels;
+            for (size_t o = 0; o < layer.outChannels; ++o) {
+                float sum = layer.bias ? layer.bias[o] : 0.0f;
+                for (size_t k = 0; k < layer.kernel; ++k) {
+                    const float* x = sequence.data() + (t * layer.stride + k) * layer.inChannels;
+                    for (size_t c = 0; c < layer.inChannels; ++c) {
+                        sum += layer.weight[(o * layer.inChannels + c) * layer.kernel + k] * x[c];
+                    }
+                }
+                y[o] = sum;
+            }
+            if (layer.normGamma) layerNorm(y, layer.outChannels, layer.normGamma, layer.normBeta);
+            for (size_t o = 0; o < layer.outChannels; ++o) y[o] = gelu(y[o]);
+        }
+        sequence.swap(next);
+        numFrames = outputs;
+    }
+
+    // Projection puis transformer, chaque couche sur toute la séquence avec le masque causal.
+    const size_t dim = weights_.dim;
+    const size_t convChannels = weights_.conv.back().outChannels;
+    std::vector<float> x(numFrames * dim);
+    std::vector<float> normalized(convChannels);
+    for (size_t t = 0; t < numFrames; ++t) {
+        std::copy(sequence.begin() + static_cast<ptrdiff_t>(t * convChannels),
+                  sequence.begin() + static_cast<ptrdiff_t>((t + 1) * convChannels), normalized.begin());
+        if (weights_.projectionNormGamma) {
+            layerNorm(normalized.data(), convChannels, weights_.projectionNormGamma, weights_.projectionNormBeta);
+        }
+        linear(weights_.projection, weights_.projectionBias, normalized.data(), convChannels, dim, x.data() + t * dim);
+    }
+
+    // Convolution positionnelle causale (padding à gauche), sur les trames projetées.
+    const ContentEncoderWeights::PositionalConv& positional = weights_.positionalConv;
+    if (positional.kernel > 0) {
+        const size_t groupChannels = dim / positional.groups;
+        std::vector<float> convolved(numFrames * dim);
+        for (size_t t = 0; t < numFrames; ++t) {
+            for (size_t o = 0; o < dim; ++o) {
+                const size_t group = o / groupChannels;
+                float sum = positional.bias ? positional.bias[o] : 0.0f;
+                for (size_t k = 0; k < positional.kernel; ++k) {
+                    if (t + k + 1 < positional.kernel) continue; // Avant le début du flux
+                    const float* frame = x.data() + (t + k + 1 - positional.kernel) * dim + group * groupChannels;
+                    for (size_t c = 0; c < groupChannels; ++c) {
+                        sum += positional.weight[(o * groupChannels + c) * positional.kernel + k] * frame[c];
+                    }
+                }
+                convolved[t * dim + o] = sum;
+            }
+        }
+        for (size_t i = 0; i < x.size(); ++i) x[i] += gelu(convolved[i]);
+    }
+    if (weights_.encoderNormGamma) {
+        for (size_t t = 0; t < numFrames; ++t) {
+            layerNorm(x.data() + t * dim, dim, weights_.encoderNormGamma, weights_.encoderNormBeta);
+        }
+    }
+
+    std::vector<float> qkv(numFrames * 3 * dim);
+    std::vector<float> keys(numFrames * dim);
+    std::vector<float> values(numFrames * dim);
+    std::vector<float> attended(dim);
+    std::vector<float> projected(dim);
+    std::vector<float> hidden(weights_.ffnDim);
+    std::vector<float> scores(weights_.contextFrames);
+    for (size_t l = 0; l < weights_.layers.size(); ++l) {
+        const ContentEncoderWeights::TransformerLayer& layer = weights_.layers[l];
+        for (size_t t = 0; t < numFrames; ++t) {
+            linear(layer.inProj, layer.inBias, x.data() + t * dim, dim, 3 * dim, qkv.data() + t * 3 * dim);
+            std::copy(qkv.begin() + static_cast<ptrdiff_t>(t * 3 * dim + dim),
+                      qkv.begin() + static_cast<ptrdiff_t>(t * 3 * dim + 2 * dim), keys.begin() + static_cast<ptrdiff_t>(t * dim));
+            std::copy(qkv.begin() + static_cast<ptrdiff_t>(t * 3 * dim + 2 * dim),
+                      qkv.begin() + static_cast<ptrdiff_t>((t + 1) * 3 * dim), values.begin() + static_cast<ptrdiff_t>(t * dim));
+        }
+        for (size_t t = 0; t < numFrames; ++t) {
+            const size_t first = t + 1 > weights_.contextFrames ? t + 1 - weights_.contextFrames : 0;
+            float* row = x.data() + t * dim;
+            attend(qkv.data() + t * 3 * dim, keys.data() + first * dim, values.data() + first * dim, t + 1 - first,
+                   scores.data(), attended.data());
+            linear(layer.outProj, layer.outBias, attended.data(), dim, dim, projected.data());
+            simd::accumulate(row, projected.data(), dim);
+            layerNorm(row, dim, layer.norm1Gamma, layer.norm1Beta);
+            linear(layer.ffn1, layer.ffn1Bias, row, dim, weights_.ffnDim, hidden.data());
+            for (float& h : hidden) h = gelu(h);
+            linear(layer.ffn2, layer.ffn2Bias, hidden.data(), weights_.ffnDim, dim, projected.data());
+            simd::accumulate(row, projected.data(), dim);
+            layerNorm(row, dim, layer.norm2Gamma, layer.norm2Beta);
+        }
+    }
+    return x;
+}
+
+} // namespace rvc
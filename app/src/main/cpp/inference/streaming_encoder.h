@@ -0,0 +1,175 @@
+#pragma once
+
+#include "dsp/resampler.h"
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace rvc {
+
+/**
+ * Poids de l'encodeur de contenu (vues sur des tenseurs extraits du modèle, disposition
+ * PyTorch). Toutes les matrices sont [sortie][entrée].
+ */
+struct ContentEncoderWeights {
+    // Couche du front-end convolutif : Conv1d (sans padding), LayerNorm facultative sur les
+    // canaux (extracteur en mode "layer_norm"), puis GELU.
+    struct ConvLayer {
+        size_t inChannels = 0;
+        size_t outChannels = 0;
+        size_t kernel = 0;
+        size_t stride = 0;
+        const float* weight = nullptr; // [outChannels][inChannels][kernel]
+        const float* bias = nullptr;   // outChannels, facultatif
+        const float* normGamma = nullptr;
+        const float* normBeta = nullptr;
+    };
+
+    // Couche de transformer post-LN (HuBERT) : x = LN1(x + Attn(x)), x = LN2(x + FFN(x)).
+    struct TransformerLayer {
+        const float* inProj = nullptr;  // [3 * dim][dim] : requêtes, clés, valeurs
+        const float* inBias = nullptr;  // 3 * dim
+        const float* outProj = nullptr; // [dim][dim]
+        const float* outBias = nullptr;
+        const float* norm1Gamma = nullptr;
+        const float* norm1Beta = nullptr;
+        const float* ffn1 = nullptr;    // [ffnDim][dim]
+        const float* ffn1Bias = nullptr;
+        const float* ffn2 = nullptr;    // [dim][ffnDim]
+        const float* ffn2Bias = nullptr;
+        const float* norm2Gamma = nullptr;
+        const float* norm2Beta = nullptr;
+    };
+
+    // Convolution positionnelle (pos_conv de HuBERT), entre la projection et le transformer :
+    // x += GELU(conv(x)), convolution groupée sur le temps, normalisation des poids déjà
+    // repliée (weight_g * v / |v|). HuBERT la centre (128 prises, 64 trames de futur) : non
+    // causale, elle interdit le flux et selfCheck() la refuse. Seule une variante entraînée
+    // avec un padding à gauche uniquement (causal = true) passe en flux.
+    struct PositionalConv {
+        size_t kernel = 0; // 0 : absente
+        size_t groups = 16;
+        bool causal = false;
+        const float* weight = nullptr; // [dim][dim / groups][kernel]
+        const float* bias = nullptr;   // dim, facultatif
+    };
+
+    std::vector<ConvLayer> conv;
+
+    // Projection des features convolutives : LayerNorm(convChannels) puis Linear -> dim.
+    const float* projectionNormGamma = nullptr;
+    const float* projectionNormBeta = nullptr;
+    const float* projection = nullptr; // [dim][convChannels]
+    const float* projectionBias = nullptr;
+
+    PositionalConv positionalConv;
+    // LayerNorm de l'encodeur après la convolution positionnelle (HuBERT post-LN), facultative.
+    const float* encoderNormGamma = nullptr;
+    const float* encoderNormBeta = nullptr;
+
+    size_t dim = 768;
+    size_t heads = 12;
+    size_t ffnDim = 3072;
+    // Trames passées visibles par l'attention (trame courante comprise). Seul un encodeur
+    // entraîné avec ce masque causal à gauche se met en flux sans changer de sortie.
+    size_t contextFrames = 50;
+    std::vector<TransformerLayer> layers;
+};
+
+/**
+ * Encodeur de contenu en flux (V16.0) : seules les trames nouvelles de chaque bloc sont
+ * calculées, au lieu de réencoder toute la fenêtre de contexte à chaque appel.
+ *
+ *   - front-end convolutif : chaque couche garde les (kernel - 1) trames d'entrée encore
+ *     nécessaires à sa prochaine sortie et ne calcule que les sorties complètes ;
+ *   - convolution positionnelle causale : les kernel dernières trames projetées sont
+ *     gardées en anneau ;
+ *   - transformer : les clés/valeurs des contextFrames dernières trames de chaque couche
+ *     sont gardées en anneau, la requête de la trame nouvelle les parcourt.
+ *
+ * Le résultat est celui de l'encodage de tout le flux en une fois (encodeFullWindow), à
+ * l'arrondi près : selfCheck() le vérifie sur les poids réels avant de choisir le mode flux.
+ * Ne convient pas aux modèles dont une couche voit le futur ou normalise sur le temps
+ * (GroupNorm du mode "default" de HuBERT base, attention bidirectionnelle, convolution
+ * positionnelle centrée) : ceux-là restent en fenêtre complète dans le moteur. C'est le cas
+ * des encodeurs RVC actuels (HuBERT/ContentVec) ; tools/checks/check_streaming_encoder
+ * vérifie le flux sur des poids aléatoires.
+ */
+class StreamingContentEncoder {
+public:
+    static constexpr int kInputRate = 16000;
+    // Les trames de l'encodeur (50 par seconde pour HuBERT) sont répétées pour les trames du
+    // synthétiseur (100 par seconde), comme l'interpolation x2 de RVC.
+    static constexpr size_t kFrameRepeat = 2;
+
+    // modelSampleRate : fréquence des blocs d'encode() ; maxBlockSamples : plus grand bloc.
+    StreamingContentEncoder(const ContentEncoderWeights& weights, int modelSampleRate, size_t maxBlockSamples);
+
+    // Compare flux (blocs irréguliers) et fenêtre complète sur un signal pseudo-aléatoire.
+    // Hors thread audio (alloue).
+    static bool selfCheck(const ContentEncoderWeights& weights, std::string* error = nullptr);
+
+    size_t dim() const { return weights_.dim; }
+    // Échantillons (à kInputRate) entre deux trames de l'encodeur, et fenêtre d'une trame.
+    size_t hopSamples() const { return hop_; }
+    size_t receptiveField() const { return receptiveField_; }
+
+    // --- Thread d'inférence ---
+    // Échantillons à kInputRate -> trames de dim() floats terminées pendant l'appel (au plus
+    // maxFrames écrites) ; retourne leur nombre.
+    size_t process(const float* in, size_t numSamples, float* frames, size_t maxFrames);
+
+    // Bloc à la fréquence du modèle -> numFrames trames du synthétiseur, prises dans l'ordre
+    // des trames produites (la dernière est répétée si l'encodeur n'en a pas encore assez).
+    void encode(const float* audio, size_t numSamples, float* features, size_t numFrames);
+
+    // Nouveau flux : caches vidés.
+    void reset();
+
+    // Référence : tout le signal d'un coup, sans cache. Hors thread audio.
+    std::vector<float> encodeFullWindow(const float* in, size_t numSamples) const;
+
+private:
+    struct ConvState {
+        std::vector<float> packed; // [outChannels][kernel][inChannels]
+        std::vector<float> input;  // Trames [temps][inChannels] pas encore consommées
+        size_t count = 0;
+    };
+
+    struct AttentionState {
+        std::vector<float> keys;   // Anneau [contextFrames][dim]
+        std::vector<float> values;
+        size_t write = 0;
+        size_t size = 0;
+    };
+
+    void runConv(size_t layer, const float* frames, size_t numFrames, float* out, size_t& produced);
+    void positionalConv(float* x);
+    const float* finishFrame(const float* frame);
+    void attend(const float* query, const float* keys, const float* values, size_t numKeys, float* scores,
+                float* out) const;
+    void transformerLayer(size_t layer, float* x, AttentionState& state);
+
+    ContentEncoderWeights weights_;
+    size_t hop_ = 1;
+    size_t receptiveField_ = 1;
+
+    std::vector<ConvState> conv_;
+    std::vector<std::vector<float>> convOut_; // Sorties de chaque couche pour la suivante
+    std::vector<float> positionalPacked_;  // [dim][kernel][dim / groups]
+    std::vector<float> positionalHistory_; // Anneau doublé [2 * kernel][dim] : fenêtre contiguë
+    size_t positionalWrite_ = 0;
+    std::vector<AttentionState> attention_;
+    std::vector<float> scratch_; // q, k, v, attention, FFN, scores, trame normalisée
+    std::vector<float> frame_;   // Trame en cours dans le transformer
+
+    std::unique_ptr<PolyphaseResampler> toInput_; // nullptr si le modèle est déjà à kInputRate
+    std::vector<float> resampled_;
+    std::vector<float> produced_; // Trames du bloc courant
+    std::vector<float> pending_;  // Trames produites pas encore rendues (la tête est la trame rendue)
+    size_t pendingCount_ = 0;
+    size_t headUses_ = 0;         // Fois où la trame en tête a été rendue
+};
+
+} // namespace rvc
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace rvc {
+
+// Quantification de la F0 transposée (IPCManager.SCALE_*).
+enum class PitchScale : uint8_t {
+    Off = 0,       // Contour libre (vibrato, glissandos conservés)
+    Chromatic = 1, // Demi-ton le plus proche
+    Major = 2,
+    Minor = 3,     // Mineur naturel
+};
+
+/**
+ * Réglages de voix du profil actif (Profile.kt), publiés par l'UI via JNI dans la session
+ * de capture et récupérés par le thread audio une fois par bloc (TripleBuffer).
+ */
+struct VoiceParameters {
+    float pitchSemitones = 0.0f; // pitchValue : -12 à 12 demi-tons (cents en partie fractionnaire)
+    float indexRate = 0.5f;      // naturalityValue / 100 : part des features issues de l'index
+    PitchScale scale = PitchScale::Off;
+    int scaleRoot = 0;           // Tonique de la gamme : 0 = do ... 11 = si
+};
+
+} // namespace rvc
@@ -8,12 +8,22 @@
 #include <string>
 #include <vector>
 #include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 // Inclusion des Headers Critiques du Projet
 #include "inference/ie_manager.h" // Gestionnaire TFLite/ONNX
 #include "dsp/fx_graph.h"        // Pipeline d'effets (EQ, Compresseur, PLC)
 #include "security/lock_manager.h" // Pour la gestion des verrous et la stabilité
 #include "audio/oboe_duplex.h"     // Pour le Sidetone (monitoring casque)
+#include "dsp/voice_activity.h"     // Saut de l'inférence hors parole (VAD)
+#include "dsp/denormals.h"          // FTZ/DAZ du thread audio
+#include "dsp/preset_file.h"        // Presets binaires projetés (profils par application)
+#include "audio/capture_session.h"   // Format de l'AudioRecord hooké (fréquence, canaux)
+#include "inference/voice_parameters.h"
 
 // Définitions pour les Logs Android
 #define LOG_TAG "RVC_NDK_CORE"
@@ -21,6 +31,8 @@
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
 // Constantes Critiques de Temps Réel
+// Fréquence native du modèle RVC (entrée et sortie de runInference). Le graphe d'effets
+// tourne à celle de la session de capture.
 constexpr int RVC_SAMPLE_RATE = 48000;
 constexpr int WATCHDOG_TIMEOUT_MS = 30; // 30ms max avant de forcer le PLC
 
@@ -33,6 +45,25 @@ static InferenceEngineManager *ieManager = nullptr;
 static FXGraph *fxGraph = nullptr;
 static pthread_t watchdogThread; // Thread Watchdog pour la stabilité
 
+// Session de capture courante (format de l'AudioRecord hooké, VAD, conversions vers le
+// modèle). Remplacée par configureSession (sérialisé par sessionMutex, également pris par
+// les JNI de lecture), libérée une fois les blocs en cours terminés.
+static std::atomic<rvc::CaptureSession*> captureSession{nullptr};
+static std::atomic<int> activeBlocks{0};
+static std::mutex sessionMutex;
+static std::atomic<bool> comfortNoiseEnabled{true}; // Reporté sur chaque nouvelle session
+static std::atomic<bool> processingExcluded{false};  // Preset kExcluded : audio rendu tel quel
+
+// Bloc en cours sur le thread audio : la session lue reste valide jusqu'à sa fin.
+struct ActiveBlock {
+    ActiveBlock() { activeBlocks.fetch_add(1); }
+    ~ActiveBlock() { activeBlocks.fetch_sub(1); }
+};
+
+// Réglages de voix du profil : écrits par l'UI sous sessionMutex (jamais pris par le
+// thread audio) et publiés sans verrou dans la session, qui les récupère au bloc suivant.
+static rvc::VoiceParameters currentVoice; // Reporté sur chaque nouvelle session
+
 // --- Déclaration des Fonctions JNI (Appelées par IPCManager.kt) ---
 
 extern "C" JNIEXPORT jboolean JNICALL
@@ -70,10 +101,19 @@ Java_com_rvc_patch_ipc_IPCManager_initializeNativeEngine(
 
         // 3. Initialisation des composants RVC critiques
         ieManager = new InferenceEngineManager();
+        // Session par défaut (mono à la fréquence du modèle) jusqu'au premier configureSession.
         fxGraph = new FXGraph(RVC_SAMPLE_RATE);
-        
-        // Simule le chargement du modèle par défaut et le benchmark DSP/Hexagon
-        if (!ieManager->loadDefaultModel(bufferSize, RVC_SAMPLE_RATE)) {
+        rvc::CaptureSession *session =
+            new rvc::CaptureSession(RVC_SAMPLE_RATE, 1, RVC_SAMPLE_RATE, sharedBufferSize / sizeof(float));
+        captureSession.store(session);
+
+        // V16.0: Étages du modèle pipelinés sur les SoC multicœurs (blocs de toute session),
+        // déclarés avant le chargement pour que le benchmark mesure ces étages.
+        ieManager->enablePipeline(rvc::CaptureSession::maxModelSamples(sharedBufferSize / sizeof(float), RVC_SAMPLE_RATE));
+
+        // Modèle par défaut et benchmark des délégués, au bloc de la session (en échantillons
+        // du modèle) et non à la taille de l'Ashmem.
+        if (!ieManager->loadDefaultModel(session->modelBlockSamples(), RVC_SAMPLE_RATE)) {
              LOGE("Échec du chargement du modèle par défaut.");
              // Nous pourrions choisir de continuer ou de retourner JNI_FALSE ici.
         }
@@ -127,15 +167,30 @@ Java_com_rvc_patch_ipc_IPCManager_processAudioNative(
         return JNI_FALSE;
     }
     
+    // Application exclue par son profil : le buffer repart sans aucun traitement.
+    if (processingExcluded.load(std::memory_order_relaxed)) return JNI_TRUE;
+
+    // Dénormalisés mis à zéro pendant le bloc (thread Java appelant : état restauré en sortie).
+    rvc::ScopedFlushDenormals flushDenormals;
+
     // Démarre la mesure de la latence (chrono)
     auto start_time = std::chrono::high_resolution_clock::now();
 
-    const size_t numSamples = bytesRead / sizeof(float);
+    // V16.0: Format de la session (fréquence et canaux de l'AudioRecord) : traitement mono
+    // à la fréquence de l'application.
+    ActiveBlock activeBlock;
+    rvc::CaptureSession *session = captureSession.load();
+
+    // Réglages du profil publiés depuis le bloc précédent (sans verrou)
+    session->acquireVoice();
+    const size_t numSamples = bytesRead / (sizeof(float) * session->channelCount());
+    float *voice = session->downmix(sharedBufferPtr, numSamples);
     
     // Si le traitement RVC n'est pas activé par l'utilisateur (Pass-through léger)
     if (!isRVCTransforming) {
         // Applique seulement le Noise Gate et le Limiteur de Crête (Mode Low Power Pass-Through V10.0)
-        fxGraph->applyLowPowerDSP(sharedBufferPtr, numSamples);
+        fxGraph->applyLowPowerDSP(voice, numSamples);
+        session->upmix(voice, sharedBufferPtr, numSamples);
         return JNI_TRUE;
     }
 
@@ -143,17 +198,38 @@ Java_com_rvc_patch_ipc_IPCManager_processAudioNative(
         // --- Pipeline RVC Complet ---
 
         // 1. Pré-Traitement Acoustique (AEC, DNS Neuronale)
-        fxGraph->applyAcousticPreprocessing(sharedBufferPtr, numSamples); 
+        fxGraph->applyAcousticPreprocessing(voice, numSamples); 
+
+        // V16.0: Contour de F0 de la voix nettoyée, transposé selon le profil pour le modèle.
+        session->trackPitch(voice, numSamples);
 
         // 2. Inférence RVC (La partie la plus lourde sur le DSP/Hexagon)
-        // ieManager traite directement le sharedBufferPtr (In-Place Inference)
-        ieManager->runInference(sharedBufferPtr, numSamples); 
+        // ieManager traite directement la voix (In-Place Inference), à sa fréquence native :
+        // V16.0: conversions autour du modèle seulement si la session capture à une autre fréquence.
+        // Si le Noise Gate a fermé tout le bloc, le buffer est déjà nul : on saute le modèle.
+        // V16.0: Le VAD saute aussi le modèle hors parole (bruit de confort, fondus aux transitions).
+        // Inférence pipelinée : ses décisions suivent la voix, kDepth blocs plus tard.
+        rvc::VoiceActivityGate &voiceActivity = session->voiceActivity();
+        voiceActivity.setDecisionDelay(ieManager->isPipelined() ? rvc::InferencePipeline::kDepth : 0);
+        if (voiceActivity.analyze(voice, numSamples, fxGraph->isInputGated())) {
+            auto inference_start = std::chrono::high_resolution_clock::now();
+            session->runModel(voice, numSamples, [](float *samples, size_t count, const rvc::ModelConditioning &conditioning) {
+                ieManager->runInference(samples, count, conditioning);
+            });
+            voiceActivity.recordInference(
+                std::chrono::duration<float, std::micro>(std::chrono::high_resolution_clock::now() - inference_start).count(),
+                numSamples);
+        } else {
+            session->skipModel();
+        }
+        voiceActivity.finish(voice, numSamples);
 
         // 3. Post-Traitement et Finition (EQ, Compresseur Multibandes, PLC)
-        fxGraph->applyPostProcessing(sharedBufferPtr, numSamples);
+        fxGraph->applyPostProcessing(voice, numSamples);
+        session->upmix(voice, sharedBufferPtr, numSamples);
 
         // 4. Envoi du Sidetone au casque (Monitoring)
-        // OboeDuplex::getInstance()->sendAudio(sharedBufferPtr, numSamples);
+        // OboeDuplex::getInstance()->sendAudio(voice, numSamples);
 
         // --- Fin du Pipeline RVC ---
         
@@ -178,3 +254,274 @@ Java_com_rvc_patch_ipc_IPCManager_processAudioNative(
         return JNI_FALSE; // Retourne false pour forcer le Pass-Through en Java
     }
 }
+
+/**
+ * Réglages de voix du profil actif (pitchValue, naturalityValue de Profile.kt), plus la
+ * transposition fine (cents) et la gamme de quantification de la F0 (scale : 0 = libre,
+ * 1 = chromatique, 2 = majeure, 3 = mineure ; scaleRoot : 0 = do ... 11 = si).
+ * Appelé depuis le thread UI : publication sans verrou, prise en compte au bloc suivant.
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_rvc_patch_ipc_IPCManager_setVoiceParameters(
+    JNIEnv *env,
+    jobject /* this */,
+    jint pitchSemitones,
+    jint pitchCents,
+    jint naturality,
+    jint scale,
+    jint scaleRoot) {
+
+    rvc::VoiceParameters params;
+    params.pitchSemitones = std::clamp(static_cast<float>(pitchSemitones) + static_cast<float>(pitchCents) / 100.0f,
+                                       -12.0f, 12.0f);
+    params.indexRate = static_cast<float>(std::clamp(static_cast<int>(naturality), 0, 100)) / 100.0f;
+    params.scale = static_cast<rvc::PitchScale>(std::clamp(static_cast<int>(scale), 0, 3));
+    params.scaleRoot = std::clamp(static_cast<int>(scaleRoot), 0, 11);
+
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    currentVoice = params;
+    if (rvc::CaptureSession *session = captureSession.load()) {
+        session->publishVoice(params);
+    }
+}
+
+/**
+ * Application d'un preset binaire (profil d'une application, voir PresetWriter.kt) reçu
+ * par IPC : le fichier est privé à l'application RVC, ce processus (autre UID) ne peut pas
+ * l'ouvrir. Validation des sommes de contrôle, puis réglages de voix et chaînes d'effets.
+ * Même topologie que les chaînes courantes : quelques µs, sans allocation côté audio.
+ * Application exclue (kExcluded) : audio rendu tel quel jusqu'au preset suivant.
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_rvc_patch_ipc_IPCManager_loadPreset(
+    JNIEnv *env,
+    jobject /* this */,
+    jbyteArray data) {
+
+    if (!isEngineInitialized) return JNI_FALSE;
+
+    const jsize size = env->GetArrayLength(data);
+    jbyte *bytes = env->GetByteArrayElements(data, nullptr);
+    std::string error;
+    std::unique_ptr<rvc::PresetFile> preset = rvc::PresetFile::fromBytes(bytes, static_cast<size_t>(size), &error);
+    env->ReleaseByteArrayElements(data, bytes, JNI_ABORT);
+    if (!preset) {
+        LOGE("Preset refusé : %s", error.c_str());
+        return JNI_FALSE;
+    }
+
+    if (preset->isExcluded()) {
+        processingExcluded.store(true, std::memory_order_relaxed);
+        LOGI("Application exclue du traitement : audio non modifié.");
+        return JNI_TRUE;
+    }
+    if (!fxGraph->applyPreset(*preset, &error)) {
+        LOGE("Preset non appliqué : %s", error.c_str());
+        return JNI_FALSE;
+    }
+    processingExcluded.store(false, std::memory_order_relaxed);
+
+    // Le preset porte la voix du profil ; la gamme de quantification reste celle en cours.
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    currentVoice.pitchSemitones = std::clamp(preset->header().pitchSemitones, -12.0f, 12.0f);
+    currentVoice.indexRate = std::clamp(preset->header().indexRate, 0.0f, 1.0f);
+    captureSession.load()->publishVoice(currentVoice);
+    return JNI_TRUE;
+}
+
+/**
+ * Latence ajoutée par le traitement natif, en échantillons à la fréquence de la session :
+ * chaînes pré + post-traitement, conversions vers le modèle et pipeline d'inférence en
+ * mode RVC, chaîne Low Power sinon. Permet à l'hôte de recaler la piste audio
+ * (synchronisation A/V des applications d'enregistrement).
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_com_rvc_patch_ipc_IPCManager_getLatencySamples(
+    JNIEnv *env,
+    jobject /* this */) {
+
+    if (!isEngineInitialized || processingExcluded.load(std::memory_order_relaxed)) return 0;
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    const rvc::CaptureSession *session = captureSession.load();
+    // Retard algorithmique du modèle et blocs de retard du pipeline d'inférence, comptés à la
+    // fréquence du modèle.
+    const size_t inferenceLatency = (ieManager->modelLatencySamples() + ieManager->pipelineLatencySamples()) *
+                                    session->sampleRate() / RVC_SAMPLE_RATE;
+    const size_t latency = isRVCTransforming
+        ? fxGraph->latencySamples(rvc::FXChain::Preprocessing) + fxGraph->latencySamples(rvc::FXChain::PostProcessing) +
+              session->modelLatencySamples() + inferenceLatency
+        : fxGraph->latencySamples(rvc::FXChain::LowPower);
+    return static_cast<jint>(latency);
+}
+
+/**
+ * Réglage d'un paramètre d'un nœud du graphe d'effets (EQ, réverbération, gate...).
+ * chain : 0 = pré-traitement, 1 = post-traitement, 2 = Low Power (voir FXChain).
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_rvc_patch_ipc_IPCManager_setNodeParameter(
+    JNIEnv *env,
+    jobject /* this */,
+    jint chain,
+    jstring nodeId,
+    jstring name,
+    jfloat value) {
+
+    if (!isEngineInitialized || chain < 0 || chain >= static_cast<jint>(rvc::FXGraph::kNumChains)) {
+        return JNI_FALSE;
+    }
+
+    const char *nodeChars = env->GetStringUTFChars(nodeId, nullptr);
+    const char *nameChars = env->GetStringUTFChars(name, nullptr);
+    const bool applied = fxGraph->setParameter(static_cast<rvc::FXChain>(chain), nodeChars, nameChars, value);
+    env->ReleaseStringUTFChars(nodeId, nodeChars);
+    env->ReleaseStringUTFChars(name, nameChars);
+    return applied ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Plusieurs paramètres d'un même nœud publiés ensemble (une seule publication
+ * NodeParameters) : le thread audio ne voit jamais un mélange d'anciennes et de nouvelles
+ * valeurs (ex: bande d'égaliseur à la nouvelle fréquence avec l'ancien gain). Rien n'est
+ * publié si un nom est inconnu ou si les tableaux n'ont pas la même taille.
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_rvc_patch_ipc_IPCManager_setNodeParameters(
+    JNIEnv *env,
+    jobject /* this */,
+    jint chain,
+    jstring nodeId,
+    jobjectArray names,
+    jfloatArray values) {
+
+    if (!isEngineInitialized || chain < 0 || chain >= static_cast<jint>(rvc::FXGraph::kNumChains) ||
+        names == nullptr || values == nullptr) {
+        return JNI_FALSE;
+    }
+    const jsize count = env->GetArrayLength(names);
+    if (count != env->GetArrayLength(values)) return JNI_FALSE;
+
+    std::vector<std::pair<std::string, float>> entries;
+    entries.reserve(static_cast<size_t>(count));
+    std::vector<jfloat> valueData(static_cast<size_t>(count));
+    env->GetFloatArrayRegion(values, 0, count, valueData.data());
+    for (jsize i = 0; i < count; ++i) {
+        jstring name = static_cast<jstring>(env->GetObjectArrayElement(names, i));
+        if (name == nullptr) return JNI_FALSE;
+        const char *nameChars = env->GetStringUTFChars(name, nullptr);
+        entries.emplace_back(nameChars, valueData[static_cast<size_t>(i)]);
+        env->ReleaseStringUTFChars(name, nameChars);
+        env->DeleteLocalRef(name);
+    }
+
+    const char *nodeChars = env->GetStringUTFChars(nodeId, nullptr);
+    const bool applied = fxGraph->setParameters(static_cast<rvc::FXChain>(chain), nodeChars, entries);
+    env->ReleaseStringUTFChars(nodeId, nodeChars);
+    return applied ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Contournement d'un nœud du graphe d'effets (fondu enchaîné, puis coût nul).
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_rvc_patch_ipc_IPCManager_setNodeBypass(
+    JNIEnv *env,
+    jobject /* this */,
+    jint chain,
+    jstring nodeId,
+    jboolean bypass) {
+
+    if (!isEngineInitialized || chain < 0 || chain >= static_cast<jint>(rvc::FXGraph::kNumChains)) {
+        return JNI_FALSE;
+    }
+
+    const char *nodeChars = env->GetStringUTFChars(nodeId, nullptr);
+    const bool applied = fxGraph->setBypass(static_cast<rvc::FXChain>(chain), nodeChars, bypass == JNI_TRUE);
+    env->ReleaseStringUTFChars(nodeId, nodeChars);
+    return applied ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Statistiques du saut de l'inférence par le VAD, pour le HUD de performance :
+ * [parole (0/1), taux de blocs sautés, blocs sautés, blocs traités, temps d'inférence évité (ms)].
+ */
+extern "C" JNIEXPORT jfloatArray JNICALL
+Java_com_rvc_patch_ipc_IPCManager_getVoiceActivityStats(
+    JNIEnv *env,
+    jobject /* this */) {
+
+    jfloatArray result = env->NewFloatArray(5);
+    if (!isEngineInitialized || result == nullptr) return result;
+
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    const rvc::VoiceActivityGate::Stats stats = captureSession.load()->voiceActivity().stats();
+    const jfloat values[5] = {
+        stats.speech ? 1.0f : 0.0f,
+        stats.skipRatio,
+        static_cast<jfloat>(stats.skippedBlocks),
+        static_cast<jfloat>(stats.blocks),
+        stats.savedInferenceMs,
+    };
+    env->SetFloatArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+/**
+ * Hors parole : bruit de confort au niveau du bruit de fond (défaut) ou silence.
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_com_rvc_patch_ipc_IPCManager_setComfortNoise(
+    JNIEnv *env,
+    jobject /* this */,
+    jboolean enabled) {
+
+    if (!isEngineInitialized) return;
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    comfortNoiseEnabled.store(enabled == JNI_TRUE);
+    captureSession.load()->voiceActivity().setComfortNoise(enabled == JNI_TRUE);
+}
+
+/**
+ * Nouvelle session de capture (AudioRecord de l'application hookée) : fréquence et nombre de
+ * canaux réels. Le graphe d'effets est recompilé à cette fréquence (réglages conservés) et
+ * le modèle reste à la sienne, avec conversions à sa frontière. Appelé hors du thread audio
+ * de préférence (startRecording) ; sans effet si le format n'a pas changé.
+ */
+extern "C" JNIEXPORT jboolean JNICALL
+Java_com_rvc_patch_ipc_IPCManager_configureSession(
+    JNIEnv *env,
+    jobject /* this */,
+    jint sampleRate,
+    jint channelCount) {
+
+    if (!isEngineInitialized) return JNI_FALSE;
+    if (!rvc::CaptureSession::isValidFormat(sampleRate, channelCount)) {
+        LOGE("Format de capture refusé : %d Hz, %d canal(aux).", sampleRate, channelCount);
+        return JNI_FALSE;
+    }
+
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    const rvc::CaptureSession *current = captureSession.load();
+    if (current->sampleRate() == sampleRate && current->channelCount() == channelCount) {
+        return JNI_TRUE;
+    }
+
+    try {
+        auto session = std::make_unique<rvc::CaptureSession>(
+            sampleRate, channelCount, RVC_SAMPLE_RATE, sharedBufferSize / (sizeof(float) * channelCount));
+        session->voiceActivity().setComfortNoise(comfortNoiseEnabled.load());
+        session->publishVoice(currentVoice);
+        // Un bloc peut encore passer entre les deux échanges : graphe à la nouvelle fréquence,
+        // ancienne session (une seule fois, au démarrage de la capture).
+        if (!fxGraph->setSampleRate(sampleRate)) return JNI_FALSE;
+
+        std::unique_ptr<rvc::CaptureSession> previous(captureSession.exchange(session.release()));
+        while (activeBlocks.load() != 0) {
+            std::this_thread::yield();
+        }
+        return JNI_TRUE;
+    } catch (const std::exception &e) {
+        LOGE("Session de capture non créée : %s", e.what());
+        return JNI_FALSE;
+    }
+}
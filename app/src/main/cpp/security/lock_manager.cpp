@@ -1,5 +1,6 @@
 #include "security/lock_manager.h"
 #include <android/log.h>
+#include <cstring>
 #include <pthread.h>
 #include <sched.h>
 #include <sys/mman.h>
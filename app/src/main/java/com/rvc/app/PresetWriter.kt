@@ -0,0 +1,151 @@
+package com.rvc.app.util
+
+import com.google.gson.Gson
+import com.google.gson.reflect.TypeToken
+import com.rvc.app.data.Profile
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.zip.CRC32
+
+/**
+ * Écrit les profils au format de preset binaire "RVCP" lu par le moteur natif (PresetFile) :
+ * le moteur projette le fichier en mémoire et l'applique sans analyse JSON.
+ *
+ * Disposition (version 1, petit-boutiste, décalages absolus alignés sur 4 octets) :
+ * en-tête de 56 octets, enregistrements de chaînes (24), de nœuds (20), de paramètres (8),
+ * d'arêtes (8), puis table des chaînes de caractères UTF-8 terminées par 0. Toute
+ * modification de cette disposition impose d'incrémenter VERSION des deux côtés.
+ */
+object PresetWriter {
+
+    private const val MAGIC = 0x50435652 // "RVCP"
+    private const val VERSION: Short = 1
+    private const val HEADER_SIZE = 56
+    private const val CHAIN_RECORD_SIZE = 24
+    private const val NODE_RECORD_SIZE = 20
+    private const val PARAM_RECORD_SIZE = 8
+    private const val EDGE_RECORD_SIZE = 8
+    private const val NO_STRING = -1 // 0xFFFFFFFF
+    private const val FLAG_EXCLUDED = 1
+    private const val NODE_FLAG_BYPASSED = 1
+
+    private val gson = Gson()
+
+    /**
+     * Convertisseur depuis le JSON actuel des profils (Map package -> Profile de ProfileManager).
+     */
+    fun convertProfilesJson(json: String): Map<String, ByteArray> {
+        val type = object : TypeToken<Map<String, Profile>>() {}.type
+        val profiles: Map<String, Profile> = gson.fromJson(json, type) ?: emptyMap()
+        return profiles.mapValues { (_, profile) -> encode(profile) }
+    }
+
+    /**
+     * Encode un profil : réglages de voix, chemin du modèle et chaînes d'effets éventuelles.
+     */
+    fun encode(profile: Profile): ByteArray {
+        val chains = profile.effects.orEmpty()
+
+        // Table des chaînes : "" en premier (la table n'est jamais vide), sans doublons.
+        val strings = LinkedHashMap<String, Int>()
+        var stringsSize = 0
+        fun intern(value: String): Int = strings.getOrPut(value) {
+            val offset = stringsSize
+            stringsSize += value.toByteArray(Charsets.UTF_8).size + 1
+            offset
+        }
+        intern("")
+        val modelPath = intern(profile.modelInfo.path)
+        for (chain in chains) {
+            for (node in chain.nodes) {
+                intern(node.id)
+                intern(node.type)
+                node.parameters.orEmpty().keys.forEach { intern(it) }
+            }
+            for (edge in chain.edges) {
+                intern(edge.from)
+                intern(edge.to)
+            }
+        }
+
+        val numNodes = chains.sumOf { it.nodes.size }
+        val numParams = chains.sumOf { chain -> chain.nodes.sumOf { it.parameters.orEmpty().size } }
+        val numEdges = chains.sumOf { it.edges.size }
+        val chainsOffset = HEADER_SIZE
+        val nodesOffset = chainsOffset + chains.size * CHAIN_RECORD_SIZE
+        val paramsOffset = nodesOffset + numNodes * NODE_RECORD_SIZE
+        val edgesOffset = paramsOffset + numParams * PARAM_RECORD_SIZE
+        val stringsOffset = edgesOffset + numEdges * EDGE_RECORD_SIZE
+        val fileSize = stringsOffset + stringsSize
+
+        val buffer = ByteBuffer.allocate(fileSize).order(ByteOrder.LITTLE_ENDIAN)
+
+        // En-tête (sommes de contrôle complétées à la fin)
+        buffer.putInt(MAGIC)
+        buffer.putShort(VERSION)
+        buffer.putShort(HEADER_SIZE.toShort())
+        buffer.putInt(fileSize)
+        buffer.putInt(0) // headerCrc
+        buffer.putInt(0) // payloadCrc
+        buffer.putFloat(profile.pitchValue.coerceIn(-12, 12).toFloat())
+        buffer.putFloat(profile.naturalityValue.coerceIn(0, 100) / 100.0f)
+        buffer.putInt(if (profile.isExcluded) FLAG_EXCLUDED else 0)
+        buffer.putInt(if (profile.modelInfo.path.isEmpty()) NO_STRING else modelPath)
+        buffer.putInt(chains.size)
+        buffer.putInt(chainsOffset)
+        buffer.putInt(stringsOffset)
+        buffer.putInt(stringsSize)
+        buffer.putInt(0) // Réservé
+
+        // Chaînes, puis nœuds, paramètres et arêtes dans le même ordre
+        var nextNode = nodesOffset
+        var nextEdge = edgesOffset
+        for (chain in chains) {
+            buffer.putInt(chain.chain)
+            buffer.putInt(chain.nodes.size)
+            buffer.putInt(nextNode)
+            buffer.putInt(chain.edges.size)
+            buffer.putInt(nextEdge)
+            buffer.putInt(0)
+            nextNode += chain.nodes.size * NODE_RECORD_SIZE
+            nextEdge += chain.edges.size * EDGE_RECORD_SIZE
+        }
+        var nextParam = paramsOffset
+        for (chain in chains) {
+            for (node in chain.nodes) {
+                val parameters = node.parameters.orEmpty()
+                buffer.putInt(strings.getValue(node.id))
+                buffer.putInt(strings.getValue(node.type))
+                buffer.putInt(if (node.bypassed) NODE_FLAG_BYPASSED else 0)
+                buffer.putInt(parameters.size)
+                buffer.putInt(nextParam)
+                nextParam += parameters.size * PARAM_RECORD_SIZE
+            }
+        }
+        for (chain in chains) {
+            for (node in chain.nodes) {
+                for ((name, value) in node.parameters.orEmpty()) {
+                    buffer.putInt(strings.getValue(name))
+                    buffer.putFloat(value)
+                }
+            }
+        }
+        for (chain in chains) {
+            for (edge in chain.edges) {
+                buffer.putInt(strings.getValue(edge.from))
+                buffer.putInt(strings.getValue(edge.to))
+            }
+        }
+        for (value in strings.keys) {
+            buffer.put(value.toByteArray(Charsets.UTF_8))
+            buffer.put(0)
+        }
+
+        val bytes = buffer.array()
+        val payloadCrc = CRC32().apply { update(bytes, HEADER_SIZE, fileSize - HEADER_SIZE) }.value.toInt()
+        buffer.putInt(16, payloadCrc)
+        val headerCrc = CRC32().apply { update(bytes, 0, HEADER_SIZE) }.value.toInt()
+        buffer.putInt(12, headerCrc)
+        return bytes
+    }
+}
@@ -4,15 +4,19 @@ import android.content.Context
 import com.google.gson.Gson
 import com.google.gson.reflect.TypeToken
 import com.rvc.app.data.Profile
+import java.io.File
 
 /**
  * Gère la sauvegarde et le chargement des profils RVC pour des applications spécifiques.
- * Utilise SharedPreferences pour la persistance locale des données.
+ * Utilise SharedPreferences pour la persistance locale des données, et tient à jour pour
+ * chaque profil un preset binaire (PresetWriter) que le moteur natif projette sans analyse.
  */
 object ProfileManager {
 
     private const val PREFS_NAME = "RVC_Profiles"
     private const val KEY_PROFILES_MAP = "profiles_map"
+    private const val PRESETS_DIR = "presets"
+    private const val PRESET_EXTENSION = ".rvcp"
 
     private val gson = Gson()
 
@@ -50,6 +54,7 @@ object ProfileManager {
         val profilesMap = loadAllProfiles(context)
         profilesMap[packageName] = profile
         saveAllProfiles(context, profilesMap)
+        writePreset(context, packageName, PresetWriter.encode(profile))
         // Note: Un mécanisme de notification (Broadcast) serait idéal ici pour informer le Hook
         // de la mise à jour des règles d'exclusion/injection.
     }
@@ -72,6 +77,7 @@ object ProfileManager {
         if (profilesMap.remove(packageName) != null) {
             saveAllProfiles(context, profilesMap)
         }
+        getPresetFile(context, packageName).delete()
     }
 
     /**
@@ -81,6 +87,51 @@ object ProfileManager {
         return loadAllProfiles(context).keys
     }
     
+    // --- Presets binaires (V16.0) ---
+
+    /**
+     * Preset binaire d'un package, qu'il existe ou non. Stockage privé de l'application : le
+     * processus hooké (autre UID) ne peut pas l'ouvrir, on lui transmet le contenu (readPreset).
+     */
+    fun getPresetFile(context: Context, packageName: String): File {
+        return File(File(context.filesDir, PRESETS_DIR), packageName + PRESET_EXTENSION)
+    }
+
+    /**
+     * Contenu du preset d'un package, à transmettre au moteur par IPC (IPCManager.applyPreset) ;
+     * null si le package n'a pas de profil.
+     */
+    fun readPreset(context: Context, packageName: String): ByteArray? {
+        val file = getPresetFile(context, packageName)
+        return if (file.exists()) file.readBytes() else null
+    }
+
+    /**
+     * Migration : convertit tous les profils JSON existants en presets binaires.
+     * @return Le nombre de presets écrits.
+     */
+    fun convertProfilesToPresets(context: Context): Int {
+        val prefs = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
+        val json = prefs.getString(KEY_PROFILES_MAP, null) ?: return 0
+        val presets = PresetWriter.convertProfilesJson(json)
+        presets.forEach { (packageName, bytes) -> writePreset(context, packageName, bytes) }
+        return presets.size
+    }
+
+    /**
+     * Écriture atomique (fichier temporaire puis renommage) : un moteur qui a déjà projeté
+     * l'ancien preset garde une copie cohérente, le suivant lit le nouveau en entier.
+     */
+    private fun writePreset(context: Context, packageName: String, bytes: ByteArray) {
+        val target = getPresetFile(context, packageName)
+        target.parentFile?.mkdirs()
+        val temp = File(target.parentFile, target.name + ".tmp")
+        temp.writeBytes(bytes)
+        if (!temp.renameTo(target)) {
+            temp.delete()
+        }
+    }
+
     // --- Logique pour la Liste d'Exclusion (V10.0) ---
 
     /**
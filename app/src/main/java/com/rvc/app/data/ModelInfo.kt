@@ -11,5 +11,26 @@ data class Profile(
     val modelInfo: ModelInfo,
     val pitchValue: Int,        // -12 à 12
     val naturalityValue: Int,   // 0 à 100
-    val isExcluded: Boolean = false // Si l'app est sur la liste noire (pas de RVC)
+    val isExcluded: Boolean = false, // Si l'app est sur la liste noire (pas de RVC)
+    val effects: List<EffectChainPreset>? = null // Chaînes d'effets du profil (null : chaînes courantes)
+)
+
+// --- app/src/main/java/com/rvc/app/data/EffectPreset.kt ---
+// Graphe d'une chaîne d'effets native (chain : 0 = pré-traitement, 1 = post-traitement, 2 = Low Power).
+data class EffectChainPreset(
+    val chain: Int,
+    val nodes: List<EffectNodePreset>,
+    val edges: List<EffectEdgePreset>
+)
+
+data class EffectNodePreset(
+    val id: String,
+    val type: String,                        // Type du registre natif (ex: "parametric_eq")
+    val parameters: Map<String, Float>? = null,
+    val bypassed: Boolean = false
+)
+
+data class EffectEdgePreset(
+    val from: String, // "input", "output" ou identifiant de nœud
+    val to: String
 )
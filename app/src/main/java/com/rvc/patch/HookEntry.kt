@@ -38,9 +38,30 @@ class HookEntry : IXposedHookLoadPackage {
 
         // 2. Tenter d'intercepter la méthode de lecture (read) d'AudioRecord.
         // C'est le point où les données du microphone sont capturées avant d'atteindre l'application.
+        hookAudioRecordStart()
         hookAudioRecordRead(lpparam.classLoader)
     }
 
+    /**
+     * Intercepte AudioRecord.startRecording() : le moteur se configure au format réel de la
+     * capture (fréquence, canaux) avant la première lecture, hors de la boucle temps réel.
+     */
+    private fun hookAudioRecordStart() {
+        try {
+            XposedBridge.hookMethod(
+                AudioRecord::class.java.getMethod("startRecording"),
+                object : XC_MethodHook() {
+                    override fun beforeHookedMethod(param: MethodHookParam) {
+                        val record = param.thisObject as AudioRecord
+                        ipcManager.beginSession(record.sampleRate, record.channelCount)
+                    }
+                })
+            Log.i(TAG, "✅ Hook AudioRecord.startRecording() réussi.")
+        } catch (e: Exception) {
+            Log.e(TAG, "❌ Échec du Hook AudioRecord.startRecording: " + e.message)
+        }
+    }
+
     /**
      * Intercepte la méthode AudioRecord.read(ByteBuffer dest, int size).
      * C'est la méthode de haute performance utilisée par Oboe/AAudio.
@@ -74,7 +95,10 @@ class HookEntry : IXposedHookLoadPackage {
                         // 3. Envoyer les données brutes au Moteur NDK (via Ashmem)
                         // Le code NDK va lire le buffer, le traiter (RVC, Pitch, EQ, etc.) et écrire
                         // le résultat modifié directement dans la même zone Ashmem.
-                        val processed = ipcManager.processAudioBuffer(audioBuffer, bytesRead)
+                        val record = param.thisObject as AudioRecord
+                        val processed = ipcManager.processAudioBuffer(
+                            audioBuffer, bytesRead, record.sampleRate, record.channelCount
+                        )
                         
                         // Si le processus RVC est actif et a retourné un succès (true)
                         if (processed) {
@@ -34,6 +34,63 @@ class IPCManager {
     // Méthode JNI native pour traiter les données audio
     private external fun processAudioNative(bytesRead: Int): Boolean
 
+    // Format de l'AudioRecord hooké (fréquence réelle, canaux entrelacés)
+    private external fun configureSession(sampleRate: Int, channelCount: Int): Boolean
+
+    // Méthodes JNI natives pour les réglages du profil : publiées sans verrou, le thread
+    // audio les récupère au bloc suivant. Les paramètres d'effets sont lissés côté natif ;
+    // la transposition s'applique telle quelle au contour de F0 du bloc suivant.
+    private external fun setVoiceParameters(
+        pitchSemitones: Int,
+        pitchCents: Int,
+        naturality: Int,
+        scale: Int,
+        scaleRoot: Int
+    )
+    private external fun setNodeParameter(chain: Int, nodeId: String, name: String, value: Float): Boolean
+    private external fun setNodeParameters(chain: Int, nodeId: String, names: Array<String>, values: FloatArray): Boolean
+    private external fun setNodeBypass(chain: Int, nodeId: String, bypass: Boolean): Boolean
+    private external fun loadPreset(data: ByteArray): Boolean
+
+    // Latence du traitement natif (échantillons à la fréquence de la session)
+    private external fun getLatencySamples(): Int
+
+    // Saut de l'inférence hors parole (VAD) : statistiques et remplissage des silences
+    private external fun getVoiceActivityStats(): FloatArray
+    private external fun setComfortNoise(enabled: Boolean)
+
+    /**
+     * Statistiques du VAD pour le HUD : blocs où le modèle n'a pas tourné (hors parole ou
+     * Noise Gate fermé) et temps d'inférence ainsi évité.
+     */
+    data class VoiceActivityStats(
+        val speechActive: Boolean,
+        val skipRatio: Float,
+        val skippedBlocks: Int,
+        val totalBlocks: Int,
+        val savedInferenceMs: Float
+    )
+
+    companion object {
+        // Chaînes du graphe d'effets natif (FXChain)
+        const val CHAIN_PREPROCESSING = 0
+        const val CHAIN_POSTPROCESSING = 1
+        const val CHAIN_LOW_POWER = 2
+
+        // Fréquence native du modèle (RVC_SAMPLE_RATE) et format de la session par défaut
+        const val NATIVE_SAMPLE_RATE = 48000
+
+        // Quantification de la F0 transposée (PitchScale natif)
+        const val SCALE_OFF = 0
+        const val SCALE_CHROMATIC = 1
+        const val SCALE_MAJOR = 2
+        const val SCALE_MINOR = 3
+    }
+
+    // Format de la session de capture courante (configureSession)
+    @Volatile private var sessionSampleRate = NATIVE_SAMPLE_RATE
+    @Volatile private var sessionChannelCount = 1
+
     // Déclaration du bloc natif pour charger les bibliothèques NDK (libmain.so)
     init {
         try {
@@ -74,16 +131,53 @@ class IPCManager {
         }
     }
 
+    /**
+     * Déclare le format de l'AudioRecord de l'application (appelé au startRecording, et à
+     * chaque lecture par sécurité) : le moteur traite à cette fréquence, sans conversion
+     * hors de la frontière du modèle. Sans effet si le format n'a pas changé.
+     */
+    @Synchronized
+    fun beginSession(sampleRate: Int, channelCount: Int): Boolean {
+        if (sampleRate == sessionSampleRate && channelCount == sessionChannelCount) return true
+        return try {
+            val configured = configureSession(sampleRate, channelCount)
+            if (configured) {
+                sessionSampleRate = sampleRate
+                sessionChannelCount = channelCount
+                Log.i(TAG, "Session de capture : $sampleRate Hz, $channelCount canal(aux).")
+            } else {
+                Log.e(TAG, "Format de capture refusé : $sampleRate Hz, $channelCount canal(aux).")
+            }
+            configured
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Session de capture non transmise: ${e.message}")
+            false
+        }
+    }
+
     /**
      * Traite le buffer audio en utilisant la mémoire partagée.
      * C'est la fonction appelée par le HookEntry dans le processus système.
      *
      * @param sourceBuffer Le ByteBuffer provenant d'AudioRecord (micro).
      * @param bytesRead Le nombre d'octets lus.
+     * @param sampleRate Fréquence de l'AudioRecord.
+     * @param channelCount Nombre de canaux (entrelacés) de l'AudioRecord.
      * @return true si le traitement RVC a eu lieu, false sinon (pass-through).
      */
-    fun processAudioBuffer(sourceBuffer: ByteBuffer, bytesRead: Int): Boolean {
+    fun processAudioBuffer(
+        sourceBuffer: ByteBuffer,
+        bytesRead: Int,
+        sampleRate: Int = sessionSampleRate,
+        channelCount: Int = sessionChannelCount
+    ): Boolean {
         if (sharedByteBuffer == null) return false
+        // Format inconnu du moteur : pass-through plutôt qu'un traitement à la mauvaise fréquence.
+        if ((sampleRate != sessionSampleRate || channelCount != sessionChannelCount) &&
+            !beginSession(sampleRate, channelCount)
+        ) {
+            return false
+        }
 
         try {
             // 1. Copier le buffer AudioRecord dans le buffer Ashmem
@@ -111,4 +205,141 @@ class IPCManager {
             return false // Force le pass-through en cas d'erreur
         }
     }
+
+    /**
+     * Transmet les réglages de voix d'un profil (pitchValue -12..12, naturalityValue 0..100).
+     * La F0 est transposée côté natif avant la synthèse, sans recharger le modèle.
+     *
+     * @param pitchCents Transposition fine (-100..100 cents) ajoutée à pitchValue.
+     * @param scale Quantification de la F0 transposée (SCALE_*), SCALE_OFF par défaut.
+     * @param scaleRoot Tonique de la gamme (0 = do ... 11 = si).
+     */
+    fun applyProfile(
+        pitchValue: Int,
+        naturalityValue: Int,
+        pitchCents: Int = 0,
+        scale: Int = SCALE_OFF,
+        scaleRoot: Int = 0
+    ) {
+        try {
+            setVoiceParameters(pitchValue, pitchCents, naturalityValue, scale, scaleRoot)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Réglages de voix non transmis: ${e.message}")
+        }
+    }
+
+    /**
+     * Règle un paramètre d'un nœud du graphe d'effets (ex: "reverb" / "wet").
+     * @return false si le moteur n'est pas prêt ou si le nœud/paramètre est inconnu.
+     */
+    fun setEffectParameter(chain: Int, nodeId: String, name: String, value: Float): Boolean {
+        return try {
+            setNodeParameter(chain, nodeId, name, value)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Paramètre '$nodeId.$name' non transmis: ${e.message}")
+            false
+        }
+    }
+
+    /**
+     * Règle plusieurs paramètres d'un même nœud en une seule publication : le thread audio
+     * les applique tous au même bloc. Rien n'est appliqué si un nom est inconnu.
+     */
+    fun setEffectParameters(chain: Int, nodeId: String, values: Map<String, Float>): Boolean {
+        return try {
+            setNodeParameters(chain, nodeId, values.keys.toTypedArray(), values.values.toFloatArray())
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Paramètres de '$nodeId' non transmis: ${e.message}")
+            false
+        }
+    }
+
+    /**
+     * Applique le preset binaire d'un profil (ProfileManager.readPreset, transmis par IPC : ce
+     * processus ne peut pas lire les fichiers privés de l'application) : réglages de voix et
+     * chaînes d'effets, sans analyse JSON côté natif. Profil exclu : audio rendu tel quel.
+     * @return false si le preset est corrompu ou refusé (les réglages courants sont conservés).
+     */
+    fun applyPreset(data: ByteArray): Boolean {
+        return try {
+            loadPreset(data)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Preset non transmis: ${e.message}")
+            false
+        }
+    }
+
+    /**
+     * Active ou contourne un effet (ex: "reverb", "deesser") sans clic : fondu enchaîné
+     * côté natif, puis l'effet contourné ne consomme plus de CPU.
+     */
+    fun setEffectBypass(chain: Int, nodeId: String, bypassed: Boolean): Boolean {
+        return try {
+            setNodeBypass(chain, nodeId, bypassed)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Contournement de '$nodeId' non transmis: ${e.message}")
+            false
+        }
+    }
+
+    /**
+     * Règle une bande de l'égaliseur utilisateur (type : 0 = cloche, 1 = plateau grave,
+     * 2 = plateau aigu, 3 = passe-bas, 4 = passe-haut, 5 = coupe-bande). Les cinq valeurs
+     * sont publiées ensemble : jamais une bande à la nouvelle fréquence avec l'ancien gain.
+     */
+    fun setEqualizerBand(index: Int, type: Int, frequencyHz: Float, gainDb: Float, q: Float, enabled: Boolean): Boolean {
+        val prefix = "band${index}_"
+        return setEffectParameters(CHAIN_POSTPROCESSING, "eq", linkedMapOf(
+            prefix + "type" to type.toFloat(),
+            prefix + "freq" to frequencyHz,
+            prefix + "gain" to gainDb,
+            prefix + "q" to q,
+            prefix + "enabled" to if (enabled) 1.0f else 0.0f
+        ))
+    }
+
+    /**
+     * Latence ajoutée par le traitement (ms), à déclarer à l'application hôte pour garder
+     * la synchronisation audio/vidéo. 0 si le moteur n'est pas prêt.
+     */
+    fun getProcessingLatencyMs(): Float {
+        return try {
+            getLatencySamples() * 1000.0f / sessionSampleRate
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Latence native indisponible: ${e.message}")
+            0.0f
+        }
+    }
+
+    /**
+     * Hors parole, le moteur remplace la sortie du modèle par un bruit de confort au niveau
+     * du bruit de fond (défaut), ou par du silence.
+     */
+    fun setComfortNoiseEnabled(enabled: Boolean) {
+        try {
+            setComfortNoise(enabled)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Réglage du bruit de confort non transmis: ${e.message}")
+        }
+    }
+
+    /**
+     * Dernière décision du VAD et taux de saut de l'inférence. null si le moteur n'est pas prêt.
+     */
+    fun getVoiceActivityStatistics(): VoiceActivityStats? {
+        return try {
+            val values = getVoiceActivityStats()
+            if (values.size < 5) return null
+            VoiceActivityStats(
+                speechActive = values[0] > 0.5f,
+                skipRatio = values[1],
+                skippedBlocks = values[2].toInt(),
+                totalBlocks = values[3].toInt(),
+                savedInferenceMs = values[4]
+            )
+        } catch (e: UnsatisfiedLinkError) {
+            Log.e(TAG, "Statistiques du VAD indisponibles: ${e.message}")
+            null
+        }
+    }
 }
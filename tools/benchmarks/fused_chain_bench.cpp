@@ -0,0 +1,151 @@
+/**
+ * Benchmark des chaînes fusionnées (dsp/elementwise.h, V16.0) sur la machine hôte : coût
+ * par échantillon de fused::run() contre fused::runUnfused() (un passage sur le buffer par
+ * étage), de blocs de 10 ms à des buffers qui ne tiennent plus dans les caches, pour :
+ *   - gain -> suppression du continu -> saturation douce -> écrêtage (étages élémentaires) ;
+ *   - gate_limiter (GateLimiterNode : gate -> suppression du continu -> écrêtage).
+ * Les sorties des deux chemins sont comparées au bit près à chaque taille.
+ *
+ * Compilation (depuis la racine du dépôt), avec les options de fused_nodes.cpp dans
+ * CMakeLists.txt pour les unités qui instancient les chaînes :
+ *   D=app/src/main/cpp
+ *   c++ -std=c++20 -O3 -ffast-math -ffp-contract=off -fno-associative-math -I$D \
+ *       -c tools/benchmarks/fused_chain_bench.cpp $D/dsp/fused_nodes.cpp
+ *   c++ -std=c++20 -O3 -ffast-math -I$D -c $D/dsp/noise_gate.cpp
+ *   c++ fused_chain_bench.o fused_nodes.o noise_gate.o -o fused_chain_bench
+ *
+ * Utilisation :
+ *   fused_chain_bench [options]
+ *     --samples N   Échantillons traités par mesure et par taille (défaut : 2^24)
+ *     --repeat N    Mesures par configuration, la meilleure est gardée (défaut : 5)
+ */
+#include "dsp/elementwise.h"
+#include "dsp/fused_nodes.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using rvc::GateLimiterNode;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "fused_chain_bench: %s\n", message.c_str());
+    std::exit(1);
+}
+
+// Voix en rafales sur un bruit de fond et un offset continu (le gate s'ouvre et se ferme).
+std::vector<float> testSignal(size_t numSamples) {
+    std::vector<float> signal(numSamples);
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 0.0004f);
+    for (size_t i = 0; i < numSamples; ++i) {
+        const float amplitude = (i / 24000) % 3 == 2 ? 0.0f : 0.8f;
+        const float t = static_cast<float>(i % kSampleRate) / kSampleRate;
+        signal[i] = amplitude * std::sin(2.0f * static_cast<float>(M_PI) * 180.0f * t) + noise(rng) + 0.01f;
+    }
+    return signal;
+}
+
+// Chaîne d'étages élémentaires, fusionnée ou non.
+class ElementwiseChain {
+public:
+    ElementwiseChain() : gain_(1.6f), dcBlock_(kSampleRate), softClip_(0.9f), clamp_(0.99f) {}
+    void process(float* buffer, size_t n) { rvc::fused::run(buffer, n, gain_, dcBlock_, softClip_, clamp_); }
+    void processUnfused(float* buffer, size_t n) {
+        rvc::fused::runUnfused(buffer, n, gain_, dcBlock_, softClip_, clamp_);
+    }
+
+private:
+    rvc::fused::Gain gain_;
+    rvc::fused::DCBlock dcBlock_;
+    rvc::fused::SoftClip softClip_;
+    rvc::fused::Clamp clamp_;
+};
+
+using Process = std::function<void(float*, size_t)>;
+
+/**
+ * Meilleur temps (ns par échantillon) pour traiter totalSamples échantillons par blocs de
+ * blockSize, chaque bloc relu depuis l'entrée ; output reçoit le dernier passage.
+ */
+double measure(const Process& process, const std::vector<float>& input, size_t blockSize, size_t totalSamples,
+               int repeat, std::vector<float>& output) {
+    std::vector<float> buffer(blockSize);
+    double best = 1e30;
+    for (int r = 0; r < repeat; ++r) {
+        size_t position = 0;
+        double elapsed = 0.0;
+        for (size_t done = 0; done < totalSamples; done += blockSize) {
+            if (position + blockSize > input.size()) position = 0;
+            std::copy(input.begin() + position, input.begin() + position + blockSize, buffer.begin());
+            const auto start = std::chrono::steady_clock::now();
+            process(buffer.data(), blockSize);
+            elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if (r == repeat - 1) {
+                output.resize(std::max(output.size(), position + blockSize));
+                std::copy(buffer.begin(), buffer.end(), output.begin() + position);
+            }
+            position += blockSize;
+        }
+        best = std::min(best, elapsed / static_cast<double>(totalSamples));
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t totalSamples = size_t(1) << 24;
+    int repeat = 5;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) die("valeur manquante pour " + arg);
+            return argv[++i];
+        };
+        if (arg == "--samples") totalSamples = std::stoul(value());
+        else if (arg == "--repeat") repeat = std::stoi(value());
+        else die("option inconnue : " + arg);
+    }
+    if (totalSamples == 0 || repeat <= 0) die("valeurs strictement positives attendues");
+
+    const size_t blockSizes[] = {480, 4096, 65536, size_t(1) << 20, size_t(1) << 22};
+    const size_t largest = std::max(totalSamples, blockSizes[std::size(blockSizes) - 1]);
+    const std::vector<float> input = testSignal(largest);
+
+    std::printf("%zu échantillons par mesure, meilleure de %d\n", totalSamples, repeat);
+    std::printf("chaîne         bloc      fusionné ns/éch  étage par étage ns/éch  rapport\n");
+    for (const char* chain : {"élémentaire", "gate_limiter"}) {
+        const bool gate = std::strcmp(chain, "gate_limiter") == 0;
+        for (size_t blockSize : blockSizes) {
+            const size_t samples = std::max(totalSamples, blockSize);
+            ElementwiseChain fusedChain, unfusedChain;
+            GateLimiterNode fusedNode(kSampleRate), unfusedNode(kSampleRate);
+            const Process fused = gate ? Process([&](float* x, size_t n) { fusedNode.process(x, n); })
+                                       : Process([&](float* x, size_t n) { fusedChain.process(x, n); });
+            const Process unfused = gate ? Process([&](float* x, size_t n) { unfusedNode.processUnfused(x, n); })
+                                         : Process([&](float* x, size_t n) { unfusedChain.processUnfused(x, n); });
+            std::vector<float> fusedOut, unfusedOut;
+            const double fusedNs = measure(fused, input, blockSize, samples, repeat, fusedOut);
+            const double unfusedNs = measure(unfused, input, blockSize, samples, repeat, unfusedOut);
+            if (fusedOut.size() != unfusedOut.size() ||
+                std::memcmp(fusedOut.data(), unfusedOut.data(), fusedOut.size() * sizeof(float)) != 0) {
+                die(std::string(chain) + " : sorties fusionnée et étage par étage différentes (bloc " +
+                    std::to_string(blockSize) + ")");
+            }
+            std::printf("%-12s %8zu  %15.2f  %22.2f  %7.2f\n", chain, blockSize, fusedNs, unfusedNs,
+                        unfusedNs / fusedNs);
+        }
+    }
+    return 0;
+}
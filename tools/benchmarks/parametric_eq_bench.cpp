@@ -0,0 +1,164 @@
+/**
+ * Benchmark de l'égaliseur paramétrique (dsp/parametric_eq.h) sur la machine hôte : coût par
+ * bande et par seconde de signal à 48 kHz, pour 1 à 10 bandes actives, et écart maximal
+ * avec une cascade scalaire en double précision (mêmes coefficients RBJ). L'écart d'une
+ * cascade de biquads float scalaires (rvc::Biquad) est affiché en regard : c'est le plancher
+ * d'arrondi du float (pôles proches de z = 1 des bandes graves), pas une erreur de l'égaliseur.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   c++ -std=c++20 -O3 -ffast-math -Iapp/src/main/cpp tools/benchmarks/parametric_eq_bench.cpp \
+ *       app/src/main/cpp/dsp/parametric_eq.cpp app/src/main/cpp/dsp/biquad.cpp -o parametric_eq_bench
+ *
+ * Utilisation :
+ *   parametric_eq_bench [options]
+ *     --block N     Taille de bloc en échantillons (défaut : 480, 10 ms)
+ *     --seconds S   Durée de signal traitée par mesure (défaut : 20)
+ *     --repeat N    Mesures par configuration, la meilleure est gardée (défaut : 5)
+ */
+#include "dsp/biquad.h"
+#include "dsp/parametric_eq.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using rvc::ParametricEQ;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kSettleSamples = kSampleRate; // Lissage des coefficients terminé (20 ms)
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "parametric_eq_bench: %s\n", message.c_str());
+    std::exit(1);
+}
+
+// Bandes réparties en fréquence, types variés, comme un réglage utilisateur chargé.
+ParametricEQ::Band bandAt(size_t index) {
+    static const rvc::BiquadType kTypes[] = {rvc::BiquadType::LowShelf, rvc::BiquadType::Peaking,
+                                             rvc::BiquadType::Peaking, rvc::BiquadType::HighShelf};
+    ParametricEQ::Band band;
+    band.type = kTypes[index % 4];
+    band.frequencyHz = 60.0f * std::pow(1.8f, static_cast<float>(index));
+    band.gainDb = index % 2 ? -4.0f : 5.0f;
+    band.q = 0.7f + 0.3f * static_cast<float>(index % 3);
+    band.enabled = true;
+    return band;
+}
+
+// Cascade de référence (forme directe I, double précision).
+class ReferenceCascade {
+public:
+    explicit ReferenceCascade(size_t numBands) {
+        for (size_t b = 0; b < numBands; ++b) {
+            const ParametricEQ::Band band = bandAt(b);
+            const rvc::BiquadCoefficients c =
+                rvc::designBiquad(band.type, kSampleRate, band.frequencyHz, band.gainDb, band.q);
+            stages_.push_back({c.b0, c.b1, c.b2, c.a1, c.a2});
+        }
+    }
+
+    double process(double x) {
+        for (Stage& s : stages_) {
+            const double y = s.b0 * x + s.b1 * s.x1 + s.b2 * s.x2 - s.a1 * s.y1 - s.a2 * s.y2;
+            s.x2 = s.x1;
+            s.x1 = x;
+            s.y2 = s.y1;
+            s.y1 = y;
+            x = y;
+        }
+        return x;
+    }
+
+private:
+    struct Stage {
+        double b0, b1, b2, a1, a2;
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+    };
+    std::vector<Stage> stages_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t blockSize = 480;
+    double seconds = 20.0;
+    int repeat = 5;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) die("valeur manquante pour " + arg);
+            return argv[++i];
+        };
+        if (arg == "--block") blockSize = std::stoul(value());
+        else if (arg == "--seconds") seconds = std::stod(value());
+        else if (arg == "--repeat") repeat = std::stoi(value());
+        else die("option inconnue : " + arg);
+    }
+    if (blockSize == 0 || seconds <= 0.0 || repeat <= 0) die("valeurs strictement positives attendues");
+
+    const size_t numSamples = static_cast<size_t>(seconds * kSampleRate);
+    std::vector<float> noise(numSamples);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> uniform(-0.5f, 0.5f);
+    for (float& x : noise) x = uniform(rng);
+    std::vector<float> buffer(numSamples);
+
+    std::printf("bloc %zu, %.0f s à %d Hz\n", blockSize, seconds, kSampleRate);
+    std::printf("bandes  µs/s (total)  µs/bande/s  écart max  (biquads float)\n");
+    for (size_t numBands = 1; numBands <= ParametricEQ::kMaxBands; ++numBands) {
+        ParametricEQ eq(kSampleRate);
+        for (size_t b = 0; b < numBands; ++b) eq.setBand(b, bandAt(b));
+        std::vector<float> settle(kSettleSamples, 0.0f);
+        for (size_t i = 0; i < settle.size(); i += blockSize) {
+            eq.process(settle.data() + i, std::min(blockSize, settle.size() - i));
+        }
+
+        double best = 1e30;
+        for (int r = 0; r < repeat; ++r) {
+            std::copy(noise.begin(), noise.end(), buffer.begin());
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < numSamples; i += blockSize) {
+                eq.process(buffer.data() + i, std::min(blockSize, numSamples - i));
+            }
+            best = std::min(best, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        // Précision : nouvel égaliseur (coefficients rejoints), comparé à la référence.
+        ParametricEQ check(kSampleRate);
+        for (size_t b = 0; b < numBands; ++b) check.setBand(b, bandAt(b));
+        for (size_t i = 0; i < settle.size(); i += blockSize) {
+            check.process(settle.data() + i, std::min(blockSize, settle.size() - i));
+        }
+        ReferenceCascade reference(numBands);
+        const size_t checkSamples = std::min<size_t>(numSamples, kSampleRate);
+        std::copy(noise.begin(), noise.begin() + checkSamples, buffer.begin());
+        for (size_t i = 0; i < checkSamples; i += blockSize) {
+            check.process(buffer.data() + i, std::min(blockSize, checkSamples - i));
+        }
+        std::vector<rvc::Biquad> scalar(numBands);
+        for (size_t b = 0; b < numBands; ++b) {
+            const ParametricEQ::Band band = bandAt(b);
+            scalar[b].c = rvc::designBiquad(band.type, kSampleRate, band.frequencyHz, band.gainDb, band.q);
+        }
+        double maxError = 0.0;
+        double scalarError = 0.0;
+        for (size_t i = 0; i < checkSamples; ++i) {
+            const double expected = reference.process(noise[i]);
+            float y = noise[i];
+            for (rvc::Biquad& biquad : scalar) y = biquad.process(y);
+            maxError = std::max(maxError, std::fabs(expected - buffer[i]));
+            scalarError = std::max(scalarError, std::fabs(expected - y));
+        }
+
+        const double perSecond = best / seconds;
+        std::printf("%6zu  %12.1f  %10.1f  %9.1e  (%.1e)\n", numBands, perSecond,
+                    perSecond / static_cast<double>(numBands), maxError, scalarError);
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * Benchmark des longs silences (V16.0, voir dsp/denormals.h et CompiledGraph::skipSilentStep)
+ * sur la machine hôte : chaîne EQ (plateau grave + cloche Q 8) -> réverbération (RT60 1,5 s)
+ * -> gate/limiteur, 1 s de signal puis un long silence numérique, en blocs de 10 ms. Coût
+ * moyen par bloc, par fenêtre de 5 s, dans trois configurations :
+ *   - sans FTZ : les états des filtres décroissent en nombres dénormalisés ;
+ *   - FTZ : ScopedFlushDenormals pendant le traitement, nœuds toujours exécutés ;
+ *   - FTZ + saut : nœuds sautés une fois leur traîne écoulée (tailSamples).
+ * Les deux premières utilisent des copies des nœuds qui ne déclarent pas de traîne (jamais
+ * sautées). La sortie de "FTZ + saut" est comparée à celle de "FTZ".
+ *
+ * Compilation (depuis la racine du dépôt). L'édition de liens se fait sans -ffast-math : avec,
+ * crtfastmath activerait FTZ au démarrage sur x86 et la première mesure n'aurait plus de sens.
+ *   D=app/src/main/cpp
+ *   c++ -std=c++20 -O3 -ffast-math -I$D -Itools/host -c tools/benchmarks/silence_bench.cpp \
+ *       $D/dsp/audio_graph.cpp $D/dsp/node_registry.cpp $D/dsp/node_parameters.cpp \
+ *       $D/dsp/worker_pool.cpp $D/dsp/builtin_nodes.cpp $D/dsp/deesser.cpp $D/dsp/fdn_reverb.cpp \
+ *       $D/dsp/formant_shifter.cpp $D/dsp/fused_nodes.cpp $D/dsp/harmonic_corrector.cpp \
+ *       $D/dsp/noise_gate.cpp $D/dsp/packet_loss_concealer.cpp $D/dsp/pitch_tracker.cpp \
+ *       $D/dsp/parametric_eq.cpp $D/dsp/spectral_analyzer.cpp $D/dsp/biquad.cpp $D/dsp/fft.cpp \
+ *       $D/dsp/resampler.cpp $D/dsp/delay_line.cpp $D/security/lock_manager.cpp
+ *   c++ *.o -lpthread -o silence_bench
+ *
+ * Utilisation :
+ *   silence_bench [options]
+ *     --silence S   Durée du silence après le signal (défaut : 60)
+ *     --window S    Durée d'une fenêtre de mesure (défaut : 5)
+ */
+#include "dsp/audio_graph.h"
+#include "dsp/biquad.h"
+#include "dsp/denormals.h"
+#include "dsp/node_parameters.h"
+#include "dsp/node_registry.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using rvc::AudioProcessor;
+using rvc::CompiledGraph;
+using rvc::GraphDescription;
+using rvc::NodeContext;
+using rvc::ParameterInfo;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kBlockSize = 480;
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "silence_bench: %s\n", message.c_str());
+    std::exit(1);
+}
+
+// Nœud enveloppé sans traîne déclarée : le graphe l'exécute même sur un silence établi.
+class NeverSkipped : public AudioProcessor {
+public:
+    explicit NeverSkipped(std::unique_ptr<AudioProcessor> node) : node_(std::move(node)) {}
+
+    void process(float* buffer, size_t numSamples) override { node_->process(buffer, numSamples); }
+    size_t numParameters() const override { return node_->numParameters(); }
+    const ParameterInfo* parameterInfo() const override { return node_->parameterInfo(); }
+    void setParameters(const float* values) override { node_->setParameters(values); }
+    size_t latencySamples() const override { return node_->latencySamples(); }
+    size_t primingSamples() const override { return node_->primingSamples(); }
+
+private:
+    std::unique_ptr<AudioProcessor> node_;
+};
+
+void registerNeverSkipped(const std::string& type) {
+    rvc::NodeRegistry::getInstance()->registerNode("never_skipped_" + type, [type](const NodeContext& context) {
+        std::unique_ptr<AudioProcessor> node = rvc::NodeRegistry::getInstance()->create(type, context);
+        return node ? std::make_unique<NeverSkipped>(std::move(node)) : nullptr;
+    });
+}
+
+std::unique_ptr<CompiledGraph> buildChain(bool skippable) {
+    const std::string prefix = skippable ? "" : "never_skipped_";
+    const GraphDescription description = GraphDescription::chain(
+        {{"eq", prefix + "parametric_eq"}, {"reverb", prefix + "fdn_reverb"}, {"limiter", prefix + "gate_limiter"}});
+    NodeContext context;
+    context.sampleRate = kSampleRate;
+    context.maxBlockSize = kBlockSize;
+    std::string error;
+    std::unique_ptr<CompiledGraph> graph = CompiledGraph::compile(description, context, &error);
+    if (!graph) die(error);
+
+    graph->findParameters("eq")->set({{"band0_type", static_cast<float>(rvc::BiquadType::LowShelf)},
+                                      {"band0_freq", 120.0f},
+                                      {"band0_gain", 4.0f},
+                                      {"band0_q", 0.7f},
+                                      {"band0_enabled", 1.0f},
+                                      {"band1_type", static_cast<float>(rvc::BiquadType::Peaking)},
+                                      {"band1_freq", 2500.0f},
+                                      {"band1_gain", 6.0f},
+                                      {"band1_q", 8.0f},
+                                      {"band1_enabled", 1.0f}});
+    graph->findParameters("reverb")->set({{"decay_s", 1.5f}, {"wet", 0.3f}});
+    return graph;
+}
+
+struct Run {
+    std::vector<double> windowUs; // Coût moyen par bloc de chaque fenêtre
+    std::vector<float> output;
+};
+
+Run run(const std::vector<float>& input, bool flushDenormals, bool skippable, size_t windowBlocks) {
+    std::unique_ptr<CompiledGraph> graph = buildChain(skippable);
+    Run result;
+    result.output = input;
+    std::unique_ptr<rvc::ScopedFlushDenormals> flush;
+    if (flushDenormals) flush = std::make_unique<rvc::ScopedFlushDenormals>();
+
+    double windowTotal = 0.0;
+    size_t blocks = 0;
+    for (size_t offset = 0; offset + kBlockSize <= input.size(); offset += kBlockSize) {
+        const auto start = std::chrono::steady_clock::now();
+        graph->process(result.output.data() + offset, kBlockSize);
+        windowTotal += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (++blocks == windowBlocks) {
+            result.windowUs.push_back(windowTotal / static_cast<double>(blocks));
+            windowTotal = 0.0;
+            blocks = 0;
+        }
+    }
+    return result;
+}
+
+void print(const char* name, const Run& result) {
+    std::printf("%-12s", name);
+    for (double us : result.windowUs) std::printf(" %7.1f", us);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double silenceSeconds = 60.0;
+    double windowSeconds = 5.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) die("valeur manquante pour " + arg);
+            return argv[++i];
+        };
+        if (arg == "--silence") silenceSeconds = std::stod(value());
+        else if (arg == "--window") windowSeconds = std::stod(value());
+        else die("option inconnue : " + arg);
+    }
+    if (silenceSeconds <= 0.0 || windowSeconds <= 0.0) die("valeurs strictement positives attendues");
+
+    for (const char* type : {"parametric_eq", "fdn_reverb", "gate_limiter"}) registerNeverSkipped(type);
+
+    // 1 s de voix simulée (harmoniques de 150 Hz et bruit), puis le silence.
+    std::vector<float> input(static_cast<size_t>((1.0 + silenceSeconds) * kSampleRate), 0.0f);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+    for (size_t i = 0; i < static_cast<size_t>(kSampleRate); ++i) {
+        const float t = static_cast<float>(i) / kSampleRate;
+        float voice = 0.0f;
+        for (int h = 1; h <= 8; ++h) {
+            voice += 0.3f / static_cast<float>(h) * std::sin(2.0f * static_cast<float>(M_PI) * 150.0f * h * t);
+        }
+        input[i] = voice + noise(rng);
+    }
+
+    const size_t windowBlocks = std::max<size_t>(1, static_cast<size_t>(windowSeconds * kSampleRate) / kBlockSize);
+    std::printf("µs par bloc de %zu échantillons, fenêtres de %.0f s (1 s de signal, puis %.0f s de silence)\n",
+                kBlockSize, windowSeconds, silenceSeconds);
+    const Run plain = run(input, false, false, windowBlocks);
+    const Run flushed = run(input, true, false, windowBlocks);
+    const Run skipped = run(input, true, true, windowBlocks);
+    print("sans FTZ", plain);
+    print("FTZ", flushed);
+    print("FTZ + saut", skipped);
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < input.size(); ++i) {
+        maxError = std::max(maxError, std::fabs(flushed.output[i] - skipped.output[i]));
+    }
+    std::printf("écart max FTZ + saut / FTZ : %.1e\n", maxError);
+    return 0;
+}
@@ -0,0 +1,219 @@
+/**
+ * Benchmark du saut de l'inférence hors parole (VoiceActivityGate, V16.0) sur la machine
+ * hôte, à travers une CaptureSession comme dans le moteur (suivi de F0, conversion vers la
+ * fréquence du modèle, bruit de confort et fondus) : segments de parole simulée (voyelles à
+ * F0 variable, syllabes) séparés de silences au bruit de fond, en blocs de 10 ms.
+ *
+ * Le modèle est remplacé par un filtre RIF à état de coût fixe (--taps) à 40 kHz. Deux
+ * passages sur le même signal :
+ *   - référence : le modèle tourne sur chaque bloc, sans VAD ;
+ *   - VAD : analyze() décide, le modèle est sauté hors parole, finish() applique la décision.
+ * Affiche la part de blocs sautés, le temps d'inférence économisé (mesuré, et estimé par la
+ * porte elle-même) et, à chaque début de parole, le retard de la décision et l'écart entre
+ * les deux sorties par fenêtre après le début (dB sous le niveau de parole de la référence
+ * sur le segment).
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   D=app/src/main/cpp
+ *   c++ -std=c++20 -O3 -ffast-math -I$D -Itools/host tools/benchmarks/vad_skip_bench.cpp \
+ *       $D/audio/capture_session.cpp $D/dsp/voice_activity.cpp $D/dsp/pitch_tracker.cpp \
+ *       $D/dsp/resampler.cpp $D/dsp/fft.cpp $D/inference/f0_conditioner.cpp -o vad_skip_bench
+ *
+ * Utilisation :
+ *   vad_skip_bench [options]
+ *     --cycles N    Paires parole / silence (défaut : 6)
+ *     --speech S    Durée d'un segment de parole (défaut : 2)
+ *     --silence S   Durée d'un silence (défaut : 3)
+ *     --taps N      Coefficients du modèle factice (défaut : 2048)
+ */
+#include "audio/capture_session.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using rvc::CaptureSession;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr int kModelSampleRate = 40000;
+constexpr size_t kBlockSize = kSampleRate / 100;
+constexpr float kNoiseLevel = 0.002f; // Bruit de fond (~-54 dBFS)
+constexpr float kOnsetWindowsMs[] = {0.0f, 10.0f, 20.0f, 50.0f, 100.0f, 200.0f}; // Bornes des fenêtres
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "vad_skip_bench: %s\n", message.c_str());
+    std::exit(1);
+}
+
+/**
+ * Modèle factice : filtre RIF passe-bas à état, en place. Coût fixe par échantillon, sortie
+ * différente de l'entrée, mémoire qui survit aux blocs sautés comme celle d'un vrai modèle.
+ * Noyau exponentiel décroissant (coupure ~1,6 kHz) : retard de groupe de quelques
+ * échantillons, la sortie de référence suit le début de parole sans décalage.
+ */
+class StandInModel {
+public:
+    explicit StandInModel(size_t taps) : taps_(taps), history_(2 * taps, 0.0f) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < taps; ++k) {
+            taps_[k] = std::exp(-static_cast<float>(k) / 4.0f);
+            sum += taps_[k];
+        }
+        for (float& tap : taps_) tap /= sum;
+    }
+
+    void run(float* samples, size_t count) {
+        const size_t n = taps_.size();
+        for (size_t i = 0; i < count; ++i) {
+            // Historique doublé : les n dernières entrées sont toujours contiguës, la plus
+            // récente en window[0].
+            position_ = (position_ + n - 1) % n;
+            history_[position_] = history_[position_ + n] = samples[i];
+            const float* window = history_.data() + position_;
+            float sum = 0.0f;
+            for (size_t k = 0; k < n; ++k) sum += taps_[k] * window[k];
+            samples[i] = sum;
+        }
+    }
+
+private:
+    std::vector<float> taps_;
+    std::vector<float> history_;
+    size_t position_ = 0;
+};
+
+// Parole simulée : harmoniques d'une F0 glissante, syllabes de ~200 ms, sur le bruit de fond.
+std::vector<float> testSignal(size_t cycles, size_t speechSamples, size_t silenceSamples) {
+    std::vector<float> signal(cycles * (speechSamples + silenceSamples));
+    std::mt19937 rng(11);
+    std::normal_distribution<float> noise(0.0f, kNoiseLevel);
+    float phase = 0.0f;
+    for (size_t i = 0; i < signal.size(); ++i) {
+        const size_t position = i % (speechSamples + silenceSamples);
+        float voice = 0.0f;
+        if (position < speechSamples) {
+            const float t = static_cast<float>(position) / kSampleRate;
+            const float f0 = 140.0f + 30.0f * std::sin(2.0f * static_cast<float>(M_PI) * 0.7f * t);
+            phase += 2.0f * static_cast<float>(M_PI) * f0 / kSampleRate;
+            const float syllable = 0.6f + 0.4f * std::sin(2.0f * static_cast<float>(M_PI) * 5.0f * t);
+            for (int h = 1; h <= 10; ++h) voice += std::sin(phase * static_cast<float>(h)) / static_cast<float>(h);
+            voice *= 0.12f * syllable;
+        }
+        signal[i] = voice + noise(rng);
+    }
+    return signal;
+}
+
+struct Run {
+    std::vector<float> output;
+    std::vector<bool> modelUsed; // Par bloc : le modèle a tourné
+    double inferenceMs = 0.0;
+    rvc::VoiceActivityGate::Stats stats{};
+};
+
+Run run(const std::vector<float>& input, size_t taps, bool vad) {
+    CaptureSession session(kSampleRate, 1, kModelSampleRate, kBlockSize);
+    StandInModel model(taps);
+    Run result;
+    result.output = input;
+    for (size_t offset = 0; offset + kBlockSize <= input.size(); offset += kBlockSize) {
+        float* voice = session.downmix(result.output.data() + offset, kBlockSize);
+        session.acquireVoice();
+        session.trackPitch(voice, kBlockSize);
+        rvc::VoiceActivityGate& gate = session.voiceActivity();
+        const bool runModel = !vad || gate.analyze(voice, kBlockSize, false);
+        if (runModel) {
+            const auto start = std::chrono::steady_clock::now();
+            session.runModel(voice, kBlockSize, [&](float* samples, size_t count, const rvc::ModelConditioning&) {
+                model.run(samples, count);
+            });
+            const float us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+            result.inferenceMs += us / 1000.0;
+            if (vad) gate.recordInference(us, kBlockSize);
+        } else {
+            session.skipModel();
+        }
+        if (vad) gate.finish(voice, kBlockSize);
+        result.modelUsed.push_back(runModel);
+    }
+    result.stats = session.voiceActivity().stats();
+    return result;
+}
+
+double rms(const float* x, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += static_cast<double>(x[i]) * x[i];
+    return std::sqrt(sum / static_cast<double>(n));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t cycles = 6;
+    double speechSeconds = 2.0;
+    double silenceSeconds = 3.0;
+    size_t taps = 2048;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) die("valeur manquante pour " + arg);
+            return argv[++i];
+        };
+        if (arg == "--cycles") cycles = std::stoul(value());
+        else if (arg == "--speech") speechSeconds = std::stod(value());
+        else if (arg == "--silence") silenceSeconds = std::stod(value());
+        else if (arg == "--taps") taps = std::stoul(value());
+        else die("option inconnue : " + arg);
+    }
+    if (cycles == 0 || speechSeconds <= 0.0 || silenceSeconds <= 0.0 || taps < 2) {
+        die("valeurs strictement positives attendues");
+    }
+
+    const size_t speechSamples = static_cast<size_t>(speechSeconds * kSampleRate) / kBlockSize * kBlockSize;
+    const size_t silenceSamples = static_cast<size_t>(silenceSeconds * kSampleRate) / kBlockSize * kBlockSize;
+    const std::vector<float> input = testSignal(cycles, speechSamples, silenceSamples);
+    const Run reference = run(input, taps, false);
+    const Run gated = run(input, taps, true);
+
+    const double seconds = static_cast<double>(input.size()) / kSampleRate;
+    std::printf("%zu cycles (%.1f s de parole, %.1f s de silence), %.0f s, blocs de %zu, modèle RIF %zu coefficients\n",
+                cycles, speechSeconds, silenceSeconds, seconds, kBlockSize, taps);
+    std::printf("blocs sautés : %u / %u (%.1f %%, silence : %.1f %% du signal)\n", gated.stats.skippedBlocks,
+                gated.stats.blocks, 100.0f * gated.stats.skipRatio,
+                100.0 * static_cast<double>(silenceSamples) / static_cast<double>(speechSamples + silenceSamples));
+    std::printf("inférence : %.1f ms sans VAD, %.1f ms avec, %.1f ms économisées (estimation de la porte : %.1f ms)\n",
+                reference.inferenceMs, gated.inferenceMs, reference.inferenceMs - gated.inferenceMs,
+                gated.stats.savedInferenceMs);
+
+    // Débuts de parole : retard de la décision et écart des sorties par fenêtre.
+    std::printf("début de parole  retard (ms)");
+    for (size_t w = 1; w < std::size(kOnsetWindowsMs); ++w) {
+        std::printf("  %3.0f-%3.0f ms (dB)", kOnsetWindowsMs[w - 1], kOnsetWindowsMs[w]);
+    }
+    std::printf("\n");
+    for (size_t c = 0; c < cycles; ++c) {
+        const size_t onset = c * (speechSamples + silenceSamples);
+        const double level = rms(reference.output.data() + onset, speechSamples);
+        size_t block = onset / kBlockSize;
+        while (block < gated.modelUsed.size() && !gated.modelUsed[block]) ++block;
+        std::printf("%14.2f s  %11.0f", static_cast<double>(onset) / kSampleRate,
+                    static_cast<double>(block * kBlockSize - onset) * 1000.0 / kSampleRate);
+        for (size_t w = 1; w < std::size(kOnsetWindowsMs); ++w) {
+            const size_t from = onset + static_cast<size_t>(kOnsetWindowsMs[w - 1] * 0.001f * kSampleRate);
+            const size_t to = onset + static_cast<size_t>(kOnsetWindowsMs[w] * 0.001f * kSampleRate);
+            std::vector<float> difference(to - from);
+            for (size_t i = from; i < to; ++i) difference[i - from] = gated.output[i] - reference.output[i];
+            const double error = rms(difference.data(), difference.size());
+            if (error == 0.0) std::printf("  %16s", "identique");
+            else std::printf("  %16.1f", 20.0 * std::log10(error / level));
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
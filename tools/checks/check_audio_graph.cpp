@@ -0,0 +1,270 @@
+/**
+ * Vérification de la compensation de latence du graphe compilé (CompiledGraph, V16.0).
+ * Aucun nœud intégré ne déclare de latence : un nœud de test ("test_latency") retarde son
+ * entrée de kLatency échantillons et le déclare, un autre ("test_identity") la recopie.
+ *
+ *   - parallèle : input -> {test_latency, test_identity} -> output. La branche directe doit
+ *     être retardée au mixage (un retard de compensation), la latence rapportée est
+ *     kLatency et la sortie vaut exactement 2·x[n - kLatency] ;
+ *   - contournement : test_latency contourné puis réactivé dans ce graphe. Une fois le
+ *     fondu terminé, le chemin sec doit être retardé de la latence du nœud : la sortie
+ *     reste exactement 2·x[n - kLatency] ;
+ *   - série : input -> test_latency -> output contourné, sortie x[n - kLatency] ;
+ *   - amorçage : un filtre RIF de test ("test_fir", mémoire égale à son amorçage) réactivé
+ *     après un long contournement doit donner la sortie d'un filtre neuf nourri des mêmes
+ *     entrées récentes (fondu d'entrée compris) : l'historique est celui qui précède la
+ *     réactivation, pas le début du contournement.
+ *
+ * Blocs de tailles irrégulières, plus grands que la taille de bloc du graphe compris.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   D=app/src/main/cpp
+ *   c++ -std=c++20 -O3 -ffast-math -I$D -Itools/host -c tools/checks/check_audio_graph.cpp \
+ *       $D/dsp/audio_graph.cpp $D/dsp/node_registry.cpp $D/dsp/node_parameters.cpp \
+ *       $D/dsp/worker_pool.cpp $D/dsp/builtin_nodes.cpp $D/dsp/deesser.cpp $D/dsp/fdn_reverb.cpp \
+ *       $D/dsp/formant_shifter.cpp $D/dsp/fused_nodes.cpp $D/dsp/harmonic_corrector.cpp \
+ *       $D/dsp/noise_gate.cpp $D/dsp/packet_loss_concealer.cpp $D/dsp/pitch_tracker.cpp \
+ *       $D/dsp/parametric_eq.cpp $D/dsp/spectral_analyzer.cpp $D/dsp/biquad.cpp $D/dsp/fft.cpp \
+ *       $D/dsp/resampler.cpp $D/dsp/delay_line.cpp $D/security/lock_manager.cpp
+ *   c++ *.o -lpthread -o check_audio_graph
+ *
+ * Utilisation :
+ *   check_audio_graph
+ *
+ * Code de retour 1 au premier écart.
+ */
+#include "dsp/audio_graph.h"
+#include "dsp/node_registry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using rvc::AudioProcessor;
+using rvc::CompiledGraph;
+using rvc::GraphDescription;
+using rvc::NodeContext;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kMaxBlockSize = 256;
+constexpr size_t kLatency = 37;
+constexpr size_t kFirTaps = 512;
+constexpr float kFadeTolerance = 1e-5f;
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "check_audio_graph: %s\n", message.c_str());
+    std::exit(1);
+}
+
+// Retard pur de latency échantillons, déclaré au graphe (0 : recopie).
+class LatencyNode : public AudioProcessor {
+public:
+    explicit LatencyNode(size_t latency) : history_(latency, 0.0f) {}
+
+    void process(float* buffer, size_t numSamples) override {
+        if (history_.empty()) return;
+        for (size_t i = 0; i < numSamples; ++i) {
+            const float delayed = history_[position_];
+            history_[position_] = buffer[i];
+            position_ = (position_ + 1) % history_.size();
+            buffer[i] = delayed;
+        }
+    }
+    size_t latencySamples() const override { return history_.size(); }
+
+private:
+    std::vector<float> history_;
+    size_t position_ = 0;
+};
+
+// RIF de kFirTaps coefficients : son état ne dépend que des kFirTaps - 1 dernières entrées,
+// toutes rejouées par l'amorçage.
+class FirNode : public AudioProcessor {
+public:
+    FirNode() : taps_(kFirTaps), history_(kFirTaps, 0.0f) {
+        std::mt19937 rng(9);
+        std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+        for (size_t k = 0; k < kFirTaps; ++k) {
+            taps_[k] = uniform(rng) * std::exp(-4.0f * static_cast<float>(k) / kFirTaps) / 16.0f;
+        }
+    }
+
+    void process(float* buffer, size_t numSamples) override {
+        for (size_t i = 0; i < numSamples; ++i) {
+            history_[position_] = buffer[i];
+            float sum = 0.0f;
+            for (size_t k = 0; k < kFirTaps; ++k) sum += taps_[k] * history_[(position_ + kFirTaps - k) % kFirTaps];
+            position_ = (position_ + 1) % kFirTaps;
+            buffer[i] = sum;
+        }
+    }
+    size_t primingSamples() const override { return kFirTaps; }
+
+private:
+    std::vector<float> taps_;
+    std::vector<float> history_;
+    size_t position_ = 0;
+};
+
+void registerTestNodes() {
+    rvc::NodeRegistry* registry = rvc::NodeRegistry::getInstance();
+    registry->registerNode("test_fir", [](const NodeContext&) { return std::make_unique<FirNode>(); });
+    registry->registerNode("test_latency", [](const NodeContext&) { return std::make_unique<LatencyNode>(kLatency); });
+    registry->registerNode("test_identity", [](const NodeContext&) { return std::make_unique<LatencyNode>(0); });
+}
+
+std::unique_ptr<CompiledGraph> compile(const GraphDescription& description) {
+    NodeContext context;
+    context.sampleRate = kSampleRate;
+    context.maxBlockSize = kMaxBlockSize;
+    std::string error;
+    std::unique_ptr<CompiledGraph> graph = CompiledGraph::compile(description, context, &error);
+    if (!graph) die(error);
+    return graph;
+}
+
+std::vector<float> noise(size_t numSamples) {
+    std::vector<float> signal(numSamples);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> uniform(-0.5f, 0.5f);
+    for (float& x : signal) x = uniform(rng);
+    return signal;
+}
+
+// Traite input par blocs irréguliers ; event(offset) est appelé avant chaque bloc.
+template <typename Event>
+std::vector<float> run(CompiledGraph& graph, const std::vector<float>& input, Event&& event) {
+    const size_t blockSizes[] = {480, 1, 97, 256, 1000, 33};
+    std::vector<float> output = input;
+    size_t offset = 0;
+    for (size_t block = 0; offset < output.size(); ++block) {
+        const size_t n = std::min(blockSizes[block % std::size(blockSizes)], output.size() - offset);
+        event(offset);
+        graph.process(output.data() + offset, n);
+        offset += n;
+    }
+    return output;
+}
+
+// Sortie attendue gain·x[n - kLatency] sur [from, to).
+void expectDelayed(const char* name, const std::vector<float>& input, const std::vector<float>& output, float gain,
+                   size_t from, size_t to) {
+    for (size_t i = from; i < to; ++i) {
+        const float expected = i < kLatency ? 0.0f : gain * input[i - kLatency];
+        if (output[i] != expected) {
+            die(std::string(name) + " : échantillon " + std::to_string(i) + " = " + std::to_string(output[i]) +
+                ", attendu " + std::to_string(expected));
+        }
+    }
+}
+
+void checkParallel(const std::vector<float>& input) {
+    GraphDescription description;
+    description.nodes = {{"lagged", "test_latency"}, {"direct", "test_identity"}};
+    description.edges = {{GraphDescription::kInput, "lagged"}, {GraphDescription::kInput, "direct"},
+                         {"lagged", GraphDescription::kOutput}, {"direct", GraphDescription::kOutput}};
+    std::unique_ptr<CompiledGraph> graph = compile(description);
+    if (graph->latencySamples() != kLatency) {
+        die("parallèle : latence rapportée " + std::to_string(graph->latencySamples()));
+    }
+    if (graph->numCompensationDelays() != 1) {
+        die("parallèle : " + std::to_string(graph->numCompensationDelays()) + " retards de compensation");
+    }
+    const std::vector<float> output = run(*graph, input, [](size_t) {});
+    expectDelayed("parallèle", input, output, 2.0f, 0, output.size());
+    std::printf("parallèle      : latence %zu, 1 retard de compensation, sortie alignée\n", kLatency);
+}
+
+void checkParallelBypass(const std::vector<float>& input) {
+    GraphDescription description;
+    description.nodes = {{"lagged", "test_latency"}, {"direct", "test_identity"}};
+    description.edges = {{GraphDescription::kInput, "lagged"}, {GraphDescription::kInput, "direct"},
+                         {"lagged", GraphDescription::kOutput}, {"direct", GraphDescription::kOutput}};
+    std::unique_ptr<CompiledGraph> graph = compile(description);
+    // Contournement au premier quart, réactivation à la moitié ; fondus de 10 ms.
+    const size_t bypassAt = input.size() / 4;
+    const size_t enableAt = input.size() / 2;
+    const size_t fade = static_cast<size_t>(0.010 * kSampleRate) + 1000; // Fondu et bloc qui le termine
+    size_t bypassedFrom = 0;
+    size_t enabledFrom = 0;
+    const std::vector<float> output = run(*graph, input, [&](size_t offset) {
+        if (bypassedFrom == 0 && offset >= bypassAt) {
+            graph->setBypass("lagged", true);
+            bypassedFrom = offset;
+        } else if (enabledFrom == 0 && offset >= enableAt) {
+            graph->setBypass("lagged", false);
+            enabledFrom = offset;
+        }
+    });
+    expectDelayed("contournement", input, output, 2.0f, 0, bypassedFrom);
+    expectDelayed("contournement (chemin sec)", input, output, 2.0f, bypassedFrom + fade, enabledFrom);
+    expectDelayed("réactivation", input, output, 2.0f, enabledFrom + fade, output.size());
+    std::printf("contournement  : chemin sec retardé de %zu, sortie alignée contourné et réactivé\n", kLatency);
+}
+
+void checkSerialBypass(const std::vector<float>& input) {
+    std::unique_ptr<CompiledGraph> graph = compile(GraphDescription::chain({{"lagged", "test_latency"}}));
+    if (graph->latencySamples() != kLatency || graph->numCompensationDelays() != 0) {
+        die("série : latence ou retards de compensation inattendus");
+    }
+    graph->restoreBypass(0, true);
+    const std::vector<float> output = run(*graph, input, [](size_t) {});
+    expectDelayed("série contournée", input, output, 1.0f, 0, output.size());
+    std::printf("série          : contournée, sortie x[n - %zu]\n", kLatency);
+}
+
+void checkPriming(const std::vector<float>& input) {
+    std::unique_ptr<CompiledGraph> graph = compile(GraphDescription::chain({{"fir", "test_fir"}}));
+    // Contourné de 10 % à 90 % du signal : l'historique des premiers échantillons contournés
+    // serait périmé de 0,8 s.
+    size_t bypassedFrom = 0;
+    size_t enabledFrom = 0;
+    const std::vector<float> output = run(*graph, input, [&](size_t offset) {
+        if (bypassedFrom == 0 && offset >= input.size() / 10) {
+            graph->setBypass("fir", true);
+            bypassedFrom = offset;
+        } else if (enabledFrom == 0 && offset >= input.size() * 9 / 10) {
+            graph->setBypass("fir", false);
+            enabledFrom = offset;
+        }
+    });
+
+    // Filtre neuf nourri des kFirTaps entrées qui précèdent la réactivation, puis de la suite.
+    FirNode fresh;
+    std::vector<float> wet(input.begin() + static_cast<long>(enabledFrom - kFirTaps), input.end());
+    fresh.process(wet.data(), wet.size());
+    wet.erase(wet.begin(), wet.begin() + kFirTaps);
+
+    // Fondu d'entrée à puissance constante (10 ms), puis le filtre seul.
+    const size_t fade = static_cast<size_t>(0.010f * kSampleRate);
+    const float thetaStep = static_cast<float>(M_PI_2) / static_cast<float>(fade);
+    float worst = 0.0f;
+    for (size_t i = 0; i < wet.size(); ++i) {
+        const float theta = thetaStep * static_cast<float>(std::min(i + 1, fade));
+        const float expected = wet[i] * std::sin(theta) + input[enabledFrom + i] * std::cos(theta);
+        worst = std::max(worst, std::fabs(output[enabledFrom + i] - expected));
+    }
+    if (worst > kFadeTolerance) {
+        die("amorçage : écart " + std::to_string(worst) + " avec un filtre neuf nourri des entrées récentes");
+    }
+    std::printf("amorçage       : réactivé après %zu échantillons contournés, écart %.1e avec un filtre neuf\n",
+                enabledFrom - bypassedFrom, worst);
+}
+
+} // namespace
+
+int main() {
+    registerTestNodes();
+    const std::vector<float> input = noise(kSampleRate);
+    checkParallel(input);
+    checkParallelBypass(input);
+    checkSerialBypass(input);
+    checkPriming(input);
+    return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * Vérification de la chaîne fusionnée gate -> suppression du continu -> limiteur
+ * (GateLimiterNode, chaîne Low Power) : la boucle fusionnée doit donner une sortie identique
+ * au bit près à l'exécution étage par étage (processUnfused), pour toute taille de bloc.
+ *
+ * Compilation (depuis la racine du dépôt), avec les options de CMakeLists.txt : fused_nodes.cpp
+ * sans contraction ni réassociation, le reste en -ffast-math (le gate y instancie aussi le
+ * code inline partagé avec la chaîne fusionnée) :
+ *   c++ -std=c++20 -O3 -ffast-math -Iapp/src/main/cpp -c tools/checks/check_fused_gate.cpp \
+ *       app/src/main/cpp/dsp/noise_gate.cpp
+ *   c++ -std=c++20 -O3 -ffast-math -ffp-contract=off -fno-associative-math -Iapp/src/main/cpp \
+ *       -c app/src/main/cpp/dsp/fused_nodes.cpp
+ *   c++ check_fused_gate.o noise_gate.o fused_nodes.o -o check_fused_gate
+ *
+ * Utilisation :
+ *   check_fused_gate [--seconds S]   (défaut : 10 s de signal par taille de bloc)
+ *
+ * Code de retour 1 au premier échantillon différent.
+ */
+#include "dsp/fused_nodes.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using rvc::GateLimiterNode;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "check_fused_gate: %s\n", message.c_str());
+    std::exit(1);
+}
+
+/**
+ * Signal qui fait travailler toutes les branches du gate : rafales voisées (ouverture,
+ * maintien, relâchement), bruit de fond sous le seuil, offset continu et crêtes écrêtées.
+ */
+std::vector<float> testSignal(size_t numSamples) {
+    std::vector<float> signal(numSamples);
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 0.0004f);
+    std::uniform_real_distribution<float> level(0.05f, 1.4f);
+    float amplitude = 0.0f;
+    for (size_t i = 0; i < numSamples; ++i) {
+        if (i % 24000 == 0) amplitude = (i / 24000) % 3 == 2 ? 0.0f : level(rng);
+        const float t = static_cast<float>(i) / kSampleRate;
+        const float voice = amplitude * (std::sin(2.0f * static_cast<float>(M_PI) * 180.0f * t) +
+                                         0.4f * std::sin(2.0f * static_cast<float>(M_PI) * 1250.0f * t));
+        signal[i] = voice + noise(rng) + 0.01f;
+    }
+    return signal;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) seconds = std::stod(argv[++i]);
+        else die("option inconnue : " + arg);
+    }
+
+    const std::vector<float> input = testSignal(static_cast<size_t>(seconds * kSampleRate));
+    const size_t blockSizes[] = {1, 3, 31, 96, 480, 1000, 1024, 2048, 4097};
+    for (size_t blockSize : blockSizes) {
+        GateLimiterNode fusedNode(kSampleRate);
+        GateLimiterNode unfusedNode(kSampleRate);
+        std::vector<float> fusedOut = input;
+        std::vector<float> unfusedOut = input;
+        size_t closedBlocks = 0;
+        for (size_t offset = 0; offset < input.size(); offset += blockSize) {
+            const size_t n = std::min(blockSize, input.size() - offset);
+            fusedNode.process(fusedOut.data() + offset, n);
+            unfusedNode.processUnfused(unfusedOut.data() + offset, n);
+            if (fusedNode.gate().isClosed()) ++closedBlocks;
+        }
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (std::memcmp(&fusedOut[i], &unfusedOut[i], sizeof(float)) != 0) {
+                std::fprintf(stderr, "bloc %zu : échantillon %zu différent (%.9g fusionné, %.9g étage par étage)\n",
+                             blockSize, i, fusedOut[i], unfusedOut[i]);
+                return 1;
+            }
+        }
+        std::printf("bloc %4zu : identique sur %zu échantillons (%zu blocs entièrement fermés)\n", blockSize,
+                    input.size(), closedBlocks);
+    }
+    return 0;
+}
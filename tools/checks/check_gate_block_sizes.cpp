@@ -0,0 +1,125 @@
+/**
+ * Vérification des constantes de temps du Noise Gate selon la taille des blocs : attaque,
+ * maintien, relâchement et décroissance du détecteur sont réglés en millisecondes et ne
+ * doivent pas dépendre de la taille des callbacks (sous-blocs partiels en fin de bloc).
+ *
+ * Le signal est une onde carrée (|x| constant) : le gain de chaque échantillon se lit
+ * directement, |y| / |x|. Des rafales au-dessus du seuil d'ouverture alternent avec un
+ * fond à -60 dB ; pour chaque transition, l'instant où le gain franchit 0,5 à l'ouverture
+ * et 0,01 (-40 dB) à la fermeture est comparé à celui de blocs de kSubBlock échantillons
+ * (sous-blocs tous complets, référence). Seul le placement des sous-blocs peut déplacer une
+ * décision : l'écart toléré est de deux sous-blocs.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   D=app/src/main/cpp
+ *   c++ -std=c++20 -O3 -ffast-math -I$D tools/checks/check_gate_block_sizes.cpp $D/dsp/noise_gate.cpp \
+ *       -o check_gate_block_sizes
+ *
+ * Utilisation :
+ *   check_gate_block_sizes [--bursts N]   (défaut : 8 rafales)
+ *
+ * Code de retour 1 si une transition s'écarte de la référence au-delà de la tolérance.
+ */
+#include "dsp/noise_gate.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using rvc::NoiseGate;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr size_t kBurstSamples = kSampleRate / 2;   // Rafale, puis fond de même durée
+constexpr size_t kSquarePeriod = kSampleRate / 200; // Onde carrée à 200 Hz
+constexpr float kBurstLevel = 0.3f;
+constexpr float kFloorLevel = 0.001f; // -60 dB, sous le seuil de fermeture
+constexpr float kOpenCrossing = 0.5f;
+constexpr float kCloseCrossing = 0.01f;
+constexpr long kTolerance = 2 * static_cast<long>(NoiseGate::kSubBlock);
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "check_gate_block_sizes: %s\n", message.c_str());
+    std::exit(1);
+}
+
+std::vector<float> testSignal(size_t bursts) {
+    std::vector<float> signal(2 * bursts * kBurstSamples);
+    for (size_t i = 0; i < signal.size(); ++i) {
+        const float level = (i / kBurstSamples) % 2 == 0 ? kBurstLevel : kFloorLevel;
+        signal[i] = (i % kSquarePeriod) < kSquarePeriod / 2 ? level : -level;
+    }
+    return signal;
+}
+
+// Gain de chaque échantillon pour des blocs de blockSize échantillons.
+std::vector<float> gainTrajectory(const std::vector<float>& input, size_t blockSize) {
+    NoiseGate gate(kSampleRate);
+    std::vector<float> output = input;
+    for (size_t offset = 0; offset < output.size(); offset += blockSize) {
+        gate.process(output.data() + offset, std::min(blockSize, output.size() - offset));
+    }
+    for (size_t i = 0; i < output.size(); ++i) output[i] = std::fabs(output[i] / input[i]);
+    return output;
+}
+
+/**
+ * Instants de franchissement, un par transition : gain >= kOpenCrossing après le début
+ * d'une rafale, gain < kCloseCrossing après sa fin (-1 si jamais franchi).
+ */
+std::vector<long> crossings(const std::vector<float>& gain) {
+    std::vector<long> times;
+    for (size_t start = 0; start < gain.size(); start += kBurstSamples) {
+        const bool opening = (start / kBurstSamples) % 2 == 0;
+        long time = -1;
+        for (size_t i = start; i < start + kBurstSamples; ++i) {
+            if (opening ? gain[i] >= kOpenCrossing : gain[i] < kCloseCrossing) {
+                time = static_cast<long>(i - start);
+                break;
+            }
+        }
+        times.push_back(time);
+    }
+    return times;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t bursts = 8;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--bursts" && i + 1 < argc) bursts = std::stoul(argv[++i]);
+        else die("option inconnue : " + arg);
+    }
+    if (bursts == 0) die("au moins une rafale attendue");
+
+    const std::vector<float> input = testSignal(bursts);
+    const std::vector<long> reference = crossings(gainTrajectory(input, NoiseGate::kSubBlock));
+    for (long time : reference) {
+        if (time < 0) die("référence : transition sans franchissement");
+    }
+
+    bool ok = true;
+    const size_t blockSizes[] = {1, 7, 31, 33, 100, 240, 480, 1000, 4097};
+    for (size_t blockSize : blockSizes) {
+        const std::vector<long> times = crossings(gainTrajectory(input, blockSize));
+        long worstOpen = 0;
+        long worstClose = 0;
+        for (size_t t = 0; t < times.size(); ++t) {
+            const long deviation = times[t] < 0 ? kBurstSamples : std::labs(times[t] - reference[t]);
+            long& worst = t % 2 == 0 ? worstOpen : worstClose;
+            worst = std::max(worst, deviation);
+        }
+        const bool pass = worstOpen <= kTolerance && worstClose <= kTolerance;
+        ok = ok && pass;
+        std::printf("bloc %4zu : écart max %3ld échantillons à l'ouverture, %4ld à la fermeture%s\n", blockSize,
+                    worstOpen, worstClose, pass ? "" : "  <- hors tolérance");
+    }
+    std::printf("référence (blocs de %zu) : ouverture en %ld échantillons, fermeture (-40 dB) en %ld\n",
+                NoiseGate::kSubBlock, reference[0], reference[1]);
+    return ok ? 0 : 1;
+}
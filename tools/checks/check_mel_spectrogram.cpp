@@ -0,0 +1,150 @@
+/**
+ * Vérification du front-end mel (MelSpectrogram, V16.0) contre les valeurs de référence du
+ * front-end Python de RMVPE (librosa.filters.mel + torch.stft, voir mel_reference.py), pour
+ * les réglages par défaut : le log-mel produit sur l'appareil doit être celui sur lequel le
+ * modèle a été entraîné.
+ *
+ * Le signal de test de mel_reference.py est recalculé ici à l'identique et envoyé en blocs
+ * de tailles irrégulières (le découpage ne doit rien changer). En flux, seul le début est
+ * paddé : les trames centrées au-delà de la fin du signal ne sont pas calculées, seules les
+ * trames communes sont comparées. L'écart toléré couvre la FFT en float et le log approché
+ * (simd::logCompress).
+ *
+ * Contrôles négatifs : avec un padding par zéros (reflectPad = false) ou l'échelle mel de
+ * Slaney, l'écart doit dépasser la tolérance ; sinon la vérification ne distingue rien.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   D=app/src/main/cpp
+ *   c++ -std=c++20 -O3 -ffast-math -I$D tools/checks/check_mel_spectrogram.cpp $D/dsp/mel_spectrogram.cpp \
+ *       $D/dsp/fft.cpp -o check_mel_spectrogram
+ *
+ * Utilisation :
+ *   check_mel_spectrogram [--reference FICHIER]   (défaut : tools/checks/mel_reference_rmvpe.txt)
+ *
+ * Code de retour 1 si une valeur s'écarte de la référence au-delà de la tolérance.
+ */
+#include "dsp/mel_spectrogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using rvc::MelSpectrogram;
+
+namespace {
+
+constexpr int kSampleRate = 16000;
+constexpr size_t kNumSamples = 4000;
+constexpr float kTolerance = 0.002f; // Écart absolu max sur ln(mel) (mesuré : ~1e-4)
+constexpr size_t kBlockSizes[] = {1, 97, 160, 333, 7, 1024, 50};
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "check_mel_spectrogram: %s\n", message.c_str());
+    std::exit(1);
+}
+
+// Même formule que test_signal() de mel_reference.py : calcul en double, arrondi en float.
+std::vector<float> testSignal() {
+    std::vector<float> signal(kNumSamples);
+    uint64_t state = 12345;
+    for (size_t i = 0; i < kNumSamples; ++i) {
+        const double t = static_cast<double>(i) / kSampleRate;
+        const double chirp = 0.2 * std::sin(2.0 * M_PI * (200.0 * t + 3000.0 * t * t));
+        const double tones = 0.3 * std::sin(2.0 * M_PI * 220.0 * t) + 0.1 * std::sin(2.0 * M_PI * 1375.5 * t);
+        state = (state * 1103515245 + 12345) % 2147483648;
+        const double noise = 0.02 * (static_cast<double>(state) / 2147483648.0 - 0.5);
+        signal[i] = static_cast<float>(chirp + tones + noise);
+    }
+    return signal;
+}
+
+// Trames de référence, [trame][mel].
+std::vector<std::vector<float>> readReference(const std::string& path, size_t numMels) {
+    std::ifstream file(path);
+    if (!file) die("référence introuvable : " + path);
+    std::vector<std::vector<float>> frames;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream values(line);
+        std::vector<float> frame;
+        float value;
+        while (values >> value) frame.push_back(value);
+        if (frame.size() != numMels) die("trame de référence de " + std::to_string(frame.size()) + " valeurs");
+        frames.push_back(std::move(frame));
+    }
+    if (frames.empty()) die("référence vide : " + path);
+    return frames;
+}
+
+struct Comparison {
+    size_t frames = 0;
+    float maxError = 0.0f;
+    size_t worstFrame = 0;
+    size_t worstMel = 0;
+};
+
+Comparison compare(const MelSpectrogram::Settings& settings, const std::vector<float>& signal,
+                   const std::vector<std::vector<float>>& reference) {
+    MelSpectrogram mel(kSampleRate, settings);
+    std::vector<float> tensor(reference.size() * settings.numMels, 0.0f);
+    const MelSpectrogram::TensorView view{tensor.data(), reference.size(), MelSpectrogram::Layout::FrameMajor};
+    Comparison result;
+    size_t offset = 0;
+    for (size_t b = 0; offset < signal.size(); ++b) {
+        const size_t n = std::min(kBlockSizes[b % std::size(kBlockSizes)], signal.size() - offset);
+        result.frames += mel.process(signal.data() + offset, n, view, result.frames);
+        offset += n;
+    }
+    result.frames = std::min(result.frames, reference.size());
+    for (size_t t = 0; t < result.frames; ++t) {
+        for (size_t m = 0; m < settings.numMels; ++m) {
+            const float error = std::fabs(tensor[t * settings.numMels + m] - reference[t][m]);
+            if (error > result.maxError) result = {result.frames, error, t, m};
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string path = "tools/checks/mel_reference_rmvpe.txt";
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--reference" && i + 1 < argc) path = argv[++i];
+        else die("option inconnue : " + arg);
+    }
+
+    const MelSpectrogram::Settings rmvpe;
+    const std::vector<float> signal = testSignal();
+    const std::vector<std::vector<float>> reference = readReference(path, rmvpe.numMels);
+
+    const Comparison result = compare(rmvpe, signal, reference);
+    // Trames entièrement dans le signal : fin de fenêtre (t * hop + fftSize / 2) <= longueur.
+    const size_t expectedFrames = (kNumSamples - rmvpe.fftSize / 2) / rmvpe.hopSize + 1;
+    if (result.frames != expectedFrames) {
+        die(std::to_string(result.frames) + " trames calculées, " + std::to_string(expectedFrames) + " attendues");
+    }
+    const bool pass = result.maxError <= kTolerance;
+    std::printf("RMVPE : %zu / %zu trames comparées, écart max %.5f (trame %zu, mel %zu), tolérance %.3f%s\n",
+                result.frames, reference.size(), result.maxError, result.worstFrame, result.worstMel, kTolerance,
+                pass ? "" : "  <- hors tolérance");
+
+    MelSpectrogram::Settings zeroPad = rmvpe;
+    zeroPad.reflectPad = false;
+    MelSpectrogram::Settings slaney = rmvpe;
+    slaney.scale = MelSpectrogram::MelScale::Slaney;
+    bool discriminates = true;
+    for (const auto& [name, settings] : {std::pair{"padding par zéros", zeroPad}, std::pair{"échelle Slaney", slaney}}) {
+        const float error = compare(settings, signal, reference).maxError;
+        discriminates = discriminates && error > kTolerance;
+        std::printf("contrôle négatif (%s) : écart max %.3f%s\n", name, error,
+                    error > kTolerance ? "" : "  <- non détecté");
+    }
+    return pass && discriminates ? 0 : 1;
+}
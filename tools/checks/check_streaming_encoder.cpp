@@ -0,0 +1,218 @@
+/**
+ * Vérification de l'encodeur de contenu en flux (StreamingContentEncoder, V16.0) sur des
+ * poids aléatoires : les moteurs n'exposent pas encore de poids d'encodeur causal, ce
+ * contrôle est le seul à exécuter selfCheck() et la comparaison flux / fenêtre complète.
+ *
+ * Pour chaque architecture (front-end avec ou sans LayerNorm, avec ou sans convolution
+ * positionnelle causale et normalisation de l'encodeur) :
+ *   - selfCheck() doit accepter les poids ;
+ *   - process() par blocs irréguliers doit reproduire encodeFullWindow().
+ * Une convolution positionnelle centrée (celle de HuBERT) doit être refusée par selfCheck().
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   D=app/src/main/cpp
+ *   c++ -std=c++20 -O3 -ffast-math -I$D -Itools/host tools/checks/check_streaming_encoder.cpp \
+ *       $D/inference/streaming_encoder.cpp $D/dsp/resampler.cpp -o check_streaming_encoder
+ *
+ * Utilisation :
+ *   check_streaming_encoder [--seconds S]   (défaut : 2 s de signal par architecture)
+ *
+ * Code de retour 1 au premier écart.
+ */
+#include "inference/streaming_encoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using rvc::ContentEncoderWeights;
+using rvc::StreamingContentEncoder;
+
+namespace {
+
+constexpr float kTolerance = 1e-3f;
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "check_streaming_encoder: %s\n", message.c_str());
+    std::exit(1);
+}
+
+struct Architecture {
+    const char* name;
+    bool convNorm;
+    size_t positionalKernel; // 0 : sans convolution positionnelle
+    bool causal;
+    bool encoderNorm;
+};
+
+/**
+ * Poids aléatoires d'un encodeur réduit (front-end 400 -> 320 échantillons par trame comme
+ * HuBERT, dimension 64) : les tenseurs vivent dans storage, les poids n'en sont que des vues.
+ */
+class RandomEncoder {
+public:
+    RandomEncoder(const Architecture& architecture, uint32_t seed) : rng_(seed) {
+        const size_t convLayers[][3] = {{32, 10, 5}, {32, 3, 2}, {32, 3, 2}, {32, 2, 2}, {32, 2, 2}, {32, 2, 2}};
+        size_t channels = 1;
+        for (const auto& spec : convLayers) {
+            ContentEncoderWeights::ConvLayer layer;
+            layer.inChannels = channels;
+            layer.outChannels = spec[0];
+            layer.kernel = spec[1];
+            layer.stride = spec[2];
+            layer.weight = tensor(layer.outChannels * layer.inChannels * layer.kernel, layer.inChannels * layer.kernel);
+            layer.bias = tensor(layer.outChannels, 4);
+            if (architecture.convNorm) {
+                layer.normGamma = ones(layer.outChannels);
+                layer.normBeta = tensor(layer.outChannels, 16);
+            }
+            weights_.conv.push_back(layer);
+            channels = layer.outChannels;
+        }
+
+        weights_.dim = 64;
+        weights_.heads = 4;
+        weights_.ffnDim = 128;
+        weights_.contextFrames = 20;
+        const size_t dim = weights_.dim;
+        weights_.projectionNormGamma = ones(channels);
+        weights_.projectionNormBeta = tensor(channels, 16);
+        weights_.projection = tensor(dim * channels, channels);
+        weights_.projectionBias = tensor(dim, 16);
+
+        if (architecture.positionalKernel > 0) {
+            ContentEncoderWeights::PositionalConv& positional = weights_.positionalConv;
+            positional.kernel = architecture.positionalKernel;
+            positional.groups = 4;
+            positional.causal = architecture.causal;
+            positional.weight = tensor(dim * (dim / positional.groups) * positional.kernel,
+                                       dim / positional.groups * positional.kernel);
+            positional.bias = tensor(dim, 16);
+        }
+        if (architecture.encoderNorm) {
+            weights_.encoderNormGamma = ones(dim);
+            weights_.encoderNormBeta = tensor(dim, 16);
+        }
+
+        for (int l = 0; l < 2; ++l) {
+            ContentEncoderWeights::TransformerLayer layer;
+            layer.inProj = tensor(3 * dim * dim, dim);
+            layer.inBias = tensor(3 * dim, 16);
+            layer.outProj = tensor(dim * dim, dim);
+            layer.outBias = tensor(dim, 16);
+            layer.norm1Gamma = ones(dim);
+            layer.norm1Beta = tensor(dim, 16);
+            layer.ffn1 = tensor(weights_.ffnDim * dim, dim);
+            layer.ffn1Bias = tensor(weights_.ffnDim, 16);
+            layer.ffn2 = tensor(dim * weights_.ffnDim, weights_.ffnDim);
+            layer.ffn2Bias = tensor(dim, 16);
+            layer.norm2Gamma = ones(dim);
+            layer.norm2Beta = tensor(dim, 16);
+            weights_.layers.push_back(layer);
+        }
+    }
+
+    const ContentEncoderWeights& weights() const { return weights_; }
+
+private:
+    // Uniforme de variance 1 / fanIn (initialisation de type Xavier), stockage stable.
+    const float* tensor(size_t size, size_t fanIn) {
+        const float bound = std::sqrt(3.0f / static_cast<float>(fanIn));
+        std::uniform_real_distribution<float> uniform(-bound, bound);
+        storage_.emplace_back(size);
+        for (float& value : storage_.back()) value = uniform(rng_);
+        return storage_.back().data();
+    }
+    const float* ones(size_t size) {
+        storage_.emplace_back(size, 1.0f);
+        return storage_.back().data();
+    }
+
+    std::mt19937 rng_;
+    std::vector<std::vector<float>> storage_; // Vecteurs jamais redimensionnés après création
+    ContentEncoderWeights weights_;
+};
+
+std::vector<float> testSignal(size_t numSamples, uint32_t seed) {
+    std::vector<float> signal(numSamples);
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.05f);
+    for (size_t i = 0; i < numSamples; ++i) {
+        const float t = static_cast<float>(i) / StreamingContentEncoder::kInputRate;
+        signal[i] = 0.3f * std::sin(2.0f * static_cast<float>(M_PI) * 140.0f * t) + noise(rng);
+    }
+    return signal;
+}
+
+// Écart maximal relatif entre process() par blocs irréguliers et encodeFullWindow().
+float compareStreaming(const ContentEncoderWeights& weights, const std::vector<float>& signal) {
+    StreamingContentEncoder encoder(weights, StreamingContentEncoder::kInputRate, signal.size());
+    const std::vector<float> reference = encoder.encodeFullWindow(signal.data(), signal.size());
+
+    const size_t blockSizes[] = {320, 1, 7, 160, 4096, 321, 999, 5000, 64};
+    std::vector<float> streamed(reference.size() + weights.dim);
+    size_t numStreamed = 0;
+    size_t position = 0;
+    for (size_t block = 0; position < signal.size(); ++block) {
+        const size_t count = std::min(blockSizes[block % std::size(blockSizes)], signal.size() - position);
+        const size_t room = streamed.size() / weights.dim - numStreamed;
+        numStreamed += encoder.process(signal.data() + position, count, streamed.data() + numStreamed * weights.dim, room);
+        position += count;
+    }
+    if (numStreamed * weights.dim != reference.size()) {
+        die("trames en flux : " + std::to_string(numStreamed) + ", fenêtre complète : " +
+            std::to_string(reference.size() / weights.dim));
+    }
+
+    float peak = 1.0f;
+    float worst = 0.0f;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        peak = std::max(peak, std::fabs(reference[i]));
+        worst = std::max(worst, std::fabs(reference[i] - streamed[i]));
+    }
+    return worst / peak;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    double seconds = 2.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--seconds" && i + 1 < argc) seconds = std::stod(argv[++i]);
+        else die("option inconnue : " + arg);
+    }
+    if (seconds <= 0.0) die("durée strictement positive attendue");
+
+    const Architecture architectures[] = {
+        {"front-end layer_norm", true, 0, false, false},
+        {"front-end sans norme", false, 0, false, false},
+        {"pos_conv causale 16", true, 16, true, true},
+        {"pos_conv causale 128", true, 128, true, true},
+    };
+    const std::vector<float> signal =
+        testSignal(static_cast<size_t>(seconds * StreamingContentEncoder::kInputRate), 11);
+    uint32_t seed = 1;
+    for (const Architecture& architecture : architectures) {
+        const RandomEncoder encoder(architecture, seed++);
+        std::string error;
+        if (!StreamingContentEncoder::selfCheck(encoder.weights(), &error)) {
+            die(std::string(architecture.name) + " : selfCheck refusé (" + error + ")");
+        }
+        const float worst = compareStreaming(encoder.weights(), signal);
+        std::printf("%-22s selfCheck ok, écart flux / fenêtre complète %.1e\n", architecture.name, worst);
+        if (worst > kTolerance) die(std::string(architecture.name) + " : écart au-delà de la tolérance");
+    }
+
+    // Convolution positionnelle de HuBERT (128 prises centrées) : le flux doit être refusé.
+    const RandomEncoder hubert({"pos_conv centrée 128", true, 128, false, true}, seed);
+    std::string error;
+    if (StreamingContentEncoder::selfCheck(hubert.weights(), &error)) {
+        die("convolution positionnelle centrée acceptée en flux");
+    }
+    std::printf("%-22s refusée (%s)\n", "pos_conv centrée 128", error.c_str());
+    return 0;
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""
+Valeurs de référence du front-end mel de RMVPE pour check_mel_spectrogram.
+
+Le front-end est celui de RVC (rmvpe.py, classe MelSpectrogram) : 16 kHz, n_fft = fenêtre
+= 1024, pas de 160, 128 filtres de 30 Hz à 8 kHz,
+
+    mel_basis = librosa.filters.mel(sr=16000, n_fft=1024, n_mels=128, fmin=30, fmax=8000, htk=True)
+    fft = torch.stft(audio, n_fft=1024, hop_length=160, win_length=1024,
+                     window=torch.hann_window(1024), center=True, return_complex=True)
+    log_mel = torch.log(torch.clamp(mel_basis @ fft.abs(), min=1e-5))
+
+Avec librosa et torch installés, ce code est exécuté tel quel. Sinon, les mêmes formules
+sont recalculées en Python pur, en double précision : librosa.filters.mel (échelle HTK,
+normalisation Slaney), padding par réflexion de torch.stft(center=True), Hann périodique,
+DFT directe. La ligne d'en-tête du fichier indique la source utilisée.
+
+Le signal de test (somme de sinus, glissando et bruit pseudo-aléatoire, arrondis en float32)
+est recalculé à l'identique par check_mel_spectrogram.
+
+Utilisation (depuis la racine du dépôt) :
+    python3 tools/checks/mel_reference.py > tools/checks/mel_reference_rmvpe.txt
+"""
+import math
+import struct
+import sys
+
+SAMPLE_RATE = 16000
+N_FFT = 1024
+HOP = 160
+N_MELS = 128
+FMIN = 30.0
+FMAX = 8000.0
+CLAMP = 1e-5
+NUM_SAMPLES = 4000
+
+
+def to_float32(x):
+    return struct.unpack("f", struct.pack("f", x))[0]
+
+
+def test_signal():
+    """Même formule que testSignal() de check_mel_spectrogram.cpp (double, puis float32)."""
+    signal = []
+    state = 12345
+    for i in range(NUM_SAMPLES):
+        t = i / SAMPLE_RATE
+        chirp = 0.2 * math.sin(2.0 * math.pi * (200.0 * t + 3000.0 * t * t))
+        tones = 0.3 * math.sin(2.0 * math.pi * 220.0 * t) + 0.1 * math.sin(2.0 * math.pi * 1375.5 * t)
+        state = (state * 1103515245 + 12345) % 2147483648
+        noise = 0.02 * (state / 2147483648.0 - 0.5)
+        signal.append(to_float32(chirp + tones + noise))
+    return signal
+
+
+def reference_torch(signal):
+    import librosa
+    import numpy as np
+    import torch
+
+    mel_basis = torch.from_numpy(
+        librosa.filters.mel(sr=SAMPLE_RATE, n_fft=N_FFT, n_mels=N_MELS, fmin=FMIN, fmax=FMAX, htk=True)).float()
+    audio = torch.tensor(np.array(signal, dtype=np.float32)).unsqueeze(0)
+    fft = torch.stft(audio, n_fft=N_FFT, hop_length=HOP, win_length=N_FFT, window=torch.hann_window(N_FFT),
+                     center=True, return_complex=True)
+    log_mel = torch.log(torch.clamp(torch.matmul(mel_basis, fft.abs()), min=CLAMP))
+    return log_mel[0].double().numpy().T.tolist()
+
+
+def hz_to_mel(hz):
+    return 2595.0 * math.log10(1.0 + hz / 700.0)
+
+
+def mel_to_hz(mel):
+    return 700.0 * (10.0 ** (mel / 2595.0) - 1.0)
+
+
+def reference_python(signal):
+    # librosa.filters.mel(htk=True, norm="slaney")
+    min_mel, max_mel = hz_to_mel(FMIN), hz_to_mel(FMAX)
+    points = [mel_to_hz(min_mel + (max_mel - min_mel) * i / (N_MELS + 1)) for i in range(N_MELS + 2)]
+    num_bins = N_FFT // 2 + 1
+    freqs = [k * SAMPLE_RATE / N_FFT for k in range(num_bins)]
+    basis = []
+    for m in range(N_MELS):
+        lower, center, upper = points[m], points[m + 1], points[m + 2]
+        norm = 2.0 / (upper - lower)
+        basis.append([max(0.0, min((f - lower) / (center - lower), (upper - f) / (upper - center))) * norm
+                      for f in freqs])
+
+    # torch.stft(center=True) : réflexion de n_fft / 2 échantillons de chaque côté.
+    half = N_FFT // 2
+    padded = signal[half:0:-1] + signal + signal[-2:-half - 2:-1]
+    window = [0.5 - 0.5 * math.cos(2.0 * math.pi * n / N_FFT) for n in range(N_FFT)]
+    cos_table = [math.cos(2.0 * math.pi * k / N_FFT) for k in range(N_FFT)]
+    sin_table = [math.sin(2.0 * math.pi * k / N_FFT) for k in range(N_FFT)]
+
+    frames = []
+    for start in range(0, len(padded) - N_FFT + 1, HOP):
+        x = [padded[start + n] * window[n] for n in range(N_FFT)]
+        magnitude = []
+        for k in range(num_bins):
+            re = im = 0.0
+            for n in range(N_FFT):
+                index = (k * n) % N_FFT
+                re += x[n] * cos_table[index]
+                im -= x[n] * sin_table[index]
+            magnitude.append(math.hypot(re, im))
+        frames.append([math.log(max(sum(w * a for w, a in zip(basis[m], magnitude)), CLAMP))
+                       for m in range(N_MELS)])
+    return frames
+
+
+def main():
+    signal = test_signal()
+    try:
+        frames = reference_torch(signal)
+        source = "librosa+torch"
+    except ImportError:
+        frames = reference_python(signal)
+        source = "python"
+    out = sys.stdout
+    out.write("# rmvpe sr=%d n_fft=%d hop=%d n_mels=%d fmin=%g fmax=%g samples=%d frames=%d source=%s\n"
+              % (SAMPLE_RATE, N_FFT, HOP, N_MELS, FMIN, FMAX, NUM_SAMPLES, len(frames), source))
+    for frame in frames:
+        out.write(" ".join("%.7g" % v for v in frame) + "\n")
+
+
+if __name__ == "__main__":
+    main()
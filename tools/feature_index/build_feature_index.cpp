@@ -0,0 +1,317 @@
+/**
+ * Construction d'un index de features RVC (format "RVCI", voir inference/feature_index.h),
+ * sur la machine hôte, à partir des matrices de features exportées de l'entraînement
+ * (.npy float32 [N][dim], par exemple total_fea.npy de RVC).
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   c++ -std=c++20 -O3 -pthread -Iapp/src/main/cpp tools/feature_index/build_feature_index.cpp \
+ *       -o build_feature_index
+ *
+ * Utilisation :
+ *   build_feature_index [options] sortie.rvci features.npy [features2.npy ...]
+ *     --lists N       Listes inversées (défaut : 4 * sqrt(N), entre 1 et N / 39)
+ *     --pq M          Quantification par produit sur M sous-espaces (défaut : 0 = flat)
+ *     --metric l2|ip  Distance de recherche (défaut : l2, comme RVC)
+ *     --iterations N  Itérations de k-means (défaut : 20)
+ *     --train N       Vecteurs tirés pour l'apprentissage (défaut : 256 par liste)
+ *     --seed N        Graine du tirage (défaut : 1)
+ *
+ * Le moteur charge l'index "<modèle>.rvci" posé à côté du modèle.
+ */
+#include "dsp/crc32.h"
+#include "inference/feature_index.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using rvc::FeatureIndex;
+
+namespace {
+
+struct Matrix {
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<float> data;
+    const float* row(size_t r) const { return data.data() + r * cols; }
+};
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "build_feature_index: %s\n", message.c_str());
+    std::exit(1);
+}
+
+// Lecture d'un .npy (versions 1 à 3) : float32 petit-boutiste, 2 dimensions, ordre C.
+Matrix readNpy(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) die("lecture impossible : " + path);
+    char magic[8];
+    in.read(magic, 8);
+    if (!in || std::memcmp(magic, "\x93NUMPY", 6) != 0) die("pas un fichier .npy : " + path);
+    const int major = static_cast<unsigned char>(magic[6]);
+    uint32_t headerLength = 0;
+    if (major == 1) {
+        uint16_t length16 = 0;
+        in.read(reinterpret_cast<char*>(&length16), 2);
+        headerLength = length16;
+    } else {
+        in.read(reinterpret_cast<char*>(&headerLength), 4);
+    }
+    std::string header(headerLength, '\0');
+    in.read(header.data(), headerLength);
+    if (!in) die("en-tête .npy tronqué : " + path);
+
+    if (header.find("'descr': '<f4'") == std::string::npos) die("float32 petit-boutiste attendu : " + path);
+    if (header.find("'fortran_order': False") == std::string::npos) die("ordre C attendu : " + path);
+    const size_t shape = header.find("'shape': (");
+    if (shape == std::string::npos) die("forme absente : " + path);
+    Matrix matrix;
+    if (std::sscanf(header.c_str() + shape, "'shape': (%zu, %zu)", &matrix.rows, &matrix.cols) != 2 ||
+        matrix.rows == 0 || matrix.cols == 0) {
+        die("matrice [N, dim] attendue : " + path);
+    }
+    matrix.data.resize(matrix.rows * matrix.cols);
+    in.read(reinterpret_cast<char*>(matrix.data.data()), matrix.data.size() * sizeof(float));
+    if (!in) die("données tronquées : " + path);
+    for (float v : matrix.data) {
+        if (!std::isfinite(v)) die("valeur non finie : " + path);
+    }
+    return matrix;
+}
+
+float squaredDistance(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        const float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+float dot(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+// Plus proche centroïde de chaque ligne (sous-vecteur [offset, offset + dim)), en parallèle.
+void assign(const Matrix& points, size_t offset, size_t dim, const std::vector<float>& centroids, size_t k,
+            bool innerProduct, std::vector<uint32_t>& labels) {
+    labels.resize(points.rows);
+    const size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t r = t; r < points.rows; r += numThreads) {
+                const float* p = points.row(r) + offset;
+                float best = std::numeric_limits<float>::max();
+                for (size_t c = 0; c < k; ++c) {
+                    const float* centroid = centroids.data() + c * dim;
+                    const float d = innerProduct ? -dot(p, centroid, dim) : squaredDistance(p, centroid, dim);
+                    if (d < best) {
+                        best = d;
+                        labels[r] = static_cast<uint32_t>(c);
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+}
+
+/**
+ * k-means de Lloyd sur les sous-vecteurs [offset, offset + dim) d'un échantillon. Une liste
+ * vide reprend un point de la plus grande (légèrement décalé), comme faiss.
+ */
+std::vector<float> kmeans(const Matrix& sample, size_t offset, size_t dim, size_t k, size_t iterations,
+                          bool innerProduct, std::mt19937& random) {
+    std::vector<float> centroids(k * dim);
+    std::vector<size_t> order(sample.rows);
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), random);
+    for (size_t c = 0; c < k; ++c) {
+        std::copy_n(sample.row(order[c % order.size()]) + offset, dim, centroids.begin() + c * dim);
+    }
+
+    std::vector<uint32_t> labels;
+    std::vector<double> sums(k * dim);
+    std::vector<size_t> counts(k);
+    for (size_t iteration = 0; iteration < iterations; ++iteration) {
+        assign(sample, offset, dim, centroids, k, innerProduct, labels);
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t r = 0; r < sample.rows; ++r) {
+            const float* p = sample.row(r) + offset;
+            double* sum = sums.data() + labels[r] * dim;
+            for (size_t i = 0; i < dim; ++i) sum[i] += p[i];
+            ++counts[labels[r]];
+        }
+        for (size_t c = 0; c < k; ++c) {
+            if (counts[c] == 0) {
+                const size_t largest = std::max_element(counts.begin(), counts.end()) - counts.begin();
+                for (size_t i = 0; i < dim; ++i) {
+                    const float value = centroids[largest * dim + i];
+                    centroids[c * dim + i] = value * (i % 2 ? 1.0001f : 0.9999f);
+                }
+                continue;
+            }
+            for (size_t i = 0; i < dim; ++i) {
+                centroids[c * dim + i] = static_cast<float>(sums[c * dim + i] / static_cast<double>(counts[c]));
+            }
+        }
+    }
+    return centroids;
+}
+
+size_t alignUp(size_t offset) {
+    return (offset + FeatureIndex::kAlignment - 1) / FeatureIndex::kAlignment * FeatureIndex::kAlignment;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t numLists = 0;
+    size_t pqSubspaces = 0;
+    size_t iterations = 20;
+    size_t trainSize = 0;
+    unsigned seed = 1;
+    bool innerProduct = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) die("valeur manquante pour " + arg);
+            return argv[++i];
+        };
+        if (arg == "--lists") numLists = std::stoul(value());
+        else if (arg == "--pq") pqSubspaces = std::stoul(value());
+        else if (arg == "--iterations") iterations = std::stoul(value());
+        else if (arg == "--train") trainSize = std::stoul(value());
+        else if (arg == "--seed") seed = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--metric") {
+            const std::string metric = value();
+            if (metric != "l2" && metric != "ip") die("métrique inconnue : " + metric);
+            innerProduct = metric == "ip";
+        } else positional.push_back(arg);
+    }
+    if (positional.size() < 2) die("usage : build_feature_index [options] sortie.rvci features.npy [...]");
+
+    // 1. Features concaténées.
+    Matrix features;
+    for (size_t f = 1; f < positional.size(); ++f) {
+        Matrix part = readNpy(positional[f]);
+        if (features.cols != 0 && part.cols != features.cols) die("dimensions différentes : " + positional[f]);
+        features.cols = part.cols;
+        features.rows += part.rows;
+        features.data.insert(features.data.end(), part.data.begin(), part.data.end());
+    }
+    const size_t dim = features.cols;
+    if (features.rows > std::numeric_limits<uint32_t>::max()) die("trop de vecteurs");
+    if (pqSubspaces != 0 && dim % pqSubspaces != 0) die("dim doit être un multiple de --pq");
+    if (numLists == 0) {
+        numLists = static_cast<size_t>(4.0 * std::sqrt(static_cast<double>(features.rows)));
+        numLists = std::clamp<size_t>(numLists, 1, std::max<size_t>(1, features.rows / 39));
+    }
+    numLists = std::min(numLists, features.rows);
+    std::printf("%zu vecteurs de dimension %zu, %zu listes, %s\n", features.rows, dim, numLists,
+                pqSubspaces ? ("PQ " + std::to_string(pqSubspaces) + "x8 bits").c_str() : "flat");
+
+    // 2. Échantillon d'apprentissage.
+    std::mt19937 random(seed);
+    if (trainSize == 0) trainSize = 256 * std::max(numLists, pqSubspaces ? FeatureIndex::kCodebookSize : 0);
+    Matrix sample;
+    sample.cols = dim;
+    if (trainSize >= features.rows) {
+        sample = features;
+    } else {
+        std::vector<size_t> order(features.rows);
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::shuffle(order.begin(), order.end(), random);
+        sample.rows = trainSize;
+        sample.data.resize(trainSize * dim);
+        for (size_t r = 0; r < trainSize; ++r) std::copy_n(features.row(order[r]), dim, sample.data.begin() + r * dim);
+    }
+
+    // 3. Centroïdes IVF, puis répartition de tous les vecteurs.
+    const std::vector<float> centroids = kmeans(sample, 0, dim, numLists, iterations, innerProduct, random);
+    std::vector<uint32_t> labels;
+    assign(features, 0, dim, centroids, numLists, innerProduct, labels);
+    std::vector<uint32_t> listStarts(numLists + 1, 0);
+    for (uint32_t label : labels) ++listStarts[label + 1];
+    for (size_t list = 0; list < numLists; ++list) listStarts[list + 1] += listStarts[list];
+    std::vector<uint32_t> ordered(features.rows);
+    {
+        std::vector<uint32_t> cursor(listStarts.begin(), listStarts.end() - 1);
+        for (size_t r = 0; r < features.rows; ++r) ordered[cursor[labels[r]]++] = static_cast<uint32_t>(r);
+    }
+
+    // 4. Dictionnaires PQ (k-means de 256 centroïdes par sous-espace) et codes.
+    const size_t sub = pqSubspaces ? dim / pqSubspaces : 0;
+    std::vector<float> codebooks;
+    std::vector<uint8_t> codes;
+    if (pqSubspaces) {
+        codebooks.resize(pqSubspaces * FeatureIndex::kCodebookSize * sub);
+        codes.resize(features.rows * pqSubspaces);
+        for (size_t m = 0; m < pqSubspaces; ++m) {
+            // La PQ code les vecteurs eux-mêmes : distances toujours en L2 dans un sous-espace.
+            const std::vector<float> book =
+                kmeans(sample, m * sub, sub, FeatureIndex::kCodebookSize, iterations, false, random);
+            std::copy(book.begin(), book.end(), codebooks.begin() + m * FeatureIndex::kCodebookSize * sub);
+            std::vector<uint32_t> subLabels;
+            assign(features, m * sub, sub, book, FeatureIndex::kCodebookSize, false, subLabels);
+            for (size_t i = 0; i < features.rows; ++i) {
+                codes[i * pqSubspaces + m] = static_cast<uint8_t>(subLabels[ordered[i]]);
+            }
+        }
+    }
+
+    // 5. Disposition et écriture.
+    FeatureIndex::Header header = {};
+    header.magic = FeatureIndex::kMagic;
+    header.version = FeatureIndex::kVersion;
+    header.headerSize = sizeof(FeatureIndex::Header);
+    header.encoding = static_cast<uint32_t>(pqSubspaces ? FeatureIndex::Encoding::ProductQuantized
+                                                        : FeatureIndex::Encoding::Flat);
+    header.metric = static_cast<uint32_t>(innerProduct ? FeatureIndex::Metric::InnerProduct : FeatureIndex::Metric::L2);
+    header.dim = static_cast<uint32_t>(dim);
+    header.numLists = static_cast<uint32_t>(numLists);
+    header.numVectors = static_cast<uint32_t>(features.rows);
+    header.pqSubspaces = static_cast<uint32_t>(pqSubspaces);
+    size_t offset = alignUp(sizeof(FeatureIndex::Header));
+    header.centroidsOffset = offset;
+    offset = alignUp(offset + centroids.size() * sizeof(float));
+    header.listsOffset = offset;
+    offset = alignUp(offset + listStarts.size() * sizeof(uint32_t));
+    if (pqSubspaces) {
+        header.codebooksOffset = offset;
+        offset = alignUp(offset + codebooks.size() * sizeof(float));
+    }
+    header.vectorsOffset = offset;
+    offset += pqSubspaces ? codes.size() : features.data.size() * sizeof(float);
+    header.fileSize = offset;
+    header.headerCrc = rvc::crc32(&header, sizeof(header));
+
+    std::vector<uint8_t> file(offset, 0);
+    std::memcpy(file.data(), &header, sizeof(header));
+    std::memcpy(file.data() + header.centroidsOffset, centroids.data(), centroids.size() * sizeof(float));
+    std::memcpy(file.data() + header.listsOffset, listStarts.data(), listStarts.size() * sizeof(uint32_t));
+    if (pqSubspaces) {
+        std::memcpy(file.data() + header.codebooksOffset, codebooks.data(), codebooks.size() * sizeof(float));
+        std::memcpy(file.data() + header.vectorsOffset, codes.data(), codes.size());
+    } else {
+        float* vectors = reinterpret_cast<float*>(file.data() + header.vectorsOffset);
+        for (size_t i = 0; i < features.rows; ++i) std::copy_n(features.row(ordered[i]), dim, vectors + i * dim);
+    }
+
+    std::ofstream out(positional[0], std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    if (!out) die("écriture impossible : " + positional[0]);
+    std::printf("%s : %zu octets\n", positional[0].c_str(), file.size());
+    return 0;
+}
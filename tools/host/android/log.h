@@ -0,0 +1,12 @@
+/**
+ * Journal Android pour les outils compilés sur la machine hôte (-Itools/host) : les
+ * messages des modules du moteur partent sur stderr.
+ */
+#pragma once
+
+#include <stdio.h>
+
+enum { ANDROID_LOG_DEBUG = 3, ANDROID_LOG_INFO = 4, ANDROID_LOG_WARN = 5, ANDROID_LOG_ERROR = 6 };
+
+#define __android_log_print(priority, tag, ...) \
+    ((void)(priority), fprintf(stderr, "%s: ", tag), fprintf(stderr, __VA_ARGS__), fputc('\n', stderr))
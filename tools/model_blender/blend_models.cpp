@@ -0,0 +1,92 @@
+/**
+ * Mélange de deux modèles RVC de même architecture (voir inference/model_blender.h), sur la
+ * machine hôte : les poids flottants sont interpolés, (1 - ratio) * A + ratio * B.
+ *
+ * Compilation (depuis la racine du dépôt) :
+ *   c++ -std=c++20 -O3 -Iapp/src/main/cpp tools/model_blender/blend_models.cpp \
+ *       app/src/main/cpp/inference/model_blender.cpp -o blend_models
+ *
+ * Utilisation :
+ *   blend_models [options] sortie.tflite a.tflite b.tflite   (ou .onnx)
+ *     --ratio R   Part du modèle B, entre 0 et 1 (défaut : 0.5)
+ *     --list      Affiche la table des poids de A et B sans rien écrire
+ *
+ * Le moteur construit les mêmes mélanges à la demande (BlendedModelCache) ; l'outil sert à
+ * les préparer, ou à vérifier la compatibilité de deux modèles.
+ */
+#include "inference/model_blender.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using rvc::ModelBlender;
+using rvc::ModelWeights;
+using rvc::WeightTensor;
+
+namespace {
+
+[[noreturn]] void die(const std::string& message) {
+    std::fprintf(stderr, "blend_models: %s\n", message.c_str());
+    std::exit(1);
+}
+
+void listWeights(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) die("lecture impossible : " + path);
+    const std::vector<uint8_t> data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    std::vector<WeightTensor> tensors;
+    std::string error;
+    if (!ModelWeights::read(data.data(), data.size(), ModelWeights::formatOf(path), tensors, &error)) {
+        die(path + " : " + error);
+    }
+    uint64_t blendable = 0;
+    std::printf("%s : %zu tenseurs\n", path.c_str(), tensors.size());
+    for (const WeightTensor& tensor : tensors) {
+        std::string shape;
+        for (int64_t d : tensor.shape) {
+            if (!shape.empty()) shape += 'x';
+            shape += std::to_string(d);
+        }
+        const char* type = tensor.type == WeightTensor::Type::Float32   ? "f32"
+                           : tensor.type == WeightTensor::Type::Float16 ? "f16"
+                                                                        : "autre";
+        std::printf("  %-40s %-5s [%s] %llu octets\n", tensor.name.c_str(), type, shape.c_str(),
+                    static_cast<unsigned long long>(tensor.size));
+        if (tensor.type != WeightTensor::Type::Other) blendable += tensor.size;
+    }
+    std::printf("  poids mélangeables : %llu octets\n", static_cast<unsigned long long>(blendable));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    float ratio = 0.5f;
+    bool listOnly = false;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--ratio") {
+            if (i + 1 >= argc) die("valeur manquante pour " + arg);
+            ratio = std::stof(argv[++i]);
+            if (!(ratio >= 0.0f && ratio <= 1.0f)) die("ratio entre 0 et 1 attendu");
+        } else if (arg == "--list") {
+            listOnly = true;
+        } else positional.push_back(arg);
+    }
+
+    if (listOnly) {
+        if (positional.empty()) die("usage : blend_models --list modèle [...]");
+        for (const std::string& path : positional) listWeights(path);
+        return 0;
+    }
+    if (positional.size() != 3) die("usage : blend_models [--ratio R] sortie a.tflite b.tflite");
+
+    std::string error;
+    if (!ModelBlender::blend(positional[1], positional[2], ratio, positional[0], &error)) die(error);
+    std::printf("%s : %.0f %% %s + %.0f %% %s\n", positional[0].c_str(), 100.0f * (1.0f - ratio),
+                positional[1].c_str(), 100.0f * ratio, positional[2].c_str());
+    return 0;
+}